@@ -0,0 +1,175 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadGroup.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace carla {
+
+namespace detail {
+
+  /// Worker threads shared by every ParallelFor call, created on first use.
+  ///
+  /// The calling thread takes tasks of its own job too, and only waits for
+  /// the tasks already being run by other threads. Thus nested calls, or
+  /// calls made while every worker is busy, never block waiting for a free
+  /// worker.
+  class ParallelForPool : private NonCopyable {
+  public:
+
+    static ParallelForPool &GetInstance() {
+      static ParallelForPool pool;
+      return pool;
+    }
+
+    ~ParallelForPool() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+      }
+      _job_available.notify_all();
+      _workers.JoinAll();
+    }
+
+    /// Call `task(i)` for every i in [0, count), returns when every call is
+    /// done. @a task must not throw.
+    void Run(const size_t count, const std::function<void(size_t)> &task) {
+      Job job{task, count};
+      std::unique_lock<std::mutex> lock(_mutex);
+      _jobs.push_back(&job);
+      lock.unlock();
+      _job_available.notify_all();
+      lock.lock();
+      while (job.next < job.count) {
+        RunNextTask(job, lock);
+      }
+      _task_done.wait(lock, [&]() { return job.done == job.count; });
+    }
+
+  private:
+
+    struct Job {
+      const std::function<void(size_t)> &task;
+      const size_t count;
+      size_t next = 0u;
+      size_t done = 0u;
+    };
+
+    ParallelForPool() {
+      const auto hardware_threads = std::max(std::thread::hardware_concurrency(), 2u);
+      _workers.CreateThreads(hardware_threads - 1u, [this]() { RunWorker(); });
+    }
+
+    /// Run the next task of @a job, @a lock must be locked.
+    void RunNextTask(Job &job, std::unique_lock<std::mutex> &lock) {
+      const size_t index = job.next++;
+      if (job.next == job.count) {
+        _jobs.erase(std::find(_jobs.begin(), _jobs.end(), &job));
+      }
+      lock.unlock();
+      job.task(index);
+      lock.lock();
+      if (++job.done == job.count) {
+        _task_done.notify_all();
+      }
+    }
+
+    void RunWorker() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      for (;;) {
+        _job_available.wait(lock, [this]() { return _stop || !_jobs.empty(); });
+        if (_stop) {
+          return;
+        }
+        RunNextTask(*_jobs.front(), lock);
+      }
+    }
+
+    std::mutex _mutex;
+
+    std::condition_variable _job_available;
+
+    std::condition_variable _task_done;
+
+    /// Jobs with tasks not started yet.
+    std::deque<Job *> _jobs;
+
+    bool _stop = false;
+
+    ThreadGroup _workers;
+  };
+
+} // namespace detail
+
+  /// Splits the range [0, count) in contiguous chunks and calls
+  /// `functor(begin, end)` for each of them. The chunks are processed by the
+  /// calling thread and a pool of worker threads shared by every call (one per
+  /// hardware thread). Blocks until every chunk is done, if any of the calls
+  /// throws, the first exception is rethrown here (unless compiled with
+  /// LIBCARLA_NO_EXCEPTIONS).
+  ///
+  /// @param number_of_threads maximum number of chunks, zero to use one per
+  ///   hardware thread.
+  /// @param min_chunk_size do not split the work in chunks smaller than this.
+  template <typename F>
+  void ParallelFor(
+      const size_t count,
+      F &&functor,
+      size_t number_of_threads = 0u,
+      const size_t min_chunk_size = 1024u) {
+    if (number_of_threads == 0u) {
+      number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const size_t min_chunk = std::max<size_t>(min_chunk_size, 1u);
+    const size_t max_chunks = (count + min_chunk - 1u) / min_chunk;
+    const size_t max_threads = std::max<size_t>(1u, std::min(number_of_threads, max_chunks));
+    if (max_threads == 1u) {
+      functor(size_t(0u), count);
+      return;
+    }
+    const size_t chunk_size = (count + max_threads - 1u) / max_threads;
+    const size_t chunks = (count + chunk_size - 1u) / chunk_size;
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    std::exception_ptr exception;
+    std::mutex mutex;
+    auto run = [&](size_t begin, size_t end) {
+      try {
+        functor(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    };
+#else
+    auto run = [&](size_t begin, size_t end) {
+      functor(begin, end);
+    };
+#endif // LIBCARLA_NO_EXCEPTIONS
+    auto run_chunk = [&](size_t i) {
+      const size_t begin = i * chunk_size;
+      run(begin, std::min(begin + chunk_size, count));
+    };
+    detail::ParallelForPool::GetInstance().Run(chunks, std::ref(run_chunk));
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+#endif // LIBCARLA_NO_EXCEPTIONS
+  }
+
+} // namespace carla
@@ -88,6 +88,18 @@ namespace client {
       _simulator->SetReplayerTimeFactor(time_factor);
     }
 
+    /// Write the raw buffers received from every sensor listened through
+    /// this client to a stream log at @a path, see sensor::StreamLogWriter.
+    void StartStreamCapture(
+        std::string path,
+        uint64_t max_segment_size = sensor::StreamLogWriter::DefaultMaxSegmentSize) {
+      _simulator->StartStreamCapture(std::move(path), max_segment_size);
+    }
+
+    void StopStreamCapture() {
+      _simulator->StopStreamCapture();
+    }
+
     void ApplyBatch(
         std::vector<rpc::Command> commands,
         bool do_tick_cue = false) const {
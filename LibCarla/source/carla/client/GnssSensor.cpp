@@ -15,7 +15,15 @@
 namespace carla {
 namespace client {
 
-  GnssSensor::~GnssSensor() = default;
+  GnssSensor::~GnssSensor() {
+    if (_is_listening && GetEpisode().IsValid()) {
+      try {
+        Stop();
+      } catch (const std::exception &e) {
+        log_error("exception trying to stop sensor:", GetDisplayId(), ':', e.what());
+      }
+    }
+  }
 
   void GnssSensor::Listen(CallbackFunctionType callback) {
     if (_is_listening) {
@@ -35,7 +43,7 @@ namespace client {
     auto self = boost::static_pointer_cast<GnssSensor>(shared_from_this());
 
     log_debug(GetDisplayId(), ": subscribing to tick event");
-    GetEpisode().Lock()->RegisterOnTickEvent([
+    _callback_id = GetEpisode().Lock()->RegisterOnTickEvent([
         cb=std::move(callback),
         weak_self=WeakPtr<GnssSensor>(self)](const auto &timestamp) {
       auto self = weak_self.lock();
@@ -66,7 +74,14 @@ namespace client {
   }
 
   void GnssSensor::Stop() {
-    /// @todo We need unsubscribe from the world on tick.
+    if (!_is_listening) {
+      log_warning(
+          "attempting to unsubscribe from tick event but sensor wasn't listening:",
+          GetDisplayId());
+      return;
+    }
+    log_debug(GetDisplayId(), ": unsubscribing from tick event");
+    GetEpisode().Lock()->RemoveOnTickEvent(_callback_id);
     _is_listening = false;
   }
 
@@ -43,6 +43,8 @@ namespace client {
     geom::GeoLocation _geo_reference;
 
     bool _is_listening = false;
+
+    size_t _callback_id = 0u;
   };
 
 } // namespace client
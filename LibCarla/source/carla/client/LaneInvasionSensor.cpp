@@ -40,7 +40,15 @@ namespace client {
         location + Rotate(yaw, geom::Location(-box.extent.x, -box.extent.y, 0.0f))};
   }
 
-  LaneInvasionSensor::~LaneInvasionSensor() = default;
+  LaneInvasionSensor::~LaneInvasionSensor() {
+    if (_is_listening && GetEpisode().IsValid()) {
+      try {
+        Stop();
+      } catch (const std::exception &e) {
+        log_error("exception trying to stop sensor:", GetDisplayId(), ':', e.what());
+      }
+    }
+  }
 
   void LaneInvasionSensor::Listen(CallbackFunctionType callback) {
     if (_is_listening) {
@@ -60,7 +68,7 @@ namespace client {
     auto self = boost::static_pointer_cast<LaneInvasionSensor>(shared_from_this());
 
     log_debug(GetDisplayId(), ": subscribing to tick event");
-    GetEpisode().Lock()->RegisterOnTickEvent([
+    _callback_id = GetEpisode().Lock()->RegisterOnTickEvent([
         cb=std::move(callback),
         weak_self=WeakPtr<LaneInvasionSensor>(self)](const auto &timestamp) {
       auto self = weak_self.lock();
@@ -75,20 +83,30 @@ namespace client {
   }
 
   void LaneInvasionSensor::Stop() {
-    /// @todo We need unsubscribe from the world on tick.
+    if (!_is_listening) {
+      log_warning(
+          "attempting to unsubscribe from tick event but sensor wasn't listening:",
+          GetDisplayId());
+      return;
+    }
+    log_debug(GetDisplayId(), ": unsubscribing from tick event");
+    GetEpisode().Lock()->RemoveOnTickEvent(_callback_id);
     _is_listening = false;
   }
 
   SharedPtr<sensor::SensorData> LaneInvasionSensor::TickLaneInvasionSensor(
       const Timestamp &timestamp) {
     try {
+      using road::element::LaneCrossingCalculator;
+      const auto &map = _map->GetMap();
       const auto new_bounds = GetVehicleBounds(*_vehicle);
       std::vector<road::element::LaneMarking> crossed_lanes;
       for (auto i = 0u; i < _bounds.size(); ++i) {
-        const auto lanes = _map->CalculateCrossedLanes(_bounds[i], new_bounds[i]);
+        auto projection = LaneCrossingCalculator::Project(map, new_bounds[i], &_bounds[i]);
+        const auto lanes = LaneCrossingCalculator::Calculate(map, _bounds[i], projection);
         crossed_lanes.insert(crossed_lanes.end(), lanes.begin(), lanes.end());
+        _bounds[i] = std::move(projection);
       }
-      _bounds = new_bounds;
       return crossed_lanes.empty() ?
           nullptr :
           MakeShared<sensor::data::LaneInvasionEvent>(
@@ -7,7 +7,7 @@
 #pragma once
 
 #include "carla/client/ClientSideSensor.h"
-#include "carla/geom/Location.h"
+#include "carla/road/element/LaneCrossingCalculator.h"
 
 #include <array>
 
@@ -32,7 +32,6 @@ namespace client {
     void Listen(CallbackFunctionType callback) override;
 
     /// Stop listening for new measurements.
-    /// @throw Not implemented error.
     void Stop() override;
 
     /// Return whether this Sensor instance is currently listening to the
@@ -47,11 +46,15 @@ namespace client {
 
     bool _is_listening = false;
 
+    size_t _callback_id = 0u;
+
     SharedPtr<Map> _map;
 
     SharedPtr<Vehicle> _vehicle;
 
-    std::array<geom::Location, 4u> _bounds;
+    /// Corners of the vehicle's bounding box projected on the road in the
+    /// previous tick, reused as hints for the next projection.
+    std::array<road::element::RoadProjection, 4u> _bounds;
   };
 
 } // namespace client
@@ -97,5 +97,21 @@ namespace client {
     return _map.GetGeoReference();
   }
 
+  SharedPtr<const road::LaneGeometry> Map::GetLaneGeometry(const double resolution) const {
+    {
+      std::lock_guard<std::mutex> lock(_lane_geometry_mutex);
+      if ((_lane_geometry != nullptr) && (_lane_geometry_resolution == resolution)) {
+        return _lane_geometry;
+      }
+    }
+    // Computing the geometry takes a while, do not block other threads
+    // meanwhile. If two threads compute it at once, the last one is kept.
+    auto geometry = MakeShared<const road::LaneGeometry>(_map.ComputeLaneGeometry(resolution));
+    std::lock_guard<std::mutex> lock(_lane_geometry_mutex);
+    _lane_geometry_resolution = resolution;
+    _lane_geometry = geometry;
+    return geometry;
+  }
+
 } // namespace client
 } // namespace carla
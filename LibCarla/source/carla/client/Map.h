@@ -13,6 +13,7 @@
 #include "carla/rpc/MapInfo.h"
 #include "carla/road/Lane.h"
 
+#include <mutex>
 #include <string>
 
 namespace carla {
@@ -65,11 +66,22 @@ namespace client {
 
     const geom::GeoLocation &GetGeoReference() const;
 
+    /// Center and boundary polylines of every lane, sampled every @a
+    /// resolution meters. The geometry of the last resolution requested is
+    /// cached with the map.
+    SharedPtr<const road::LaneGeometry> GetLaneGeometry(double resolution) const;
+
   private:
 
     const rpc::MapInfo _description;
 
     const road::Map _map;
+
+    mutable std::mutex _lane_geometry_mutex;
+
+    mutable double _lane_geometry_resolution = 0.0;
+
+    mutable SharedPtr<const road::LaneGeometry> _lane_geometry;
   };
 
 } // namespace client
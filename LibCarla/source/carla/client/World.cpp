@@ -79,13 +79,32 @@ namespace client {
     return _episode.Lock()->WaitForTick(timeout);
   }
 
-  void World::OnTick(std::function<void(Timestamp)> callback) {
+  size_t World::OnTick(std::function<void(Timestamp)> callback) {
     return _episode.Lock()->RegisterOnTickEvent(std::move(callback));
   }
 
+  void World::RemoveOnTick(size_t callback_id) {
+    _episode.Lock()->RemoveOnTickEvent(callback_id);
+  }
+
+  void World::SetOnTickWorkerThreads(size_t count) {
+    _episode.Lock()->SetOnTickWorkerThreads(count);
+  }
+
   void World::Tick() {
     _episode.Lock()->Tick();
   }
 
+  uint64_t World::TickAndWait(time_duration timeout, time_duration spin_time) {
+    return _episode.Lock()->TickAndWait(timeout, spin_time);
+  }
+
+  boost::optional<uint64_t> World::TickPipelined(
+      size_t max_outstanding_ticks,
+      time_duration timeout,
+      time_duration spin_time) {
+    return _episode.Lock()->TickPipelined(max_outstanding_ticks, timeout, spin_time);
+  }
+
 } // namespace client
 } // namespace carla
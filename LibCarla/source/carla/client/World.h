@@ -17,6 +17,8 @@
 #include "carla/rpc/VehiclePhysicsControl.h"
 #include "carla/rpc/WeatherParameters.h"
 
+#include <boost/optional.hpp>
+
 namespace carla {
 namespace client {
 
@@ -88,12 +90,48 @@ namespace client {
     Timestamp WaitForTick(time_duration timeout) const;
 
     /// Register a @a callback to be called every time a world tick is received.
-    void OnTick(std::function<void(Timestamp)> callback);
+    ///
+    /// @return ID of the callback, use it to remove the callback.
+    size_t OnTick(std::function<void(Timestamp)> callback);
+
+    /// Remove a callback registered with OnTick.
+    void RemoveOnTick(size_t callback_id);
+
+    /// Set the number of worker threads used to run the on-tick callbacks. If
+    /// zero (default), callbacks are run one after another in the thread that
+    /// receives the tick. Otherwise each callback runs in a worker thread, one
+    /// call at a time and in order, so a slow callback does not delay the
+    /// rest.
+    void SetOnTickWorkerThreads(size_t count);
 
     /// Signal the simulator to continue to next tick (only has effect on
     /// synchronous mode).
     void Tick();
 
+    /// Signal the simulator to continue to next tick and wait until the frame
+    /// produced is received (only has effect on synchronous mode). The thread
+    /// spins for up to @a spin_time before blocking, this reduces the latency
+    /// at the cost of CPU time.
+    ///
+    /// @return the id of the frame produced.
+    uint64_t TickAndWait(time_duration timeout, time_duration spin_time = {});
+
+    /// Same as TickAndWait but allows up to @a max_outstanding_ticks ticks to
+    /// be in flight, so the client can work while the simulator computes the
+    /// next frames. Only waits for the oldest ticks in excess.
+    ///
+    /// @note The simulator acknowledges each tick in the game thread, at the
+    /// end of the frame. Sending a tick blocks while a frame is being
+    /// computed, so only one frame overlaps with the client's work; values
+    /// greater than one do not improve the throughput.
+    ///
+    /// @return the id of the latest frame completed by this call, empty if
+    /// no tick had to be waited for.
+    boost::optional<uint64_t> TickPipelined(
+        size_t max_outstanding_ticks,
+        time_duration timeout,
+        time_duration spin_time = {});
+
     DebugHelper MakeDebugHelper() const {
       return DebugHelper{_episode};
     }
@@ -7,46 +7,234 @@
 #pragma once
 
 #include "carla/AtomicSharedPtr.h"
+#include "carla/Logging.h"
 #include "carla/NonCopyable.h"
+#include "carla/streaming/detail/AsioThreadPool.h"
 
+#include <algorithm>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 namespace carla {
 namespace client {
 namespace detail {
 
+  /// List of callbacks that can be registered and removed at any time, and
+  /// called from any thread.
+  ///
+  /// By default callbacks are executed one after another in the thread calling
+  /// `Call`. After `SetWorkerThreads(n)` with n > 0 they are dispatched to a
+  /// pool of n worker threads instead, so a slow callback does not delay the
+  /// others. Each callback still receives its calls one at a time and in the
+  /// same order `Call` was invoked.
   template <typename... InputsT>
   class CallbackList : private NonCopyable {
   public:
 
     using CallbackType = std::function<void(InputsT...)>;
 
+    /// Identifies a registered callback, zero is never a valid id.
+    using CallbackId = size_t;
+
     CallbackList() : _list(std::make_shared<ListType>()) {}
 
     void Call(InputsT... args) const {
       auto list = _list.load();
-      for (auto &callback : *list) {
-        callback(args...);
+      auto pool = _pool.load();
+      for (auto &entry : *list) {
+        if (pool == nullptr) {
+          entry->callback(args...);
+        } else {
+          Entry::Post(entry, *pool, args...);
+        }
       }
     }
 
-    /// @todo This function cannot be called concurrently.
-    void RegisterCallback(CallbackType callback) {
+    /// Register @a callback, the returned id can be used to remove it later.
+    CallbackId RegisterCallback(CallbackType callback) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto entry = std::make_shared<Entry>(++_next_id, std::move(callback));
       auto new_list = std::make_shared<ListType>(*_list.load());
-      new_list->emplace_back(std::move(callback));
+      new_list->emplace_back(entry);
       _list = new_list;
+      return entry->id;
+    }
+
+    /// Remove the callback registered with @a id. Returns false if no such
+    /// callback is registered.
+    ///
+    /// Calls already dispatched to the worker threads are discarded, but a
+    /// call that is currently being executed is not interrupted.
+    bool RemoveCallback(CallbackId id) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto new_list = std::make_shared<ListType>(*_list.load());
+      auto it = std::find_if(new_list->begin(), new_list->end(), [id](const auto &entry) {
+        return entry->id == id;
+      });
+      if (it == new_list->end()) {
+        return false;
+      }
+      (*it)->Cancel();
+      new_list->erase(it);
+      _list = new_list;
+      return true;
     }
 
     void Clear() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &entry : *_list.load()) {
+        entry->Cancel();
+      }
       _list = std::make_shared<ListType>();
     }
 
+    /// Set the number of worker threads used to execute the callbacks. If
+    /// zero, callbacks are executed in the thread calling `Call`.
+    ///
+    /// Calls pending in the previous worker threads are dropped. It is safe to
+    /// call it from a callback, even one running in the worker threads being
+    /// replaced.
+    void SetWorkerThreads(size_t count) {
+      std::shared_ptr<WorkerPool> old_pool;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::shared_ptr<WorkerPool> pool;
+        if (count > 0u) {
+          pool = std::shared_ptr<WorkerPool>(new WorkerPool(++_next_generation), WorkerPoolDeleter{});
+          pool->AsyncRun(count);
+        }
+        old_pool = _pool.load();
+        _pool = pool;
+      }
+      // The old pool joins its threads when destroyed, this must not happen
+      // while holding the lock as a callback running in those threads may be
+      // waiting for it.
+    }
+
   private:
 
-    using ListType = std::vector<CallbackType>;
+    struct WorkerPool : public streaming::detail::AsioThreadPool {
+      explicit WorkerPool(size_t generation) : generation(generation) {}
+      const size_t generation;
+    };
+
+    /// Destroys a WorkerPool. If the last reference is dropped by one of the
+    /// pool's own threads, e.g. a callback replacing the worker threads, the
+    /// pool cannot join them here; it is stopped and destroyed by a separate
+    /// thread instead.
+    struct WorkerPoolDeleter {
+      void operator()(WorkerPool *pool) const {
+        if (pool->service().get_executor().running_in_this_thread()) {
+          pool->service().stop();
+          std::thread([pool]() { delete pool; }).detach();
+        } else {
+          delete pool;
+        }
+      }
+    };
+
+    /// A registered callback together with the queue of calls dispatched to
+    /// the worker threads. At most one task per entry is scheduled at any
+    /// time, this guarantees the order of the calls.
+    struct Entry : private NonCopyable {
+
+      Entry(CallbackId id, CallbackType callback)
+        : id(id),
+          callback(std::move(callback)) {}
+
+      static void Post(
+          const std::shared_ptr<Entry> &self,
+          WorkerPool &pool,
+          const InputsT &... args) {
+        {
+          std::lock_guard<std::mutex> lock(self->mutex);
+          if (self->cancelled) {
+            return;
+          }
+          if (self->generation != pool.generation) {
+            // The pool changed, the calls queued in the old one are lost.
+            self->pending.clear();
+            self->scheduled = false;
+            self->generation = pool.generation;
+          }
+          self->pending.emplace_back(args...);
+          if (self->scheduled) {
+            return;
+          }
+          self->scheduled = true;
+        }
+        const auto generation = pool.generation;
+        pool.service().post([self, generation]() {
+          self->Run(generation);
+        });
+      }
+
+      void Run(size_t task_generation) {
+        for (;;) {
+          std::tuple<InputsT...> next;
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            if ((generation != task_generation) || cancelled) {
+              return;
+            }
+            if (pending.empty()) {
+              scheduled = false;
+              return;
+            }
+            next = std::move(pending.front());
+            pending.pop_front();
+          }
+          try {
+            Apply(next, std::index_sequence_for<InputsT...>());
+          } catch (const std::exception &e) {
+            log_error("exception in callback:", e.what());
+          }
+        }
+      }
+
+      template <size_t... Is>
+      void Apply(std::tuple<InputsT...> &args, std::index_sequence<Is...>) {
+        callback(std::get<Is>(args)...);
+      }
+
+      void Cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        pending.clear();
+      }
+
+      const CallbackId id;
+
+      const CallbackType callback;
+
+      std::mutex mutex;
+
+      std::deque<std::tuple<InputsT...>> pending;
+
+      size_t generation = 0u;
+
+      bool scheduled = false;
+
+      bool cancelled = false;
+    };
+
+    using ListType = std::vector<std::shared_ptr<Entry>>;
+
+    std::mutex _mutex;
+
+    CallbackId _next_id = 0u;
+
+    size_t _next_generation = 0u;
 
     AtomicSharedPtr<const ListType> _list;
+
+    AtomicSharedPtr<WorkerPool> _pool;
   };
 
 } // namespace detail
@@ -324,6 +324,10 @@ namespace detail {
     _pimpl->AsyncCall("tick_cue");
   }
 
+  uint64_t Client::SendTickCueAndGetFrame() {
+    return _pimpl->CallAndWait<uint64_t>("tick_cue");
+  }
+
 } // namespace detail
 } // namespace client
 } // namespace carla
@@ -202,6 +202,10 @@ namespace detail {
 
     void SendTickCue();
 
+    /// Send a tick cue and wait for the simulator to acknowledge it. Returns
+    /// the id of the frame that the simulator will produce for this cue.
+    uint64_t SendTickCueAndGetFrame();
+
   private:
 
     class Pimpl;
@@ -67,6 +67,7 @@ namespace detail {
         }
 
         // Notify waiting threads and do the callbacks.
+        self->_frame.SetFrame(next->GetFrameCount());
         self->_timestamp.SetValue(next->GetTimestamp());
         self->_on_tick_callbacks.Call(next->GetTimestamp());
       }
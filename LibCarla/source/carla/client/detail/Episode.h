@@ -13,6 +13,7 @@
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/client/detail/FrameWaiter.h"
 #include "carla/rpc/EpisodeInfo.h"
 
 #include <vector>
@@ -59,8 +60,24 @@ namespace detail {
       return _timestamp.WaitFor(timeout);
     }
 
-    void RegisterOnTickEvent(std::function<void(Timestamp)> callback) {
-      _on_tick_callbacks.RegisterCallback(std::move(callback));
+    /// Wait until the state of @a frame (or a later one) is received, spinning
+    /// up to @a spin_time before blocking.
+    ///
+    /// @return false if the timeout is met.
+    bool WaitForFrame(uint64_t frame, time_duration timeout, time_duration spin_time) {
+      return _frame.WaitFor(frame, timeout, spin_time);
+    }
+
+    size_t RegisterOnTickEvent(std::function<void(Timestamp)> callback) {
+      return _on_tick_callbacks.RegisterCallback(std::move(callback));
+    }
+
+    bool RemoveOnTickEvent(size_t id) {
+      return _on_tick_callbacks.RemoveCallback(id);
+    }
+
+    void SetOnTickWorkerThreads(size_t count) {
+      _on_tick_callbacks.SetWorkerThreads(count);
     }
 
   private:
@@ -79,6 +96,8 @@ namespace detail {
 
     RecurrentSharedFuture<Timestamp> _timestamp;
 
+    FrameWaiter _frame;
+
     const streaming::Token _token;
   };
 
@@ -0,0 +1,92 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/StopWatch.h"
+#include "carla/Time.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Keeps track of the latest frame received and lets threads wait for a
+  /// specific frame.
+  ///
+  /// Setting a new frame is lock-free unless some thread is blocked waiting.
+  /// Waiting threads may spin for a while before blocking, this trades CPU
+  /// time for latency when the frame is expected to arrive soon.
+  class FrameWaiter : private NonCopyable {
+  public:
+
+    uint64_t GetFrame() const {
+      return _frame.load();
+    }
+
+    /// Set the latest frame received and wake up any thread waiting for it.
+    void SetFrame(uint64_t frame) {
+      _frame.store(frame);
+      if (_waiters.load() > 0u) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cv.notify_all();
+      }
+    }
+
+    /// Wait until a frame equal or greater than @a frame is received. Spin for
+    /// up to @a spin_time before blocking the thread.
+    ///
+    /// @return false if the timeout is met.
+    bool WaitFor(uint64_t frame, time_duration timeout, time_duration spin_time = {}) {
+      if (IsReady(frame)) {
+        return true;
+      }
+      const auto max_time = timeout.to_chrono();
+      const auto max_spin_time = std::min(spin_time.to_chrono(), max_time);
+      StopWatch timer;
+      while (timer.GetDuration() < max_spin_time) {
+        if (IsReady(frame)) {
+          return true;
+        }
+        std::this_thread::yield();
+      }
+      std::unique_lock<std::mutex> lock(_mutex);
+      ++_waiters;
+      const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(timer.GetDuration());
+      const bool result = _cv.wait_for(
+          lock,
+          max_time - std::min(max_time, elapsed),
+          [&]() { return IsReady(frame); });
+      --_waiters;
+      return result;
+    }
+
+  private:
+
+    bool IsReady(uint64_t frame) const {
+      return _frame.load() >= frame;
+    }
+
+    std::atomic<uint64_t> _frame{0u};
+
+    std::atomic_size_t _waiters{0u};
+
+    std::mutex _mutex;
+
+    std::condition_variable _cv;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
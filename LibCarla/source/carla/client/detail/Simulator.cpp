@@ -51,6 +51,7 @@ namespace detail {
       const bool enable_garbage_collection)
     : LIBCARLA_INITIALIZE_LIFETIME_PROFILER("SimulatorClient("s + host + ":" + std::to_string(port) + ")"),
       _client(host, port, worker_threads),
+      _stream_capture(std::make_shared<AtomicSharedPtr<sensor::StreamLogWriter>>()),
       _gc_policy(enable_garbage_collection ?
         GarbageCollectionPolicy::Enabled : GarbageCollectionPolicy::Disabled) {}
 
@@ -105,6 +106,31 @@ namespace detail {
     return *result;
   }
 
+  uint64_t Simulator::TickAndWait(time_duration timeout, time_duration spin_time) {
+    auto frame = TickPipelined(0u, timeout, spin_time);
+    DEBUG_ASSERT(frame.has_value());
+    return *frame;
+  }
+
+  boost::optional<uint64_t> Simulator::TickPipelined(
+      const size_t max_outstanding_ticks,
+      const time_duration timeout,
+      const time_duration spin_time) {
+    DEBUG_ASSERT(_episode != nullptr);
+    std::lock_guard<std::mutex> lock(_tick_mutex);
+    _outstanding_ticks.emplace_back(_client.SendTickCueAndGetFrame());
+    boost::optional<uint64_t> result;
+    while (_outstanding_ticks.size() > max_outstanding_ticks) {
+      const auto frame = _outstanding_ticks.front();
+      if (!_episode->WaitForFrame(frame, timeout, spin_time)) {
+        throw_exception(TimeoutException(_client.GetEndpoint(), timeout));
+      }
+      _outstanding_ticks.pop_front();
+      result = frame;
+    }
+    return result;
+  }
+
   // ===========================================================================
   // -- Access to global objects in the episode --------------------------------
   // ===========================================================================
@@ -178,7 +204,18 @@ namespace detail {
     DEBUG_ASSERT(_episode != nullptr);
     _client.SubscribeToStream(
         sensor.GetActorDescription().GetStreamToken(),
-        [cb=std::move(callback), ep=WeakEpisodeProxy{shared_from_this()}](auto buffer) {
+        [cb=std::move(callback),
+         ep=WeakEpisodeProxy{shared_from_this()},
+         capture=_stream_capture,
+         id=sensor.GetId()](auto buffer) {
+          auto log = capture->load();
+          if (log != nullptr) {
+            try {
+              log->Write(id, buffer);
+            } catch (const std::exception &e) {
+              log_error("failed to write stream log", log->GetPath(), ':', e.what());
+            }
+          }
           auto data = sensor::Deserializer::Deserialize(std::move(buffer));
           data->_episode = ep.TryLock();
           cb(std::move(data));
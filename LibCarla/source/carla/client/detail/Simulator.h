@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/AtomicSharedPtr.h"
 #include "carla/Debug.h"
 #include "carla/Memory.h"
 #include "carla/NonCopyable.h"
@@ -19,8 +20,13 @@
 #include "carla/client/detail/EpisodeProxy.h"
 #include "carla/profiler/LifetimeProfiled.h"
 #include "carla/rpc/TrafficLightState.h"
+#include "carla/sensor/StreamLog.h"
 
+#include <boost/optional.hpp>
+
+#include <deque>
 #include <memory>
+#include <mutex>
 
 namespace carla {
 namespace client {
@@ -126,15 +132,40 @@ namespace detail {
 
     Timestamp WaitForTick(time_duration timeout);
 
-    void RegisterOnTickEvent(std::function<void(Timestamp)> callback) {
+    size_t RegisterOnTickEvent(std::function<void(Timestamp)> callback) {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->RegisterOnTickEvent(std::move(callback));
+    }
+
+    void RemoveOnTickEvent(size_t id) {
       DEBUG_ASSERT(_episode != nullptr);
-      _episode->RegisterOnTickEvent(std::move(callback));
+      _episode->RemoveOnTickEvent(id);
+    }
+
+    void SetOnTickWorkerThreads(size_t count) {
+      DEBUG_ASSERT(_episode != nullptr);
+      _episode->SetOnTickWorkerThreads(count);
     }
 
     void Tick() {
       _client.SendTickCue();
     }
 
+    /// Send a tick cue and wait until the frame it produces is received.
+    /// Returns the id of that frame.
+    uint64_t TickAndWait(time_duration timeout, time_duration spin_time);
+
+    /// Send a tick cue allowing up to @a max_outstanding_ticks cues to be in
+    /// flight, i.e. waits only for the oldest ticks in excess. Returns the id
+    /// of the latest frame completed within this call, if any.
+    ///
+    /// Sending a cue blocks until the simulator acknowledges it at the end of
+    /// the current frame, so at most one frame overlaps with the caller.
+    boost::optional<uint64_t> TickPipelined(
+        size_t max_outstanding_ticks,
+        time_duration timeout,
+        time_duration spin_time);
+
     /// @}
     // =========================================================================
     /// @name Access to global objects in the episode
@@ -309,6 +340,17 @@ namespace detail {
 
     void UnSubscribeFromSensor(const Sensor &sensor);
 
+    /// Write the raw buffers received from every sensor subscribed through
+    /// this client to a stream log at @a path, replacing the current capture
+    /// if any.
+    void StartStreamCapture(std::string path, uint64_t max_segment_size) {
+      _stream_capture->store(std::make_shared<sensor::StreamLogWriter>(std::move(path), max_segment_size));
+    }
+
+    void StopStreamCapture() {
+      _stream_capture->reset();
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations with traffic lights
@@ -371,7 +413,15 @@ namespace detail {
 
     std::shared_ptr<Episode> _episode;
 
+    /// Shared with the sensor callbacks, which may outlive this simulator.
+    std::shared_ptr<AtomicSharedPtr<sensor::StreamLogWriter>> _stream_capture;
+
     GarbageCollectionPolicy _gc_policy;
+
+    std::mutex _tick_mutex;
+
+    /// Frames of the tick cues sent with TickPipelined not yet received.
+    std::deque<uint64_t> _outstanding_ticks;
   };
 
 } // namespace detail
@@ -0,0 +1,478 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ColorConverterKernels.h"
+
+#include "carla/image/CityScapesPalette.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define LIBCARLA_IMAGE_KERNELS_X86
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#    define LIBCARLA_TARGET(isa)
+#  else
+#    define LIBCARLA_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#endif
+
+namespace carla {
+namespace image {
+
+  using Pixel = ColorConverterKernels::Pixel;
+  using InstructionSet = ColorConverterKernels::InstructionSet;
+
+  static_assert(sizeof(Pixel) == sizeof(uint32_t), "Invalid pixel size.");
+
+  // ===========================================================================
+  // -- Scalar kernels ---------------------------------------------------------
+  // ===========================================================================
+
+  // These replicate exactly the operations done by the ColorConverter functors
+  // and boost::gil channel conversions.
+
+  static constexpr float MaxDepth = static_cast<float>(256 * 256 * 256 - 1);
+
+  static inline float ToDepth(const Pixel &pixel) {
+    const float depth = pixel.r + (pixel.g * 256) + (pixel.b * 256 * 256);
+    return depth / MaxDepth;
+  }
+
+  static inline float ToLogarithmicDepth(float depth) {
+    const float value = 1.0f + std::log(depth) / 5.70378f;
+    return std::max(std::min(value, 1.0f), 0.005f);
+  }
+
+  static inline uint8_t ToGray8(float value) {
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+  }
+
+  static inline void Store(Pixel *dst, uint8_t value) {
+    *dst = Pixel{value, value, value, 255u};
+  }
+
+  static inline void Store(uint8_t *dst, uint8_t value) {
+    *dst = value;
+  }
+
+  template <bool Logarithmic, typename DstT>
+  static void DepthScalar(const Pixel *src, DstT *dst, size_t count) {
+    for (size_t i = 0u; i < count; ++i) {
+      const float depth = ToDepth(src[i]);
+      Store(dst + i, ToGray8(Logarithmic ? ToLogarithmicDepth(depth) : depth));
+    }
+  }
+
+  static void DepthScalar(const Pixel *src, float *dst, size_t count) {
+    for (size_t i = 0u; i < count; ++i) {
+      dst[i] = ToDepth(src[i]);
+    }
+  }
+
+  /// Map each possible tag to its color already packed as a BGRA pixel.
+  static const std::array<Pixel, 256u> &GetCityScapesLookUpTable() {
+    static const auto table = []() {
+      std::array<Pixel, 256u> result;
+      for (auto i = 0u; i < result.size(); ++i) {
+        const auto color = CityScapesPalette::GetColor(static_cast<uint8_t>(i));
+        result[i] = Pixel{color[0u], color[1u], color[2u], 255u};
+      }
+      return result;
+    }();
+    return table;
+  }
+
+  static void CityScapesPaletteScalar(const Pixel *src, Pixel *dst, size_t count) {
+    const auto &table = GetCityScapesLookUpTable();
+    for (size_t i = 0u; i < count; ++i) {
+      dst[i] = table[src[i].r];
+    }
+  }
+
+#ifdef LIBCARLA_IMAGE_KERNELS_X86
+
+  // ===========================================================================
+  // -- SSE4.1 kernels ---------------------------------------------------------
+  // ===========================================================================
+
+  // Natural logarithm of positive values, adapted from the Cephes library.
+  // Accurate to a couple of ulps.
+  LIBCARLA_TARGET("sse4.1")
+  static inline __m128 Log_SSE41(__m128 x) {
+    x = _mm_max_ps(x, _mm_set1_ps(1.17549435e-38f)); // Avoid zero.
+    __m128i exponent = _mm_srli_epi32(_mm_castps_si128(x), 23);
+    exponent = _mm_sub_epi32(exponent, _mm_set1_epi32(126));
+    __m128 e = _mm_cvtepi32_ps(exponent);
+    // Keep the mantissa in [0.5, 1).
+    x = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000)));
+    x = _mm_or_ps(x, _mm_set1_ps(0.5f));
+    const __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+    e = _mm_sub_ps(e, _mm_and_ps(_mm_set1_ps(1.0f), mask));
+    x = _mm_add_ps(_mm_sub_ps(x, _mm_set1_ps(1.0f)), _mm_and_ps(x, mask));
+    const __m128 z = _mm_mul_ps(x, x);
+    __m128 y = _mm_set1_ps(7.0376836292e-2f);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+    y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    x = _mm_add_ps(x, y);
+    return _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+  }
+
+  /// Convert 4 BGRA pixels into 4 normalized depths.
+  LIBCARLA_TARGET("sse4.1")
+  static inline __m128 ToDepth_SSE41(__m128i pixels) {
+    // Reorder the bytes of each pixel as (R, G, B, 0), which is the 24-bit
+    // integer R + G * 256 + B * 256 * 256.
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+    const __m128i depth = _mm_shuffle_epi8(pixels, shuffle);
+    return _mm_div_ps(_mm_cvtepi32_ps(depth), _mm_set1_ps(MaxDepth));
+  }
+
+  /// Convert 4 BGRA pixels into 4 gray levels, one per 32-bit lane.
+  template <bool Logarithmic>
+  LIBCARLA_TARGET("sse4.1")
+  static inline __m128i DepthToGray8_SSE41(__m128i pixels) {
+    __m128 value = ToDepth_SSE41(pixels);
+    if (Logarithmic) {
+      value = _mm_div_ps(Log_SSE41(value), _mm_set1_ps(5.70378f));
+      value = _mm_add_ps(_mm_set1_ps(1.0f), value);
+      value = _mm_max_ps(_mm_min_ps(value, _mm_set1_ps(1.0f)), _mm_set1_ps(0.005f));
+    }
+    value = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+    return _mm_cvttps_epi32(value);
+  }
+
+  LIBCARLA_TARGET("sse4.1")
+  static inline void Store_SSE41(uint8_t *dst, __m128i gray) {
+    const __m128i shuffle = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const int32_t packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(gray, shuffle));
+    std::memcpy(dst, &packed, sizeof(packed));
+  }
+
+  LIBCARLA_TARGET("sse4.1")
+  static inline void Store_SSE41(Pixel *dst, __m128i gray) {
+    const __m128i bgra = _mm_or_si128(
+        _mm_mullo_epi32(gray, _mm_set1_epi32(0x00010101)),
+        _mm_set1_epi32(static_cast<int32_t>(0xff000000)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), bgra);
+  }
+
+  template <bool Logarithmic, typename DstT>
+  LIBCARLA_TARGET("sse4.1")
+  static size_t Depth_SSE41(const Pixel *src, DstT *dst, size_t count) {
+    constexpr size_t N = 4u;
+    size_t i = 0u;
+    for (; i + N <= count; i += N) {
+      const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      Store_SSE41(dst + i, DepthToGray8_SSE41<Logarithmic>(pixels));
+    }
+    return i;
+  }
+
+  LIBCARLA_TARGET("sse4.1")
+  static size_t Depth_SSE41(const Pixel *src, float *dst, size_t count) {
+    constexpr size_t N = 4u;
+    size_t i = 0u;
+    for (; i + N <= count; i += N) {
+      const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      _mm_storeu_ps(dst + i, ToDepth_SSE41(pixels));
+    }
+    return i;
+  }
+
+  // ===========================================================================
+  // -- AVX2 kernels -----------------------------------------------------------
+  // ===========================================================================
+
+  // Same as Log_SSE41 with 8 lanes.
+  LIBCARLA_TARGET("avx2")
+  static inline __m256 Log_AVX2(__m256 x) {
+    x = _mm256_max_ps(x, _mm256_set1_ps(1.17549435e-38f));
+    __m256i exponent = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+    exponent = _mm256_sub_epi32(exponent, _mm256_set1_epi32(126));
+    __m256 e = _mm256_cvtepi32_ps(exponent);
+    x = _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000)));
+    x = _mm256_or_ps(x, _mm256_set1_ps(0.5f));
+    const __m256 mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(_mm256_set1_ps(1.0f), mask));
+    x = _mm256_add_ps(_mm256_sub_ps(x, _mm256_set1_ps(1.0f)), _mm256_and_ps(x, mask));
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993e-1f));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174e-1f));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+    y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+    x = _mm256_add_ps(x, y);
+    return _mm256_add_ps(x, _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+  }
+
+  /// Convert 8 BGRA pixels into 8 normalized depths.
+  LIBCARLA_TARGET("avx2")
+  static inline __m256 ToDepth_AVX2(__m256i pixels) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1,
+        2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1);
+    const __m256i depth = _mm256_shuffle_epi8(pixels, shuffle);
+    return _mm256_div_ps(_mm256_cvtepi32_ps(depth), _mm256_set1_ps(MaxDepth));
+  }
+
+  /// Convert 8 BGRA pixels into 8 gray levels, one per 32-bit lane.
+  template <bool Logarithmic>
+  LIBCARLA_TARGET("avx2")
+  static inline __m256i DepthToGray8_AVX2(__m256i pixels) {
+    __m256 value = ToDepth_AVX2(pixels);
+    if (Logarithmic) {
+      value = _mm256_div_ps(Log_AVX2(value), _mm256_set1_ps(5.70378f));
+      value = _mm256_add_ps(_mm256_set1_ps(1.0f), value);
+      value = _mm256_max_ps(_mm256_min_ps(value, _mm256_set1_ps(1.0f)), _mm256_set1_ps(0.005f));
+    }
+    value = _mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f));
+    return _mm256_cvttps_epi32(value);
+  }
+
+  LIBCARLA_TARGET("avx2")
+  static inline void Store_AVX2(uint8_t *dst, __m256i gray) {
+    // Pack the low byte of each lane in the first 4 bytes of each 128-bit
+    // half, then move both halves together.
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i packed = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(gray, shuffle),
+        _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+  }
+
+  LIBCARLA_TARGET("avx2")
+  static inline void Store_AVX2(Pixel *dst, __m256i gray) {
+    const __m256i bgra = _mm256_or_si256(
+        _mm256_mullo_epi32(gray, _mm256_set1_epi32(0x00010101)),
+        _mm256_set1_epi32(static_cast<int32_t>(0xff000000)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), bgra);
+  }
+
+  template <bool Logarithmic, typename DstT>
+  LIBCARLA_TARGET("avx2")
+  static size_t Depth_AVX2(const Pixel *src, DstT *dst, size_t count) {
+    constexpr size_t N = 8u;
+    size_t i = 0u;
+    for (; i + N <= count; i += N) {
+      const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      Store_AVX2(dst + i, DepthToGray8_AVX2<Logarithmic>(pixels));
+    }
+    return i;
+  }
+
+  LIBCARLA_TARGET("avx2")
+  static size_t Depth_AVX2(const Pixel *src, float *dst, size_t count) {
+    constexpr size_t N = 8u;
+    size_t i = 0u;
+    for (; i + N <= count; i += N) {
+      const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      _mm256_storeu_ps(dst + i, ToDepth_AVX2(pixels));
+    }
+    return i;
+  }
+
+  LIBCARLA_TARGET("avx2")
+  static size_t CityScapesPalette_AVX2(const Pixel *src, Pixel *dst, size_t count) {
+    constexpr size_t N = 8u;
+    const auto *table = reinterpret_cast<const int *>(GetCityScapesLookUpTable().data());
+    const __m256i tag_mask = _mm256_set1_epi32(0xff);
+    size_t i = 0u;
+    for (; i + N <= count; i += N) {
+      const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      // The tag is stored in the red channel, the third byte of each pixel.
+      const __m256i tags = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), tag_mask);
+      const __m256i colors = _mm256_i32gather_epi32(table, tags, sizeof(uint32_t));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), colors);
+    }
+    return i;
+  }
+
+#endif // LIBCARLA_IMAGE_KERNELS_X86
+
+  // ===========================================================================
+  // -- Dispatch ---------------------------------------------------------------
+  // ===========================================================================
+
+  static InstructionSet DetectInstructionSet() {
+#ifdef LIBCARLA_IMAGE_KERNELS_X86
+#  ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    bool sse41 = false;
+    bool avx2 = false;
+    if (max_leaf >= 1) {
+      __cpuid(info, 1);
+      sse41 = (info[2] & (1 << 19)) != 0;
+      const bool os_saves_avx =
+          ((info[2] & (1 << 27)) != 0) && // OSXSAVE
+          ((info[2] & (1 << 28)) != 0) && // AVX
+          ((_xgetbv(0) & 0x6) == 0x6);
+      if (os_saves_avx && (max_leaf >= 7)) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+      }
+    }
+#  else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#  endif
+    if (avx2) {
+      return InstructionSet::AVX2;
+    }
+    if (sse41) {
+      return InstructionSet::SSE41;
+    }
+#endif // LIBCARLA_IMAGE_KERNELS_X86
+    return InstructionSet::Scalar;
+  }
+
+  static InstructionSet Resolve(InstructionSet requested) {
+    const auto supported = ColorConverterKernels::GetSupportedInstructionSet();
+    return static_cast<int>(requested) < static_cast<int>(supported) ? requested : supported;
+  }
+
+  template <bool Logarithmic, typename DstT>
+  static void ConvertDepth(InstructionSet instruction_set, const Pixel *src, DstT *dst, size_t count) {
+    size_t done = 0u;
+    switch (Resolve(instruction_set)) {
+#ifdef LIBCARLA_IMAGE_KERNELS_X86
+      case InstructionSet::AVX2:
+        done = Depth_AVX2<Logarithmic>(src, dst, count);
+        break;
+      case InstructionSet::SSE41:
+        done = Depth_SSE41<Logarithmic>(src, dst, count);
+        break;
+#endif // LIBCARLA_IMAGE_KERNELS_X86
+      default:
+        break;
+    }
+    DepthScalar<Logarithmic>(src + done, dst + done, count - done);
+  }
+
+  static void ConvertDepth(InstructionSet instruction_set, const Pixel *src, float *dst, size_t count) {
+    size_t done = 0u;
+    switch (Resolve(instruction_set)) {
+#ifdef LIBCARLA_IMAGE_KERNELS_X86
+      case InstructionSet::AVX2:
+        done = Depth_AVX2(src, dst, count);
+        break;
+      case InstructionSet::SSE41:
+        done = Depth_SSE41(src, dst, count);
+        break;
+#endif // LIBCARLA_IMAGE_KERNELS_X86
+      default:
+        break;
+    }
+    DepthScalar(src + done, dst + done, count - done);
+  }
+
+  // ===========================================================================
+  // -- ColorConverterKernels --------------------------------------------------
+  // ===========================================================================
+
+  InstructionSet ColorConverterKernels::GetSupportedInstructionSet() {
+    static const auto result = DetectInstructionSet();
+    return result;
+  }
+
+  const char *ColorConverterKernels::GetName(InstructionSet instruction_set) {
+    switch (instruction_set) {
+      case InstructionSet::AVX2:  return "AVX2";
+      case InstructionSet::SSE41: return "SSE4.1";
+      default:                    return "Scalar";
+    }
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::Depth,
+      const Pixel *src,
+      Pixel *dst,
+      size_t count) {
+    ConvertDepth<false>(instruction_set, src, dst, count);
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::Depth,
+      const Pixel *src,
+      uint8_t *dst,
+      size_t count) {
+    ConvertDepth<false>(instruction_set, src, dst, count);
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::Depth,
+      const Pixel *src,
+      float *dst,
+      size_t count) {
+    ConvertDepth(instruction_set, src, dst, count);
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::LogarithmicDepth,
+      const Pixel *src,
+      Pixel *dst,
+      size_t count) {
+    ConvertDepth<true>(instruction_set, src, dst, count);
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::LogarithmicDepth,
+      const Pixel *src,
+      uint8_t *dst,
+      size_t count) {
+    ConvertDepth<true>(instruction_set, src, dst, count);
+  }
+
+  void ColorConverterKernels::Convert(
+      InstructionSet instruction_set,
+      ColorConverter::CityScapesPalette,
+      const Pixel *src,
+      Pixel *dst,
+      size_t count) {
+    size_t done = 0u;
+#ifdef LIBCARLA_IMAGE_KERNELS_X86
+    // Without gather instructions SSE4.1 does not improve the look-up table.
+    if (Resolve(instruction_set) == InstructionSet::AVX2) {
+      done = CityScapesPalette_AVX2(src, dst, count);
+    }
+#else
+    (void)instruction_set;
+#endif // LIBCARLA_IMAGE_KERNELS_X86
+    CityScapesPaletteScalar(src + done, dst + done, count - done);
+  }
+
+} // namespace image
+} // namespace carla
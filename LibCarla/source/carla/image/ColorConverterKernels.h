@@ -0,0 +1,75 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/image/ColorConverter.h"
+#include "carla/sensor/data/Color.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace image {
+
+  /// Whole-buffer versions of the ColorConverter functors. The source is a
+  /// tightly packed buffer of BGRA8 pixels (the memory layout of
+  /// sensor::data::Color), the destination is either another BGRA8 buffer or
+  /// a buffer of 8-bit gray pixels. Depth can also be written as float, the
+  /// normalized depth in [0, 1] before quantizing it to a gray level.
+  ///
+  /// The kernels are vectorized with SSE4.1 or AVX2, the best instruction set
+  /// supported by the CPU is selected at runtime. Depth and CityScapesPalette
+  /// produce exactly the same output as the ColorConverter functors,
+  /// LogarithmicDepth approximates the logarithm and may differ by one gray
+  /// level.
+  ///
+  /// Source and destination may point to the same buffer.
+  class ColorConverterKernels {
+  public:
+
+    using Pixel = sensor::data::Color;
+
+    enum class InstructionSet {
+      Scalar,
+      SSE41,
+      AVX2
+    };
+
+    /// Best instruction set supported by this CPU and build.
+    static InstructionSet GetSupportedInstructionSet();
+
+    static const char *GetName(InstructionSet instruction_set);
+
+    /// Convert @a count pixels from @a src into @a dst.
+    template <typename ColorConverterT, typename DstT>
+    static void Convert(ColorConverterT cc, const Pixel *src, DstT *dst, size_t count) {
+      Convert(GetSupportedInstructionSet(), cc, src, dst, count);
+    }
+
+    /// @name Convert using a given instruction set
+    ///
+    /// If @a instruction_set is not supported the next best one is used
+    /// instead.
+    /// @{
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::Depth, const Pixel *src, Pixel *dst, size_t count);
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::Depth, const Pixel *src, uint8_t *dst, size_t count);
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::Depth, const Pixel *src, float *dst, size_t count);
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::LogarithmicDepth, const Pixel *src, Pixel *dst, size_t count);
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::LogarithmicDepth, const Pixel *src, uint8_t *dst, size_t count);
+
+    static void Convert(InstructionSet instruction_set, ColorConverter::CityScapesPalette, const Pixel *src, Pixel *dst, size_t count);
+
+    /// @}
+  };
+
+} // namespace image
+} // namespace carla
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include "carla/image/ColorConverterKernels.h"
 #include "carla/image/ImageView.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/ImageTmpl.h"
 
 namespace carla {
 namespace image {
@@ -28,6 +31,15 @@ namespace image {
           ImageView::MakeColorConvertedView<MutableImageView, DstPixelT>(image_view, converter),
           image_view);
     }
+
+    /// Convert a sensor image in place. Uses the whole-buffer kernels of
+    /// ColorConverterKernels instead of converting pixel by pixel.
+    template <typename ColorConverter>
+    static void ConvertInPlace(
+        sensor::data::ImageTmpl<sensor::data::Color> &image,
+        ColorConverter converter = ColorConverter()) {
+      ColorConverterKernels::Convert(converter, image.data(), image.data(), image.size());
+    }
   };
 
 } // namespace image
@@ -0,0 +1,144 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ImagePipeline.h"
+
+#include <utility>
+
+namespace carla {
+namespace image {
+
+  using Interpolation = ImagePipeline::Interpolation;
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  template <typename FilterT>
+  static void AddTap(FilterT &filter, size_t index, float weight) {
+    if (weight > 0.0f) {
+      filter.index.emplace_back(static_cast<uint32_t>(index));
+      filter.weight.emplace_back(weight);
+    }
+  }
+
+  /// Weights to resample the @a src_size pixels starting at @a src_offset to
+  /// @a dst_size pixels.
+  template <typename FilterT>
+  static FilterT MakeFilter(
+      const size_t src_offset,
+      const size_t src_size,
+      const size_t dst_size,
+      const Interpolation interpolation) {
+    FilterT filter;
+    filter.begin.reserve(dst_size + 1u);
+    filter.begin.emplace_back(0u);
+    const double scale = static_cast<double>(src_size) / static_cast<double>(dst_size);
+    for (auto i = 0u; i < dst_size; ++i) {
+      if (interpolation == Interpolation::Area) {
+        // Source interval [first, last) covered by output pixel i.
+        const double first = i * scale;
+        const double last = std::min((i + 1u) * scale, static_cast<double>(src_size));
+        for (auto j = static_cast<size_t>(first); static_cast<double>(j) < last; ++j) {
+          const double overlap = std::min(last, j + 1.0) - std::max(first, static_cast<double>(j));
+          AddTap(filter, src_offset + j, static_cast<float>(overlap / scale));
+        }
+      } else {
+        // Align pixel centers, as OpenCV and PIL do.
+        const double center = std::max((i + 0.5) * scale - 0.5, 0.0);
+        const size_t j = std::min(static_cast<size_t>(center), src_size - 1u);
+        const double fraction = std::min(center - static_cast<double>(j), 1.0);
+        AddTap(filter, src_offset + j, static_cast<float>(1.0 - fraction));
+        AddTap(filter, src_offset + std::min(j + 1u, src_size - 1u), static_cast<float>(fraction));
+      }
+      filter.begin.emplace_back(filter.index.size());
+    }
+    return filter;
+  }
+
+  // ===========================================================================
+  // -- ImagePipeline ----------------------------------------------------------
+  // ===========================================================================
+
+  ImagePipeline &ImagePipeline::Crop(size_t x, size_t y, size_t width, size_t height) {
+    if ((width == 0u) || (height == 0u)) {
+      throw_exception(std::invalid_argument("crop region cannot be empty"));
+    }
+    _crop = true;
+    _roi = {{x, y, width, height}};
+    return *this;
+  }
+
+  ImagePipeline &ImagePipeline::Resize(size_t width, size_t height, Interpolation interpolation) {
+    if ((width == 0u) || (height == 0u)) {
+      throw_exception(std::invalid_argument("output size cannot be zero"));
+    }
+    _width = width;
+    _height = height;
+    _interpolation = interpolation;
+    return *this;
+  }
+
+  ImagePipeline &ImagePipeline::Normalize(std::vector<float> mean, std::vector<float> std) {
+    if (mean.empty() || (mean.size() > 4u) || std.empty() || (std.size() > 4u)) {
+      throw_exception(std::invalid_argument("mean and std must have between 1 and 4 values"));
+    }
+    for (auto value : std) {
+      if (value == 0.0f) {
+        throw_exception(std::invalid_argument("std cannot be zero"));
+      }
+    }
+    _mean = std::move(mean);
+    _std = std::move(std);
+    return *this;
+  }
+
+  ImagePipeline::Plan ImagePipeline::MakePlan(const size_t width, const size_t height) const {
+    Plan plan;
+    std::array<size_t, 4u> roi = {{0u, 0u, width, height}};
+    if (_crop) {
+      roi = _roi;
+      if ((roi[0u] + roi[2u] > width) || (roi[1u] + roi[3u] > height)) {
+        throw_exception(std::invalid_argument("crop region outside of the image"));
+      }
+    }
+    if ((roi[2u] == 0u) || (roi[3u] == 0u)) {
+      throw_exception(std::invalid_argument("empty image"));
+    }
+    plan.shape.width = _width > 0u ? _width : roi[2u];
+    plan.shape.height = _height > 0u ? _height : roi[3u];
+    plan.horizontal = MakeFilter<Filter>(roi[0u], roi[2u], plan.shape.width, _interpolation);
+    plan.vertical = MakeFilter<Filter>(roi[1u], roi[3u], plan.shape.height, _interpolation);
+
+    switch (_channel_order) {
+      case ChannelOrder::BGRA: plan.channels = {{2u, 1u, 0u, 3u}}; plan.shape.channels = 4u; break;
+      case ChannelOrder::RGBA: plan.channels = {{0u, 1u, 2u, 3u}}; plan.shape.channels = 4u; break;
+      case ChannelOrder::BGR:  plan.channels = {{2u, 1u, 0u, 3u}}; plan.shape.channels = 3u; break;
+      case ChannelOrder::RGB:  plan.channels = {{0u, 1u, 2u, 3u}}; plan.shape.channels = 3u; break;
+      default:
+        throw_exception(std::invalid_argument("invalid channel order"));
+    }
+
+    auto get = [&](const std::vector<float> &values, size_t channel) {
+      if (values.size() == 1u) {
+        return values[0u];
+      } else if (values.size() == plan.shape.channels) {
+        return values[channel];
+      }
+      throw_exception(std::invalid_argument("mean and std must have one value or one per channel"));
+      return 0.0f;
+    };
+    for (auto c = 0u; c < plan.shape.channels; ++c) {
+      const float mean = get(_mean, c);
+      const float std = get(_std, c);
+      plan.scale[c] = 1.0f / (255.0f * std);
+      plan.bias[c] = -mean / std;
+    }
+    return plan;
+  }
+
+} // namespace image
+} // namespace carla
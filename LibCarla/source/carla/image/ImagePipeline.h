@@ -0,0 +1,279 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+#include "carla/image/BoostGil.h"
+#include "carla/image/ImageView.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/ImageTmpl.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  /// Prepares camera images as input tensors: crops a region of interest,
+  /// resizes it, reorders the channels, and writes it as uint8 or as
+  /// normalized float to a buffer provided by the caller.
+  ///
+  /// The steps are configured by chaining calls, and always applied in this
+  /// order, e.g.
+  ///
+  ///     ImagePipeline pipeline;
+  ///     pipeline.Crop(0u, 200u, 800u, 400u).Resize(84u, 84u).SetChannelOrder(ImagePipeline::ChannelOrder::RGB);
+  ///     pipeline.Run(image, tensor);
+  ///
+  /// Source images are boost::gil views with an RGBA color space, like the
+  /// views of ImageView::MakeView.
+  class ImagePipeline {
+  public:
+
+    using SensorImage = sensor::data::ImageTmpl<sensor::data::Color>;
+
+    enum class Interpolation : uint8_t {
+      /// Average of the source pixels covered by each output pixel, the
+      /// right choice for downscaling.
+      Area,
+      /// Bilinear interpolation of the four closest source pixels, aliases
+      /// when downscaling by more than a factor of two.
+      Bilinear
+    };
+
+    enum class ChannelOrder : uint8_t {
+      BGRA,
+      RGBA,
+      BGR,
+      RGB
+    };
+
+    enum class Layout : uint8_t {
+      /// Height x width x channels.
+      HWC,
+      /// Channels x height x width.
+      CHW
+    };
+
+    struct Shape {
+      size_t height;
+      size_t width;
+      size_t channels;
+
+      size_t size() const {
+        return height * width * channels;
+      }
+
+      bool operator==(const Shape &rhs) const {
+        return (height == rhs.height) && (width == rhs.width) && (channels == rhs.channels);
+      }
+
+      bool operator!=(const Shape &rhs) const {
+        return !(*this == rhs);
+      }
+    };
+
+    // =========================================================================
+    /// @name Configuration
+    // =========================================================================
+    /// @{
+
+    /// Keep only the rectangle of @a width x @a height pixels with top-left
+    /// corner at (@a x, @a y).
+    ImagePipeline &Crop(size_t x, size_t y, size_t width, size_t height);
+
+    ImagePipeline &Resize(size_t width, size_t height, Interpolation interpolation = Interpolation::Area);
+
+    ImagePipeline &SetChannelOrder(ChannelOrder order) {
+      _channel_order = order;
+      return *this;
+    }
+
+    ImagePipeline &SetLayout(Layout layout) {
+      _layout = layout;
+      return *this;
+    }
+
+    Layout GetLayout() const {
+      return _layout;
+    }
+
+    /// Float outputs are written as `(value / 255 - mean) / std`. Each of
+    /// @a mean and @a std has either one value for every channel or one per
+    /// output channel. Without normalization float outputs are in [0, 1].
+    /// Ignored for uint8 outputs.
+    ImagePipeline &Normalize(std::vector<float> mean, std::vector<float> std);
+
+    /// @}
+    // =========================================================================
+    /// @name Processing
+    // =========================================================================
+    /// @{
+
+    /// Shape of the output for an input image of @a width x @a height.
+    Shape GetOutputShape(size_t width, size_t height) const {
+      return MakePlan(width, height).shape;
+    }
+
+    /// Process @a src into @a out, which must have room for
+    /// `GetOutputShape(src.width(), src.height()).size()` elements. The
+    /// output rows are split among @a number_of_threads threads.
+    template <typename SrcViewT, typename T>
+    void Run(const SrcViewT &src, T *out, size_t number_of_threads = 1u) const;
+
+    template <typename T>
+    void Run(const SensorImage &image, T *out, size_t number_of_threads = 1u) const {
+      Run(ImageView::MakeView(image), out, number_of_threads);
+    }
+
+    /// Process @a count images into consecutive tensors of @a out, a batch
+    /// of shape `count x GetOutputShape()`. Every image must produce the same
+    /// output shape. The images are split among @a number_of_threads
+    /// threads.
+    template <typename T>
+    void RunBatch(
+        const SensorImage *const *images,
+        size_t count,
+        T *out,
+        size_t number_of_threads = 0u) const;
+
+    /// @}
+
+  private:
+
+    /// Separable resampling weights, output pixel i is the weighted sum of
+    /// source pixels `index[begin[i]]` to `index[begin[i + 1] - 1]`.
+    struct Filter {
+      std::vector<size_t> begin;
+      std::vector<uint32_t> index;
+      std::vector<float> weight;
+    };
+
+    struct Plan {
+      Shape shape;
+      Filter horizontal;
+      Filter vertical;
+      /// Source channel of each output channel, in RGBA order.
+      std::array<uint8_t, 4u> channels;
+      std::array<float, 4u> scale;
+      std::array<float, 4u> bias;
+
+      size_t GetOffset(size_t y, size_t x, size_t c, Layout layout) const {
+        return layout == Layout::HWC ?
+            (y * shape.width + x) * shape.channels + c :
+            (c * shape.height + y) * shape.width + x;
+      }
+    };
+
+    Plan MakePlan(size_t width, size_t height) const;
+
+    static void Store(float value, float, float, uint8_t &out) {
+      out = static_cast<uint8_t>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+    }
+
+    static void Store(float value, float scale, float bias, float &out) {
+      out = value * scale + bias;
+    }
+
+    bool _crop = false;
+
+    std::array<size_t, 4u> _roi = {{0u, 0u, 0u, 0u}};
+
+    size_t _width = 0u;
+
+    size_t _height = 0u;
+
+    Interpolation _interpolation = Interpolation::Area;
+
+    ChannelOrder _channel_order = ChannelOrder::BGRA;
+
+    Layout _layout = Layout::HWC;
+
+    std::vector<float> _mean = {0.0f};
+
+    std::vector<float> _std = {1.0f};
+  };
+
+  // ===========================================================================
+  // -- ImagePipeline implementation -------------------------------------------
+  // ===========================================================================
+
+  template <typename SrcViewT, typename T>
+  void ImagePipeline::Run(const SrcViewT &src, T *out, size_t number_of_threads) const {
+    using namespace boost::gil;
+    static_assert(
+        std::is_same<T, uint8_t>::value || std::is_same<T, float>::value,
+        "Output must be uint8_t or float");
+    static_assert(
+        std::is_same<typename color_space_type<typename SrcViewT::value_type>::type, rgba_t>::value,
+        "Source view must be RGBA or BGRA");
+    const Plan plan = MakePlan(static_cast<size_t>(src.width()), static_cast<size_t>(src.height()));
+    const auto &h = plan.horizontal;
+    const auto &v = plan.vertical;
+    const Layout layout = _layout;
+    ParallelFor(plan.shape.height, [&](size_t begin, size_t end) {
+      for (auto y = begin; y < end; ++y) {
+        for (auto x = 0u; x < plan.shape.width; ++x) {
+          std::array<float, 4u> rgba = {{0.0f, 0.0f, 0.0f, 0.0f}};
+          for (auto j = v.begin[y]; j < v.begin[y + 1u]; ++j) {
+            const auto row = src.row_begin(static_cast<std::ptrdiff_t>(v.index[j]));
+            const float wy = v.weight[j];
+            for (auto i = h.begin[x]; i < h.begin[x + 1u]; ++i) {
+              const auto &pixel = row[static_cast<std::ptrdiff_t>(h.index[i])];
+              const float w = wy * h.weight[i];
+              rgba[0u] += w * static_cast<float>(get_color(pixel, red_t()));
+              rgba[1u] += w * static_cast<float>(get_color(pixel, green_t()));
+              rgba[2u] += w * static_cast<float>(get_color(pixel, blue_t()));
+              rgba[3u] += w * static_cast<float>(get_color(pixel, alpha_t()));
+            }
+          }
+          for (auto c = 0u; c < plan.shape.channels; ++c) {
+            Store(
+                rgba[plan.channels[c]],
+                plan.scale[c],
+                plan.bias[c],
+                out[plan.GetOffset(y, x, c, layout)]);
+          }
+        }
+      }
+    }, number_of_threads, 1u);
+  }
+
+  template <typename T>
+  void ImagePipeline::RunBatch(
+      const SensorImage *const *images,
+      const size_t count,
+      T *out,
+      const size_t number_of_threads) const {
+    if (count == 0u) {
+      return;
+    }
+    const auto shape = GetOutputShape(images[0u]->GetWidth(), images[0u]->GetHeight());
+    for (auto i = 1u; i < count; ++i) {
+      if (GetOutputShape(images[i]->GetWidth(), images[i]->GetHeight()) != shape) {
+        throw_exception(std::invalid_argument("images of the batch produce different output shapes"));
+      }
+    }
+    if (count == 1u) {
+      Run(*images[0u], out, number_of_threads);
+      return;
+    }
+    ParallelFor(count, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        Run(*images[i], out + i * shape.size(), 1u);
+      }
+    }, number_of_threads, 1u);
+  }
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,79 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/image/ColorConverterKernels.h"
+#include "carla/image/ImageIO.h"
+#include "carla/image/ImageView.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/ImageTmpl.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  /// Writes sensor images to disk applying one of the ColorConverter functors.
+  /// The conversion is done into a temporary buffer, the image itself is
+  /// never modified.
+  class ImageWriter {
+  public:
+
+    using SensorImage = sensor::data::ImageTmpl<sensor::data::Color>;
+
+    enum class ColorConversion {
+      Raw,
+      Depth,
+      LogarithmicDepth,
+      CityScapesPalette
+    };
+
+    /// Write @a image to @a path, the format is deduced from the extension of
+    /// @a path. Returns the path written.
+    static std::string WriteImage(
+        std::string path,
+        const SensorImage &image,
+        ColorConversion color_conversion) {
+      using namespace boost::gil;
+      switch (color_conversion) {
+        case ColorConversion::Raw:
+          return ImageIO::WriteView(std::move(path), ImageView::MakeView(image));
+        case ColorConversion::Depth:
+          return WriteConvertedImage<gray8_pixel_t, uint8_t>(std::move(path), image, ColorConverter::Depth());
+        case ColorConversion::LogarithmicDepth:
+          return WriteConvertedImage<gray8_pixel_t, uint8_t>(std::move(path), image, ColorConverter::LogarithmicDepth());
+        case ColorConversion::CityScapesPalette:
+          return WriteConvertedImage<bgra8_pixel_t, sensor::data::Color>(std::move(path), image, ColorConverter::CityScapesPalette());
+        default:
+          throw_exception(std::invalid_argument("invalid color converter!"));
+      }
+    }
+
+  private:
+
+    /// Convert @a image with the whole-buffer kernels and write it as an image
+    /// of @a PixelT.
+    template <typename PixelT, typename DstT, typename CC>
+    static std::string WriteConvertedImage(std::string path, const SensorImage &image, CC cc) {
+      static_assert(sizeof(PixelT) == sizeof(DstT), "Invalid pixel size");
+      std::vector<DstT> buffer(image.size());
+      ColorConverterKernels::Convert(cc, image.data(), buffer.data(), buffer.size());
+      return ImageIO::WriteView(
+          std::move(path),
+          boost::gil::interleaved_view(
+              image.GetWidth(),
+              image.GetHeight(),
+              reinterpret_cast<PixelT *>(buffer.data()),
+              sizeof(PixelT) * image.GetWidth()));
+    }
+  };
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,343 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/SegmentationAnalysis.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace carla {
+namespace image {
+
+  using Pixel = SegmentationAnalysis::Pixel;
+  using Box = SegmentationAnalysis::Box;
+  using Component = SegmentationAnalysis::Component;
+
+  constexpr size_t SegmentationAnalysis::NumberOfTags;
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  /// Number of blocks of rows to split an image of @a height rows.
+  static size_t GetNumberOfBlocks(size_t height) {
+    constexpr size_t rows_per_block = 32u;
+    return std::max<size_t>(1u, std::min<size_t>(256u, height / rows_per_block));
+  }
+
+  static size_t GetFirstRow(size_t block, size_t blocks, size_t height) {
+    return (block * height) / blocks;
+  }
+
+  static void Extend(Box &box, uint32_t x_min, uint32_t x_max, uint32_t y) {
+    box.x_min = std::min(box.x_min, x_min);
+    box.x_max = std::max(box.x_max, x_max);
+    box.y_min = std::min(box.y_min, y);
+    box.y_max = std::max(box.y_max, y);
+  }
+
+  static constexpr Box EmptyBox() {
+    return {
+      std::numeric_limits<uint32_t>::max(),
+      std::numeric_limits<uint32_t>::max(),
+      0u,
+      0u};
+  }
+
+  /// Union-find over run indices. A root is always the smallest index of its
+  /// set, so every run points to an index lower or equal than its own.
+  class DisjointSets {
+  public:
+
+    explicit DisjointSets(size_t size) : _parent(size) {
+      for (auto i = 0u; i < size; ++i) {
+        _parent[i] = static_cast<uint32_t>(i);
+      }
+    }
+
+    uint32_t Find(uint32_t i) {
+      while (_parent[i] != i) {
+        _parent[i] = _parent[_parent[i]];
+        i = _parent[i];
+      }
+      return i;
+    }
+
+    void Union(uint32_t a, uint32_t b) {
+      a = Find(a);
+      b = Find(b);
+      if (a < b) {
+        _parent[b] = a;
+      } else if (b < a) {
+        _parent[a] = b;
+      }
+    }
+
+    /// Point @a i directly to its root and return it. Requires every lower
+    /// index to be flattened already.
+    uint32_t Flatten(uint32_t i) {
+      return _parent[i] = _parent[_parent[i]];
+    }
+
+  private:
+
+    std::vector<uint32_t> _parent;
+  };
+
+  /// Horizontal run of pixels with the same tag, [x_begin, x_end).
+  struct Run {
+    uint32_t x_begin;
+    uint32_t x_end;
+    uint32_t y;
+    uint32_t tag;
+  };
+
+  /// Runs of a block of rows. Runs of row y are `runs[row_begin[y - first_row]]`
+  /// to `runs[row_begin[y - first_row + 1] - 1]`, their global index is
+  /// @a offset plus their index in @a runs.
+  struct RunBlock {
+    size_t first_row;
+    size_t last_row;
+    std::vector<Run> runs;
+    std::vector<size_t> row_begin;
+    size_t offset;
+  };
+
+  /// Join the runs of two consecutive rows that touch and have the same tag.
+  static void JoinRows(
+      const Run *upper, size_t upper_count, size_t upper_offset,
+      const Run *lower, size_t lower_count, size_t lower_offset,
+      DisjointSets &sets) {
+    size_t i = 0u;
+    size_t j = 0u;
+    while ((i < upper_count) && (j < lower_count)) {
+      const auto &a = upper[i];
+      const auto &b = lower[j];
+      if ((a.x_begin < b.x_end) && (b.x_begin < a.x_end) && (a.tag == b.tag)) {
+        sets.Union(static_cast<uint32_t>(upper_offset + i), static_cast<uint32_t>(lower_offset + j));
+      }
+      if (a.x_end < b.x_end) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+  }
+
+  // ===========================================================================
+  // -- SegmentationAnalysis ---------------------------------------------------
+  // ===========================================================================
+
+  void SegmentationAnalysis::ComputeTagStatistics(
+      const Pixel *pixels,
+      const size_t width,
+      const size_t height,
+      uint32_t *histogram,
+      Box *boxes,
+      const size_t number_of_threads) {
+    DEBUG_ASSERT((pixels != nullptr) || (width * height == 0u));
+    struct Partial {
+      std::array<uint32_t, NumberOfTags> count;
+      std::array<Box, NumberOfTags> box;
+    };
+    const size_t blocks = GetNumberOfBlocks(height);
+    std::vector<Partial> partials(blocks);
+    ParallelFor(blocks, [&](size_t begin, size_t end) {
+      for (auto block = begin; block < end; ++block) {
+        auto &partial = partials[block];
+        partial.count.fill(0u);
+        partial.box.fill(EmptyBox());
+        const size_t last_row = GetFirstRow(block + 1u, blocks, height);
+        for (auto y = GetFirstRow(block, blocks, height); y < last_row; ++y) {
+          // Segmentation images are mostly long runs of the same tag.
+          const Pixel *row = pixels + y * width;
+          size_t x = 0u;
+          while (x < width) {
+            const uint8_t tag = GetTag(row[x]);
+            size_t run_end = x + 1u;
+            while ((run_end < width) && (GetTag(row[run_end]) == tag)) {
+              ++run_end;
+            }
+            partial.count[tag] += static_cast<uint32_t>(run_end - x);
+            Extend(
+                partial.box[tag],
+                static_cast<uint32_t>(x),
+                static_cast<uint32_t>(run_end - 1u),
+                static_cast<uint32_t>(y));
+            x = run_end;
+          }
+        }
+      }
+    }, number_of_threads, 1u);
+
+    for (auto tag = 0u; tag < NumberOfTags; ++tag) {
+      uint32_t count = 0u;
+      Box box = EmptyBox();
+      for (const auto &partial : partials) {
+        count += partial.count[tag];
+        if (partial.count[tag] > 0u) {
+          Extend(box, partial.box[tag].x_min, partial.box[tag].x_max, partial.box[tag].y_min);
+          Extend(box, partial.box[tag].x_min, partial.box[tag].x_max, partial.box[tag].y_max);
+        }
+      }
+      if (histogram != nullptr) {
+        histogram[tag] = count;
+      }
+      if (boxes != nullptr) {
+        boxes[tag] = count > 0u ? box : Box{0u, 0u, 0u, 0u};
+      }
+    }
+  }
+
+  std::vector<Component> SegmentationAnalysis::FindConnectedComponents(
+      const Pixel *pixels,
+      const size_t width,
+      const size_t height,
+      const ComponentOptions &options,
+      uint32_t *labels) {
+    DEBUG_ASSERT((pixels != nullptr) || (width * height == 0u));
+    const size_t size = width * height;
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      throw_exception(std::invalid_argument("image too big"));
+    }
+    std::array<bool, NumberOfTags> selected;
+    selected.fill(options.tags.empty());
+    for (auto tag : options.tags) {
+      selected[tag] = true;
+    }
+
+    // Split each block of rows in runs of the selected tags.
+    const size_t blocks = GetNumberOfBlocks(height);
+    std::vector<RunBlock> run_blocks(blocks);
+    ParallelFor(blocks, [&](size_t begin, size_t end) {
+      for (auto block = begin; block < end; ++block) {
+        auto &run_block = run_blocks[block];
+        run_block.first_row = GetFirstRow(block, blocks, height);
+        run_block.last_row = GetFirstRow(block + 1u, blocks, height);
+        run_block.row_begin.reserve(run_block.last_row - run_block.first_row + 1u);
+        for (auto y = run_block.first_row; y < run_block.last_row; ++y) {
+          run_block.row_begin.emplace_back(run_block.runs.size());
+          const Pixel *row = pixels + y * width;
+          size_t x = 0u;
+          while (x < width) {
+            const uint8_t tag = GetTag(row[x]);
+            size_t run_end = x + 1u;
+            while ((run_end < width) && (GetTag(row[run_end]) == tag)) {
+              ++run_end;
+            }
+            if (selected[tag]) {
+              run_block.runs.push_back(Run{
+                  static_cast<uint32_t>(x),
+                  static_cast<uint32_t>(run_end),
+                  static_cast<uint32_t>(y),
+                  tag});
+            }
+            x = run_end;
+          }
+        }
+        run_block.row_begin.emplace_back(run_block.runs.size());
+      }
+    }, options.number_of_threads, 1u);
+    size_t number_of_runs = 0u;
+    for (auto &run_block : run_blocks) {
+      run_block.offset = number_of_runs;
+      number_of_runs += run_block.runs.size();
+    }
+
+    // Join the runs of each block independently, then the runs crossing the
+    // boundaries between blocks.
+    DisjointSets sets(number_of_runs);
+    ParallelFor(blocks, [&](size_t begin, size_t end) {
+      for (auto block = begin; block < end; ++block) {
+        const auto &b = run_blocks[block];
+        for (auto row = 1u; row < b.row_begin.size() - 1u; ++row) {
+          const auto upper = b.row_begin[row - 1u];
+          const auto lower = b.row_begin[row];
+          JoinRows(
+              b.runs.data() + upper, lower - upper, b.offset + upper,
+              b.runs.data() + lower, b.row_begin[row + 1u] - lower, b.offset + lower,
+              sets);
+        }
+      }
+    }, options.number_of_threads, 1u);
+    for (auto block = 1u; block < blocks; ++block) {
+      const auto &a = run_blocks[block - 1u];
+      const auto &b = run_blocks[block];
+      const auto upper = a.row_begin[a.row_begin.size() - 2u];
+      JoinRows(
+          a.runs.data() + upper, a.runs.size() - upper, a.offset + upper,
+          b.runs.data(), b.row_begin[1u], b.offset,
+          sets);
+    }
+
+    // Number the components in raster order and accumulate their statistics.
+    std::vector<Component> components;
+    std::vector<std::array<uint64_t, 2u>> sums;
+    std::vector<uint32_t> run_labels(number_of_runs);
+    for (const auto &run_block : run_blocks) {
+      for (auto index = 0u; index < run_block.runs.size(); ++index) {
+        const auto &run = run_block.runs[index];
+        const auto i = static_cast<uint32_t>(run_block.offset + index);
+        const uint32_t root = sets.Flatten(i);
+        if (root == i) {
+          components.emplace_back(Component{run.tag, 0u, EmptyBox(), 0.0f, 0.0f});
+          sums.push_back({{0u, 0u}});
+          run_labels[i] = static_cast<uint32_t>(components.size());
+        } else {
+          run_labels[i] = run_labels[root];
+        }
+        const auto id = run_labels[i] - 1u;
+        const uint64_t length = run.x_end - run.x_begin;
+        auto &component = components[id];
+        component.pixel_count += static_cast<uint32_t>(length);
+        Extend(component.box, run.x_begin, run.x_end - 1u, run.y);
+        sums[id][0u] += (uint64_t(run.x_begin) + run.x_end - 1u) * length;
+        sums[id][1u] += uint64_t(run.y) * length;
+      }
+    }
+
+    // Drop the small components.
+    std::vector<uint32_t> remap(components.size() + 1u, 0u);
+    size_t count = 0u;
+    for (auto i = 0u; i < components.size(); ++i) {
+      auto &component = components[i];
+      if (component.pixel_count < options.min_pixel_count) {
+        continue;
+      }
+      component.centroid_x = static_cast<float>(0.5 * static_cast<double>(sums[i][0u]) / component.pixel_count);
+      component.centroid_y = static_cast<float>(static_cast<double>(sums[i][1u]) / component.pixel_count);
+      components[count] = component;
+      remap[i + 1u] = static_cast<uint32_t>(++count);
+    }
+    components.resize(count);
+
+    if (labels != nullptr) {
+      ParallelFor(blocks, [&](size_t begin, size_t end) {
+        for (auto block = begin; block < end; ++block) {
+          const auto &run_block = run_blocks[block];
+          std::fill(
+              labels + run_block.first_row * width,
+              labels + run_block.last_row * width,
+              0u);
+          for (auto index = 0u; index < run_block.runs.size(); ++index) {
+            const auto &run = run_block.runs[index];
+            auto *row = labels + run.y * width;
+            std::fill(row + run.x_begin, row + run.x_end, remap[run_labels[run_block.offset + index]]);
+          }
+        }
+      }, options.number_of_threads, 1u);
+    }
+    return components;
+  }
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,112 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/ImageTmpl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  /// Statistics of semantic segmentation images, computed directly on the tag
+  /// stored in the red channel of each pixel. Images are split in blocks of
+  /// rows processed by @a number_of_threads threads (zero for one per
+  /// hardware thread).
+  class SegmentationAnalysis {
+  public:
+
+    using Pixel = sensor::data::Color;
+
+    using SensorImage = sensor::data::ImageTmpl<Pixel>;
+
+    /// Number of possible tags, the size of the per-tag arrays.
+    static constexpr size_t NumberOfTags = 256u;
+
+    /// Pixel coordinates, inclusive, of the rectangle enclosing a region.
+    struct Box {
+      uint32_t x_min;
+      uint32_t y_min;
+      uint32_t x_max;
+      uint32_t y_max;
+    };
+
+    static_assert(sizeof(Box) == 4u * sizeof(uint32_t), "Invalid box size.");
+
+    struct Component {
+      uint32_t tag;
+      uint32_t pixel_count;
+      Box box;
+      float centroid_x;
+      float centroid_y;
+    };
+
+    static uint8_t GetTag(const Pixel &pixel) {
+      return pixel.r;
+    }
+
+    /// Count the pixels of each tag into @a histogram and compute the box
+    /// enclosing each tag into @a boxes, both arrays of NumberOfTags
+    /// elements. Boxes of tags not present in the image are set to zero.
+    /// Either of the outputs may be null.
+    static void ComputeTagStatistics(
+        const Pixel *pixels,
+        size_t width,
+        size_t height,
+        uint32_t *histogram,
+        Box *boxes,
+        size_t number_of_threads = 0u);
+
+    struct ComponentOptions {
+      /// Tags to label, empty for all of them.
+      std::vector<uint8_t> tags;
+
+      /// Discard components with fewer pixels than this.
+      uint32_t min_pixel_count = 1u;
+
+      size_t number_of_threads = 0u;
+    };
+
+    /// Find the 4-connected regions of pixels with the same tag. Components
+    /// are returned in the order of their first pixel in raster order.
+    ///
+    /// If @a labels is not null it must have room for `width * height`
+    /// elements, each pixel is set to the index in the result plus one of
+    /// its component, or zero if not part of any.
+    static std::vector<Component> FindConnectedComponents(
+        const Pixel *pixels,
+        size_t width,
+        size_t height,
+        const ComponentOptions &options,
+        uint32_t *labels = nullptr);
+
+    /// @name Overloads for sensor images
+    /// @{
+
+    static void ComputeTagStatistics(
+        const SensorImage &image,
+        uint32_t *histogram,
+        Box *boxes,
+        size_t number_of_threads = 0u) {
+      ComputeTagStatistics(image.data(), image.GetWidth(), image.GetHeight(), histogram, boxes, number_of_threads);
+    }
+
+    static std::vector<Component> FindConnectedComponents(
+        const SensorImage &image,
+        const ComponentOptions &options,
+        uint32_t *labels = nullptr) {
+      return FindConnectedComponents(image.data(), image.GetWidth(), image.GetHeight(), options, labels);
+    }
+
+    /// @}
+  };
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,124 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/pointcloud/DepthProjection.h"
+
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+#include "carla/geom/Math.h"
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  using Pixel = DepthProjection::Pixel;
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  static inline float ToMeters(const Pixel &pixel) {
+    constexpr float scale = DepthProjection::FarPlane / static_cast<float>(256 * 256 * 256 - 1);
+    return static_cast<float>(pixel.r + (pixel.g * 256) + (pixel.b * 256 * 256)) * scale;
+  }
+
+  /// Affine transform as a 3x4 row-major matrix, computed once instead of per
+  /// point as in geom::Transform::TransformPoint.
+  static std::array<float, 12u> MakeMatrix(const geom::Transform &transform) {
+    using geom::Math;
+    const auto &rotation = transform.rotation;
+    const double cy = std::cos(Math::to_radians(rotation.yaw));
+    const double sy = std::sin(Math::to_radians(rotation.yaw));
+    const double cr = std::cos(Math::to_radians(rotation.roll));
+    const double sr = std::sin(Math::to_radians(rotation.roll));
+    const double cp = std::cos(Math::to_radians(rotation.pitch));
+    const double sp = std::sin(Math::to_radians(rotation.pitch));
+    const auto &l = transform.location;
+    return {{
+      float(cp * cy), float(cy * sp * sr - sy * cr), float(-cy * sp * cr - sy * sr), l.x,
+      float(cp * sy), float(sy * sp * sr + cy * cr), float(-sy * sp * cr + cy * sr), l.y,
+      float(sp),      float(-(cp * sr)),             float(cp * cr),                 l.z
+    }};
+  }
+
+  // ===========================================================================
+  // -- DepthProjection --------------------------------------------------------
+  // ===========================================================================
+
+  constexpr float DepthProjection::FarPlane;
+
+  size_t DepthProjection::Project(
+      const Pixel *pixels,
+      const size_t width,
+      const size_t height,
+      const float fov,
+      const Options &options,
+      geom::Location *out) {
+    if (!(fov > 0.0f && fov < 180.0f)) {
+      throw_exception(std::invalid_argument("invalid field of view"));
+    }
+    const size_t stride = options.stride > 0u ? options.stride : 1u;
+    const size_t rows = (height + stride - 1u) / stride;
+    const float max_range = options.max_range;
+
+    const float focal = static_cast<float>(width) / (2.0f * std::tan(geom::Math::to_radians(fov) / 2.0f));
+    const float inverse_focal = 1.0f / focal;
+    const float cx = static_cast<float>(width) / 2.0f;
+    const float cy = static_cast<float>(height) / 2.0f;
+
+    // Count the points of each row so rows can be written in parallel, each
+    // at its own offset.
+    std::vector<size_t> offsets(rows + 1u, 0u);
+    ParallelFor(rows, [&](size_t begin, size_t end) {
+      for (auto row = begin; row < end; ++row) {
+        const Pixel *line = pixels + row * stride * width;
+        size_t count = 0u;
+        for (size_t u = 0u; u < width; u += stride) {
+          count += (ToMeters(line[u]) < max_range) ? 1u : 0u;
+        }
+        offsets[row + 1u] = count;
+      }
+    }, options.number_of_threads, 16u);
+    for (auto i = 1u; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1u];
+    }
+
+    const bool transform = (options.transform != nullptr);
+    const auto m = transform ? MakeMatrix(*options.transform) : std::array<float, 12u>{};
+    ParallelFor(rows, [&](size_t begin, size_t end) {
+      for (auto row = begin; row < end; ++row) {
+        const size_t v = row * stride;
+        const Pixel *line = pixels + v * width;
+        const float z_factor = (cy - static_cast<float>(v)) * inverse_focal;
+        geom::Location *dst = out + offsets[row];
+        for (size_t u = 0u; u < width; u += stride) {
+          const float depth = ToMeters(line[u]);
+          if (!(depth < max_range)) {
+            continue;
+          }
+          const float x = depth;
+          const float y = (static_cast<float>(u) - cx) * inverse_focal * depth;
+          const float z = z_factor * depth;
+          if (transform) {
+            *dst++ = geom::Location(
+                m[0u] * x + m[1u] * y + m[2u]  * z + m[3u],
+                m[4u] * x + m[5u] * y + m[6u]  * z + m[7u],
+                m[8u] * x + m[9u] * y + m[10u] * z + m[11u]);
+          } else {
+            *dst++ = geom::Location(x, y, z);
+          }
+        }
+      }
+    }, options.number_of_threads, 16u);
+    return offsets.back();
+  }
+
+} // namespace pointcloud
+} // namespace carla
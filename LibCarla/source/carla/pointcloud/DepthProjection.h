@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/Location.h"
+#include "carla/geom/Transform.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/Image.h"
+
+#include <cstddef>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Reconstructs the 3D points seen by a depth camera. The depth of each
+  /// pixel is decoded from its RGB channels as ColorConverter::Depth does,
+  /// and the camera intrinsics are computed from the image size and field of
+  /// view.
+  ///
+  /// Points are in the camera frame, x forward, y right, and z up, or in the
+  /// world frame if a transform is given. They are written row by row to a
+  /// buffer provided by the caller, so the result can be passed directly to
+  /// PointCloudIO.
+  class DepthProjection {
+  public:
+
+    using Pixel = sensor::data::Color;
+
+    /// Depth in meters of the far plane, the depth encoded as white.
+    static constexpr float FarPlane = 1000.0f;
+
+    struct Options {
+      /// Take one pixel out of @a stride in each direction.
+      size_t stride = 1u;
+
+      /// Drop pixels with a depth greater or equal than this, in meters. By
+      /// default the pixels at the far plane (the sky) are dropped.
+      float max_range = FarPlane;
+
+      /// If not null, points are transformed by it (usually the sensor
+      /// transform) to world coordinates.
+      const geom::Transform *transform = nullptr;
+
+      /// Number of threads to split the work, zero for one per hardware
+      /// thread.
+      size_t number_of_threads = 0u;
+    };
+
+    /// Maximum number of points generated from an image of the given size,
+    /// the minimum size of the output buffer.
+    static size_t GetMaxNumberOfPoints(size_t width, size_t height, size_t stride) {
+      stride = stride > 0u ? stride : 1u;
+      return ((width + stride - 1u) / stride) * ((height + stride - 1u) / stride);
+    }
+
+    /// Project the @a width x @a height depth image @a pixels, with
+    /// horizontal field of view @a fov in degrees.
+    ///
+    /// @return the number of points written to @a out.
+    static size_t Project(
+        const Pixel *pixels,
+        size_t width,
+        size_t height,
+        float fov,
+        const Options &options,
+        geom::Location *out);
+
+    /// Project @a image. The sensor transform of the image is used if
+    /// @a world_frame is true, overriding options.transform.
+    static size_t Project(
+        const sensor::data::Image &image,
+        Options options,
+        bool world_frame,
+        geom::Location *out) {
+      if (world_frame) {
+        options.transform = &image.GetSensorTransform();
+      }
+      return Project(image.data(), image.GetWidth(), image.GetHeight(), image.GetFOVAngle(), options, out);
+    }
+  };
+
+} // namespace pointcloud
+} // namespace carla
@@ -0,0 +1,198 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/pointcloud/LidarProcessing.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  /// Number of blocks to split @a count points so the output offsets of each
+  /// block can be computed before writing.
+  static size_t GetNumberOfBlocks(size_t count) {
+    constexpr size_t block_size = 4096u;
+    return std::max<size_t>(1u, std::min<size_t>(256u, count / block_size));
+  }
+
+  static bool IsInside(const geom::Location &point, const geom::BoundingBox &box) {
+    return
+        (std::abs(point.x - box.location.x) <= box.extent.x) &&
+        (std::abs(point.y - box.location.y) <= box.extent.y) &&
+        (std::abs(point.z - box.location.z) <= box.extent.z);
+  }
+
+  /// Packs the voxel coordinates of @a point in 21 bits each. Voxels further
+  /// than 2^20 voxels from the origin are clamped.
+  static uint64_t GetVoxelKey(const geom::Location &point, float inverse_voxel_size) {
+    constexpr int64_t offset = int64_t(1) << 20;
+    auto coordinate = [=](float value) -> uint64_t {
+      const auto index = static_cast<int64_t>(std::floor(value * inverse_voxel_size));
+      return static_cast<uint64_t>(std::min(std::max(index + offset, int64_t(0)), 2 * offset - 1));
+    };
+    return (coordinate(point.x) << 42u) | (coordinate(point.y) << 21u) | coordinate(point.z);
+  }
+
+  // ===========================================================================
+  // -- LidarProcessing --------------------------------------------------------
+  // ===========================================================================
+
+  size_t LidarProcessing::Crop(
+      const Point *points,
+      const size_t count,
+      const geom::BoundingBox &box,
+      Point *out,
+      const size_t number_of_threads) {
+    DEBUG_ASSERT((points != nullptr) || (count == 0u));
+    const size_t blocks = GetNumberOfBlocks(count);
+    const size_t block_size = (count + blocks - 1u) / blocks;
+    std::vector<size_t> offsets(blocks + 1u, 0u);
+    ParallelFor(blocks, [&](size_t begin, size_t end) {
+      for (auto block = begin; block < end; ++block) {
+        const auto first = points + std::min(count, block * block_size);
+        const auto last = points + std::min(count, (block + 1u) * block_size);
+        offsets[block + 1u] = static_cast<size_t>(std::count_if(first, last, [&](const Point &point) {
+          return IsInside(point, box);
+        }));
+      }
+    }, number_of_threads, 1u);
+    for (auto i = 1u; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1u];
+    }
+    ParallelFor(blocks, [&](size_t begin, size_t end) {
+      for (auto block = begin; block < end; ++block) {
+        const auto first = points + std::min(count, block * block_size);
+        const auto last = points + std::min(count, (block + 1u) * block_size);
+        std::copy_if(first, last, out + offsets[block], [&](const Point &point) {
+          return IsInside(point, box);
+        });
+      }
+    }, number_of_threads, 1u);
+    return offsets.back();
+  }
+
+  size_t LidarProcessing::VoxelDownsample(
+      const Point *points,
+      const size_t count,
+      const float voxel_size,
+      Point *out,
+      const size_t number_of_threads) {
+    DEBUG_ASSERT((points != nullptr) || (count == 0u));
+    if (!(voxel_size > 0.0f)) {
+      throw_exception(std::invalid_argument("voxel size must be positive"));
+    }
+    const float inverse_voxel_size = 1.0f / voxel_size;
+
+    // Sort the points by voxel.
+    std::vector<std::pair<uint64_t, uint32_t>> keys(count);
+    ParallelFor(count, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        keys[i] = {GetVoxelKey(points[i], inverse_voxel_size), static_cast<uint32_t>(i)};
+      }
+    }, number_of_threads);
+    std::sort(keys.begin(), keys.end());
+
+    // Each run of equal keys is a voxel.
+    std::vector<size_t> voxels;
+    for (auto i = 0u; i < keys.size(); ++i) {
+      if ((i == 0u) || (keys[i].first != keys[i - 1u].first)) {
+        voxels.emplace_back(i);
+      }
+    }
+    const size_t number_of_voxels = voxels.size();
+    voxels.emplace_back(keys.size());
+
+    ParallelFor(number_of_voxels, [&](size_t begin, size_t end) {
+      for (auto voxel = begin; voxel < end; ++voxel) {
+        double x = 0.0, y = 0.0, z = 0.0;
+        for (auto i = voxels[voxel]; i < voxels[voxel + 1u]; ++i) {
+          const auto &point = points[keys[i].second];
+          x += point.x;
+          y += point.y;
+          z += point.z;
+        }
+        const double n = static_cast<double>(voxels[voxel + 1u] - voxels[voxel]);
+        out[voxel] = Point(
+            static_cast<float>(x / n),
+            static_cast<float>(y / n),
+            static_cast<float>(z / n));
+      }
+    }, number_of_threads);
+    return number_of_voxels;
+  }
+
+  void LidarProcessing::MakeRangeImage(
+      const Point *points,
+      const uint32_t *points_per_channel,
+      const size_t channels,
+      const size_t width,
+      float *out,
+      const size_t number_of_threads) {
+    DEBUG_ASSERT((points_per_channel != nullptr) || (channels == 0u));
+    if (width == 0u) {
+      return;
+    }
+    std::vector<size_t> offsets(channels + 1u, 0u);
+    for (auto i = 0u; i < channels; ++i) {
+      offsets[i + 1u] = offsets[i] + points_per_channel[i];
+    }
+    constexpr float pi = 3.14159265358979323846f;
+    const float columns_per_radian = static_cast<float>(width) / (2.0f * pi);
+    // One channel per task, so no two threads write the same row.
+    ParallelFor(channels, [&](size_t begin, size_t end) {
+      for (auto channel = begin; channel < end; ++channel) {
+        float *row = out + channel * width;
+        std::fill(row, row + width, 0.0f);
+        for (auto i = offsets[channel]; i < offsets[channel + 1u]; ++i) {
+          const auto &point = points[i];
+          const float range = std::sqrt(point.x * point.x + point.y * point.y + point.z * point.z);
+          if (!(range > 0.0f)) {
+            continue;
+          }
+          // Azimuth in [-pi, pi], both ends (backward) fall in column zero.
+          const float column = std::floor((std::atan2(point.y, point.x) + pi) * columns_per_radian);
+          const size_t index = static_cast<size_t>(std::max(column, 0.0f)) % width;
+          float &pixel = row[index];
+          if ((pixel == 0.0f) || (range < pixel)) {
+            pixel = range;
+          }
+        }
+      }
+    }, number_of_threads, 1u);
+  }
+
+  void LidarProcessing::MakeRangeImage(
+      const sensor::data::LidarMeasurement &measurement,
+      const size_t width,
+      float *out,
+      const size_t number_of_threads) {
+    const size_t channels = measurement.GetChannelCount();
+    std::vector<uint32_t> points_per_channel(channels);
+    size_t total = 0u;
+    for (auto i = 0u; i < channels; ++i) {
+      points_per_channel[i] = measurement.GetPointCount(i);
+      total += points_per_channel[i];
+    }
+    if (total > measurement.size()) {
+      throw_exception(std::runtime_error("lidar measurement has fewer points than its header states"));
+    }
+    MakeRangeImage(measurement.data(), points_per_channel.data(), channels, width, out, number_of_threads);
+  }
+
+} // namespace pointcloud
+} // namespace carla
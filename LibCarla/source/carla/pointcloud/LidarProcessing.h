@@ -0,0 +1,98 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/BoundingBox.h"
+#include "carla/geom/Location.h"
+#include "carla/sensor/data/LidarMeasurement.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Preprocessing kernels for lidar point clouds. The work is split among
+  /// @a number_of_threads threads (zero for one per hardware thread), and
+  /// the results are written to buffers provided by the caller.
+  class LidarProcessing {
+  public:
+
+    using Point = geom::Location;
+
+    /// Copy to @a out the points inside @a box, keeping their order. The box
+    /// is axis-aligned and in the same coordinate frame as the points. @a out
+    /// must have room for @a count points.
+    ///
+    /// @return the number of points written to @a out.
+    static size_t Crop(
+        const Point *points,
+        size_t count,
+        const geom::BoundingBox &box,
+        Point *out,
+        size_t number_of_threads = 0u);
+
+    /// Replace the points falling in each cube of side @a voxel_size by their
+    /// centroid. @a out must have room for @a count points, the centroids
+    /// are written sorted by voxel.
+    ///
+    /// @return the number of points written to @a out.
+    static size_t VoxelDownsample(
+        const Point *points,
+        size_t count,
+        float voxel_size,
+        Point *out,
+        size_t number_of_threads = 0u);
+
+    /// Spherical projection of the points to a @a channels x @a width image
+    /// of ranges. Points must be sorted by channel, with
+    /// @a points_per_channel[i] points in channel i; row i of the image
+    /// corresponds to channel i. The column is given by the azimuth of the
+    /// point, the forward direction (+x) falls in the center column. If
+    /// several points fall in the same pixel the closest one is kept, pixels
+    /// without points are set to zero.
+    ///
+    /// @a out must have room for `channels * width` floats, in row-major
+    /// order.
+    static void MakeRangeImage(
+        const Point *points,
+        const uint32_t *points_per_channel,
+        size_t channels,
+        size_t width,
+        float *out,
+        size_t number_of_threads = 0u);
+
+    /// @name Overloads for LidarMeasurement
+    /// @{
+
+    static size_t Crop(
+        const sensor::data::LidarMeasurement &measurement,
+        const geom::BoundingBox &box,
+        Point *out,
+        size_t number_of_threads = 0u) {
+      return Crop(measurement.data(), measurement.size(), box, out, number_of_threads);
+    }
+
+    static size_t VoxelDownsample(
+        const sensor::data::LidarMeasurement &measurement,
+        float voxel_size,
+        Point *out,
+        size_t number_of_threads = 0u) {
+      return VoxelDownsample(measurement.data(), measurement.size(), voxel_size, out, number_of_threads);
+    }
+
+    /// @a out must have room for `GetChannelCount() * width` floats.
+    static void MakeRangeImage(
+        const sensor::data::LidarMeasurement &measurement,
+        size_t width,
+        float *out,
+        size_t number_of_threads = 0u);
+
+    /// @}
+  };
+
+} // namespace pointcloud
+} // namespace carla
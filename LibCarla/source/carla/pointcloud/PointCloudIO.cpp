@@ -6,14 +6,15 @@
 
 #include "carla/pointcloud/PointCloudIO.h"
 
+#include <algorithm>
 #include <iomanip>
 
 namespace carla {
 namespace pointcloud {
 
-  void PointCloudIO::WriteHeader(std::ostream &out, size_t number_of_points) {
+  void PointCloudIO::WriteHeader(std::ostream &out, size_t number_of_points, Format format) {
     out << "ply\n"
-           "format ascii 1.0\n"
+           "format " << (format == Format::PlyAscii ? "ascii" : "binary_little_endian") << " 1.0\n"
            "element vertex " << number_of_points << "\n"
            "property float32 x\n"
            "property float32 y\n"
@@ -25,5 +26,12 @@ namespace pointcloud {
     out << std::fixed << std::setprecision(4u);
   }
 
+  void PointCloudIO::SwapBytes(std::vector<float> &buffer) {
+    for (auto &value : buffer) {
+      auto *bytes = reinterpret_cast<unsigned char *>(&value);
+      std::reverse(bytes, bytes + sizeof(value));
+    }
+  }
+
 } // namespace pointcloud
 } // namespace carla
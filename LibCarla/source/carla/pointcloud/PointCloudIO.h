@@ -8,8 +8,11 @@
 
 #include "carla/FileSystem.h"
 
+#include <cstdint>
 #include <fstream>
 #include <iterator>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace pointcloud {
@@ -17,25 +20,104 @@ namespace pointcloud {
   class PointCloudIO {
   public:
 
+    enum class Format {
+      /// PLY with one line of text per point.
+      PlyAscii,
+      /// PLY with the points as little-endian float32 x, y, z.
+      PlyBinary,
+      /// Headerless little-endian float32 x, y, z, intensity per point, the
+      /// layout of the KITTI velodyne scans. Intensity is always zero.
+      Bin
+    };
+
+    /// File extension used by default for @a format.
+    static const char *GetExtension(Format format) {
+      return format == Format::Bin ? ".bin" : ".ply";
+    }
+
     template <typename PointIt>
-    static void Dump(std::ostream &out, PointIt begin, PointIt end) {
-      WriteHeader(out, std::distance(begin, end));
-      for (; begin != end; ++begin) {
-        out << begin->x << ' ' << begin->y << ' ' << begin->z << '\n';
+    static void Dump(std::ostream &out, PointIt begin, PointIt end, Format format = Format::PlyAscii) {
+      switch (format) {
+        case Format::PlyAscii:
+          WriteHeader(out, std::distance(begin, end), format);
+          for (; begin != end; ++begin) {
+            out << begin->x << ' ' << begin->y << ' ' << begin->z << '\n';
+          }
+          break;
+        case Format::PlyBinary:
+          WriteHeader(out, std::distance(begin, end), format);
+          WriteBinary<3u>(out, begin, end);
+          break;
+        case Format::Bin:
+          WriteBinary<4u>(out, begin, end);
+          break;
       }
     }
 
     template <typename PointIt>
-    static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
-      FileSystem::ValidateFilePath(path, ".ply");
-      std::ofstream out(path);
-      Dump(out, begin, end);
+    static std::string SaveToDisk(
+        std::string path,
+        PointIt begin,
+        PointIt end,
+        Format format = Format::PlyAscii) {
+      FileSystem::ValidateFilePath(path, GetExtension(format));
+      std::ofstream out(path, std::ios::binary);
+      Dump(out, begin, end, format);
       return path;
     }
 
   private:
 
-    static void WriteHeader(std::ostream &out, size_t number_of_points);
+    static void WriteHeader(std::ostream &out, size_t number_of_points, Format format);
+
+    static bool IsLittleEndian() {
+      const uint16_t one = 1u;
+      return *reinterpret_cast<const uint8_t *>(&one) == 1u;
+    }
+
+    /// Whether PointIt points to contiguous memory with the layout
+    /// {float x, y, z}, so the points can be written as they are.
+    template <typename PointIt>
+    static constexpr bool IsPackedFloat3() {
+      using T = typename std::iterator_traits<PointIt>::value_type;
+      return std::is_pointer<PointIt>::value &&
+          std::is_standard_layout<T>::value &&
+          std::is_same<std::decay_t<decltype(std::declval<T>().x)>, float>::value &&
+          (sizeof(T) == 3u * sizeof(float));
+    }
+
+    /// Writes @a Floats little-endian float32 per point with a single call to
+    /// write. If there are more floats than x, y, z they are set to zero.
+    template <size_t Floats, typename PointIt>
+    static void WriteBinary(std::ostream &out, PointIt begin, PointIt end) {
+      static_assert(Floats >= 3u, "A point needs at least 3 floats");
+      if (begin == end) {
+        return;
+      }
+      if ((Floats == 3u) && IsPackedFloat3<PointIt>() && IsLittleEndian()) {
+        const auto size = sizeof(float) * Floats * static_cast<size_t>(std::distance(begin, end));
+        out.write(reinterpret_cast<const char *>(&*begin), static_cast<std::streamsize>(size));
+        return;
+      }
+      std::vector<float> buffer;
+      buffer.reserve(Floats * static_cast<size_t>(std::distance(begin, end)));
+      for (; begin != end; ++begin) {
+        buffer.emplace_back(begin->x);
+        buffer.emplace_back(begin->y);
+        buffer.emplace_back(begin->z);
+        for (auto i = 3u; i < Floats; ++i) {
+          buffer.emplace_back(0.0f);
+        }
+      }
+      if (!IsLittleEndian()) {
+        SwapBytes(buffer);
+      }
+      out.write(
+          reinterpret_cast<const char *>(buffer.data()),
+          static_cast<std::streamsize>(sizeof(float) * buffer.size()));
+    }
+
+    static void SwapBytes(std::vector<float> &buffer);
   };
 
 } // namespace pointcloud
@@ -0,0 +1,99 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/AsyncFileWriter.h"
+
+#include "carla/Logging.h"
+
+namespace carla {
+namespace recorder {
+
+  bool AsyncFileWriter::Open(const std::string &path) {
+    Close();
+    _file.open(path, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open()) {
+      return false;
+    }
+    _failed = false;
+    _bytes_written = 0u;
+    _stop = false;
+    _thread = std::thread([this]() { Run(); });
+    return true;
+  }
+
+  void AsyncFileWriter::Write(OutputBuffer &buffer) {
+    DEBUG_ASSERT(IsOpen());
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return !_has_queued; });
+      _queued.swap(buffer);
+      _has_queued = true;
+    }
+    _condition.notify_all();
+    buffer.clear();
+  }
+
+  void AsyncFileWriter::Flush() {
+    if (!IsOpen()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return !_has_queued && !_is_writing; });
+    // The thread does not touch the file until something else is queued.
+    _file.flush();
+  }
+
+  void AsyncFileWriter::Close() {
+    if (!IsOpen()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+    _file.close();
+    if (_file.fail()) {
+      _failed = true;
+    }
+  }
+
+  void AsyncFileWriter::Run() {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _has_queued || _stop; });
+        if (!_has_queued) {
+          return;
+        }
+        _writing.swap(_queued);
+        _has_queued = false;
+        _is_writing = true;
+      }
+      _condition.notify_all();
+
+      if (!_failed) {
+        _file.write(reinterpret_cast<const char *>(_writing.data()), static_cast<std::streamsize>(_writing.size()));
+        if (_file.fail()) {
+          log_error("recorder: error writing file");
+          _failed = true;
+        } else {
+          _bytes_written += _writing.size();
+        }
+      }
+      _writing.clear();
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _is_writing = false;
+      }
+      _condition.notify_all();
+    }
+  }
+
+} // namespace recorder
+} // namespace carla
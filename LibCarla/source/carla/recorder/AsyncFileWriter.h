@@ -0,0 +1,96 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/BinaryStream.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace carla {
+namespace recorder {
+
+  /// Appends buffers to a file from a background thread.
+  ///
+  /// A buffer handed to Write is exchanged for the one the thread finished
+  /// writing before, so the caller only blocks if it produces data faster
+  /// than the disk can take it, and the memory of the buffers is reused.
+  class AsyncFileWriter : private NonCopyable {
+  public:
+
+    AsyncFileWriter() = default;
+
+    ~AsyncFileWriter() {
+      Close();
+    }
+
+    /// Create (or truncate) the file at @a path and start the writer thread.
+    /// Return false if the file cannot be created.
+    bool Open(const std::string &path);
+
+    bool IsOpen() const {
+      return _thread.joinable();
+    }
+
+    /// Queue the content of @a buffer to be written, @a buffer is replaced by
+    /// an empty buffer. Blocks while the previous buffer queued has not been
+    /// picked up by the writer thread.
+    void Write(OutputBuffer &buffer);
+
+    /// Block until every buffer queued has been written and flushed to the
+    /// operating system.
+    void Flush();
+
+    /// Write every buffer queued, stop the thread and close the file.
+    void Close();
+
+    /// Whether any write failed since the file was opened.
+    bool HasFailed() const {
+      return _failed;
+    }
+
+    uint64_t GetBytesWritten() const {
+      return _bytes_written;
+    }
+
+  private:
+
+    void Run();
+
+    std::ofstream _file;
+
+    std::thread _thread;
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    /// Buffer waiting to be written.
+    OutputBuffer _queued;
+
+    /// Buffer being written by the thread.
+    OutputBuffer _writing;
+
+    bool _has_queued = false;
+
+    bool _is_writing = false;
+
+    bool _stop = false;
+
+    std::atomic_bool _failed{false};
+
+    std::atomic<uint64_t> _bytes_written{0u};
+  };
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,208 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Growable byte buffer the recorder packets are serialized to, values are
+  /// stored in native byte order as in the original recorder format.
+  class OutputBuffer {
+  public:
+
+    using value_type = unsigned char;
+
+    OutputBuffer() = default;
+
+    explicit OutputBuffer(size_t capacity) {
+      _data.reserve(capacity);
+    }
+
+    const value_type *data() const {
+      return _data.data();
+    }
+
+    value_type *data() {
+      return _data.data();
+    }
+
+    size_t size() const {
+      return _data.size();
+    }
+
+    size_t capacity() const {
+      return _data.capacity();
+    }
+
+    bool empty() const {
+      return _data.empty();
+    }
+
+    /// Clear the content, keeps the allocated memory.
+    void clear() {
+      _data.clear();
+    }
+
+    void reserve(size_t capacity) {
+      _data.reserve(capacity);
+    }
+
+    /// Discard the bytes after @a size.
+    void resize(size_t size) {
+      DEBUG_ASSERT(size <= _data.size());
+      _data.resize(size);
+    }
+
+    void swap(OutputBuffer &other) {
+      _data.swap(other._data);
+    }
+
+    void Write(const void *data, size_t size) {
+      const auto *begin = static_cast<const value_type *>(data);
+      _data.insert(_data.end(), begin, begin + size);
+    }
+
+    template <typename T>
+    void Write(const T &value) {
+      static_assert(std::is_trivially_copyable<T>::value, "Type cannot be written as raw bytes.");
+      Write(&value, sizeof(T));
+    }
+
+    /// Write the length of @a str (2 bytes) followed by its characters.
+    void WriteString(const std::string &str) {
+      const auto length = static_cast<uint16_t>(str.size());
+      Write(length);
+      Write(str.data(), length);
+    }
+
+    /// Overwrite the bytes at @a offset with @a value.
+    template <typename T>
+    void WriteAt(size_t offset, const T &value) {
+      static_assert(std::is_trivially_copyable<T>::value, "Type cannot be written as raw bytes.");
+      DEBUG_ASSERT(offset + sizeof(T) <= _data.size());
+      std::memcpy(_data.data() + offset, &value, sizeof(T));
+    }
+
+  private:
+
+    std::vector<value_type> _data;
+  };
+
+  /// Reads values written by an OutputBuffer from a block of memory.
+  ///
+  /// @throw std::runtime_error when reading past the end of the block, unless
+  ///   constructed with @a throw_on_error false. In that case the values read
+  ///   past the end are zero and IsValid returns false afterwards; the
+  ///   simulator, built without exceptions, reads the recorder files this
+  ///   way.
+  class InputBuffer {
+  public:
+
+    using value_type = unsigned char;
+
+    InputBuffer(const value_type *data, size_t size, bool throw_on_error = true)
+      : _begin(data),
+        _it(data),
+        _end(data + size),
+        _throw_on_error(throw_on_error) {}
+
+    /// Whether every read so far was within the block.
+    bool IsValid() const {
+      return _is_valid;
+    }
+
+    size_t GetOffset() const {
+      return static_cast<size_t>(_it - _begin);
+    }
+
+    size_t GetRemaining() const {
+      return static_cast<size_t>(_end - _it);
+    }
+
+    bool IsAtEnd() const {
+      return _it == _end;
+    }
+
+    const value_type *GetPosition() const {
+      return _it;
+    }
+
+    void Read(void *data, size_t size) {
+      const auto *source = Advance(size);
+      if (source != nullptr) {
+        std::memcpy(data, source, size);
+      } else {
+        std::memset(data, 0, size);
+      }
+    }
+
+    template <typename T>
+    void Read(T &value) {
+      static_assert(std::is_trivially_copyable<T>::value, "Type cannot be read as raw bytes.");
+      Read(&value, sizeof(T));
+    }
+
+    template <typename T>
+    T Read() {
+      T value;
+      Read(value);
+      return value;
+    }
+
+    void ReadString(std::string &str) {
+      const auto length = Read<uint16_t>();
+      const auto *data = Advance(length);
+      if (data != nullptr) {
+        str.assign(reinterpret_cast<const char *>(data), length);
+      } else {
+        str.clear();
+      }
+    }
+
+    void Skip(size_t size) {
+      Advance(size);
+    }
+
+  private:
+
+    const value_type *Advance(size_t size) {
+      if (size > GetRemaining()) {
+        if (_throw_on_error) {
+          throw_exception(std::runtime_error("recorder: unexpected end of data"));
+        }
+        _is_valid = false;
+        _it = _end;
+        return nullptr;
+      }
+      const auto *result = _it;
+      _it += size;
+      return result;
+    }
+
+    const value_type *_begin;
+
+    const value_type *_it;
+
+    const value_type *_end;
+
+    const bool _throw_on_error;
+
+    bool _is_valid = true;
+  };
+
+} // namespace recorder
+} // namespace carla
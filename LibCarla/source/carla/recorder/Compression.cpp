@@ -0,0 +1,175 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/Compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace carla {
+namespace recorder {
+
+  /// Shortest back-reference encoded.
+  constexpr size_t MinMatch = 4u;
+
+  /// The last bytes of a block are always literals.
+  constexpr size_t LastLiterals = 5u;
+
+  /// No back-reference starts in the last bytes of a block.
+  constexpr size_t MatchLimit = 12u;
+
+  constexpr size_t MaxOffset = 0xFFFFu;
+
+  constexpr uint32_t HashBits = 12u;
+
+  /// Largest length stored in the token, longer ones are followed by extra
+  /// length bytes.
+  constexpr size_t TokenMaxLength = 15u;
+
+  static inline uint32_t Load32(const unsigned char *data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  static inline uint32_t Hash(const uint32_t value) {
+    return (value * 2654435761u) >> (32u - HashBits);
+  }
+
+  static void WriteLength(OutputBuffer &out, size_t length) {
+    for (; length >= 0xFFu; length -= 0xFFu) {
+      out.Write(uint8_t(0xFFu));
+    }
+    out.Write(static_cast<uint8_t>(length));
+  }
+
+  /// Write @a literals followed by a back-reference, @a match_length is zero
+  /// for the last sequence of the block.
+  static void WriteSequence(
+      OutputBuffer &out,
+      const unsigned char *literals,
+      const size_t literal_length,
+      const size_t offset,
+      const size_t match_length) {
+    const auto literal_token = std::min(literal_length, TokenMaxLength);
+    const auto match_token = match_length > 0u ? std::min(match_length - MinMatch, TokenMaxLength) : 0u;
+    out.Write(static_cast<uint8_t>((literal_token << 4u) | match_token));
+    if (literal_token == TokenMaxLength) {
+      WriteLength(out, literal_length - TokenMaxLength);
+    }
+    out.Write(literals, literal_length);
+    if (match_length > 0u) {
+      out.Write(static_cast<uint8_t>(offset & 0xFFu));
+      out.Write(static_cast<uint8_t>(offset >> 8u));
+      if (match_token == TokenMaxLength) {
+        WriteLength(out, match_length - MinMatch - TokenMaxLength);
+      }
+    }
+  }
+
+  static bool ReadLength(const unsigned char *&it, const unsigned char *end, size_t &length) {
+    uint8_t byte;
+    do {
+      if (it == end) {
+        return false;
+      }
+      byte = *it++;
+      length += byte;
+    } while (byte == 0xFFu);
+    return true;
+  }
+
+  void BlockCompressor::Compress(const unsigned char *data, const size_t size, OutputBuffer &out) {
+    DEBUG_ASSERT(size <= std::numeric_limits<uint32_t>::max());
+    _table.assign(1u << HashBits, 0u);
+    size_t anchor = 0u;
+    size_t position = 0u;
+    if (size > MatchLimit) {
+      const size_t search_limit = size - MatchLimit;
+      const size_t match_end_limit = size - LastLiterals;
+      while (position < search_limit) {
+        const auto sequence = Load32(data + position);
+        auto &entry = _table[Hash(sequence)];
+        const size_t candidate = entry;
+        entry = static_cast<uint32_t>(position);
+        if ((candidate < position) &&
+            (position - candidate <= MaxOffset) &&
+            (Load32(data + candidate) == sequence)) {
+          auto length = MinMatch;
+          while ((position + length < match_end_limit) &&
+                 (data[candidate + length] == data[position + length])) {
+            ++length;
+          }
+          WriteSequence(out, data + anchor, position - anchor, position - candidate, length);
+          position += length;
+          anchor = position;
+        } else {
+          ++position;
+        }
+      }
+    }
+    WriteSequence(out, data + anchor, size - anchor, 0u, 0u);
+  }
+
+  bool DecompressBlock(
+      const unsigned char *source,
+      const size_t source_size,
+      unsigned char *destination,
+      const size_t size) {
+    const auto *it = source;
+    const auto *end = source + source_size;
+    auto *out = destination;
+    auto *out_end = destination + size;
+    while (it != end) {
+      const auto token = *it++;
+      size_t literal_length = token >> 4u;
+      if ((literal_length == TokenMaxLength) && !ReadLength(it, end, literal_length)) {
+        return false;
+      }
+      if ((literal_length > static_cast<size_t>(end - it)) ||
+          (literal_length > static_cast<size_t>(out_end - out))) {
+        return false;
+      }
+      std::memcpy(out, it, literal_length);
+      it += literal_length;
+      out += literal_length;
+      if (it == end) {
+        // The last sequence has no back-reference.
+        break;
+      }
+      if (end - it < 2) {
+        return false;
+      }
+      const size_t offset = it[0u] | (it[1u] << 8u);
+      it += 2u;
+      if ((offset == 0u) || (offset > static_cast<size_t>(out - destination))) {
+        return false;
+      }
+      size_t match_length = token & 0x0Fu;
+      if ((match_length == TokenMaxLength) && !ReadLength(it, end, match_length)) {
+        return false;
+      }
+      match_length += MinMatch;
+      if (match_length > static_cast<size_t>(out_end - out)) {
+        return false;
+      }
+      const auto *match = out - offset;
+      if (offset >= match_length) {
+        std::memcpy(out, match, match_length);
+        out += match_length;
+      } else {
+        // Overlapping reference, repeats the last offset bytes.
+        for (auto i = 0u; i < match_length; ++i) {
+          *out++ = *match++;
+        }
+      }
+    }
+    return out == out_end;
+  }
+
+} // namespace recorder
+} // namespace carla
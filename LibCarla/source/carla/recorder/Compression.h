@@ -0,0 +1,47 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/recorder/BinaryStream.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Compresses blocks of bytes with a byte-oriented LZ77 scheme, laid out as
+  /// the LZ4 block format: a sequence of literal runs, each followed by a
+  /// back-reference of at least four bytes into the previous 64 KiB.
+  ///
+  /// Compression is greedy with a single hash table lookup per position,
+  /// trading ratio for speed; decompression is a plain copy loop. The hash
+  /// table is kept between calls, so compressing does not allocate once the
+  /// output buffer has grown.
+  class BlockCompressor {
+  public:
+
+    /// Append the compressed @a data to @a out. The size of @a data must be
+    /// stored by the caller, it is needed to decompress the block.
+    void Compress(const unsigned char *data, size_t size, OutputBuffer &out);
+
+  private:
+
+    std::vector<uint32_t> _table;
+  };
+
+  /// Decompress the block @a source of @a source_size bytes into exactly
+  /// @a size bytes at @a destination. Return false if the block is not
+  /// valid, it never reads or writes out of the given ranges.
+  bool DecompressBlock(
+      const unsigned char *source,
+      size_t source_size,
+      unsigned char *destination,
+      size_t size);
+
+} // namespace recorder
+} // namespace carla
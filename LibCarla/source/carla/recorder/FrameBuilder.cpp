@@ -0,0 +1,159 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/FrameBuilder.h"
+
+#include <algorithm>
+
+namespace carla {
+namespace recorder {
+
+  FrameBuilder::FrameBuilder(size_t initial_capacity)
+    : _buffer(initial_capacity) {
+    Reset();
+  }
+
+  void FrameBuilder::Reset() {
+    Clear();
+    _buffer.clear();
+    _bytes_taken = 0u;
+    _index.Reset();
+    _position_encoder.Reset(_position_encoder.GetEncoding());
+    _frame = Frame{0u, 0.0, 0.0};
+    _last_frame_begin = 0u;
+    _last_frame_duration = 0u;
+  }
+
+  void FrameBuilder::WriteInfo(const Info &info) {
+    DEBUG_ASSERT(_frame.id == 0u);
+    Write(_buffer, info);
+    _last_frame_begin = _buffer.size();
+  }
+
+  void FrameBuilder::Add(const Collision &collision) {
+    const auto it = std::find_if(_collisions.begin(), _collisions.end(), [&](const Collision &item) {
+      return
+          (item.database_id1 == collision.database_id1) &&
+          (item.database_id2 == collision.database_id2);
+    });
+    if (it == _collisions.end()) {
+      _collisions.emplace_back(collision);
+    }
+  }
+
+  void FrameBuilder::Clear() {
+    _events_add.clear();
+    _events_del.clear();
+    _events_parent.clear();
+    _collisions.clear();
+    _positions.clear();
+    _states.clear();
+  }
+
+  template <typename T>
+  void FrameBuilder::WriteFixedSizePackets(const PacketId id, const std::vector<T> &records) {
+    const auto total = static_cast<uint16_t>(records.size());
+    WritePacketHeader(id, static_cast<uint32_t>(sizeof(uint16_t) + total * sizeof(T)));
+    _buffer.Write(total);
+    _buffer.Write(records.data(), total * sizeof(T));
+  }
+
+  template <typename T>
+  void FrameBuilder::WriteVariableSizePackets(const PacketId id, const std::vector<T> &records) {
+    // The size is known once the records are serialized.
+    const auto size_offset = _buffer.size() + sizeof(char);
+    WritePacketHeader(id, 0u);
+    const auto total = static_cast<uint16_t>(records.size());
+    _buffer.Write(total);
+    for (auto i = 0u; i < total; ++i) {
+      _index.AddEvent(records[i], GetFileOffset());
+      Write(_buffer, records[i]);
+    }
+    const auto size = _buffer.size() - size_offset - sizeof(uint32_t);
+    _buffer.WriteAt(size_offset, static_cast<uint32_t>(size));
+  }
+
+  void FrameBuilder::WriteCompactPositions(const bool key_frame) {
+    const auto size_offset = _buffer.size() + sizeof(char);
+    WritePacketHeader(PacketId::PositionCompact, 0u);
+    const auto begin = _buffer.size();
+    _position_encoder.Encode(_positions, key_frame, _buffer);
+    _buffer.WriteAt(size_offset, static_cast<uint32_t>(_buffer.size() - begin));
+  }
+
+  void FrameBuilder::EndFrame(const double delta_seconds) {
+    if (_frame.id == 0u) {
+      _frame.elapsed = 0.0;
+      _frame.duration = 0.0;
+    } else {
+      _frame.duration = delta_seconds;
+      _frame.elapsed += delta_seconds;
+    }
+    ++_frame.id;
+
+    // The duration of the previous frame is this frame's delta.
+    if (_last_frame_duration > 0u) {
+      _buffer.WriteAt(_last_frame_duration, _frame.duration);
+    }
+
+    _last_frame_begin = _buffer.size();
+    // Readers seeking to a keyframe start decoding the positions there.
+    const bool key_frame = _index.AddFrame(_frame, GetFileOffset());
+    WritePacketHeader(PacketId::FrameStart, sizeof(Frame));
+    _buffer.Write(_frame.id);
+    _last_frame_duration = _buffer.size();
+    _buffer.Write(-1.0);
+    _buffer.Write(_frame.elapsed);
+
+    WriteVariableSizePackets(PacketId::EventAdd, _events_add);
+    WriteVariableSizePackets(PacketId::EventDel, _events_del);
+    WriteVariableSizePackets(PacketId::EventParent, _events_parent);
+    WriteFixedSizePackets(PacketId::Collision, _collisions);
+    if (_position_encoder.GetEncoding().compact) {
+      WriteCompactPositions(key_frame);
+    } else {
+      WriteFixedSizePackets(PacketId::Position, _positions);
+    }
+    WriteFixedSizePackets(PacketId::State, _states);
+
+    WritePacketHeader(PacketId::FrameEnd, 0u);
+
+    Clear();
+  }
+
+  void FrameBuilder::WriteIndex() {
+    _index.GetIndex().Write(_buffer, GetFileOffset());
+    // The last frame is complete, its duration stays unknown.
+    _last_frame_begin = _buffer.size();
+    _last_frame_duration = 0u;
+  }
+
+  void FrameBuilder::TakeCompleted(OutputBuffer &buffer) {
+    buffer.clear();
+    if (_last_frame_begin == 0u) {
+      return;
+    }
+    buffer.swap(_buffer);
+    // Move the last frame back, it is small compared to the completed ones.
+    _buffer.Write(buffer.data() + _last_frame_begin, buffer.size() - _last_frame_begin);
+    buffer.resize(_last_frame_begin);
+    _bytes_taken += buffer.size();
+    if (_last_frame_duration > 0u) {
+      _last_frame_duration -= _last_frame_begin;
+    }
+    _last_frame_begin = 0u;
+  }
+
+  void FrameBuilder::TakeAll(OutputBuffer &buffer) {
+    buffer.clear();
+    buffer.swap(_buffer);
+    _bytes_taken += buffer.size();
+    _last_frame_begin = 0u;
+    _last_frame_duration = 0u;
+  }
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,172 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/BinaryStream.h"
+#include "carla/recorder/FrameIndex.h"
+#include "carla/recorder/Packets.h"
+#include "carla/recorder/PositionCodec.h"
+
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Collects the packets of the current frame and serializes each finished
+  /// frame into a byte buffer, ready to be handed to a writer.
+  ///
+  /// The duration of a frame is only known when the next one starts, so the
+  /// last frame serialized is kept in the buffer until then; TakeCompleted
+  /// hands out everything before it and swaps in the caller's (empty) buffer,
+  /// so in steady state no memory is allocated.
+  ///
+  /// The position of each frame in the file is tracked to build the frame
+  /// index written by WriteIndex at the end of the recording.
+  class FrameBuilder : private NonCopyable {
+  public:
+
+    explicit FrameBuilder(size_t initial_capacity = 0u);
+
+    /// Discard any packet and serialized data, and restart the frame count.
+    void Reset();
+
+    /// Set how the positions of the next frames are written, by default as
+    /// Position packets.
+    void SetPositionEncoding(const PositionEncoding &encoding) {
+      _position_encoder.Reset(encoding);
+    }
+
+    const PositionEncoding &GetPositionEncoding() const {
+      return _position_encoder.GetEncoding();
+    }
+
+    /// Serialize the file header, must be called before the first frame.
+    void WriteInfo(const Info &info);
+
+    /// @name Packets of the current frame
+    /// @{
+
+    void Add(const EventAdd &event) {
+      _events_add.emplace_back(event);
+    }
+
+    void Add(EventAdd &&event) {
+      _events_add.emplace_back(std::move(event));
+    }
+
+    void Add(const EventDel &event) {
+      _events_del.emplace_back(event);
+    }
+
+    void Add(const EventParent &event) {
+      _events_parent.emplace_back(event);
+    }
+
+    /// Collisions between the same pair of actors are only added once per
+    /// frame.
+    void Add(const Collision &collision);
+
+    void Add(const Position &position) {
+      _positions.emplace_back(position);
+    }
+
+    void Add(const StateTrafficLight &state) {
+      _states.emplace_back(state);
+    }
+
+    /// Discard the packets added to the current frame.
+    void Clear();
+
+    /// @}
+
+    /// Serialize the packets of the current frame, @a delta_seconds after the
+    /// previous one, and clear them.
+    void EndFrame(double delta_seconds);
+
+    /// Number of serialized bytes that TakeCompleted would return.
+    size_t GetCompletedSize() const {
+      return _last_frame_begin;
+    }
+
+    /// Number of serialized bytes, including the last frame.
+    size_t GetSize() const {
+      return _buffer.size();
+    }
+
+    uint64_t GetFrameCount() const {
+      return _frame.id;
+    }
+
+    /// Serialize the frame index after the last frame. No frame can be added
+    /// afterwards until the builder is reset.
+    void WriteIndex();
+
+    const FrameIndex &GetIndex() const {
+      return _index.GetIndex();
+    }
+
+    /// Move the serialized bytes except the last frame into @a buffer,
+    /// exchanging memory with it. The content of @a buffer is discarded.
+    void TakeCompleted(OutputBuffer &buffer);
+
+    /// Move every serialized byte into @a buffer, including the last frame
+    /// that keeps an unknown duration. Used when the recording stops.
+    void TakeAll(OutputBuffer &buffer);
+
+  private:
+
+    template <typename T>
+    void WriteFixedSizePackets(PacketId id, const std::vector<T> &records);
+
+    template <typename T>
+    void WriteVariableSizePackets(PacketId id, const std::vector<T> &records);
+
+    void WriteCompactPositions(bool key_frame);
+
+    /// Offset in the file of the next byte serialized.
+    uint64_t GetFileOffset() const {
+      return _bytes_taken + _buffer.size();
+    }
+
+    void WritePacketHeader(PacketId id, uint32_t size) {
+      _buffer.Write(static_cast<char>(id));
+      _buffer.Write(size);
+    }
+
+    OutputBuffer _buffer;
+
+    /// Number of bytes handed out by TakeCompleted and TakeAll.
+    uint64_t _bytes_taken = 0u;
+
+    FrameIndexBuilder _index;
+
+    PositionEncoder _position_encoder;
+
+    Frame _frame;
+
+    /// Offset in _buffer of the last frame serialized.
+    size_t _last_frame_begin = 0u;
+
+    /// Offset in _buffer of the duration of the last frame, zero if none.
+    size_t _last_frame_duration = 0u;
+
+    std::vector<EventAdd> _events_add;
+
+    std::vector<EventDel> _events_del;
+
+    std::vector<EventParent> _events_parent;
+
+    std::vector<Collision> _collisions;
+
+    std::vector<Position> _positions;
+
+    std::vector<StateTrafficLight> _states;
+  };
+
+} // namespace recorder
+} // namespace carla
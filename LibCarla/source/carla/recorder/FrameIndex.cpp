@@ -0,0 +1,275 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/FrameIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace carla {
+namespace recorder {
+
+  constexpr const char *FrameIndex::Magic;
+
+  constexpr double FrameIndexBuilder::DefaultKeyframeInterval;
+
+  // ===========================================================================
+  // -- Local helpers ----------------------------------------------------------
+  // ===========================================================================
+
+  constexpr size_t PacketHeaderSize = sizeof(char) + sizeof(uint32_t);
+
+  template <typename T>
+  static void WriteArray(OutputBuffer &out, const std::vector<T> &items) {
+    out.Write(static_cast<uint32_t>(items.size()));
+    out.Write(items.data(), items.size() * sizeof(T));
+  }
+
+  /// Same as InputBuffer::Read but returns false instead of throwing, the
+  /// index of a damaged file is ignored rather than aborting the reader.
+  template <typename T>
+  static bool ReadArray(InputBuffer &in, std::vector<T> &items) {
+    if (in.GetRemaining() < sizeof(uint32_t)) {
+      return false;
+    }
+    const auto count = in.Read<uint32_t>();
+    if (count > in.GetRemaining() / sizeof(T)) {
+      return false;
+    }
+    items.resize(count);
+    in.Read(items.data(), count * sizeof(T));
+    return true;
+  }
+
+  template <typename T>
+  static bool ReadValue(std::istream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  static bool SkipString(std::istream &file) {
+    uint16_t length;
+    return ReadValue(file, length) && file.seekg(length, std::ios::cur);
+  }
+
+  /// Skip the Info header at the beginning of a recorder file.
+  static bool SkipInfo(std::istream &file) {
+    uint16_t version;
+    int64_t date;
+    return
+        ReadValue(file, version) &&
+        SkipString(file) &&
+        ReadValue(file, date) &&
+        SkipString(file);
+  }
+
+  /// Read the payload of the FrameIndex packet the footer of @a file points
+  /// to.
+  static bool ReadIndexPayload(std::istream &file, std::vector<unsigned char> &payload) {
+    if (!file.seekg(0, std::ios::end)) {
+      return false;
+    }
+    const auto file_size = static_cast<uint64_t>(file.tellg());
+    if (file_size < PacketHeaderSize + sizeof(FrameIndexFooter)) {
+      return false;
+    }
+    FrameIndexFooter footer;
+    file.seekg(static_cast<std::streamoff>(file_size - sizeof(FrameIndexFooter)));
+    if (!ReadValue(file, footer) ||
+        (std::memcmp(footer.magic, FrameIndex::Magic, sizeof(footer.magic)) != 0u) ||
+        (footer.offset > file_size - PacketHeaderSize - sizeof(FrameIndexFooter))) {
+      return false;
+    }
+    char id;
+    uint32_t size;
+    file.seekg(static_cast<std::streamoff>(footer.offset));
+    if (!ReadValue(file, id) ||
+        !ReadValue(file, size) ||
+        (id != static_cast<char>(PacketId::FrameIndex)) ||
+        (footer.offset + PacketHeaderSize + size != file_size)) {
+      return false;
+    }
+    payload.resize(size);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(payload.data()), size));
+  }
+
+  // ===========================================================================
+  // -- FrameIndex -------------------------------------------------------------
+  // ===========================================================================
+
+  void FrameIndex::clear() {
+    _frames.clear();
+    _actors.clear();
+    _keyframes.clear();
+  }
+
+  size_t FrameIndex::FindFrame(const double elapsed) const {
+    const auto it = std::upper_bound(
+        _frames.begin(),
+        _frames.end(),
+        elapsed,
+        [](double value, const FrameIndexEntry &entry) { return value < entry.elapsed; });
+    return it == _frames.begin() ? 0u : static_cast<size_t>(it - _frames.begin()) - 1u;
+  }
+
+  const Keyframe *FrameIndex::FindKeyframe(const double elapsed) const {
+    const auto it = std::upper_bound(
+        _keyframes.begin(),
+        _keyframes.end(),
+        elapsed,
+        [this](double value, const Keyframe &keyframe) {
+          return value < _frames[keyframe.frame].elapsed;
+        });
+    return it == _keyframes.begin() ? nullptr : &*(it - 1);
+  }
+
+  void FrameIndex::Write(OutputBuffer &out, const uint64_t offset) const {
+    const auto size_offset = out.size() + sizeof(char);
+    out.Write(static_cast<char>(PacketId::FrameIndex));
+    out.Write(uint32_t(0u));
+    const auto begin = out.size();
+    WriteArray(out, _frames);
+    WriteArray(out, _actors);
+    out.Write(static_cast<uint32_t>(_keyframes.size()));
+    for (auto &keyframe : _keyframes) {
+      out.Write(keyframe.frame);
+      WriteArray(out, keyframe.actors);
+      WriteArray(out, keyframe.parents);
+    }
+    FrameIndexFooter footer;
+    footer.offset = offset;
+    std::memcpy(footer.magic, Magic, sizeof(footer.magic));
+    out.Write(footer);
+    out.WriteAt(size_offset, static_cast<uint32_t>(out.size() - begin));
+  }
+
+  bool FrameIndex::Read(InputBuffer &in) {
+    clear();
+    bool result = ReadArray(in, _frames) && ReadArray(in, _actors);
+    uint32_t total = 0u;
+    if (result && (in.GetRemaining() >= sizeof(uint32_t))) {
+      total = in.Read<uint32_t>();
+    } else {
+      result = false;
+    }
+    for (auto i = 0u; result && (i < total); ++i) {
+      Keyframe keyframe;
+      result =
+          (in.GetRemaining() >= sizeof(uint32_t)) &&
+          ((keyframe.frame = in.Read<uint32_t>()) < _frames.size()) &&
+          ReadArray(in, keyframe.actors) &&
+          ReadArray(in, keyframe.parents) &&
+          std::all_of(keyframe.actors.begin(), keyframe.actors.end(), [this](uint32_t actor) {
+            return actor < _actors.size();
+          });
+      _keyframes.emplace_back(std::move(keyframe));
+    }
+    if (!result) {
+      clear();
+    }
+    return result;
+  }
+
+  bool FrameIndex::ReadFooter(std::istream &file) {
+    clear();
+    file.clear();
+    const auto position = file.tellg();
+    std::vector<unsigned char> payload;
+    bool result = ReadIndexPayload(file, payload);
+    if (result) {
+      // The footer is part of the payload.
+      InputBuffer in(payload.data(), payload.size() - sizeof(FrameIndexFooter));
+      result = Read(in) && in.IsAtEnd();
+    }
+    file.clear();
+    file.seekg(position);
+    return result;
+  }
+
+  bool FrameIndex::Scan(std::istream &file) {
+    clear();
+    file.clear();
+    const auto position = file.tellg();
+    file.seekg(0, std::ios::beg);
+    const bool result = SkipInfo(file);
+    while (result) {
+      const auto offset = static_cast<uint64_t>(file.tellg());
+      char id;
+      uint32_t size;
+      if (!ReadValue(file, id) ||
+          !ReadValue(file, size) ||
+          (id == static_cast<char>(PacketId::FrameIndex))) {
+        break;
+      }
+      if ((id == static_cast<char>(PacketId::FrameStart)) && (size == sizeof(Frame))) {
+        Frame frame;
+        if (!ReadValue(file, frame)) {
+          break;
+        }
+        _frames.push_back(FrameIndexEntry{frame.id, frame.elapsed, offset});
+      } else if (!file.seekg(size, std::ios::cur)) {
+        break;
+      }
+    }
+    file.clear();
+    file.seekg(position);
+    return result;
+  }
+
+  // ===========================================================================
+  // -- FrameIndexBuilder ------------------------------------------------------
+  // ===========================================================================
+
+  void FrameIndexBuilder::Reset() {
+    _index.clear();
+    _next_keyframe = 0.0;
+    _alive.clear();
+    _parents.clear();
+  }
+
+  bool FrameIndexBuilder::AddFrame(const Frame &frame, const uint64_t offset) {
+    _index._frames.push_back(FrameIndexEntry{frame.id, frame.elapsed, offset});
+    if (frame.elapsed < _next_keyframe) {
+      return false;
+    }
+    _next_keyframe = (std::floor(frame.elapsed / _keyframe_interval) + 1.0) * _keyframe_interval;
+    // The keyframe holds the actors created by the previous frames, the
+    // events of this frame are replayed with the frame itself.
+    Keyframe keyframe;
+    keyframe.frame = static_cast<uint32_t>(_index._frames.size() - 1u);
+    keyframe.actors.reserve(_alive.size());
+    for (auto &item : _alive) {
+      keyframe.actors.push_back(item.second);
+    }
+    std::sort(keyframe.actors.begin(), keyframe.actors.end());
+    for (auto &item : _parents) {
+      if ((_alive.count(item.first) > 0u) && (_alive.count(item.second) > 0u)) {
+        keyframe.parents.push_back(EventParent{item.first, item.second});
+      }
+    }
+    std::sort(keyframe.parents.begin(), keyframe.parents.end(), [](const EventParent &lhs, const EventParent &rhs) {
+      return lhs.database_id < rhs.database_id;
+    });
+    _index._keyframes.emplace_back(std::move(keyframe));
+    return true;
+  }
+
+  void FrameIndexBuilder::AddEvent(const EventAdd &event, const uint64_t offset) {
+    _alive[event.database_id] = static_cast<uint32_t>(_index._actors.size());
+    _index._actors.push_back(offset);
+  }
+
+  void FrameIndexBuilder::AddEvent(const EventDel &event, uint64_t) {
+    _alive.erase(event.database_id);
+    _parents.erase(event.database_id);
+  }
+
+  void FrameIndexBuilder::AddEvent(const EventParent &event, uint64_t) {
+    _parents[event.database_id] = event.database_id_parent;
+  }
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,184 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/recorder/BinaryStream.h"
+#include "carla/recorder/Packets.h"
+
+#include <cstdint>
+#include <istream>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+#pragma pack(push, 1)
+
+  /// Position of a frame in a recorder file.
+  struct FrameIndexEntry {
+    uint64_t id;
+    double elapsed;
+    /// Offset in the file of the FrameStart packet.
+    uint64_t offset;
+  };
+
+  /// Last bytes of a file with an index, points to the FrameIndex packet.
+  struct FrameIndexFooter {
+    uint64_t offset;
+    char magic[8u];
+  };
+
+#pragma pack(pop)
+
+  static_assert(sizeof(FrameIndexEntry) == 24u, "Invalid frame index entry size.");
+  static_assert(sizeof(FrameIndexFooter) == 16u, "Invalid frame index footer size.");
+
+  /// Actors alive at the start of a frame, enough to start replaying from
+  /// that frame without processing the events of the previous ones.
+  struct Keyframe {
+    /// Position of the frame in FrameIndex::GetFrames.
+    uint32_t frame;
+    /// Position in FrameIndex::GetActorOffsets of each actor alive, in
+    /// creation order.
+    std::vector<uint32_t> actors;
+    /// Parent of each actor attached to another, sorted by actor id.
+    std::vector<EventParent> parents;
+  };
+
+  /// Frame index written at the end of a recorder file: the elapsed time and
+  /// offset of every frame, so a reader can binary-search the frame to start
+  /// from, and periodic keyframes with the actors alive.
+  ///
+  /// The index is stored as a FrameIndex packet after the last frame, readers
+  /// unaware of it skip it as any other unknown packet. The packet payload
+  /// ends with a FrameIndexFooter, so it can be found from the end of the
+  /// file.
+  class FrameIndex {
+  public:
+
+    /// Value of FrameIndexFooter::magic.
+    static constexpr const char *Magic = "CARLAIDX";
+
+    bool empty() const {
+      return _frames.empty();
+    }
+
+    void clear();
+
+    const std::vector<FrameIndexEntry> &GetFrames() const {
+      return _frames;
+    }
+
+    /// Offset in the file of the EventAdd record of every actor created
+    /// during the recording.
+    const std::vector<uint64_t> &GetActorOffsets() const {
+      return _actors;
+    }
+
+    const std::vector<Keyframe> &GetKeyframes() const {
+      return _keyframes;
+    }
+
+    /// Elapsed time of the last frame.
+    double GetDuration() const {
+      return _frames.empty() ? 0.0 : _frames.back().elapsed;
+    }
+
+    /// Position in GetFrames of the frame being played @a elapsed seconds
+    /// after the start, i.e. the last one starting at or before that time.
+    size_t FindFrame(double elapsed) const;
+
+    /// Last keyframe at or before @a elapsed seconds, nullptr if none.
+    const Keyframe *FindKeyframe(double elapsed) const;
+
+    /// Serialize the index as a FrameIndex packet, including the footer.
+    /// @a offset is the position in the file the packet is written at.
+    void Write(OutputBuffer &out, uint64_t offset) const;
+
+    /// Parse the payload of a FrameIndex packet. Return false, leaving the
+    /// index empty, if the payload is not valid.
+    bool Read(InputBuffer &in);
+
+    /// Read the index at the end of the recorder file @a file. Return false
+    /// if the file has no (valid) index. The read position of @a file is
+    /// restored.
+    bool ReadFooter(std::istream &file);
+
+    /// Fallback for files without an index: build the frame entries by
+    /// reading every frame header of @a file, without keyframes. The read
+    /// position of @a file is restored.
+    bool Scan(std::istream &file);
+
+    /// Read the index of @a file, or build it by scanning the file if it has
+    /// none.
+    bool Load(std::istream &file) {
+      return ReadFooter(file) || Scan(file);
+    }
+
+  private:
+
+    friend class FrameIndexBuilder;
+
+    std::vector<FrameIndexEntry> _frames;
+
+    std::vector<uint64_t> _actors;
+
+    std::vector<Keyframe> _keyframes;
+  };
+
+  /// Builds the FrameIndex of a recording while its frames are serialized,
+  /// keeping track of the actors alive to take a keyframe every
+  /// keyframe interval seconds.
+  class FrameIndexBuilder {
+  public:
+
+    static constexpr double DefaultKeyframeInterval = 10.0;
+
+    explicit FrameIndexBuilder(double keyframe_interval = DefaultKeyframeInterval)
+      : _keyframe_interval(keyframe_interval) {}
+
+    void Reset();
+
+    /// A new frame starts at @a offset in the file, must be called before
+    /// adding the events of the frame. Return whether a keyframe is taken at
+    /// this frame.
+    bool AddFrame(const Frame &frame, uint64_t offset);
+
+    /// @name Events of the current frame
+    /// @{
+
+    /// @a offset is the position in the file of the EventAdd record.
+    void AddEvent(const EventAdd &event, uint64_t offset);
+
+    void AddEvent(const EventDel &event, uint64_t offset);
+
+    void AddEvent(const EventParent &event, uint64_t offset);
+
+    /// @}
+
+    const FrameIndex &GetIndex() const {
+      return _index;
+    }
+
+  private:
+
+    const double _keyframe_interval;
+
+    FrameIndex _index;
+
+    double _next_keyframe = 0.0;
+
+    /// Actor id to position in FrameIndex::_actors.
+    std::unordered_map<uint32_t, uint32_t> _alive;
+
+    /// Actor id to parent id.
+    std::unordered_map<uint32_t, uint32_t> _parents;
+  };
+
+} // namespace recorder
+} // namespace carla
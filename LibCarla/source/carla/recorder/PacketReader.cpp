@@ -0,0 +1,72 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/PacketReader.h"
+
+#include <algorithm>
+
+namespace carla {
+namespace recorder {
+
+  template <typename T>
+  static bool ReadValue(std::istream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  template <typename T>
+  bool PacketReader::ReadVariableSizeRecord(
+      std::istream &file,
+      const uint64_t offset,
+      T &record) {
+    file.clear();
+    if (!file.seekg(0, std::ios::end)) {
+      return false;
+    }
+    const auto file_size = static_cast<uint64_t>(file.tellg());
+    if (offset >= file_size) {
+      return false;
+    }
+    // The size of the record is unknown, read larger blocks until it fits.
+    const auto remaining = file_size - offset;
+    for (uint64_t length = 4096u; ; length *= 4u) {
+      length = std::min(length, remaining);
+      _payload.resize(length);
+      file.seekg(static_cast<std::streamoff>(offset));
+      if (!file.read(reinterpret_cast<char *>(_payload.data()), static_cast<std::streamsize>(length))) {
+        return false;
+      }
+      auto in = MakeInput();
+      recorder::Read(in, record);
+      if (in.IsValid()) {
+        // Leave the file right after the record.
+        file.seekg(static_cast<std::streamoff>(offset + in.GetOffset()));
+        return true;
+      }
+      if (length == remaining) {
+        return false;
+      }
+    }
+  }
+
+  bool PacketReader::ReadInfo(std::istream &file, Info &info) {
+    return ReadVariableSizeRecord(file, 0u, info);
+  }
+
+  bool PacketReader::ReadHeader(std::istream &file) {
+    return ReadValue(file, _id) && ReadValue(file, _size);
+  }
+
+  bool PacketReader::ReadPayload(std::istream &file) {
+    _payload.resize(_size);
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(_payload.data()), _size));
+  }
+
+  bool PacketReader::ReadRecordAt(std::istream &file, const uint64_t offset, EventAdd &event) {
+    return ReadVariableSizeRecord(file, offset, event);
+  }
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,104 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/BinaryStream.h"
+#include "carla/recorder/Packets.h"
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Reads a recorder file one packet at a time. The payload of each packet
+  /// is loaded in memory and parsed with the Read functions of Packets.h.
+  ///
+  /// Never throws, so it can be used by the simulator: functions return
+  /// false if the file ends in the middle of a packet or a payload is not
+  /// valid.
+  class PacketReader : private NonCopyable {
+  public:
+
+    /// Read the Info header at the beginning of @a file.
+    bool ReadInfo(std::istream &file, Info &info);
+
+    /// Read the header of the next packet of @a file. Return false at the end
+    /// of the file.
+    bool ReadHeader(std::istream &file);
+
+    PacketId GetPacketId() const {
+      return static_cast<PacketId>(_id);
+    }
+
+    uint32_t GetPacketSize() const {
+      return _size;
+    }
+
+    /// Skip the payload of the current packet.
+    void SkipPacket(std::istream &file) {
+      file.seekg(_size, std::ios::cur);
+    }
+
+    /// Read the payload of the current packet as a single record.
+    template <typename T>
+    bool Read(std::istream &file, T &record) {
+      if (!ReadPayload(file)) {
+        return false;
+      }
+      auto in = MakeInput();
+      recorder::Read(in, record);
+      return in.IsValid() && in.IsAtEnd();
+    }
+
+    /// Read the payload of the current packet as a list of records: their
+    /// number (2 bytes) followed by the records. @a records is left empty if
+    /// the payload is not valid.
+    template <typename T>
+    bool ReadList(std::istream &file, std::vector<T> &records) {
+      records.clear();
+      if (!ReadPayload(file)) {
+        return false;
+      }
+      auto in = MakeInput();
+      records.resize(in.Read<uint16_t>());
+      for (auto &record : records) {
+        recorder::Read(in, record);
+      }
+      if (!in.IsValid() || !in.IsAtEnd()) {
+        records.clear();
+        return false;
+      }
+      return true;
+    }
+
+    /// Read the EventAdd record at @a offset of @a file, as pointed by
+    /// FrameIndex::GetActorOffsets.
+    bool ReadRecordAt(std::istream &file, uint64_t offset, EventAdd &event);
+
+  private:
+
+    bool ReadPayload(std::istream &file);
+
+    template <typename T>
+    bool ReadVariableSizeRecord(std::istream &file, uint64_t offset, T &record);
+
+    InputBuffer MakeInput() const {
+      return InputBuffer{_payload.data(), _payload.size(), false};
+    }
+
+    uint8_t _id = 0u;
+
+    uint32_t _size = 0u;
+
+    std::vector<unsigned char> _payload;
+  };
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,60 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/Packets.h"
+
+namespace carla {
+namespace recorder {
+
+  void Write(OutputBuffer &out, const Info &info) {
+    out.Write(info.version);
+    out.WriteString(info.magic);
+    out.Write(info.date);
+    out.WriteString(info.map_file);
+  }
+
+  void Read(InputBuffer &in, Info &info) {
+    in.Read(info.version);
+    in.ReadString(info.magic);
+    in.Read(info.date);
+    in.ReadString(info.map_file);
+  }
+
+  void Write(OutputBuffer &out, const EventAdd &event) {
+    out.Write(event.database_id);
+    out.Write(event.type);
+    out.Write(event.location);
+    out.Write(event.rotation);
+    out.Write(event.description.uid);
+    out.WriteString(event.description.id);
+    const auto total = static_cast<uint16_t>(event.description.attributes.size());
+    out.Write(total);
+    for (auto i = 0u; i < total; ++i) {
+      const auto &attribute = event.description.attributes[i];
+      out.Write(attribute.type);
+      out.WriteString(attribute.id);
+      out.WriteString(attribute.value);
+    }
+  }
+
+  void Read(InputBuffer &in, EventAdd &event) {
+    in.Read(event.database_id);
+    in.Read(event.type);
+    in.Read(event.location);
+    in.Read(event.rotation);
+    in.Read(event.description.uid);
+    in.ReadString(event.description.id);
+    const auto total = in.Read<uint16_t>();
+    event.description.attributes.resize(total);
+    for (auto &attribute : event.description.attributes) {
+      in.Read(attribute.type);
+      in.ReadString(attribute.id);
+      in.ReadString(attribute.value);
+    }
+  }
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,136 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/Vector3D.h"
+#include "carla/recorder/BinaryStream.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Identifies each packet of a recorder file. Every packet is written as
+  /// the id (1 byte), the size of its payload in bytes (4 bytes) and the
+  /// payload. The FrameIndex packet, if any, is the last one of the file.
+  enum class PacketId : uint8_t {
+    FrameStart = 0,
+    FrameEnd,
+    EventAdd,
+    EventDel,
+    EventParent,
+    Collision,
+    Position,
+    State,
+    FrameIndex,
+    PositionCompact
+  };
+
+  /// Header of the file, written before the first packet.
+  struct Info {
+    uint16_t version;
+    std::string magic;
+    int64_t date;
+    std::string map_file;
+  };
+
+#pragma pack(push, 1)
+
+  struct Frame {
+    uint64_t id;
+    double duration;
+    double elapsed;
+  };
+
+  struct Collision {
+    uint32_t id;
+    uint32_t database_id1;
+    uint32_t database_id2;
+    bool is_actor1_hero;
+    bool is_actor2_hero;
+  };
+
+  struct Position {
+    uint32_t database_id;
+    geom::Vector3D location;
+    geom::Vector3D rotation;
+  };
+
+  struct StateTrafficLight {
+    uint32_t database_id;
+    bool is_frozen;
+    float elapsed_time;
+    char state;
+  };
+
+#pragma pack(pop)
+
+  static_assert(sizeof(Frame) == 24u, "Invalid frame packet size.");
+  static_assert(sizeof(Collision) == 14u, "Invalid collision packet size.");
+  static_assert(sizeof(Position) == 28u, "Invalid position packet size.");
+  static_assert(sizeof(StateTrafficLight) == 10u, "Invalid traffic light state packet size.");
+
+  struct ActorAttribute {
+    /// rpc::ActorAttributeType.
+    uint8_t type;
+    std::string id;
+    std::string value;
+  };
+
+  struct ActorDescription {
+    uint32_t uid;
+    std::string id;
+    std::vector<ActorAttribute> attributes;
+  };
+
+  struct EventAdd {
+    uint32_t database_id;
+    uint8_t type;
+    geom::Vector3D location;
+    geom::Vector3D rotation;
+    ActorDescription description;
+  };
+
+  struct EventDel {
+    uint32_t database_id;
+  };
+
+  struct EventParent {
+    uint32_t database_id;
+    uint32_t database_id_parent;
+  };
+
+  /// @name Serialization of the records with variable size
+  /// @{
+
+  void Write(OutputBuffer &out, const Info &info);
+  void Read(InputBuffer &in, Info &info);
+
+  void Write(OutputBuffer &out, const EventAdd &event);
+  void Read(InputBuffer &in, EventAdd &event);
+
+  /// @}
+
+  /// @name Serialization of the fixed size records, written as raw bytes
+  /// @{
+
+  template <typename T>
+  static inline void Write(OutputBuffer &out, const T &record) {
+    out.Write(record);
+  }
+
+  template <typename T>
+  static inline void Read(InputBuffer &in, T &record) {
+    in.Read(record);
+  }
+
+  /// @}
+
+} // namespace recorder
+} // namespace carla
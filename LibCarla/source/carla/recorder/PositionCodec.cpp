@@ -0,0 +1,288 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/PositionCodec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace carla {
+namespace recorder {
+
+  // ===========================================================================
+  // -- Local helpers ----------------------------------------------------------
+  // ===========================================================================
+
+  /// Bits of the flags of the payload.
+  constexpr uint8_t KeyFrame = 1u << 0u;
+  constexpr uint8_t Compressed = 1u << 1u;
+
+  /// Size of the fixed part of the payload.
+  constexpr size_t HeaderSize = sizeof(uint8_t) + 2u * sizeof(float) + sizeof(uint16_t);
+
+  /// Smaller payloads are not worth compressing.
+  constexpr size_t MinCompressedSize = 64u;
+
+  /// Largest size of a position: id and six values, each up to 10 bytes.
+  constexpr size_t MaxEncodedSize = 7u * 10u;
+
+  static inline int64_t Quantize(const float value, const float precision) {
+    return std::llround(static_cast<double>(value) / static_cast<double>(precision));
+  }
+
+  static inline float Dequantize(const int64_t value, const float precision) {
+    return static_cast<float>(static_cast<double>(value) * static_cast<double>(precision));
+  }
+
+  static inline unsigned char *WriteVarint(unsigned char *it, const int64_t value) {
+    // Zig-zag, small negative values become small positive values.
+    auto bits = (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63u);
+    while (bits >= 0x80u) {
+      *it++ = static_cast<unsigned char>(bits | 0x80u);
+      bits >>= 7u;
+    }
+    *it++ = static_cast<unsigned char>(bits);
+    return it;
+  }
+
+  static inline bool ReadVarint(const unsigned char *&it, const unsigned char *end, int64_t &value) {
+    uint64_t bits = 0u;
+    for (auto shift = 0u; shift < 64u; shift += 7u) {
+      if (it == end) {
+        return false;
+      }
+      const auto byte = *it++;
+      bits |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+      if ((byte & 0x80u) == 0u) {
+        value = static_cast<int64_t>(bits >> 1u) ^ -static_cast<int64_t>(bits & 1u);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static inline bool IsValidPrecision(const float precision) {
+    return std::isfinite(precision) && (precision > 0.0f);
+  }
+
+  // ===========================================================================
+  // -- PositionHistory --------------------------------------------------------
+  // ===========================================================================
+
+namespace detail {
+
+  void PositionHistory::clear() {
+    _previous.clear();
+    _current.clear();
+    _lookup.clear();
+    _has_lookup = false;
+  }
+
+  const QuantizedPosition *PositionHistory::Find(const size_t index, const uint32_t database_id) {
+    if ((index < _previous.size()) && (_previous[index].database_id == database_id)) {
+      return &_previous[index];
+    }
+    if (!_has_lookup) {
+      _lookup.clear();
+      for (auto i = 0u; i < _previous.size(); ++i) {
+        _lookup.emplace(_previous[i].database_id, i);
+      }
+      _has_lookup = true;
+    }
+    const auto it = _lookup.find(database_id);
+    return it != _lookup.end() ? &_previous[it->second] : nullptr;
+  }
+
+  void PositionHistory::EndFrame() {
+    _previous.swap(_current);
+    _current.clear();
+    _has_lookup = false;
+  }
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- PositionEncoder --------------------------------------------------------
+  // ===========================================================================
+
+  PositionEncoder::PositionEncoder(const PositionEncoding &encoding) {
+    Reset(encoding);
+  }
+
+  void PositionEncoder::Reset(const PositionEncoding &encoding) {
+    DEBUG_ASSERT(IsValidPrecision(encoding.location_precision));
+    DEBUG_ASSERT(IsValidPrecision(encoding.rotation_precision));
+    _encoding = encoding;
+    _history.clear();
+    _needs_key_frame = true;
+  }
+
+  void PositionEncoder::Encode(
+      const std::vector<Position> &positions,
+      bool key_frame,
+      OutputBuffer &out) {
+    const auto total = static_cast<uint16_t>(positions.size());
+    key_frame = key_frame || _needs_key_frame;
+    _needs_key_frame = false;
+    if (key_frame) {
+      _history.clear();
+    }
+    _raw.resize(total * MaxEncodedSize);
+    auto *it = _raw.data();
+    uint32_t previous_id = 0u;
+    for (auto i = 0u; i < total; ++i) {
+      const auto &position = positions[i];
+      auto &quantized = _history.Add();
+      quantized.database_id = position.database_id;
+      quantized.values[0u] = Quantize(position.location.x, _encoding.location_precision);
+      quantized.values[1u] = Quantize(position.location.y, _encoding.location_precision);
+      quantized.values[2u] = Quantize(position.location.z, _encoding.location_precision);
+      quantized.values[3u] = Quantize(position.rotation.x, _encoding.rotation_precision);
+      quantized.values[4u] = Quantize(position.rotation.y, _encoding.rotation_precision);
+      quantized.values[5u] = Quantize(position.rotation.z, _encoding.rotation_precision);
+      it = WriteVarint(it, static_cast<int64_t>(position.database_id) - previous_id);
+      previous_id = position.database_id;
+      const auto *reference = _history.Find(i, position.database_id);
+      for (auto j = 0u; j < 6u; ++j) {
+        it = WriteVarint(it, quantized.values[j] - (reference != nullptr ? reference->values[j] : 0));
+      }
+    }
+    _history.EndFrame();
+    const auto raw_size = static_cast<size_t>(it - _raw.data());
+
+    _compressed.clear();
+    if (raw_size >= MinCompressedSize) {
+      _compressor.Compress(_raw.data(), raw_size, _compressed);
+    }
+    const bool compressed = !_compressed.empty() && (_compressed.size() + sizeof(uint32_t) < raw_size);
+
+    uint8_t flags = 0u;
+    if (key_frame) {
+      flags |= KeyFrame;
+    }
+    if (compressed) {
+      flags |= Compressed;
+    }
+    out.Write(flags);
+    out.Write(_encoding.location_precision);
+    out.Write(_encoding.rotation_precision);
+    out.Write(total);
+    if (compressed) {
+      out.Write(static_cast<uint32_t>(raw_size));
+      out.Write(_compressed.data(), _compressed.size());
+    } else {
+      out.Write(_raw.data(), raw_size);
+    }
+  }
+
+  // ===========================================================================
+  // -- PositionDecoder --------------------------------------------------------
+  // ===========================================================================
+
+  void PositionDecoder::Reset() {
+    _history.clear();
+    _positions.clear();
+    _has_reference = false;
+  }
+
+  bool PositionDecoder::Decode(const unsigned char *data, const size_t size) {
+    if (!DecodePayload(data, size)) {
+      // The next frames cannot be decoded until a key frame.
+      Reset();
+      return false;
+    }
+    return true;
+  }
+
+  bool PositionDecoder::DecodePayload(const unsigned char *data, const size_t size) {
+    _positions.clear();
+    if (size < HeaderSize) {
+      return false;
+    }
+    uint8_t flags;
+    float location_precision;
+    float rotation_precision;
+    uint16_t total;
+    InputBuffer header(data, HeaderSize);
+    header.Read(flags);
+    header.Read(location_precision);
+    header.Read(rotation_precision);
+    header.Read(total);
+    if (!IsValidPrecision(location_precision) || !IsValidPrecision(rotation_precision)) {
+      return false;
+    }
+    if ((flags & KeyFrame) != 0u) {
+      _history.clear();
+    } else if (!_has_reference) {
+      return false;
+    }
+
+    const auto *begin = data + HeaderSize;
+    const auto *end = data + size;
+    if ((flags & Compressed) != 0u) {
+      uint32_t raw_size;
+      if (static_cast<size_t>(end - begin) < sizeof(raw_size)) {
+        return false;
+      }
+      std::memcpy(&raw_size, begin, sizeof(raw_size));
+      begin += sizeof(raw_size);
+      if (raw_size > total * MaxEncodedSize) {
+        return false;
+      }
+      _raw.resize(raw_size);
+      if (!DecompressBlock(begin, static_cast<size_t>(end - begin), _raw.data(), raw_size)) {
+        return false;
+      }
+      begin = _raw.data();
+      end = begin + raw_size;
+    }
+
+    _positions.resize(total);
+    int64_t previous_id = 0;
+    for (auto i = 0u; i < total; ++i) {
+      int64_t id_delta;
+      if (!ReadVarint(begin, end, id_delta)) {
+        return false;
+      }
+      auto &quantized = _history.Add();
+      quantized.database_id = static_cast<uint32_t>(previous_id + id_delta);
+      previous_id = quantized.database_id;
+      const auto *reference = _history.Find(i, quantized.database_id);
+      for (auto j = 0u; j < 6u; ++j) {
+        int64_t delta;
+        if (!ReadVarint(begin, end, delta)) {
+          return false;
+        }
+        quantized.values[j] = delta + (reference != nullptr ? reference->values[j] : 0);
+      }
+      auto &position = _positions[i];
+      position.database_id = quantized.database_id;
+      position.location.x = Dequantize(quantized.values[0u], location_precision);
+      position.location.y = Dequantize(quantized.values[1u], location_precision);
+      position.location.z = Dequantize(quantized.values[2u], location_precision);
+      position.rotation.x = Dequantize(quantized.values[3u], rotation_precision);
+      position.rotation.y = Dequantize(quantized.values[4u], rotation_precision);
+      position.rotation.z = Dequantize(quantized.values[5u], rotation_precision);
+    }
+    if (begin != end) {
+      return false;
+    }
+    _history.EndFrame();
+    _has_reference = true;
+    return true;
+  }
+
+  bool PositionDecoder::Decode(std::istream &in, const size_t size) {
+    _payload.resize(size);
+    if (!in.read(reinterpret_cast<char *>(_payload.data()), static_cast<std::streamsize>(size))) {
+      Reset();
+      return false;
+    }
+    return Decode(_payload.data(), size);
+  }
+
+} // namespace recorder
+} // namespace carla
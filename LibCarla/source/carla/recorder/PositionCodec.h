@@ -0,0 +1,163 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/recorder/BinaryStream.h"
+#include "carla/recorder/Compression.h"
+#include "carla/recorder/Packets.h"
+
+#include <cstdint>
+#include <istream>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// Info::version of the files that may contain PositionCompact packets.
+  constexpr uint16_t CompactPositionsVersion = 2u;
+
+  /// How the positions of each frame are stored in a recorder file.
+  struct PositionEncoding {
+    /// Write PositionCompact packets instead of Position packets. Files with
+    /// compact positions are marked with CompactPositionsVersion.
+    bool compact = false;
+    /// Quantization step of the locations, in the units of the locations
+    /// (centimeters in the files recorded by the simulator).
+    float location_precision = 0.1f;
+    /// Quantization step of the rotations, in degrees.
+    float rotation_precision = 0.01f;
+  };
+
+namespace detail {
+
+  struct QuantizedPosition {
+    uint32_t database_id;
+    int64_t values[6u];
+  };
+
+  /// Quantized positions of the previous frame, the reference of the deltas
+  /// of the current one.
+  class PositionHistory {
+  public:
+
+    void clear();
+
+    /// Position of @a database_id in the previous frame, nullptr if the actor
+    /// was not in it. @a index is the position of the actor in the current
+    /// frame; actors usually come in the same order every frame, so this is
+    /// normally answered without a lookup.
+    const QuantizedPosition *Find(size_t index, uint32_t database_id);
+
+    QuantizedPosition &Add() {
+      _current.emplace_back();
+      return _current.back();
+    }
+
+    /// The positions added become the reference of the next frame.
+    void EndFrame();
+
+  private:
+
+    std::vector<QuantizedPosition> _previous;
+
+    std::vector<QuantizedPosition> _current;
+
+    /// Actor id to position in _previous, built on the first miss.
+    std::unordered_map<uint32_t, uint32_t> _lookup;
+
+    bool _has_lookup = false;
+  };
+
+} // namespace detail
+
+  /// Encodes the positions of each frame as the payload of a PositionCompact
+  /// packet.
+  ///
+  /// Locations and rotations are quantized to fixed-point values with the
+  /// precision of the PositionEncoding, and stored as the difference with the
+  /// quantized value of the same actor in the previous frame (so the error
+  /// does not accumulate), in zig-zag variable-length integers. The result is
+  /// then compressed with a BlockCompressor if it saves space; actors that do
+  /// not move produce runs of zeros that compress very well.
+  ///
+  /// A key frame is encoded without reference to the previous frame, so it
+  /// can be decoded on its own; FrameBuilder encodes a key frame at every
+  /// keyframe of the FrameIndex, readers seeking to a keyframe can start
+  /// decoding there.
+  ///
+  /// Payload layout: flags (1 byte), location and rotation precision (two
+  /// floats), number of positions (2 bytes), then either the variable-length
+  /// integers, or their size (4 bytes) followed by the compressed block.
+  class PositionEncoder {
+  public:
+
+    explicit PositionEncoder(const PositionEncoding &encoding = PositionEncoding{});
+
+    /// Change the encoding, the next frame is encoded as a key frame.
+    void Reset(const PositionEncoding &encoding);
+
+    const PositionEncoding &GetEncoding() const {
+      return _encoding;
+    }
+
+    /// Append the payload encoding @a positions to @a out. The first frame
+    /// after a reset is always a key frame.
+    void Encode(const std::vector<Position> &positions, bool key_frame, OutputBuffer &out);
+
+  private:
+
+    PositionEncoding _encoding;
+
+    detail::PositionHistory _history;
+
+    std::vector<unsigned char> _raw;
+
+    OutputBuffer _compressed;
+
+    BlockCompressor _compressor;
+
+    bool _needs_key_frame = true;
+  };
+
+  /// Decodes the PositionCompact packets written by a PositionEncoder. The
+  /// packets must be decoded in order, starting at a key frame.
+  class PositionDecoder {
+  public:
+
+    /// Forget the previous frame, the next packet must be a key frame.
+    void Reset();
+
+    /// Decode the payload of a PositionCompact packet. Return false if the
+    /// payload is not valid or refers to a frame that was not decoded.
+    bool Decode(const unsigned char *data, size_t size);
+
+    /// Read @a size bytes of payload from @a in and decode them.
+    bool Decode(std::istream &in, size_t size);
+
+    /// Positions of the last packet decoded.
+    const std::vector<Position> &GetPositions() const {
+      return _positions;
+    }
+
+  private:
+
+    bool DecodePayload(const unsigned char *data, size_t size);
+
+    detail::PositionHistory _history;
+
+    std::vector<Position> _positions;
+
+    std::vector<unsigned char> _payload;
+
+    std::vector<unsigned char> _raw;
+
+    bool _has_reference = false;
+  };
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,73 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/Recorder.h"
+
+namespace carla {
+namespace recorder {
+
+  constexpr size_t Recorder::DefaultFlushSize;
+
+  Recorder::Recorder(const size_t flush_size)
+    : _flush_size(flush_size),
+      _builder(flush_size),
+      _buffer(flush_size) {}
+
+  bool Recorder::Start(
+      const std::string &path,
+      const Info &info,
+      const PositionEncoding &encoding) {
+    Stop();
+    if (!_writer.Open(path)) {
+      return false;
+    }
+    _builder.Reset();
+    _builder.SetPositionEncoding(encoding);
+    if (encoding.compact && (info.version < CompactPositionsVersion)) {
+      Info compact_info = info;
+      compact_info.version = CompactPositionsVersion;
+      _builder.WriteInfo(compact_info);
+    } else {
+      _builder.WriteInfo(info);
+    }
+    return true;
+  }
+
+  void Recorder::Stop() {
+    if (!IsRecording()) {
+      return;
+    }
+    _builder.WriteIndex();
+    _builder.TakeAll(_buffer);
+    _writer.Write(_buffer);
+    _writer.Close();
+    _builder.Reset();
+  }
+
+  void Recorder::EndFrame(const double delta_seconds) {
+    if (!IsRecording()) {
+      return;
+    }
+    _builder.EndFrame(delta_seconds);
+    if (_builder.GetCompletedSize() >= _flush_size) {
+      _builder.TakeCompleted(_buffer);
+      _writer.Write(_buffer);
+    }
+  }
+
+  void Recorder::Flush() {
+    if (!IsRecording()) {
+      return;
+    }
+    _builder.TakeCompleted(_buffer);
+    if (!_buffer.empty()) {
+      _writer.Write(_buffer);
+    }
+    _writer.Flush();
+  }
+
+} // namespace recorder
+} // namespace carla
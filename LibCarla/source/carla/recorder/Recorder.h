@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/AsyncFileWriter.h"
+#include "carla/recorder/FrameBuilder.h"
+#include "carla/recorder/Packets.h"
+
+#include <string>
+#include <utility>
+
+namespace carla {
+namespace recorder {
+
+  /// Writes a recorder file, independent of the game engine. The packets of
+  /// each frame are serialized on the calling thread into a memory buffer,
+  /// once the buffer grows beyond the flush size it is handed to a background
+  /// thread that appends it to the file in a single sequential write.
+  class Recorder : private NonCopyable {
+  public:
+
+    static constexpr size_t DefaultFlushSize = 4u * 1024u * 1024u;
+
+    explicit Recorder(size_t flush_size = DefaultFlushSize);
+
+    ~Recorder() {
+      Stop();
+    }
+
+    /// Start recording to the file at @a path, stopping any previous
+    /// recording. Return false if the file cannot be created.
+    bool Start(
+        const std::string &path,
+        const Info &info,
+        const PositionEncoding &encoding = PositionEncoding{});
+
+    /// Write every pending frame and the frame index, and close the file.
+    void Stop();
+
+    bool IsRecording() const {
+      return _writer.IsOpen();
+    }
+
+    template <typename T>
+    void Add(T &&packet) {
+      if (IsRecording()) {
+        _builder.Add(std::forward<T>(packet));
+      }
+    }
+
+    /// Discard the packets added since the previous frame.
+    void Clear() {
+      _builder.Clear();
+    }
+
+    /// Serialize the packets added since the previous frame as a new frame,
+    /// @a delta_seconds after the previous one.
+    void EndFrame(double delta_seconds);
+
+    /// Block until the frames serialized so far, except the last one, are
+    /// written to the operating system.
+    void Flush();
+
+    uint64_t GetFrameCount() const {
+      return _builder.GetFrameCount();
+    }
+
+    uint64_t GetBytesWritten() const {
+      return _writer.GetBytesWritten();
+    }
+
+    /// Whether writing to the file failed at any point of this recording.
+    bool HasFailed() const {
+      return _writer.HasFailed();
+    }
+
+  private:
+
+    const size_t _flush_size;
+
+    FrameBuilder _builder;
+
+    /// Buffer exchanged with the writer.
+    OutputBuffer _buffer;
+
+    AsyncFileWriter _writer;
+  };
+
+} // namespace recorder
+} // namespace carla
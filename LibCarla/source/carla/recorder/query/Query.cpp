@@ -0,0 +1,274 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/query/Query.h"
+
+#include "carla/geom/Math.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace carla {
+namespace recorder {
+namespace query {
+
+  // ===========================================================================
+  // -- Local helpers ----------------------------------------------------------
+  // ===========================================================================
+
+  /// Read the chunks [@a first, @a last) of @a reader, a window of
+  /// @a number_of_threads chunks at a time in parallel, and call
+  /// `merge(chunk_data)` for each one in file order.
+  template <typename F>
+  static void ForEachChunk(
+      const RecordingReader &reader,
+      const size_t first,
+      const size_t last,
+      const ChunkRequest &request,
+      size_t number_of_threads,
+      F &&merge) {
+    if (number_of_threads == 0u) {
+      number_of_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+    }
+    std::vector<ChunkData> window(std::min(number_of_threads, last - first));
+    for (auto begin = first; begin < last; begin += window.size()) {
+      const auto count = std::min(window.size(), last - begin);
+      ParallelFor(count, [&](size_t i, size_t end) {
+        for (; i < end; ++i) {
+          reader.ReadChunk(begin + i, request, window[i]);
+        }
+      }, number_of_threads, 1u);
+      for (auto i = 0u; i < count; ++i) {
+        merge(static_cast<const ChunkData &>(window[i]));
+      }
+    }
+  }
+
+  /// Call `callback(frame, events_begin, collisions_begin, positions_begin)`
+  /// for each frame of @a data.
+  template <typename F>
+  static void ForEachFrame(const ChunkData &data, F &&callback) {
+    uint32_t events = 0u;
+    uint32_t collisions = 0u;
+    uint32_t positions = 0u;
+    for (auto &frame : data.frames) {
+      callback(frame, events, collisions, positions);
+      events = frame.events_end;
+      collisions = frame.collisions_end;
+      positions = frame.positions_end;
+    }
+  }
+
+  static char GetCategory(const uint8_t type) {
+    constexpr char categories[] = {'o', 'v', 'w', 't'};
+    return type < sizeof(categories) ? categories[type] : 'o';
+  }
+
+  static bool MatchesCategory(const char filter, const char category, const bool is_hero) {
+    return (filter == 'a') || (filter == category) || ((filter == 'h') && is_hero);
+  }
+
+  // ===========================================================================
+  // -- Queries ----------------------------------------------------------------
+  // ===========================================================================
+
+  RecordingSummary QuerySummary(const RecordingReader &reader, const size_t number_of_threads) {
+    RecordingSummary summary;
+    summary.path = reader.GetPath();
+    summary.info = reader.GetInfo();
+    summary.has_index = reader.HasIndex();
+    summary.frames = reader.GetIndex().GetFrames().size();
+    summary.duration = reader.GetIndex().GetDuration();
+
+    // Actor id to position in summary.actors, while alive.
+    std::unordered_map<uint32_t, size_t> alive;
+    ChunkRequest request;
+    request.events = true;
+    ForEachChunk(reader, 0u, reader.GetChunks().size(), request, number_of_threads, [&](const ChunkData &data) {
+      ForEachFrame(data, [&](const ChunkFrame &frame, uint32_t events, uint32_t, uint32_t) {
+        for (auto i = events; i < frame.events_end; ++i) {
+          const auto &event = data.events[i];
+          EventRecord record{frame.id, frame.elapsed, EventRecord::Type::Add, event.database_id, 0u};
+          if (event.type == PacketId::EventAdd) {
+            const auto &actor = data.actors[event.value];
+            alive[event.database_id] = summary.actors.size();
+            summary.actors.push_back(ActorRecord{
+                event.database_id,
+                actor.type,
+                actor.type_id,
+                actor.is_hero,
+                frame.elapsed,
+                -1.0});
+          } else if (event.type == PacketId::EventDel) {
+            record.type = EventRecord::Type::Del;
+            const auto it = alive.find(event.database_id);
+            if (it != alive.end()) {
+              summary.actors[it->second].destroyed = frame.elapsed;
+              alive.erase(it);
+            }
+          } else {
+            record.type = EventRecord::Type::Parent;
+            record.parent = event.value;
+          }
+          summary.events.push_back(record);
+        }
+      });
+    });
+    return summary;
+  }
+
+  std::vector<CollisionRecord> QueryCollisions(
+      const RecordingReader &reader,
+      const char category1,
+      const char category2,
+      const size_t number_of_threads) {
+    std::vector<CollisionRecord> result;
+    // Actors of unknown type, as in the simulator, are 'o'.
+    std::unordered_map<uint32_t, char> categories;
+    auto get_category = [&](uint32_t id) {
+      const auto it = categories.find(id);
+      return it != categories.end() ? it->second : 'o';
+    };
+    // Pairs of actors colliding in the previous and the current frame.
+    std::unordered_set<uint64_t> previous;
+    std::unordered_set<uint64_t> current;
+    ChunkRequest request;
+    request.events = true;
+    request.collisions = true;
+    ForEachChunk(reader, 0u, reader.GetChunks().size(), request, number_of_threads, [&](const ChunkData &data) {
+      ForEachFrame(data, [&](const ChunkFrame &frame, uint32_t events, uint32_t collisions, uint32_t) {
+        previous.swap(current);
+        current.clear();
+        for (auto i = events; i < frame.events_end; ++i) {
+          const auto &event = data.events[i];
+          if (event.type == PacketId::EventAdd) {
+            categories[event.database_id] = GetCategory(data.actors[event.value].type);
+          }
+        }
+        for (auto i = collisions; i < frame.collisions_end; ++i) {
+          const auto &collision = data.collisions[i];
+          const auto type1 = get_category(collision.database_id1);
+          const auto type2 = get_category(collision.database_id2);
+          if (!MatchesCategory(category1, type1, collision.is_actor1_hero) ||
+              !MatchesCategory(category2, type2, collision.is_actor2_hero)) {
+            continue;
+          }
+          const auto pair = (static_cast<uint64_t>(collision.database_id1) << 32u) | collision.database_id2;
+          if (previous.count(pair) == 0u) {
+            result.push_back(CollisionRecord{
+                frame.id,
+                frame.elapsed,
+                collision.database_id1,
+                collision.database_id2,
+                type1,
+                type2,
+                collision.is_actor1_hero,
+                collision.is_actor2_hero});
+          }
+          current.insert(pair);
+        }
+      });
+    });
+    return result;
+  }
+
+  std::vector<BlockedRecord> QueryBlocked(
+      const RecordingReader &reader,
+      const double min_time,
+      const double min_distance,
+      const size_t number_of_threads) {
+    struct ActorState {
+      geom::Vector3D last_location;
+      double time = 0.0;
+      double duration = 0.0;
+    };
+    std::vector<BlockedRecord> result;
+    std::unordered_map<uint32_t, ActorState> actors;
+    auto report = [&](uint32_t id, const ActorState &state) {
+      if ((state.duration > 0.0) && (state.duration >= min_time)) {
+        result.push_back(BlockedRecord{id, state.time, state.duration});
+      }
+    };
+    ChunkRequest request;
+    request.events = true;
+    request.positions = true;
+    ForEachChunk(reader, 0u, reader.GetChunks().size(), request, number_of_threads, [&](const ChunkData &data) {
+      ForEachFrame(data, [&](const ChunkFrame &frame, uint32_t events, uint32_t, uint32_t positions) {
+        for (auto i = events; i < frame.events_end; ++i) {
+          const auto &event = data.events[i];
+          if (event.type == PacketId::EventDel) {
+            const auto it = actors.find(event.database_id);
+            if (it != actors.end()) {
+              report(it->first, it->second);
+              actors.erase(it);
+            }
+          }
+        }
+        // The last frame of the file has no duration.
+        const auto duration = std::max(frame.duration, 0.0);
+        for (auto i = positions; i < frame.positions_end; ++i) {
+          const auto &position = data.positions[i];
+          auto &state = actors[position.database_id];
+          if (geom::Math::Distance(state.last_location, position.location) < min_distance) {
+            // Stopped.
+            if (state.duration == 0.0) {
+              state.time = frame.elapsed;
+            }
+            state.duration += duration;
+          } else {
+            // Moving again.
+            report(position.database_id, state);
+            state.duration = 0.0;
+            state.last_location = position.location;
+          }
+        }
+      });
+    });
+    // Actors still stopped at the end.
+    for (auto &item : actors) {
+      report(item.first, item.second);
+    }
+    std::sort(result.begin(), result.end(), [](const BlockedRecord &lhs, const BlockedRecord &rhs) {
+      if (lhs.duration != rhs.duration) {
+        return lhs.duration > rhs.duration;
+      }
+      return (lhs.time < rhs.time) || ((lhs.time == rhs.time) && (lhs.id < rhs.id));
+    });
+    return result;
+  }
+
+  Trajectories QueryTrajectories(
+      const RecordingReader &reader,
+      const double begin_time,
+      const double end_time,
+      std::vector<uint32_t> actors,
+      const size_t number_of_threads) {
+    Trajectories result;
+    ChunkRequest request;
+    request.positions = true;
+    request.begin_time = begin_time;
+    request.end_time = end_time;
+    std::sort(actors.begin(), actors.end());
+    request.actors = std::move(actors);
+    const auto chunks = reader.FindChunks(begin_time, end_time);
+    ForEachChunk(reader, chunks.first, chunks.second, request, number_of_threads, [&](const ChunkData &data) {
+      ForEachFrame(data, [&](const ChunkFrame &frame, uint32_t, uint32_t, uint32_t positions) {
+        for (auto i = positions; i < frame.positions_end; ++i) {
+          const auto &position = data.positions[i];
+          result.frames.push_back(frame.id);
+          result.times.push_back(frame.elapsed);
+          result.ids.push_back(position.database_id);
+          result.locations.push_back(position.location);
+          result.rotations.push_back(position.rotation);
+        }
+      });
+    });
+    return result;
+  }
+
+} // namespace query
+} // namespace recorder
+} // namespace carla
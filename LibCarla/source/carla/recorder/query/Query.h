@@ -0,0 +1,190 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ParallelFor.h"
+#include "carla/geom/Vector3D.h"
+#include "carla/recorder/query/RecordingReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+namespace query {
+
+  // ===========================================================================
+  // -- Results ----------------------------------------------------------------
+  // ===========================================================================
+
+  /// Actor created during a recording.
+  struct ActorRecord {
+    uint32_t id;
+    /// Type recorded by the simulator: 0 other, 1 vehicle, 2 walker, 3
+    /// traffic light.
+    uint8_t type;
+    /// Blueprint id.
+    std::string type_id;
+    /// Whether the role_name attribute is "hero".
+    bool is_hero;
+    /// Elapsed time of the frames the actor was created and destroyed at,
+    /// negative if the actor was not destroyed during the recording.
+    double created;
+    double destroyed;
+  };
+
+  /// Actor event of a recording.
+  struct EventRecord {
+    enum class Type : uint8_t {
+      Add,
+      Del,
+      Parent
+    };
+    uint64_t frame;
+    double time;
+    Type type;
+    uint32_t id;
+    /// Parent id of a Parent event, zero otherwise.
+    uint32_t parent;
+  };
+
+  struct RecordingSummary {
+    std::string path;
+    Info info;
+    bool has_index;
+    uint64_t frames;
+    double duration;
+    /// In creation order.
+    std::vector<ActorRecord> actors;
+    std::vector<EventRecord> events;
+  };
+
+  /// Start of a collision between two actors, collisions that continue from
+  /// the previous frame are not repeated.
+  struct CollisionRecord {
+    uint64_t frame;
+    double time;
+    uint32_t actor1;
+    uint32_t actor2;
+    /// Category of each actor as used by the filters of QueryCollisions.
+    char category1;
+    char category2;
+    bool is_actor1_hero;
+    bool is_actor2_hero;
+  };
+
+  /// Period an actor stayed stopped.
+  struct BlockedRecord {
+    uint32_t id;
+    /// Elapsed time the actor stopped at.
+    double time;
+    double duration;
+  };
+
+  /// Positions of the actors, one row per actor and frame, in frame order.
+  struct Trajectories {
+    std::vector<uint64_t> frames;
+    std::vector<double> times;
+    std::vector<uint32_t> ids;
+    std::vector<geom::Vector3D> locations;
+    std::vector<geom::Vector3D> rotations;
+
+    size_t size() const {
+      return ids.size();
+    }
+  };
+
+  // ===========================================================================
+  // -- Queries ----------------------------------------------------------------
+  // ===========================================================================
+
+  /// @name Queries on a recording
+  ///
+  /// These answer the queries of the simulator's show_recorder_* commands
+  /// (CarlaRecorderQuery) without a running simulator, returning the results
+  /// instead of text.
+  ///
+  /// The chunks of the file are read in parallel, by windows of
+  /// @a number_of_threads chunks (zero to use one per hardware thread), and
+  /// the results of each window merged in file order, so the memory used
+  /// depends on the size of the chunks, not on the size of the file.
+  ///
+  /// @{
+
+  /// General information and actor events of the recording.
+  RecordingSummary QuerySummary(
+      const RecordingReader &reader,
+      size_t number_of_threads = 0u);
+
+  /// Collisions between an actor of @a category1 and one of @a category2,
+  /// each one of 'a' (any), 'h' (hero), 'v' (vehicle), 'w' (walker), 't'
+  /// (traffic light) or 'o' (other).
+  std::vector<CollisionRecord> QueryCollisions(
+      const RecordingReader &reader,
+      char category1,
+      char category2,
+      size_t number_of_threads = 0u);
+
+  /// Actors that moved less than @a min_distance during at least
+  /// @a min_time seconds, by decreasing duration.
+  std::vector<BlockedRecord> QueryBlocked(
+      const RecordingReader &reader,
+      double min_time,
+      double min_distance,
+      size_t number_of_threads = 0u);
+
+  /// Positions of the actors in the frames played between @a begin_time
+  /// and @a end_time. If @a actors is not empty, only the positions of these
+  /// actors. Only the chunks of the time range are read.
+  Trajectories QueryTrajectories(
+      const RecordingReader &reader,
+      double begin_time,
+      double end_time,
+      std::vector<uint32_t> actors = {},
+      size_t number_of_threads = 0u);
+
+  /// @}
+
+  /// Call `query(reader)` for a RecordingReader of each file in @a paths, in
+  /// parallel, and return the results in the same order. Each thread takes
+  /// the next file pending, so files of very different sizes are balanced.
+  /// If any query throws, the first exception is rethrown here.
+  ///
+  /// The queries should be run with a single thread, the files are already
+  /// read in parallel.
+  template <typename Query>
+  auto QueryEach(
+      const std::vector<std::string> &paths,
+      Query &&query,
+      const size_t number_of_threads = 0u)
+      -> std::vector<typename std::decay<decltype(query(std::declval<const RecordingReader &>()))>::type> {
+    using result_type = typename std::decay<decltype(query(std::declval<const RecordingReader &>()))>::type;
+    std::vector<result_type> results(paths.size());
+    std::atomic_size_t next{0u};
+    const auto threads = number_of_threads > 0u ?
+        number_of_threads :
+        std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+    // One item per thread, each one pulls files until there are none left.
+    ParallelFor(std::min(threads, paths.size()), [&](size_t, size_t) {
+      for (auto i = next++; i < paths.size(); i = next++) {
+        RecordingReader reader(paths[i]);
+        results[i] = query(static_cast<const RecordingReader &>(reader));
+      }
+    }, threads, 1u);
+    return results;
+  }
+
+} // namespace query
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,327 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/query/RecordingReader.h"
+
+#include "carla/Exception.h"
+#include "carla/recorder/PositionCodec.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace carla {
+namespace recorder {
+namespace query {
+
+  constexpr uint64_t RecordingReader::MinChunkSize;
+
+  // ===========================================================================
+  // -- Local helpers ----------------------------------------------------------
+  // ===========================================================================
+
+  constexpr uint64_t PacketHeaderSize = sizeof(char) + sizeof(uint32_t);
+
+  /// Value of Info::magic of every recorder file.
+  constexpr const char *RecorderMagic = "CARLA_RECORDER";
+
+  template <typename T>
+  static bool ReadValue(std::istream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  static bool ReadString(std::istream &file, std::string &str) {
+    uint16_t length;
+    if (!ReadValue(file, length)) {
+      return false;
+    }
+    str.resize(length);
+    return (length == 0u) || static_cast<bool>(file.read(&str[0u], length));
+  }
+
+  static bool ReadInfo(std::istream &file, Info &info) {
+    return
+        ReadValue(file, info.version) &&
+        ReadString(file, info.magic) &&
+        ReadValue(file, info.date) &&
+        ReadString(file, info.map_file);
+  }
+
+  [[noreturn]] static void ThrowInvalid(const std::string &path, const char *what) {
+    throw_exception(std::runtime_error("recorder: " + path + ": " + what));
+  }
+
+  /// Read the array of fixed-size records of a packet, preceded by its size.
+  template <typename T>
+  static void ReadRecords(InputBuffer &in, std::vector<T> &records) {
+    const auto total = in.Read<uint16_t>();
+    const auto offset = records.size();
+    records.resize(offset + total);
+    in.Read(records.data() + offset, total * sizeof(T));
+  }
+
+  static bool IsHero(const ActorDescription &description) {
+    return std::any_of(
+        description.attributes.begin(),
+        description.attributes.end(),
+        [](const ActorAttribute &attribute) {
+          return (attribute.id == "role_name") && (attribute.value == "hero");
+        });
+  }
+
+  // ===========================================================================
+  // -- ChunkData --------------------------------------------------------------
+  // ===========================================================================
+
+  void ChunkData::clear() {
+    frames.clear();
+    events.clear();
+    actors.clear();
+    collisions.clear();
+    positions.clear();
+  }
+
+  // ===========================================================================
+  // -- RecordingReader --------------------------------------------------------
+  // ===========================================================================
+
+  RecordingReader::RecordingReader(std::string path)
+    : _path(std::move(path)) {
+    std::ifstream file(_path, std::ios::binary);
+    if (!file.is_open()) {
+      ThrowInvalid(_path, "cannot open file");
+    }
+    if (!ReadInfo(file, _info) || (_info.magic != RecorderMagic)) {
+      ThrowInvalid(_path, "not a recorder file");
+    }
+    _has_index = _index.ReadFooter(file);
+    if (!_has_index) {
+      _index.Scan(file);
+    }
+    file.clear();
+    file.seekg(0, std::ios::end);
+    _file_size = static_cast<uint64_t>(file.tellg());
+    SplitChunks();
+  }
+
+  void RecordingReader::SplitChunks() {
+    _chunks.clear();
+    const auto &frames = _index.GetFrames();
+    if (frames.empty()) {
+      return;
+    }
+    std::vector<size_t> starts = {0u};
+    if (!_index.GetKeyframes().empty()) {
+      for (auto &keyframe : _index.GetKeyframes()) {
+        if (keyframe.frame > starts.back()) {
+          starts.push_back(keyframe.frame);
+        }
+      }
+    } else if (_info.version < CompactPositionsVersion) {
+      // Without compact positions any frame can start a chunk.
+      for (auto i = 1u; i < frames.size(); ++i) {
+        if (frames[i].offset - frames[starts.back()].offset >= MinChunkSize) {
+          starts.push_back(i);
+        }
+      }
+    }
+    // Otherwise the key frames of the positions are unknown, the whole file
+    // is a single chunk.
+    starts.push_back(frames.size());
+    for (auto i = 1u; i < starts.size(); ++i) {
+      _chunks.push_back(Chunk{starts[i - 1u], starts[i] - starts[i - 1u]});
+    }
+  }
+
+  std::pair<size_t, size_t> RecordingReader::FindChunks(
+      const double begin_time,
+      const double end_time) const {
+    if (_chunks.empty() || (end_time < begin_time)) {
+      return {0u, 0u};
+    }
+    auto find = [this](double time) {
+      const auto frame = _index.FindFrame(time);
+      const auto it = std::upper_bound(
+          _chunks.begin(),
+          _chunks.end(),
+          frame,
+          [](size_t value, const Chunk &chunk) { return value < chunk.first_frame; });
+      return static_cast<size_t>(it - _chunks.begin()) - 1u;
+    };
+    return {find(begin_time), find(end_time) + 1u};
+  }
+
+  void RecordingReader::ReadChunk(
+      const size_t chunk,
+      const ChunkRequest &request,
+      ChunkData &data) const {
+    DEBUG_ASSERT(chunk < _chunks.size());
+    DEBUG_ASSERT(std::is_sorted(request.actors.begin(), request.actors.end()));
+    data.clear();
+    const auto &frames = _index.GetFrames();
+    const auto first_frame = _chunks[chunk].first_frame;
+    const auto last_frame = first_frame + _chunks[chunk].frame_count;
+    const uint64_t begin = frames[first_frame].offset;
+    const uint64_t end = last_frame < frames.size() ? frames[last_frame].offset : _file_size;
+
+    std::ifstream file(_path, std::ios::binary);
+    if (!file.is_open() || !file.seekg(static_cast<std::streamoff>(begin))) {
+      ThrowInvalid(_path, "cannot open file");
+    }
+
+    // The positions are only needed until the end of the time range.
+    const bool only_positions = !request.events && !request.collisions;
+    auto is_wanted = [&](uint32_t database_id) {
+      return request.actors.empty() ||
+          std::binary_search(request.actors.begin(), request.actors.end(), database_id);
+    };
+    // Store the end of the packets of the current frame.
+    auto close_frame = [&data]() {
+      if (!data.frames.empty()) {
+        auto &frame = data.frames.back();
+        frame.events_end = static_cast<uint32_t>(data.events.size());
+        frame.collisions_end = static_cast<uint32_t>(data.collisions.size());
+        frame.positions_end = static_cast<uint32_t>(data.positions.size());
+      }
+    };
+
+    std::vector<unsigned char> payload;
+    PositionDecoder decoder;
+    EventAdd event_add;
+    bool in_range = false;
+    bool done = false;
+    uint64_t offset = begin;
+    while (!done && (end - offset >= PacketHeaderSize)) {
+      char id;
+      uint32_t size;
+      if (!ReadValue(file, id) || !ReadValue(file, size)) {
+        break;
+      }
+      offset += PacketHeaderSize;
+      const auto packet = static_cast<PacketId>(id);
+      if ((packet == PacketId::FrameIndex) || (size > end - offset)) {
+        // End of the frames, or truncated file.
+        break;
+      }
+      offset += size;
+
+      bool read = false;
+      switch (packet) {
+        case PacketId::FrameStart:
+          read = true;
+          break;
+        case PacketId::EventAdd:
+        case PacketId::EventDel:
+        case PacketId::EventParent:
+          read = request.events;
+          break;
+        case PacketId::Collision:
+          read = request.collisions;
+          break;
+        case PacketId::Position:
+          read = request.positions && in_range;
+          break;
+        case PacketId::PositionCompact:
+          // Each frame is relative to the previous one, decoded even out of
+          // the time range.
+          read = request.positions;
+          break;
+        default:
+          break;
+      }
+      if (!read || (data.frames.empty() && (packet != PacketId::FrameStart))) {
+        file.seekg(size, std::ios::cur);
+        continue;
+      }
+      payload.resize(size);
+      if (!file.read(reinterpret_cast<char *>(payload.data()), size)) {
+        break;
+      }
+      InputBuffer in(payload.data(), size);
+
+      switch (packet) {
+        case PacketId::FrameStart: {
+          Frame frame;
+          in.Read(frame);
+          if (only_positions && (frame.elapsed > request.end_time)) {
+            done = true;
+            break;
+          }
+          close_frame();
+          data.frames.push_back(ChunkFrame{frame.id, frame.elapsed, frame.duration, 0u, 0u, 0u});
+          in_range = (frame.elapsed >= request.begin_time) && (frame.elapsed <= request.end_time);
+          break;
+        }
+        case PacketId::EventAdd: {
+          const auto total = in.Read<uint16_t>();
+          for (auto i = 0u; i < total; ++i) {
+            Read(in, event_add);
+            data.events.push_back(ChunkEvent{
+                packet,
+                event_add.database_id,
+                static_cast<uint32_t>(data.actors.size())});
+            data.actors.push_back(ChunkActor{
+                event_add.database_id,
+                event_add.type,
+                event_add.description.id,
+                IsHero(event_add.description)});
+          }
+          break;
+        }
+        case PacketId::EventDel: {
+          const auto total = in.Read<uint16_t>();
+          for (auto i = 0u; i < total; ++i) {
+            const auto event = in.Read<EventDel>();
+            data.events.push_back(ChunkEvent{packet, event.database_id, 0u});
+          }
+          break;
+        }
+        case PacketId::EventParent: {
+          const auto total = in.Read<uint16_t>();
+          for (auto i = 0u; i < total; ++i) {
+            const auto event = in.Read<EventParent>();
+            data.events.push_back(ChunkEvent{packet, event.database_id, event.database_id_parent});
+          }
+          break;
+        }
+        case PacketId::Collision:
+          ReadRecords(in, data.collisions);
+          break;
+        case PacketId::Position: {
+          const auto offset_positions = data.positions.size();
+          ReadRecords(in, data.positions);
+          if (!request.actors.empty()) {
+            data.positions.erase(
+                std::remove_if(
+                    data.positions.begin() + offset_positions,
+                    data.positions.end(),
+                    [&](const Position &position) { return !is_wanted(position.database_id); }),
+                data.positions.end());
+          }
+          break;
+        }
+        case PacketId::PositionCompact:
+          if (!decoder.Decode(payload.data(), size)) {
+            ThrowInvalid(_path, "invalid compact positions");
+          }
+          if (in_range) {
+            for (auto &position : decoder.GetPositions()) {
+              if (is_wanted(position.database_id)) {
+                data.positions.push_back(position);
+              }
+            }
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    close_frame();
+  }
+
+} // namespace query
+} // namespace recorder
+} // namespace carla
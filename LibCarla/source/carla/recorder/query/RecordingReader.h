@@ -0,0 +1,170 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/FrameIndex.h"
+#include "carla/recorder/Packets.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+namespace query {
+
+  /// Range of consecutive frames of a recording that can be decoded without
+  /// reading the frames before it: the positions of its first frame are not
+  /// stored relative to the previous one.
+  struct Chunk {
+    /// Position in FrameIndex::GetFrames of the first frame.
+    size_t first_frame;
+    /// Number of frames.
+    size_t frame_count;
+  };
+
+  /// Which packets RecordingReader::ReadChunk collects.
+  struct ChunkRequest {
+    /// EventAdd, EventDel and EventParent packets.
+    bool events = false;
+
+    bool collisions = false;
+
+    /// Position and PositionCompact packets; compact positions are only
+    /// decoded if requested.
+    bool positions = false;
+
+    /// Only collect the positions of the frames in this time range.
+    double begin_time = -std::numeric_limits<double>::infinity();
+    double end_time = std::numeric_limits<double>::infinity();
+
+    /// If not empty, only collect the positions of these actors. Must be
+    /// sorted.
+    std::vector<uint32_t> actors;
+  };
+
+  /// Actor event of a chunk, in file order.
+  struct ChunkEvent {
+    PacketId type;
+    uint32_t database_id;
+    /// Parent id of an EventParent, position in ChunkData::actors of an
+    /// EventAdd.
+    uint32_t value;
+  };
+
+  /// Description of an actor created in a chunk.
+  struct ChunkActor {
+    uint32_t database_id;
+    uint8_t type;
+    std::string type_id;
+    bool is_hero;
+  };
+
+  /// Frame of a chunk. The packets of each frame are stored consecutively in
+  /// the arrays of ChunkData, each frame keeps the end of its range; the
+  /// range of a frame starts at the end of the previous one.
+  struct ChunkFrame {
+    uint64_t id;
+    double elapsed;
+    /// Time until the next frame, negative for the last frame of a file.
+    double duration;
+    uint32_t events_end;
+    uint32_t collisions_end;
+    uint32_t positions_end;
+  };
+
+  /// Packets of a chunk collected by RecordingReader::ReadChunk.
+  struct ChunkData {
+    std::vector<ChunkFrame> frames;
+    std::vector<ChunkEvent> events;
+    std::vector<ChunkActor> actors;
+    std::vector<Collision> collisions;
+    std::vector<Position> positions;
+
+    /// Clear the content, keeps the allocated memory.
+    void clear();
+  };
+
+  /// Reads a recorder file outside the simulator, without depending on the
+  /// game engine.
+  ///
+  /// On opening, the file is split in chunks using the frame index at its
+  /// end (files recorded before the index existed are scanned instead).
+  /// Every chunk is read with its own file stream and position decoder, so
+  /// several chunks of the same file can be read in parallel; a chunk
+  /// starts at each keyframe of the index, where the compact positions are
+  /// encoded as key frames.
+  ///
+  /// @throw std::runtime_error if the file cannot be opened or is not a
+  ///   recorder file, and when reading packets that are not valid. A file
+  ///   truncated in the middle of a packet (e.g. because the simulator was
+  ///   killed while recording) is read up to the last complete packet.
+  class RecordingReader : private NonCopyable {
+  public:
+
+    /// Minimum size in bytes of the chunks of a file without keyframes.
+    static constexpr uint64_t MinChunkSize = 4u * 1024u * 1024u;
+
+    explicit RecordingReader(std::string path);
+
+    const std::string &GetPath() const {
+      return _path;
+    }
+
+    const Info &GetInfo() const {
+      return _info;
+    }
+
+    /// Whether the file has a frame index, otherwise the frames were found
+    /// by scanning the file.
+    bool HasIndex() const {
+      return _has_index;
+    }
+
+    const FrameIndex &GetIndex() const {
+      return _index;
+    }
+
+    uint64_t GetFileSize() const {
+      return _file_size;
+    }
+
+    const std::vector<Chunk> &GetChunks() const {
+      return _chunks;
+    }
+
+    /// Chunks containing the frames played between @a begin_time and
+    /// @a end_time, as a [first, last) range of positions in GetChunks.
+    std::pair<size_t, size_t> FindChunks(double begin_time, double end_time) const;
+
+    /// Read the packets of the chunk at position @a chunk in GetChunks, as
+    /// selected by @a request, into @a data (cleared first). Thread-safe.
+    void ReadChunk(size_t chunk, const ChunkRequest &request, ChunkData &data) const;
+
+  private:
+
+    void SplitChunks();
+
+    const std::string _path;
+
+    Info _info;
+
+    bool _has_index = false;
+
+    FrameIndex _index;
+
+    uint64_t _file_size = 0u;
+
+    std::vector<Chunk> _chunks;
+  };
+
+} // namespace query
+} // namespace recorder
+} // namespace carla
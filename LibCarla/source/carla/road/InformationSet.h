@@ -6,47 +6,63 @@
 
 #pragma once
 
-#include "carla/NonCopyable.h"
-#include "carla/road/RoadElementSet.h"
 #include "carla/road/element/RoadInfo.h"
 #include "carla/road/element/RoadInfoIterator.h"
 
+#include <algorithm>
+#include <iterator>
 #include <vector>
-#include <memory>
 
 namespace carla {
 namespace road {
 
-  class InformationSet : private MovableNonCopyable {
+  /// A range of info records sorted by their distance on the road. The
+  /// records and the range itself are owned by the MapData.
+  class InformationSet {
   public:
 
     InformationSet() = default;
 
-    InformationSet(std::vector<std::unique_ptr<element::RoadInfo>> &&vec)
-      : _road_set(std::move(vec)) {}
+    InformationSet(element::RoadInfo *const *begin, element::RoadInfo *const *end)
+      : _begin(begin),
+        _end(end) {}
 
     /// Return all infos given a type from the start of the road
     template <typename T>
     std::vector<const T *> GetInfos() const {
       std::vector<const T *> vec;
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetAll());
+      auto it = element::MakeRoadInfoIterator<T>(_begin, _end);
       for (; !it.IsAtEnd(); ++it) {
         vec.emplace_back(&*it);
       }
       return vec;
     }
 
+    /// Return an iterator over the infos of a given type from the start of the
+    /// road, unlike GetInfos it does not allocate memory
+    template <typename T>
+    element::RoadInfoIterator<T, element::RoadInfo *const *> GetInfoIterator() const {
+      return element::MakeRoadInfoIterator<T>(_begin, _end);
+    }
+
     /// Returns single info given a type and a distance (s) from
     /// the start of the road
     template <typename T>
     const T *GetInfo(const double s) const {
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetReverseSubset(s));
+      const auto upper = std::upper_bound(_begin, _end, s, [](double lhs, const element::RoadInfo *rhs) {
+        return lhs < rhs->GetDistance();
+      });
+      auto it = element::MakeRoadInfoIterator<T>(
+          std::make_reverse_iterator(upper),
+          std::make_reverse_iterator(_begin));
       return it.IsAtEnd() ? nullptr : &*it;
     }
 
   private:
 
-    RoadElementSet<std::unique_ptr<element::RoadInfo>> _road_set;
+    element::RoadInfo *const *_begin = nullptr;
+
+    element::RoadInfo *const *_end = nullptr;
   };
 
 } // road
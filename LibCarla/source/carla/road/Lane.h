@@ -6,12 +6,15 @@
 
 #pragma once
 
+#include "carla/ListView.h"
+#include "carla/NonCopyable.h"
 #include "carla/road/InformationSet.h"
 #include "carla/road/RoadTypes.h"
 
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <utility>
 
 namespace carla {
 namespace road {
@@ -53,16 +56,6 @@ namespace road {
 
     Lane() = default;
 
-    Lane(
-        LaneSection *lane_section,
-        LaneId id,
-        std::vector<std::unique_ptr<element::RoadInfo>> &&info)
-      : _lane_section(lane_section),
-        _id(id),
-        _info(std::move(info)) {
-      DEBUG_ASSERT(lane_section != nullptr);
-    }
-
     const LaneSection *GetLaneSection() const;
 
     Road *GetRoad() const;
@@ -79,12 +72,12 @@ namespace road {
       return _info.GetInfo<T>(s);
     }
 
-    const std::vector<Lane *> &GetNextLanes() const {
-      return _next_lanes;
+    auto GetNextLanes() const {
+      return MakeListView(_next_lanes.first, _next_lanes.second);
     }
 
-    const std::vector<Lane *> &GetPreviousLanes() const {
-      return _prev_lanes;
+    auto GetPreviousLanes() const {
+      return MakeListView(_prev_lanes.first, _prev_lanes.second);
     }
 
     LaneId GetSuccessor() const {
@@ -117,9 +110,10 @@ namespace road {
 
     LaneId _predecessor = 0;
 
-    std::vector<Lane *> _next_lanes;
+    /// Ranges of the lane links arena of the MapData.
+    std::pair<Lane *const *, Lane *const *> _next_lanes { nullptr, nullptr };
 
-    std::vector<Lane *> _prev_lanes;
+    std::pair<Lane *const *, Lane *const *> _prev_lanes { nullptr, nullptr };
   };
 
 } // road
@@ -0,0 +1,77 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/road/RoadTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  /// Polylines of the center and the boundaries of the lanes of a map, stored
+  /// as flat arrays. There is a polyline for each lane of each lane section,
+  /// the points of the i-th one are [offsets[i], offsets[i + 1]).
+  ///
+  /// Left and right are relative to the direction of the lane, as the lateral
+  /// offset of element::FrenetPoint. The markings are the ones of the
+  /// RoadInfoMarkRecord at each point, as element::LaneMarking::Type and
+  /// Color values.
+  struct LaneGeometry {
+
+    /// @name Per lane
+    /// @{
+
+    std::vector<RoadId> road_ids;
+
+    std::vector<SectionId> section_ids;
+
+    std::vector<LaneId> lane_ids;
+
+    /// Lane::LaneType of each lane.
+    std::vector<uint32_t> lane_types;
+
+    /// Index of the first point of each lane, plus the total number of points
+    /// at the end.
+    std::vector<uint32_t> offsets;
+
+    /// @}
+    /// @name Per point
+    /// @{
+
+    /// Distance along the road.
+    std::vector<float> distances;
+
+    /// Three coordinates, x, y, z, per point.
+    std::vector<float> centers;
+
+    std::vector<float> left_boundaries;
+
+    std::vector<float> right_boundaries;
+
+    std::vector<uint8_t> left_marking_types;
+
+    std::vector<uint8_t> left_marking_colors;
+
+    std::vector<uint8_t> right_marking_types;
+
+    std::vector<uint8_t> right_marking_colors;
+
+    /// @}
+
+    size_t GetNumberOfLanes() const {
+      return lane_ids.size();
+    }
+
+    size_t GetNumberOfPoints() const {
+      return distances.size();
+    }
+  };
+
+} // namespace road
+} // namespace carla
@@ -6,6 +6,9 @@
 
 #include "carla/road/LaneSection.h"
 
+#include <algorithm>
+#include <cstddef>
+
 namespace carla {
 namespace road {
 
@@ -22,26 +25,38 @@ namespace road {
   }
 
   Lane *LaneSection::GetLane(const LaneId id) {
-    auto search = _lanes.find(id);
-    if (search != _lanes.end()) {
-      return &search->second;
+    return const_cast<Lane *>(static_cast<const LaneSection *>(this)->GetLane(id));
+  }
+
+  const Lane *LaneSection::GetLane(const LaneId id) const {
+    if (_lanes.first == _lanes.second) {
+      return nullptr;
+    }
+    // Lane ids are usually consecutive, try first the lane at the position
+    // given by its id.
+    const auto index = static_cast<std::ptrdiff_t>(id) - _lanes.first->GetId();
+    if ((index >= 0) && (index < (_lanes.second - _lanes.first)) && (_lanes.first[index].GetId() == id)) {
+      return _lanes.first + index;
     }
-    return nullptr;
+    const auto it = std::lower_bound(_lanes.first, _lanes.second, id, [](const Lane &lane, LaneId lane_id) {
+      return lane.GetId() < lane_id;
+    });
+    return ((it != _lanes.second) && (it->GetId() == id)) ? it : nullptr;
   }
 
-  std::map<LaneId, Lane> &LaneSection::GetLanes() {
-    return _lanes;
+  ListView<Lane *> LaneSection::GetLanes() {
+    return MakeListView(_lanes.first, _lanes.second);
   }
 
-  const std::map<LaneId, Lane> &LaneSection::GetLanes() const {
-    return _lanes;
+  ListView<const Lane *> LaneSection::GetLanes() const {
+    return MakeListView<const Lane *>(_lanes.first, _lanes.second);
   }
 
   std::vector<Lane *> LaneSection::GetLanesOfType(Lane::LaneType lane_type) {
     std::vector<Lane *> drivable_lanes;
-    for (auto &&lane : _lanes) {
-      if ((static_cast<uint32_t>(lane.second.GetType()) & static_cast<uint32_t>(lane_type)) > 0) {
-        drivable_lanes.emplace_back(&lane.second);
+    for (auto &lane : GetLanes()) {
+      if ((static_cast<uint32_t>(lane.GetType()) & static_cast<uint32_t>(lane_type)) > 0) {
+        drivable_lanes.emplace_back(&lane);
       }
     }
     return drivable_lanes;
@@ -6,13 +6,13 @@
 
 #pragma once
 
+#include "carla/ListView.h"
 #include "carla/NonCopyable.h"
 #include "carla/road/Lane.h"
-#include "carla/road/RoadElementSet.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/geom/CubicPolynomial.h"
 
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace carla {
@@ -32,15 +32,18 @@ namespace road {
 
     Lane *GetLane(const LaneId id);
 
+    const Lane *GetLane(const LaneId id) const;
+
     bool ContainsLane(LaneId id) const {
-      return (_lanes.find(id) != _lanes.end());
+      return GetLane(id) != nullptr;
     }
 
     SectionId GetId() const;
 
-    std::map<LaneId, Lane> &GetLanes();
+    /// Lanes of this section sorted by id.
+    ListView<Lane *> GetLanes();
 
-    const std::map<LaneId, Lane> &GetLanes() const;
+    ListView<const Lane *> GetLanes() const;
 
     std::vector<Lane *> GetLanesOfType(Lane::LaneType type);
 
@@ -54,7 +57,8 @@ namespace road {
 
     Road *_road = nullptr;
 
-    std::map<LaneId, Lane> _lanes;
+    /// Range of the lanes arena of the MapData.
+    std::pair<Lane *, Lane *> _lanes { nullptr, nullptr };
 
     geom::CubicPolynomial _lane_offset;
   };
@@ -14,6 +14,8 @@
 #include "carla/road/element/RoadInfoLaneOffset.h"
 #include "carla/geom/Math.h"
 
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace carla {
@@ -66,8 +68,7 @@ namespace road {
       const LaneSection &lane_section,
       double distance,
       FuncT &&func) {
-    for (const auto &pair : lane_section.GetLanes()) {
-      const auto &lane = pair.second;
+    for (const auto &lane : lane_section.GetLanes()) {
       if ((static_cast<uint32_t>(lane.GetType()) & static_cast<uint32_t>(Lane::LaneType::Driving)) > 0) {
         std::forward<FuncT>(func)(Waypoint{
             road_id,
@@ -113,15 +114,15 @@ namespace road {
     double dist = 0.0;
     double tangent = 0.0;
     for (const auto &lane : container) {
-      auto info = lane.second.template GetInfo<RoadInfoLaneWidth>(s);
+      auto info = lane.template GetInfo<RoadInfoLaneWidth>(s);
       THROW_INVALID_INPUT_ASSERT(info != nullptr);
       const auto current_polynomial = info->GetPolynomial();
       auto current_dist = current_polynomial.Evaluate(s);
       auto current_tang = current_polynomial.Tangent(s);
-      if (lane.first != lane_id) {
+      if (lane.GetId() != lane_id) {
         dist += negative_lane_id ? current_dist : -current_dist;
         tangent += current_tang;
-      } else if (lane.first == lane_id) {
+      } else if (lane.GetId() == lane_id) {
         current_dist *= 0.5;
         dist += negative_lane_id ? current_dist : -current_dist;
         tangent += current_tang * 0.5;
@@ -131,12 +132,80 @@ namespace road {
     return std::make_pair(dist, tangent);
   }
 
+  /// Clamp the "s" of @a waypoint to the length of @a road and find its lane
+  /// section. Assumes @a road contains the lane of @a waypoint.
+  static void FinishWaypointOnRoad(const Road &road, Waypoint &waypoint) {
+    // Make sure 0.0 < waipoint.s < Road's length
+    constexpr double margin = 5.0 * EPSILON;
+    DEBUG_ASSERT(margin < road.GetLength() - margin);
+    waypoint.s = geom::Math::clamp<double>(waypoint.s, margin, road.GetLength() - margin);
+
+    auto &lane = road.GetLaneByDistance(waypoint.s, waypoint.lane_id);
+
+    const auto lane_section = lane.GetLaneSection();
+    THROW_INVALID_INPUT_ASSERT(lane_section != nullptr);
+    waypoint.section_id = lane_section->GetId();
+  }
+
   /// Assumes road_id and section_id are valid.
   static bool IsLanePresent(const MapData &data, Waypoint waypoint) {
     const auto &section = data.GetRoad(waypoint.road_id).GetLaneSectionById(waypoint.section_id);
     return section.ContainsLane(waypoint.lane_id);
   }
 
+  /// Yaw of the road reference line at @a s, in radians (Unreal's
+  /// coordinates). Unlike the heading of the lanes, it does not change with
+  /// the width of the lanes, so it is perpendicular to the lateral offsets.
+  static double GetReferenceYaw(const Road &road, const double s) {
+    // Unreal's Y axis hack
+    return -road.GetDirectedPointIn(s).tangent;
+  }
+
+  /// Unit vector pointing to the right of the driving direction of the lane
+  /// @a lane_id, perpendicular to the road reference line of yaw
+  /// @a reference_yaw, in the horizontal plane (Unreal's coordinates).
+  static std::pair<double, double> GetRightVector2D(const double reference_yaw, const LaneId lane_id) {
+    const double sign = lane_id > 0 ? -1.0 : 1.0;
+    return std::make_pair(-sign * std::sin(reference_yaw), sign * std::cos(reference_yaw));
+  }
+
+  /// Unit vector pointing to the right of the driving direction of the lane
+  /// of @a waypoint, perpendicular to the road reference line.
+  static std::pair<double, double> GetRightVector2D(const Road &road, const Waypoint &waypoint) {
+    return GetRightVector2D(GetReferenceYaw(road, waypoint.s), waypoint.lane_id);
+  }
+
+  /// Offset of @a location from @a center along the road reference line at
+  /// @a s, in the horizontal plane. Zero unless @a location is beyond the
+  /// ends of the road.
+  static double GetLongitudinalOffset(
+      const Road &road,
+      const double s,
+      const geom::Location &center,
+      const geom::Location &location) {
+    const auto yaw = GetReferenceYaw(road, s);
+    return
+        std::cos(yaw) * (location.x - center.x) +
+        std::sin(yaw) * (location.y - center.y);
+  }
+
+  /// Complete @a waypoint, the projection of @a location on its lane, with
+  /// the lateral offset of @a location from the center of the lane.
+  static boost::optional<FrenetPoint> MakeFrenetPoint(
+      const Map &map,
+      const MapData &data,
+      const boost::optional<Waypoint> &waypoint,
+      const geom::Location &location) {
+    if (!waypoint.has_value()) {
+      return boost::optional<FrenetPoint>{};
+    }
+    const auto center = map.ComputeTransform(*waypoint);
+    const auto right = GetRightVector2D(data.GetRoad(waypoint->road_id), *waypoint);
+    const double dx = location.x - center.location.x;
+    const double dy = location.y - center.location.y;
+    return FrenetPoint{*waypoint, right.first * dx + right.second * dy};
+  }
+
   // ===========================================================================
   // -- Map: Geometry ----------------------------------------------------------
   // ===========================================================================
@@ -165,8 +234,8 @@ namespace road {
     double dists[max_nearests];
     std::fill(dists, dists + max_nearest_allowed, 0.0);
 
-    for (const auto &road_pair : _data.GetRoads()) {
-      const auto road = &road_pair.second;
+    for (const auto &road_ref : _data.GetRoads()) {
+      const auto road = &road_ref;
       const auto current_dist = road->GetNearestPoint(pos_inverted_y);
 
       for (int i = 0; i < max_nearest_allowed; ++i) {
@@ -203,21 +272,77 @@ namespace road {
       return boost::optional<Waypoint>{};
     }
 
-    const auto &road = _data.GetRoad(waypoint.road_id);
+    FinishWaypointOnRoad(_data.GetRoad(waypoint.road_id), waypoint);
+    return waypoint;
+  }
 
-    // Make sure 0.0 < waipoint.s < Road's length
-    constexpr double margin = 5.0 * EPSILON;
-    DEBUG_ASSERT(margin < road.GetLength() - margin);
-    waypoint.s = geom::Math::clamp<double>(waypoint.s, margin, road.GetLength() - margin);
+  boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
+      const geom::Location &pos,
+      const Waypoint &hint,
+      uint32_t lane_type) const {
+    if (!_data.ContainsRoad(hint.road_id)) {
+      return GetClosestWaypointOnRoad(pos, lane_type);
+    }
 
-    auto &lane = road.GetLaneByDistance(waypoint.s, waypoint.lane_id);
+    // Unreal's Y axis hack
+    const auto pos_inverted_y = geom::Location(pos.x, -pos.y, pos.z);
 
-    const auto lane_section = lane.GetLaneSection();
-    THROW_INVALID_INPUT_ASSERT(lane_section != nullptr);
-    const auto lane_section_id = lane_section->GetId();
-    waypoint.section_id = lane_section_id;
+    using Candidate = std::pair<Waypoint, double>;
 
-    return waypoint;
+    // Nearest lane of @a road, together with its distance, if it contains the
+    // location.
+    auto search_road = [&](const Road &road) -> boost::optional<Candidate> {
+      const auto nearest_point = road.GetNearestPoint(pos_inverted_y);
+      const auto lane_dist = road.GetNearestLane(nearest_point.first, pos_inverted_y, lane_type);
+      if (lane_dist.first == nullptr) {
+        return boost::optional<Candidate>{};
+      }
+      Waypoint waypoint;
+      waypoint.road_id = road.GetId();
+      waypoint.lane_id = lane_dist.first->GetId();
+      waypoint.s = nearest_point.first;
+      FinishWaypointOnRoad(road, waypoint);
+      if (!IsWithinLane(waypoint, pos)) {
+        return boost::optional<Candidate>{};
+      }
+      // Locations beyond the ends of the road belong to the roads connected.
+      constexpr double max_longitudinal_offset = 0.05;
+      const auto offset = GetLongitudinalOffset(
+          road,
+          waypoint.s,
+          ComputeTransform(waypoint).location,
+          pos);
+      if (std::abs(offset) > max_longitudinal_offset) {
+        return boost::optional<Candidate>{};
+      }
+      return Candidate{waypoint, lane_dist.second};
+    };
+
+    const auto &road = _data.GetRoad(hint.road_id);
+    const auto result = search_road(road);
+    if (result.has_value()) {
+      return result->first;
+    }
+
+    // Several roads connected may contain the location (e.g. the roads of a
+    // junction), take the nearest lane as the full search does.
+    boost::optional<Candidate> nearest;
+    auto search_connected = [&](const std::vector<Road *> &roads) {
+      for (auto *other : roads) {
+        DEBUG_ASSERT(other != nullptr);
+        const auto candidate = search_road(*other);
+        if (candidate.has_value() &&
+            (!nearest.has_value() || (candidate->second < nearest->second))) {
+          nearest = candidate;
+        }
+      }
+    };
+    search_connected(road.GetNexts());
+    search_connected(road.GetPrevs());
+    if (nearest.has_value()) {
+      return nearest->first;
+    }
+    return GetClosestWaypointOnRoad(pos, lane_type);
   }
 
   boost::optional<Waypoint> Map::GetWaypoint(
@@ -229,18 +354,40 @@ namespace road {
       return w;
     }
 
-    const auto dist = geom::Math::Distance2D(ComputeTransform(*w).location, pos);
-    const auto lane_width_info = GetLane(*w).GetInfo<RoadInfoLaneWidth>(w->s);
-    const auto half_lane_width =
-        lane_width_info->GetPolynomial().Evaluate(w->s) * 0.5;
-
-    if (dist < half_lane_width) {
+    if (IsWithinLane(*w, pos)) {
       return w;
     }
 
     return boost::optional<Waypoint>{};
   }
 
+  boost::optional<Waypoint> Map::GetWaypoint(
+      const RoadId road_id,
+      const LaneId lane_id,
+      const double s) const {
+    if ((lane_id == 0) || !_data.ContainsRoad(road_id)) {
+      return boost::optional<Waypoint>{};
+    }
+    const auto &road = _data.GetRoad(road_id);
+    if ((s < 0.0) || (s > road.GetLength())) {
+      return boost::optional<Waypoint>{};
+    }
+    for (const auto &section : road.GetLaneSectionsAt(s)) {
+      if (section.ContainsLane(lane_id)) {
+        return Waypoint{road_id, section.GetId(), lane_id, s};
+      }
+    }
+    return boost::optional<Waypoint>{};
+  }
+
+  bool Map::IsWithinLane(const Waypoint waypoint, const geom::Location &pos) const {
+    const auto dist = geom::Math::Distance2D(ComputeTransform(waypoint).location, pos);
+    const auto lane_width_info = GetLane(waypoint).GetInfo<RoadInfoLaneWidth>(waypoint.s);
+    const auto half_lane_width =
+        lane_width_info->GetPolynomial().Evaluate(waypoint.s) * 0.5;
+    return dist < half_lane_width;
+  }
+
   geom::Transform Map::ComputeTransform(Waypoint waypoint) const {
     // lane_id can't be 0
     THROW_INVALID_INPUT_ASSERT(waypoint.lane_id != 0);
@@ -252,26 +399,36 @@ namespace road {
     THROW_INVALID_INPUT_ASSERT(waypoint.s >= 0.0);
 
     const auto &lane_section = road.GetLaneSectionById(waypoint.section_id);
-    const std::map<LaneId, Lane> &lanes = lane_section.GetLanes();
+    // lanes sorted by id
+    const auto lanes = lane_section.GetLanes();
+    const auto lanes_begin = lanes.begin();
+    const auto lanes_end = lanes.end();
 
     // check that lane_id exists on the current s
     THROW_INVALID_INPUT_ASSERT(!lanes.empty());
-    THROW_INVALID_INPUT_ASSERT(waypoint.lane_id >= lanes.begin()->first);
-    THROW_INVALID_INPUT_ASSERT(waypoint.lane_id <= lanes.rbegin()->first);
+    THROW_INVALID_INPUT_ASSERT(waypoint.lane_id >= lanes_begin->GetId());
+    THROW_INVALID_INPUT_ASSERT(waypoint.lane_id <= (lanes_end - 1)->GetId());
+
+    auto lower_bound = [&](LaneId lane_id) {
+      return std::lower_bound(lanes_begin, lanes_end, lane_id, [](const Lane &lane, LaneId id) {
+        return lane.GetId() < id;
+      });
+    };
 
     double lane_width = 0;
     double lane_tangent = 0;
     if (waypoint.lane_id < 0) {
       // right lane
       const auto side_lanes = MakeListView(
-          std::make_reverse_iterator(lanes.lower_bound(0)), lanes.rend());
+          std::make_reverse_iterator(lower_bound(0)),
+          std::make_reverse_iterator(lanes_begin));
       const auto computed_width =
           ComputeTotalLaneWidth(side_lanes, waypoint.s, waypoint.lane_id);
       lane_width = computed_width.first;
       lane_tangent = computed_width.second;
     } else {
       // left lane
-      const auto side_lanes = MakeListView(lanes.lower_bound(1), lanes.end());
+      const auto side_lanes = MakeListView(lower_bound(1), lanes_end);
       const auto computed_width =
           ComputeTotalLaneWidth(side_lanes, waypoint.s, waypoint.lane_id);
       lane_width = computed_width.first;
@@ -310,6 +467,58 @@ namespace road {
     return geom::Transform(dp.location, rot);
   }
 
+  // ===========================================================================
+  // -- Map: Frenet coordinates ------------------------------------------------
+  // ===========================================================================
+
+  boost::optional<FrenetPoint> Map::ToFrenet(
+      const geom::Location &location,
+      const uint32_t lane_type) const {
+    return MakeFrenetPoint(*this, _data, GetClosestWaypointOnRoad(location, lane_type), location);
+  }
+
+  boost::optional<FrenetPoint> Map::ToFrenet(
+      const geom::Location &location,
+      const Waypoint &hint,
+      const uint32_t lane_type) const {
+    return MakeFrenetPoint(*this, _data, GetClosestWaypointOnRoad(location, hint, lane_type), location);
+  }
+
+  std::vector<boost::optional<FrenetPoint>> Map::ToFrenet(
+      const std::vector<geom::Location> &polyline,
+      const uint32_t lane_type) const {
+    std::vector<boost::optional<FrenetPoint>> result;
+    result.reserve(polyline.size());
+    boost::optional<Waypoint> hint;
+    for (const auto &location : polyline) {
+      const auto waypoint = hint.has_value() ?
+          GetClosestWaypointOnRoad(location, *hint, lane_type) :
+          GetClosestWaypointOnRoad(location, lane_type);
+      if (waypoint.has_value()) {
+        hint = waypoint;
+      }
+      result.emplace_back(MakeFrenetPoint(*this, _data, waypoint, location));
+    }
+    return result;
+  }
+
+  geom::Transform Map::FromFrenet(const FrenetPoint &point) const {
+    auto transform = ComputeTransform(point.waypoint);
+    const auto right = GetRightVector2D(_data.GetRoad(point.waypoint.road_id), point.waypoint);
+    transform.location.x += static_cast<float>(point.t * right.first);
+    transform.location.y += static_cast<float>(point.t * right.second);
+    return transform;
+  }
+
+  std::vector<geom::Transform> Map::FromFrenet(const std::vector<FrenetPoint> &points) const {
+    std::vector<geom::Transform> result;
+    result.reserve(points.size());
+    for (const auto &point : points) {
+      result.emplace_back(FromFrenet(point));
+    }
+    return result;
+  }
+
   // ===========================================================================
   // -- Map: Road information --------------------------------------------------
   // ===========================================================================
@@ -440,8 +649,7 @@ namespace road {
 
   std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
     std::vector<Waypoint> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
+    for (const auto &road : _data.GetRoads()) {
       for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) {
         ForEachDrivableLaneAt(road, s, [&](auto &&waypoint) {
           result.emplace_back(waypoint);
@@ -453,8 +661,7 @@ namespace road {
 
   std::vector<std::pair<Waypoint, Waypoint>> Map::GenerateTopology() const {
     std::vector<std::pair<Waypoint, Waypoint>> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
+    for (const auto &road : _data.GetRoads()) {
       ForEachDrivableLane(road, [&](auto &&waypoint) {
         for (auto &&successor : GetSuccessors(waypoint)) {
           result.push_back({waypoint, successor});
@@ -464,6 +671,205 @@ namespace road {
     return result;
   }
 
+  /// Call @a functor for each lane section of @a road with non-zero length,
+  /// with the section and the distances where it starts and ends.
+  template <typename FuncT>
+  static void ForEachLaneSection(const Road &road, FuncT &&functor) {
+    const auto sections = road.GetLaneSections();
+    for (auto section = sections.begin(); section != sections.end(); ++section) {
+      const double start = section->GetDistance();
+      const double end = (section + 1) != sections.end() ?
+          (section + 1)->GetDistance() :
+          road.GetLength();
+      if (end > start) {
+        functor(*section, start, end);
+      }
+    }
+  }
+
+  /// Number of points needed to sample [start, end] at most every @a
+  /// resolution meters, both ends included.
+  static size_t GetNumberOfSamples(const double start, const double end, const double resolution) {
+    return static_cast<size_t>(std::ceil((end - start) / resolution)) + 1u;
+  }
+
+  /// Append the x, y, z coordinates of @a location to @a points.
+  static void AppendLocation(std::vector<float> &points, const geom::Location &location) {
+    points.emplace_back(location.x);
+    points.emplace_back(location.y);
+    points.emplace_back(location.z);
+  }
+
+  /// Appends the type and color of consecutive mark records, parsing each
+  /// record only once.
+  class MarkingAppender {
+  public:
+
+    MarkingAppender(std::vector<uint8_t> &types, std::vector<uint8_t> &colors)
+      : _types(types),
+        _colors(colors) {}
+
+    /// Append the marking of @a record, or no marking if @a record is null.
+    void Append(const RoadInfoMarkRecord *record) {
+      if ((record != _record) || !_is_valid) {
+        if (record != nullptr) {
+          const LaneMarking marking(*record);
+          _type = static_cast<uint8_t>(marking.type);
+          _color = static_cast<uint8_t>(marking.color);
+        } else {
+          _type = static_cast<uint8_t>(LaneMarking::Type::None);
+          _color = static_cast<uint8_t>(LaneMarking::Color::Standard);
+        }
+        _record = record;
+        _is_valid = true;
+      }
+      _types.emplace_back(_type);
+      _colors.emplace_back(_color);
+    }
+
+  private:
+
+    std::vector<uint8_t> &_types;
+
+    std::vector<uint8_t> &_colors;
+
+    const RoadInfoMarkRecord *_record = nullptr;
+
+    bool _is_valid = false;
+
+    uint8_t _type = 0u;
+
+    uint8_t _color = 0u;
+  };
+
+  LaneGeometry Map::ComputeLaneGeometry(const double resolution, const uint32_t lane_type) const {
+    THROW_INVALID_INPUT_ASSERT(resolution > 0.0);
+    auto is_selected = [lane_type](const Lane &lane) {
+      return (lane.GetId() != 0) && ((static_cast<uint32_t>(lane.GetType()) & lane_type) != 0u);
+    };
+
+    // Count the lanes and points first to allocate the arrays only once.
+    size_t number_of_lanes = 0u;
+    size_t number_of_points = 0u;
+    for (const auto &road : _data.GetRoads()) {
+      ForEachLaneSection(road, [&](const LaneSection &section, double start, double end) {
+        for (const auto &lane : section.GetLanes()) {
+          if (is_selected(lane)) {
+            ++number_of_lanes;
+            number_of_points += GetNumberOfSamples(start, end, resolution);
+          }
+        }
+      });
+    }
+
+    LaneGeometry result;
+    result.road_ids.reserve(number_of_lanes);
+    result.section_ids.reserve(number_of_lanes);
+    result.lane_ids.reserve(number_of_lanes);
+    result.lane_types.reserve(number_of_lanes);
+    result.offsets.reserve(number_of_lanes + 1u);
+    result.distances.reserve(number_of_points);
+    result.centers.reserve(3u * number_of_points);
+    result.left_boundaries.reserve(3u * number_of_points);
+    result.right_boundaries.reserve(3u * number_of_points);
+    result.left_marking_types.reserve(number_of_points);
+    result.left_marking_colors.reserve(number_of_points);
+    result.right_marking_types.reserve(number_of_points);
+    result.right_marking_colors.reserve(number_of_points);
+
+    // The reference line at each sample, and the lateral offset of the center
+    // of each lane and half its width at each sample, of the current section.
+    std::vector<DirectedPoint> references;
+    std::vector<std::pair<double, double>> lane_offsets;
+    for (const auto &road : _data.GetRoads()) {
+      ForEachLaneSection(road, [&](const LaneSection &section, double start, double end) {
+        const auto number_of_samples = GetNumberOfSamples(start, end, resolution);
+        auto get_s = [&](size_t i) {
+          return std::min(
+              start + (end - start) * static_cast<double>(i) / static_cast<double>(number_of_samples - 1u),
+              road.GetLength());
+        };
+        const auto lanes = section.GetLanes();
+        const auto number_of_section_lanes = static_cast<size_t>(lanes.size());
+        references.clear();
+        lane_offsets.resize(number_of_section_lanes * number_of_samples);
+        // Lanes are sorted by id, walk each side of the road outwards adding
+        // up the width of the lanes, as ComputeTransform does for each one.
+        const auto center_lane = static_cast<size_t>(std::distance(
+            lanes.begin(),
+            std::lower_bound(lanes.begin(), lanes.end(), 0, [](const Lane &lane, LaneId id) {
+              return lane.GetId() < id;
+            })));
+        for (auto i = 0u; i < number_of_samples; ++i) {
+          const double s = get_s(i);
+          references.emplace_back(road.GetDirectedPointIn(s));
+          auto add_lane = [&](size_t index, double &inner_width, double sign) {
+            const auto width_info = lanes.begin()[index].GetInfo<RoadInfoLaneWidth>(s);
+            THROW_INVALID_INPUT_ASSERT(width_info != nullptr);
+            const auto width = width_info->GetPolynomial().Evaluate(s);
+            lane_offsets[index * number_of_samples + i] =
+                std::make_pair(sign * (inner_width + 0.5 * width), 0.5 * width);
+            inner_width += width;
+          };
+          double right_width = 0.0;
+          for (auto index = center_lane; index > 0u; --index) {
+            add_lane(index - 1u, right_width, 1.0);
+          }
+          double left_width = 0.0;
+          for (auto index = center_lane; index < number_of_section_lanes; ++index) {
+            if (lanes.begin()[index].GetId() > 0) {
+              add_lane(index, left_width, -1.0);
+            }
+          }
+        }
+        size_t lane_index = 0u;
+        for (const auto &lane : lanes) {
+          const auto *lane_offset = lane_offsets.data() + number_of_samples * lane_index++;
+          if (!is_selected(lane)) {
+            continue;
+          }
+          // The right of the lane is its outer side, its left marking is the
+          // one of the next lane towards the center of the road.
+          const auto inner_lane_id = lane.GetId() < 0 ? lane.GetId() + 1 : lane.GetId() - 1;
+          const auto *inner_lane = section.GetLane(inner_lane_id);
+          MarkingAppender left_markings(result.left_marking_types, result.left_marking_colors);
+          MarkingAppender right_markings(result.right_marking_types, result.right_marking_colors);
+
+          result.road_ids.emplace_back(road.GetId());
+          result.section_ids.emplace_back(section.GetId());
+          result.lane_ids.emplace_back(lane.GetId());
+          result.lane_types.emplace_back(static_cast<uint32_t>(lane.GetType()));
+          result.offsets.emplace_back(static_cast<uint32_t>(result.GetNumberOfPoints()));
+
+          for (auto i = 0u; i < number_of_samples; ++i) {
+            const double s = get_s(i);
+            // Same location as ComputeTransform.
+            auto center = references[i];
+            center.ApplyLateralOffset(lane_offset[i].first);
+            // Unreal's Y axis hack
+            center.location.y *= -1;
+            const auto half_width = lane_offset[i].second;
+            // Unreal's Y axis hack
+            const auto right = GetRightVector2D(-references[i].tangent, lane.GetId());
+            const auto offset = geom::Location(
+                static_cast<float>(half_width * right.first),
+                static_cast<float>(half_width * right.second),
+                0.0f);
+
+            result.distances.emplace_back(static_cast<float>(s));
+            AppendLocation(result.centers, center.location);
+            AppendLocation(result.left_boundaries, center.location - offset);
+            AppendLocation(result.right_boundaries, center.location + offset);
+            left_markings.Append(inner_lane != nullptr ? inner_lane->GetInfo<RoadInfoMarkRecord>(s) : nullptr);
+            right_markings.Append(lane.GetInfo<RoadInfoMarkRecord>(s));
+          }
+        }
+      });
+    }
+    result.offsets.emplace_back(static_cast<uint32_t>(result.GetNumberOfPoints()));
+    return result;
+  }
+
   // ===========================================================================
   // -- Map: Private functions -------------------------------------------------
   // ===========================================================================
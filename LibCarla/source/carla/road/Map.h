@@ -8,8 +8,10 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/geom/Transform.h"
+#include "carla/road/LaneGeometry.h"
 #include "carla/road/MapData.h"
 #include "carla/road/RoadTypes.h"
+#include "carla/road/element/FrenetPoint.h"
 #include "carla/road/element/LaneMarking.h"
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/Waypoint.h"
@@ -48,12 +50,66 @@ namespace road {
         const geom::Location &location,
         uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
 
+    /// Same as above, but the lanes around @a hint (its road and the roads
+    /// connected to it) are searched first. The whole map is searched only if
+    /// @a location does not lie within any of these lanes.
+    ///
+    /// Useful for tracking a moving location, passing as @a hint the waypoint
+    /// found in the previous call.
+    boost::optional<element::Waypoint> GetClosestWaypointOnRoad(
+        const geom::Location &location,
+        const Waypoint &hint,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
     boost::optional<element::Waypoint> GetWaypoint(
         const geom::Location &location,
         uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
 
+    /// Return whether @a location lies within the width of the lane of @a
+    /// waypoint, @a waypoint being the closest waypoint to @a location.
+    bool IsWithinLane(Waypoint waypoint, const geom::Location &location) const;
+
     geom::Transform ComputeTransform(Waypoint waypoint) const;
 
+    /// Return the waypoint at distance @a s of the lane @a lane_id of road @a
+    /// road_id, or an empty optional if the road has no such lane at @a s.
+    boost::optional<element::Waypoint> GetWaypoint(
+        RoadId road_id,
+        LaneId lane_id,
+        double s) const;
+
+    /// ========================================================================
+    /// -- Frenet coordinates --------------------------------------------------
+    /// ========================================================================
+
+    /// Project @a location onto the closest lane of @a lane_type, see
+    /// GetClosestWaypointOnRoad, and return its lane-relative coordinates.
+    boost::optional<element::FrenetPoint> ToFrenet(
+        const geom::Location &location,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Same as above, but the lanes around @a hint are searched first.
+    boost::optional<element::FrenetPoint> ToFrenet(
+        const geom::Location &location,
+        const Waypoint &hint,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Project each point of @a polyline, e.g. a trajectory. The waypoint
+    /// found for each point is used as hint for the next one, so only the
+    /// first point, and the points leaving the lanes around the previous one,
+    /// search the whole map.
+    std::vector<boost::optional<element::FrenetPoint>> ToFrenet(
+        const std::vector<geom::Location> &polyline,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Return the transform of the lane center at @a point's waypoint,
+    /// displaced laterally by @a point's t.
+    geom::Transform FromFrenet(const element::FrenetPoint &point) const;
+
+    /// Batched version of FromFrenet.
+    std::vector<geom::Transform> FromFrenet(
+        const std::vector<element::FrenetPoint> &points) const;
+
     /// ========================================================================
     /// -- Road information ----------------------------------------------------
     /// ========================================================================
@@ -99,6 +155,13 @@ namespace road {
     /// map. The waypoints are placed at the entrance of each lane.
     std::vector<std::pair<Waypoint, Waypoint>> GenerateTopology() const;
 
+    /// Compute the center and boundary polylines of every lane of @a
+    /// lane_type, sampled at most every @a resolution meters along each lane
+    /// section, both ends included.
+    LaneGeometry ComputeLaneGeometry(
+        double resolution,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Any)) const;
+
 #ifdef LIBCARLA_WITH_GTEST
     MapData &GetMap() {
       return _data;
@@ -26,7 +26,9 @@
 #include "carla/road/signal/SignalReference.h"
 #include "carla/road/signal/SignalDependency.h"
 
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
 
 using namespace carla::road::element;
@@ -36,19 +38,16 @@ namespace road {
 
   boost::optional<Map> MapBuilder::Build() {
 
-    CreatePointersBetweenRoadSegments();
-
-    for (auto &&info : _temp_road_info_container) {
-      DEBUG_ASSERT(info.first != nullptr);
-      info.first->_info = InformationSet(std::move(info.second));
-    }
+    MoveRoadsToMapData();
 
-    for (auto &&info : _temp_lane_info_container) {
-      DEBUG_ASSERT(info.first != nullptr);
-      info.first->_info = InformationSet(std::move(info.second));
-    }
+    CreatePointersBetweenRoadSegments();
 
     // remove temporal already used information
+    _temp_roads.clear();
+    _temp_lane_sections.clear();
+    _temp_lanes.clear();
+    _temp_road_sections.clear();
+    _temp_section_lanes.clear();
     _temp_road_info_container.clear();
     _temp_lane_info_container.clear();
 
@@ -67,8 +66,8 @@ namespace road {
       const double c,
       const double d) {
     DEBUG_ASSERT(road != nullptr);
-    auto elevation = std::make_unique<RoadInfoElevation>(s, a, b, c, d);
-    _temp_road_info_container[road].emplace_back(std::move(elevation));
+    auto elevation = _map_data._info_pool.Create<RoadInfoElevation>(s, a, b, c, d);
+    _temp_road_info_container[road].emplace_back(elevation);
   }
 
   // called from lane parser
@@ -77,7 +76,7 @@ namespace road {
       const double s,
       const std::string restriction) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneAccess>(s, restriction));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneAccess>(s, restriction));
   }
 
   void MapBuilder::CreateLaneBorder(
@@ -88,7 +87,7 @@ namespace road {
       const double c,
       const double d) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneBorder>(s, a, b, c, d));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneBorder>(s, a, b, c, d));
   }
 
   void MapBuilder::CreateLaneHeight(
@@ -97,7 +96,7 @@ namespace road {
       const double inner,
       const double outer) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneHeight>(s, inner, outer));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneHeight>(s, inner, outer));
   }
 
   void MapBuilder::CreateLaneMaterial(
@@ -107,7 +106,7 @@ namespace road {
       const double friction,
       const double roughness) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneMaterial>(s, surface, friction,
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneMaterial>(s, surface, friction,
         roughness));
   }
 
@@ -116,7 +115,7 @@ namespace road {
       const double s,
       const std::string value) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneRule>(s, value));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneRule>(s, value));
   }
 
   void MapBuilder::CreateLaneVisibility(
@@ -127,7 +126,7 @@ namespace road {
       const double left,
       const double right) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneVisibility>(s, forward, back,
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneVisibility>(s, forward, back,
         left, right));
   }
 
@@ -139,7 +138,7 @@ namespace road {
       const double c,
       const double d) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoLaneWidth>(s, a, b, c, d));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoLaneWidth>(s, a, b, c, d));
   }
 
   void MapBuilder::CreateRoadMark(
@@ -169,7 +168,7 @@ namespace road {
     } else {
       lc = RoadInfoMarkRecord::LaneChange::None;
     }
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoMarkRecord>(s, road_mark_id, type,
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoMarkRecord>(s, road_mark_id, type,
         weight, color,
         material, width, lc, height, type_name, type_width));
   }
@@ -201,7 +200,7 @@ namespace road {
       const double max,
       const std::string /*unit*/) {
     DEBUG_ASSERT(lane != nullptr);
-    _temp_lane_info_container[lane].emplace_back(std::make_unique<RoadInfoSpeed>(s, max));
+    _temp_lane_info_container[lane].emplace_back(_map_data._info_pool.Create<RoadInfoSpeed>(s, max));
   }
 
   void MapBuilder::AddSignal(
@@ -224,7 +223,7 @@ namespace road {
       const double hOffset,
       const double pitch,
       const double roll) {
-    auto signals = _map_data.GetRoad(road_id).getSignals();
+    auto signals = GetRoad(road_id)->getSignals();
     DEBUG_ASSERT(signals != nullptr);
     signals->emplace(signal_id,
         signal::Signal(road_id, signal_id, s, t, name, dynamic,
@@ -237,7 +236,7 @@ namespace road {
       const uint32_t signal_id,
       const int32_t from_lane,
       const int32_t to_lane) {
-    _map_data.GetRoad(road_id).GetSignal(signal_id)->AddValidity(general::Validity(signal_id, from_lane,
+    GetRoad(road_id)->GetSignal(signal_id)->AddValidity(general::Validity(signal_id, from_lane,
         to_lane));
   }
 
@@ -251,10 +250,9 @@ namespace road {
       const int32_t successor) {
 
     // add it
-    auto road = &(_map_data._roads.emplace(road_id, Road()).first->second);
+    auto road = &(_temp_roads.emplace(road_id, Road()).first->second);
 
     // set road data
-    road->_map_data = &_map_data;
     road->_id = road_id;
     road->_name = name;
     road->_length = length;
@@ -271,8 +269,10 @@ namespace road {
       const SectionId id,
       const double s) {
     DEBUG_ASSERT(road != nullptr);
-    carla::road::LaneSection &sec = road->_lane_sections.Emplace(id, s);
+    _temp_lane_sections.emplace_back(id, s);
+    carla::road::LaneSection &sec = _temp_lane_sections.back();
     sec._road = road;
+    _temp_road_sections[road].emplace_back(&sec);
     return &sec;
   }
 
@@ -285,8 +285,16 @@ namespace road {
       const int32_t successor) {
     DEBUG_ASSERT(section != nullptr);
 
-    // add the lane
-    auto *lane = &((section->_lanes.emplace(lane_id, Lane()).first)->second);
+    // add the lane, unless the section already has one with this id
+    auto &lanes = _temp_section_lanes[section];
+    for (auto *lane : lanes) {
+      if (lane->_id == lane_id) {
+        return lane;
+      }
+    }
+    _temp_lanes.emplace_back();
+    auto *lane = &_temp_lanes.back();
+    lanes.emplace_back(lane);
 
     // set lane data
     lane->_id = lane_id;
@@ -313,8 +321,8 @@ namespace road {
         hdg,
         geom::Location(x, y, 0.0));
 
-    _temp_road_info_container[road].emplace_back(std::unique_ptr<RoadInfo>(new RoadInfoGeometry(s,
-        std::move(line_geometry))));
+    _temp_road_info_container[road].emplace_back(_map_data._info_pool.Create<RoadInfoGeometry>(s,
+        std::move(line_geometry)));
   }
 
   void MapBuilder::CreateRoadSpeed(
@@ -324,7 +332,7 @@ namespace road {
       const double max,
       const std::string /*unit*/) {
     DEBUG_ASSERT(road != nullptr);
-    _temp_road_info_container[road].emplace_back(std::make_unique<RoadInfoSpeed>(s, max));
+    _temp_road_info_container[road].emplace_back(_map_data._info_pool.Create<RoadInfoSpeed>(s, max));
   }
 
   void MapBuilder::CreateSectionOffset(
@@ -335,7 +343,7 @@ namespace road {
       const double c,
       const double d) {
     DEBUG_ASSERT(road != nullptr);
-    _temp_road_info_container[road].emplace_back(std::make_unique<RoadInfoLaneOffset>(s, a, b, c, d));
+    _temp_road_info_container[road].emplace_back(_map_data._info_pool.Create<RoadInfoLaneOffset>(s, a, b, c, d));
   }
 
   void MapBuilder::AddRoadGeometryArc(
@@ -354,8 +362,8 @@ namespace road {
         geom::Location(x, y, 0.0),
         curvature);
 
-    _temp_road_info_container[road].emplace_back(std::unique_ptr<RoadInfo>(new RoadInfoGeometry(s,
-        std::move(arc_geometry))));
+    _temp_road_info_container[road].emplace_back(_map_data._info_pool.Create<RoadInfoGeometry>(s,
+        std::move(arc_geometry)));
   }
 
   void MapBuilder::AddRoadGeometrySpiral(
@@ -431,8 +439,8 @@ namespace road {
       const uint32_t signal_id,
       const int32_t from_lane,
       const int32_t to_lane) {
-    DEBUG_ASSERT(_map_data.GetRoad(road_id).GetSignal(signal_id) != nullptr);
-    _map_data.GetRoad(road_id).GetSignal(signal_id)->AddValidity(general::Validity(signal_id, from_lane,
+    DEBUG_ASSERT(GetRoad(road_id)->GetSignal(signal_id) != nullptr);
+    GetRoad(road_id)->GetSignal(signal_id)->AddValidity(general::Validity(signal_id, from_lane,
         to_lane));
   }
 
@@ -441,8 +449,8 @@ namespace road {
       const uint32_t signal_reference_id,
       const int32_t from_lane,
       const int32_t to_lane) {
-    DEBUG_ASSERT(_map_data.GetRoad(road_id).GetSignalRef(signal_reference_id) != nullptr);
-    _map_data.GetRoad(road_id).GetSignalRef(signal_reference_id)->AddValidity(general::Validity(
+    DEBUG_ASSERT(GetRoad(road_id)->GetSignalRef(signal_reference_id) != nullptr);
+    GetRoad(road_id)->GetSignalRef(signal_reference_id)->AddValidity(general::Validity(
         signal_reference_id, from_lane, to_lane));
   }
 
@@ -452,8 +460,8 @@ namespace road {
       const double s_position,
       const double t_position,
       const std::string signal_reference_orientation) {
-    DEBUG_ASSERT(_map_data.GetRoad(road_id).getSignalReferences() != nullptr);
-    _map_data.GetRoad(road_id).getSignalReferences()->emplace(signal_reference_id,
+    DEBUG_ASSERT(GetRoad(road_id)->getSignalReferences() != nullptr);
+    GetRoad(road_id)->getSignalReferences()->emplace(signal_reference_id,
         signal::SignalReference(road_id, signal_reference_id, s_position, t_position,
         signal_reference_orientation));
   }
@@ -463,8 +471,8 @@ namespace road {
       const uint32_t signal_id,
       const uint32_t dependency_id,
       const std::string dependency_type) {
-    DEBUG_ASSERT(_map_data.GetRoad(road_id).GetSignal(signal_id) != nullptr);
-    _map_data.GetRoad(road_id).GetSignal(signal_id)->AddDependency(signal::SignalDependency(
+    DEBUG_ASSERT(GetRoad(road_id)->GetSignal(signal_id) != nullptr);
+    GetRoad(road_id)->GetSignal(signal_id)->AddDependency(signal::SignalDependency(
         road_id,
         signal_id,
         dependency_id,
@@ -475,12 +483,104 @@ namespace road {
       const RoadId road_id,
       const LaneId lane_id,
       const double s) {
-    return &_map_data.GetRoad(road_id).GetLaneByDistance(s, lane_id);
+    // same as Road::GetLaneByDistance, the lanes are not in the road yet
+    const auto &sections = _temp_road_sections[GetRoad(road_id)];
+    double distance = std::numeric_limits<double>::lowest();
+    for (auto *section : sections) {
+      if ((section->GetDistance() <= s) && (section->GetDistance() > distance)) {
+        distance = section->GetDistance();
+      }
+    }
+    for (auto *section : sections) {
+      if (section->GetDistance() == distance) {
+        for (auto *lane : _temp_section_lanes[section]) {
+          if (lane->GetId() == lane_id) {
+            return lane;
+          }
+        }
+      }
+    }
+    throw_exception(std::runtime_error("lane not found"));
   }
 
   Road *MapBuilder::GetRoad(
       const RoadId road_id) {
-    return &_map_data.GetRoad(road_id);
+    return &_temp_roads.at(road_id);
+  }
+
+  void MapBuilder::MoveRoadsToMapData() {
+    auto &data = _map_data;
+
+    // reserve everything first, so the pointers between the elements remain
+    // valid while they are moved
+    size_t number_of_infos = 0u;
+    for (auto &&info : _temp_road_info_container) {
+      number_of_infos += info.second.size();
+    }
+    for (auto &&info : _temp_lane_info_container) {
+      number_of_infos += info.second.size();
+    }
+    data._roads.reserve(_temp_roads.size());
+    data._lane_sections.reserve(_temp_lane_sections.size());
+    data._lanes.reserve(_temp_lanes.size());
+    data._infos.reserve(number_of_infos);
+
+    // infos of each road and lane sorted by distance
+    auto make_information_set = [&](auto &infos, const auto *key) {
+      const auto begin = data._infos.size();
+      auto it = infos.find(key);
+      if (it != infos.end()) {
+        std::stable_sort(it->second.begin(), it->second.end(), [](const RoadInfo *lhs, const RoadInfo *rhs) {
+          return lhs->GetDistance() < rhs->GetDistance();
+        });
+        data._infos.insert(data._infos.end(), it->second.begin(), it->second.end());
+      }
+      return InformationSet(data._infos.data() + begin, data._infos.data() + data._infos.size());
+    };
+
+    std::vector<RoadId> road_ids;
+    road_ids.reserve(_temp_roads.size());
+    for (auto &&road : _temp_roads) {
+      road_ids.emplace_back(road.first);
+    }
+    std::sort(road_ids.begin(), road_ids.end());
+
+    for (auto road_id : road_ids) {
+      Road &temp_road = _temp_roads.at(road_id);
+      data._roads.emplace_back(std::move(temp_road));
+      Road &road = data._roads.back();
+      road._map_data = &data;
+      road._info = make_information_set(_temp_road_info_container, &temp_road);
+
+      auto &sections = _temp_road_sections[&temp_road];
+      std::stable_sort(sections.begin(), sections.end(), [](const LaneSection *lhs, const LaneSection *rhs) {
+        return lhs->GetDistance() < rhs->GetDistance();
+      });
+      auto *first_section = data._lane_sections.data() + data._lane_sections.size();
+      for (auto *temp_section : sections) {
+        data._lane_sections.emplace_back(std::move(*temp_section));
+        LaneSection &section = data._lane_sections.back();
+        section._road = &road;
+
+        auto &lanes = _temp_section_lanes[temp_section];
+        std::sort(lanes.begin(), lanes.end(), [](const Lane *lhs, const Lane *rhs) {
+          return lhs->GetId() < rhs->GetId();
+        });
+        auto *first_lane = data._lanes.data() + data._lanes.size();
+        for (auto *temp_lane : lanes) {
+          data._lanes.emplace_back(std::move(*temp_lane));
+          Lane &lane = data._lanes.back();
+          lane._lane_section = &section;
+          lane._info = make_information_set(_temp_lane_info_container, temp_lane);
+        }
+        section._lanes = std::make_pair(first_lane, data._lanes.data() + data._lanes.size());
+      }
+      road._lane_sections = std::make_pair(first_section, data._lane_sections.data() + data._lane_sections.size());
+    }
+
+    DEBUG_ASSERT(data._lane_sections.size() == _temp_lane_sections.size());
+    DEBUG_ASSERT(data._lanes.size() == _temp_lanes.size());
+    DEBUG_ASSERT(data._infos.size() == number_of_infos);
   }
 
   // return the pointer to a lane object
@@ -515,7 +615,7 @@ namespace road {
     Road &road = _map_data.GetRoad(road_id);
 
     // get the section
-    LaneSection &section = road._lane_sections.GetById(section_id);
+    LaneSection &section = road.GetLaneSectionById(section_id);
 
     // get the lane
     Lane *lane = section.GetLane(lane_id);
@@ -538,7 +638,7 @@ namespace road {
 
     // check if we are in a lane section in the middle
     if ((lane_id > 0 && s > 0) ||
-        (lane_id <= 0 && road._lane_sections.upper_bound(s) != road._lane_sections.end())) {
+        (lane_id <= 0 && (road._lane_sections.second - 1)->GetDistance() > s)) {
       // check if lane has a next link (if not, it deads in the middle section)
       if (next != 0 || (lane_id == 0 && next == 0)) {
         // change to next / prev section
@@ -603,54 +703,72 @@ namespace road {
 
   // assign pointers to the next lanes
   void MapBuilder::CreatePointersBetweenRoadSegments(void) {
+    auto &lanes = _map_data._lanes;
+    auto index_of = [&](const Lane *lane) {
+      DEBUG_ASSERT(lane != nullptr);
+      return static_cast<size_t>(lane - lanes.data());
+    };
+
+    std::vector<std::vector<Lane *>> next_lanes(lanes.size());
+    std::vector<std::vector<Lane *>> prev_lanes(lanes.size());
+
     // process each lane to define its nexts
-    for (auto &road : _map_data._roads) {
-      for (auto &section : road.second._lane_sections) {
-        for (auto &lane : section.second._lanes) {
-
-          // assign the next lane pointers
-          lane.second._next_lanes = GetLaneNext(road.first, section.second._id, lane.first);
-
-          // add to each lane found, this as its predecessor
-          for (auto next_lane : lane.second._next_lanes) {
-            // add as previous
-            DEBUG_ASSERT(next_lane != nullptr);
-            next_lane->_prev_lanes.push_back(&lane.second);
-          }
+    for (auto &lane : lanes) {
+      const LaneSection *section = lane._lane_section;
 
-        }
+      // assign the next lane pointers
+      auto &nexts = next_lanes[index_of(&lane)];
+      nexts = GetLaneNext(section->_road->_id, section->_id, lane._id);
+
+      // add to each lane found, this as its predecessor
+      for (auto next_lane : nexts) {
+        prev_lanes[index_of(next_lane)].push_back(&lane);
       }
     }
 
-    // process each lane to define its nexts
-    for (auto &road : _map_data._roads) {
-      for (auto &section : road.second._lane_sections) {
-        for (auto &lane : section.second._lanes) {
-
-          // add next roads
-          for (auto next_lane : lane.second._next_lanes) {
-            DEBUG_ASSERT(next_lane != nullptr);
-            // avoid same road
-            if (next_lane->GetRoad() != &road.second) {
-              if (std::find(road.second._nexts.begin(), road.second._nexts.end(),
-                  next_lane->GetRoad()) == road.second._nexts.end()) {
-                road.second._nexts.push_back(next_lane->GetRoad());
-              }
-            }
-          }
+    // store the links of all lanes in a single vector
+    size_t number_of_links = 0u;
+    for (auto i = 0u; i < lanes.size(); ++i) {
+      number_of_links += next_lanes[i].size() + prev_lanes[i].size();
+    }
+    auto &links = _map_data._lane_links;
+    links.reserve(number_of_links);
+    auto append = [&](const std::vector<Lane *> &source) {
+      const auto begin = links.size();
+      links.insert(links.end(), source.begin(), source.end());
+      return std::pair<Lane *const *, Lane *const *>(links.data() + begin, links.data() + links.size());
+    };
+    for (auto i = 0u; i < lanes.size(); ++i) {
+      lanes[i]._next_lanes = append(next_lanes[i]);
+      lanes[i]._prev_lanes = append(prev_lanes[i]);
+    }
 
-          // add prev roads
-          for (auto prev_lane : lane.second._prev_lanes) {
-            DEBUG_ASSERT(prev_lane != nullptr);
-            // avoid same road
-            if (prev_lane->GetRoad() != &road.second) {
-              if (std::find(road.second._prevs.begin(), road.second._prevs.end(),
-                  prev_lane->GetRoad()) == road.second._prevs.end()) {
-                road.second._prevs.push_back(prev_lane->GetRoad());
-              }
-            }
+    // process each lane to define the nexts and prevs of its road
+    for (auto &lane : lanes) {
+      Road *road = lane.GetRoad();
+      DEBUG_ASSERT(road != nullptr);
+
+      // add next roads
+      for (auto next_lane : lane.GetNextLanes()) {
+        DEBUG_ASSERT(next_lane != nullptr);
+        // avoid same road
+        if (next_lane->GetRoad() != road) {
+          if (std::find(road->_nexts.begin(), road->_nexts.end(),
+              next_lane->GetRoad()) == road->_nexts.end()) {
+            road->_nexts.push_back(next_lane->GetRoad());
           }
+        }
+      }
 
+      // add prev roads
+      for (auto prev_lane : lane.GetPreviousLanes()) {
+        DEBUG_ASSERT(prev_lane != nullptr);
+        // avoid same road
+        if (prev_lane->GetRoad() != road) {
+          if (std::find(road->_prevs.begin(), road->_prevs.end(),
+              prev_lane->GetRoad()) == road->_prevs.end()) {
+            road->_prevs.push_back(prev_lane->GetRoad());
+          }
         }
       }
     }
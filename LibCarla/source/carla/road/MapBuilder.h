@@ -10,7 +10,10 @@
 
 #include <boost/optional.hpp>
 
+#include <deque>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace road {
@@ -329,6 +332,11 @@ namespace road {
 
     MapData _map_data;
 
+    /// Move the roads, lane sections, lanes and infos added to the contiguous
+    /// storage of the map data. The pointers returned while adding them are
+    /// not valid afterwards.
+    void MoveRoadsToMapData();
+
     /// Create the pointers between RoadSegments based on the ids.
     void CreatePointersBetweenRoadSegments();
 
@@ -344,12 +352,25 @@ namespace road {
         RoadId road_id,
         LaneId lane_id);
 
+    /// Roads, lane sections and lanes added, with stable addresses until the
+    /// map is built.
+    std::unordered_map<RoadId, Road> _temp_roads;
+
+    std::deque<LaneSection> _temp_lane_sections;
+
+    std::deque<Lane> _temp_lanes;
+
+    std::unordered_map<const Road *, std::vector<LaneSection *>> _temp_road_sections;
+
+    std::unordered_map<const LaneSection *, std::vector<Lane *>> _temp_section_lanes;
+
     /// Map to temporary store all the road and lane infos until the map is
-    /// built, so they can be added all together.
-    std::unordered_map<Road *, std::vector<std::unique_ptr<element::RoadInfo>>>
+    /// built, so they can be added all together. The infos are owned by the
+    /// info pool of the map data.
+    std::unordered_map<const Road *, std::vector<element::RoadInfo *>>
     _temp_road_info_container;
 
-    std::unordered_map<Lane *, std::vector<std::unique_ptr<element::RoadInfo>>>
+    std::unordered_map<const Lane *, std::vector<element::RoadInfo *>>
     _temp_lane_info_container;
 
   };
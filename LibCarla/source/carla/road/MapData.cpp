@@ -5,25 +5,75 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "carla/road/MapData.h"
+
+#include "carla/Exception.h"
 #include "carla/road/Lane.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace carla {
 namespace road {
 
-  std::unordered_map<RoadId, Road> &MapData::GetRoads() {
-    return _roads;
+  MapData::MapData(MapData &&rhs) {
+    *this = std::move(rhs);
+  }
+
+  MapData &MapData::operator=(MapData &&rhs) {
+    _geo_reference = rhs._geo_reference;
+    _roads = std::move(rhs._roads);
+    _lane_sections = std::move(rhs._lane_sections);
+    _lanes = std::move(rhs._lanes);
+    _lane_links = std::move(rhs._lane_links);
+    _infos = std::move(rhs._infos);
+    _info_pool = std::move(rhs._info_pool);
+    _junctions = std::move(rhs._junctions);
+    // Moving the vectors keeps their elements in place, only the roads point
+    // back to the map.
+    for (auto &road : _roads) {
+      road._map_data = this;
+    }
+    return *this;
+  }
+
+  ListView<Road *> MapData::GetRoads() {
+    return MakeListView(_roads.data(), _roads.data() + _roads.size());
+  }
+
+  ListView<const Road *> MapData::GetRoads() const {
+    return MakeListView(_roads.data(), _roads.data() + _roads.size());
   }
 
   std::unordered_map<JuncId, Junction> &MapData::GetJunctions() {
     return _junctions;
   }
 
+  const Road *MapData::FindRoad(const RoadId id) const {
+    if (_roads.empty()) {
+      return nullptr;
+    }
+    // Road ids are usually consecutive, try first the road at the position
+    // given by its id.
+    const auto index = static_cast<size_t>(id - _roads.front().GetId());
+    if ((index < _roads.size()) && (_roads[index].GetId() == id)) {
+      return &_roads[index];
+    }
+    const auto it = std::lower_bound(_roads.begin(), _roads.end(), id, [](const Road &road, RoadId road_id) {
+      return road.GetId() < road_id;
+    });
+    return ((it != _roads.end()) && (it->GetId() == id)) ? &*it : nullptr;
+  }
+
   Road &MapData::GetRoad(const RoadId id) {
-    return _roads.at(id);
+    return const_cast<Road &>(static_cast<const MapData *>(this)->GetRoad(id));
   }
 
   const Road &MapData::GetRoad(const RoadId id) const {
-    return const_cast<MapData *>(this)->GetRoad(id);
+    const auto *road = FindRoad(id);
+    if (road == nullptr) {
+      throw_exception(std::out_of_range("road not found"));
+    }
+    return *road;
   }
 
   Junction *MapData::GetJunction(JuncId id) {
@@ -14,33 +14,49 @@
 #include "carla/road/Road.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/road/element/RoadInfo.h"
+#include "carla/road/element/RoadInfoPool.h"
 
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace road {
 
   class Lane;
 
+  /// The road network. Roads, lane sections and lanes are stored contiguously,
+  /// each in a single vector:
+  ///
+  ///   - roads are sorted by id;
+  ///   - lane sections are grouped by road, each road referencing its range,
+  ///     and sorted by distance within each road;
+  ///   - lanes are grouped by lane section, each section referencing its
+  ///     range, and sorted by id within each section.
+  ///
+  /// The info records are owned by typed pools, each road and lane
+  /// referencing a range of the records vector.
   class MapData : private MovableNonCopyable {
   public:
 
+    MapData(MapData &&rhs);
+
+    MapData &operator=(MapData &&rhs);
+
     const geom::GeoLocation &GetGeoReference() const {
       return _geo_reference;
     }
 
-    std::unordered_map<RoadId, Road> &GetRoads();
+    /// Roads sorted by id.
+    ListView<Road *> GetRoads();
 
-    const std::unordered_map<RoadId, Road> &GetRoads() const {
-      return _roads;
-    }
+    ListView<const Road *> GetRoads() const;
 
     std::unordered_map<JuncId, Junction> &GetJunctions();
 
     bool ContainsRoad(RoadId id) const {
-      return (_roads.find(id) != _roads.end());
+      return FindRoad(id) != nullptr;
     }
 
     Road &GetRoad(const RoadId id);
@@ -73,9 +89,23 @@ namespace road {
 
     MapData() = default;
 
+    const Road *FindRoad(RoadId id) const;
+
     geom::GeoLocation _geo_reference;
 
-    std::unordered_map<RoadId, Road> _roads;
+    std::vector<Road> _roads;
+
+    std::vector<LaneSection> _lane_sections;
+
+    std::vector<Lane> _lanes;
+
+    /// Next and previous lanes of each lane.
+    std::vector<Lane *> _lane_links;
+
+    /// Info records of each road and lane, sorted by distance.
+    std::vector<element::RoadInfo *> _infos;
+
+    element::RoadInfoPool _info_pool;
 
     std::unordered_map<JuncId, Junction> _junctions;
   };
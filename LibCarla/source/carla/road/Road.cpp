@@ -18,6 +18,9 @@
 #include "carla/road/element/RoadInfoLaneOffset.h"
 #include "carla/road/element/RoadInfoLaneWidth.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 
 namespace carla {
@@ -86,21 +89,73 @@ namespace road {
   }
 
   Lane &Road::GetLaneById(SectionId section_id, LaneId lane_id) {
-    return GetLaneSectionById(section_id).GetLanes().at(lane_id);
+    auto *lane = GetLaneSectionById(section_id).GetLane(lane_id);
+    if (lane == nullptr) {
+      throw_exception(std::out_of_range("lane not found"));
+    }
+    return *lane;
   }
 
   const Lane &Road::GetLaneById(SectionId section_id, LaneId lane_id) const {
     return const_cast<Road *>(this)->GetLaneById(section_id, lane_id);
   }
 
+  /// Comparators of lane sections by distance, for sorted ranges of sections.
+  static bool StartsBefore(const LaneSection &section, const double s) {
+    return section.GetDistance() < s;
+  }
+
+  static bool StartsAfter(const double s, const LaneSection &section) {
+    return s < section.GetDistance();
+  }
+
+  ListView<LaneSection *> Road::GetLaneSectionsAt(const double s) {
+    const auto begin = _lane_sections.first;
+    const auto upper = std::upper_bound(begin, _lane_sections.second, s, StartsAfter);
+    if (upper == begin) {
+      return MakeListView(_lane_sections.second, _lane_sections.second);
+    }
+    const auto lower = std::lower_bound(begin, upper, (upper - 1)->GetDistance(), StartsBefore);
+    return MakeListView(lower, upper);
+  }
+
+  ListView<const LaneSection *> Road::GetLaneSectionsAt(const double s) const {
+    auto sections = const_cast<Road *>(this)->GetLaneSectionsAt(s);
+    return MakeListView<const LaneSection *>(sections.begin(), sections.end());
+  }
+
+  LaneSection &Road::GetLaneSectionById(SectionId id) {
+    // Sections are usually numbered in order, try first the section at the
+    // position given by its id.
+    const auto count = static_cast<size_t>(_lane_sections.second - _lane_sections.first);
+    if ((id < count) && (_lane_sections.first[id].GetId() == id)) {
+      return _lane_sections.first[id];
+    }
+    for (auto it = _lane_sections.first; it != _lane_sections.second; ++it) {
+      if (it->GetId() == id) {
+        return *it;
+      }
+    }
+    throw_exception(std::out_of_range("lane section not found"));
+  }
+
+  const LaneSection &Road::GetLaneSectionById(SectionId id) const {
+    return const_cast<Road *>(this)->GetLaneSectionById(id);
+  }
+
+  double Road::UpperBound(double s) const {
+    const auto it = std::upper_bound(_lane_sections.first, _lane_sections.second, s, StartsAfter);
+    return it != _lane_sections.second ? it->GetDistance() : _length;
+  }
+
   // get the lane on a section next to 's'
   Lane *Road::GetNextLane(const double s, const LaneId lane_id) {
 
-    auto upper = _lane_sections.upper_bound(s);
+    auto upper = std::upper_bound(_lane_sections.first, _lane_sections.second, s, StartsAfter);
 
-    while (upper != _lane_sections.end()) {
+    while (upper != _lane_sections.second) {
       // check id
-      Lane *ptr = upper->second.GetLane(lane_id);
+      Lane *ptr = upper->GetLane(lane_id);
       if (ptr != nullptr) {
         return ptr;
       }
@@ -113,16 +168,15 @@ namespace road {
   // get the lane on a section previous to 's'
   Lane *Road::GetPrevLane(const double s, const LaneId lane_id) {
 
-    auto lower = _lane_sections.lower_bound(s);
-    auto rlower = std::make_reverse_iterator(lower);
+    auto lower = std::lower_bound(_lane_sections.first, _lane_sections.second, s, StartsBefore);
 
-    while (rlower != _lane_sections.rend()) {
+    while (lower != _lane_sections.first) {
       // check id
-      Lane *ptr = rlower->second.GetLane(lane_id);
+      --lower;
+      Lane *ptr = lower->GetLane(lane_id);
       if (ptr != nullptr) {
         return ptr;
       }
-      ++rlower;
     }
 
     return nullptr;
@@ -130,27 +184,22 @@ namespace road {
 
   // get the start and end section with a lan id
   LaneSection *Road::GetStartSection(LaneId id) {
-    auto it = _lane_sections.begin();
-    while (it != _lane_sections.end()) {
+    for (auto it = _lane_sections.first; it != _lane_sections.second; ++it) {
       // check id
-      Lane *ptr = it->second.GetLane(id);
-      if (ptr != nullptr) {
-        return &(it->second);
+      if (it->GetLane(id) != nullptr) {
+        return it;
       }
-      ++it;
     }
     return nullptr;
   }
 
   LaneSection *Road::GetEndSection(LaneId id) {
-    auto it = _lane_sections.rbegin();
-    while (it != _lane_sections.rend()) {
+    for (auto it = _lane_sections.second; it != _lane_sections.first;) {
+      --it;
       // check id
-      Lane *ptr = it->second.GetLane(id);
-      if (ptr != nullptr) {
-        return &(it->second);
+      if (it->GetLane(id) != nullptr) {
+        return it;
       }
-      ++it;
     }
     return nullptr;
   }
@@ -202,49 +251,37 @@ namespace road {
   const std::pair<double, double> Road::GetNearestPoint(const geom::Location &loc) const {
     std::pair<double, double> last = { 0.0, std::numeric_limits<double>::max() };
 
-    auto geom_info_list = _info.GetInfos<element::RoadInfoGeometry>();
-    decltype(geom_info_list)::iterator nearest_geom = geom_info_list.end();
-
-    for (auto g = geom_info_list.begin(); g != geom_info_list.end(); ++g) {
-      DEBUG_ASSERT(*g != nullptr);
-      auto dist = (*g)->GetGeometry().DistanceTo(loc);
+    // geometries are sorted by distance, accumulate the length of the ones
+    // before the nearest
+    double length_before = 0.0;
+    for (auto g = _info.GetInfoIterator<element::RoadInfoGeometry>(); !g.IsAtEnd(); ++g) {
+      auto dist = g->GetGeometry().DistanceTo(loc);
       if (dist.second < last.second) {
         last = dist;
-        nearest_geom = g;
+        last.first += length_before;
       }
-    }
-
-    for (auto g = geom_info_list.begin();
-        g != geom_info_list.end() && g != nearest_geom;
-        ++g) {
-      DEBUG_ASSERT(*g != nullptr);
-      last.first += (*g)->GetGeometry().GetLength();
+      length_before += g->GetGeometry().GetLength();
     }
 
     return last;
   }
 
-  const std::pair<const Lane *, double> Road::GetNearestLane(
+  /// Walk @a lanes, sorted from the center of the road outwards, displacing
+  /// @a dp by the width of each lane, and update @a result with the nearest
+  /// lane matching @a lane_type. Stops as soon as the lanes move away from @a
+  /// loc.
+  template <typename LaneRangeT>
+  static void FindNearestLaneOnSide(
+      const LaneRangeT &lanes,
       const double s,
       const geom::Location &loc,
-      uint32_t lane_type) const {
-    using namespace carla::road::element;
-    std::map<LaneId, const Lane *> lanes(GetLanesAt(s));
-    // negative right lanes
-    auto right_lanes = MakeListView(
-        std::make_reverse_iterator(lanes.lower_bound(0)), lanes.rend());
-    // positive left lanes
-    auto left_lanes = MakeListView(
-        lanes.lower_bound(1), lanes.end());
-
-    const DirectedPoint dp_lane_zero = GetDirectedPointIn(s);
-    std::pair<const Lane *, double> result =
-        std::make_pair(nullptr, std::numeric_limits<double>::max());
-
-    DirectedPoint current_dp = dp_lane_zero;
-    for (const auto &lane : right_lanes) {
-      const auto lane_width_info = lane.second->GetInfo<RoadInfoLaneWidth>(s);
-      const auto half_width = lane_width_info->GetPolynomial().Evaluate(s) * 0.5;
+      const uint32_t lane_type,
+      const double side,
+      element::DirectedPoint current_dp,
+      std::pair<const Lane *, double> &result) {
+    for (const Lane &lane : lanes) {
+      const auto lane_width_info = lane.GetInfo<element::RoadInfoLaneWidth>(s);
+      const auto half_width = side * lane_width_info->GetPolynomial().Evaluate(s) * 0.5;
 
       current_dp.ApplyLateralOffset(half_width);
       const auto current_dist = geom::Math::Distance(current_dp.location, loc);
@@ -253,8 +290,8 @@ namespace road {
       if (current_dist <= result.second) {
         // only consider the lanes that match the type flag for result
         // candidates
-        if ((static_cast<uint32_t>(lane.second->GetType()) & lane_type) > 0) {
-          result.first = &(*lane.second);
+        if ((static_cast<uint32_t>(lane.GetType()) & lane_type) > 0) {
+          result.first = &lane;
           result.second = current_dist;
         }
       } else {
@@ -263,41 +300,38 @@ namespace road {
       }
       current_dp.ApplyLateralOffset(half_width);
     }
+  }
 
-    current_dp = dp_lane_zero;
-    for (const auto &lane : left_lanes) {
-      const auto lane_width_info = lane.second->GetInfo<RoadInfoLaneWidth>(s);
-      const auto half_width = -lane_width_info->GetPolynomial().Evaluate(s) * 0.5;
+  const std::pair<const Lane *, double> Road::GetNearestLane(
+      const double s,
+      const geom::Location &loc,
+      uint32_t lane_type) const {
+    const auto lanes = GetLanesAt(s);
+    auto by_id = [](const Lane &lane, LaneId id) { return lane.GetId() < id; };
+    const auto center = std::lower_bound(lanes.begin(), lanes.end(), 0, by_id);
+    // negative right lanes
+    const auto right_lanes = MakeListView(
+        std::make_reverse_iterator(center), std::make_reverse_iterator(lanes.begin()));
+    // positive left lanes
+    const auto left_lanes = MakeListView(
+        std::lower_bound(center, lanes.end(), 1, by_id), lanes.end());
 
-      current_dp.ApplyLateralOffset(half_width);
-      const auto current_dist = geom::Math::Distance(current_dp.location, loc);
+    const element::DirectedPoint dp_lane_zero = GetDirectedPointIn(s);
+    std::pair<const Lane *, double> result =
+        std::make_pair(nullptr, std::numeric_limits<double>::max());
 
-      // if the current_dp is near to loc, we are in the right way
-      if (current_dist <= result.second) {
-        // only consider the lanes that match the type flag for result
-        // candidates
-        if ((static_cast<uint32_t>(lane.second->GetType()) & lane_type) > 0) {
-          result.first = &(*lane.second);
-          result.second = current_dist;
-        }
-      } else {
-        // elsewhere, we are be moving away
-        break;
-      }
-      current_dp.ApplyLateralOffset(half_width);
-    }
+    FindNearestLaneOnSide(right_lanes, s, loc, lane_type, 1.0, dp_lane_zero, result);
+    FindNearestLaneOnSide(left_lanes, s, loc, lane_type, -1.0, dp_lane_zero, result);
 
     return result;
   }
 
-  std::map<LaneId, const Lane *> Road::GetLanesAt(const double s) const {
-    std::map<LaneId, const Lane *> map;
-    for (auto &&lane_section : GetLaneSectionsAt(s)) {
-      for (auto &&lane : lane_section.GetLanes()) {
-        map[lane.first] = &(lane.second);
-      }
+  ListView<const Lane *> Road::GetLanesAt(const double s) const {
+    const auto sections = GetLaneSectionsAt(s);
+    if (sections.empty()) {
+      return MakeListView<const Lane *>(nullptr, nullptr);
     }
-    return map;
+    return (sections.end() - 1)->GetLanes();
   }
 
 } // road
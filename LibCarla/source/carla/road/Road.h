@@ -12,8 +12,6 @@
 #include "carla/road/InformationSet.h"
 #include "carla/road/Junction.h"
 #include "carla/road/LaneSection.h"
-#include "carla/road/LaneSectionMap.h"
-#include "carla/road/RoadElementSet.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/road/element/Geometry.h"
 #include "carla/road/element/RoadInfo.h"
@@ -21,6 +19,7 @@
 #include "carla/road/signal/SignalReference.h"
 
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace carla {
@@ -112,64 +111,36 @@ namespace road {
       return _info.GetInfo<T>(s);
     }
 
-    auto GetLaneSections() const {
-      return MakeListView(
-          iterator::make_map_values_const_iterator(_lane_sections.begin()),
-          iterator::make_map_values_const_iterator(_lane_sections.end()));
+    /// Lane sections of this road sorted by distance.
+    ListView<const LaneSection *> GetLaneSections() const {
+      return MakeListView<const LaneSection *>(_lane_sections.first, _lane_sections.second);
     }
 
-  private:
-
-    template <typename MultiMapT>
-    static auto GetLessEqualRange(MultiMapT &map, double s) {
-      if (map.find(s) == map.end()) {
-        auto it = map.lower_bound(s);
-        if (it == map.begin()) {
-          return std::make_pair(map.end(), map.end());
-        }
-        s = (--it)->first;
-      }
-      return std::make_pair(map.lower_bound(s), map.upper_bound(s));
-    }
-
-  public:
-
-    auto GetLaneSectionsAt(const double s) {
-      auto pair = GetLessEqualRange(_lane_sections, s);
-      return MakeListView(
-          iterator::make_map_values_iterator(pair.first),
-          iterator::make_map_values_iterator(pair.second));
-    }
+    /// Lane sections at distance @a s, i.e., the sections starting at the
+    /// greatest distance less or equal than @a s.
+    ListView<LaneSection *> GetLaneSectionsAt(const double s);
 
-    auto GetLaneSectionsAt(const double s) const {
-      auto pair = GetLessEqualRange(_lane_sections, s);
-      return MakeListView(
-          iterator::make_map_values_const_iterator(pair.first),
-          iterator::make_map_values_const_iterator(pair.second));
-    }
+    ListView<const LaneSection *> GetLaneSectionsAt(const double s) const;
 
-    LaneSection &GetLaneSectionById(SectionId id) {
-      return _lane_sections.GetById(id);
-    }
+    LaneSection &GetLaneSectionById(SectionId id);
 
-    const LaneSection &GetLaneSectionById(SectionId id) const {
-      return _lane_sections.GetById(id);
-    }
+    const LaneSection &GetLaneSectionById(SectionId id) const;
 
     /// Return the upper bound "s", i.e., the end distance of the lane section
     /// at @a s (clamped at road's length).
-    double UpperBound(double s) const {
-      auto it = _lane_sections.upper_bound(s);
-      return it != _lane_sections.end() ? it->first : _length;
-    }
+    double UpperBound(double s) const;
 
-    /// Get all lanes at a given s
-    std::map<LaneId, const Lane *> GetLanesAt(const double s) const;
+    /// Get all lanes at a given s, sorted by id. These are the lanes of the
+    /// last lane section starting at s, sections of zero length at the same
+    /// distance are skipped. The view does not allocate memory.
+    ListView<const Lane *> GetLanesAt(const double s) const;
 
   private:
 
     friend MapBuilder;
 
+    friend MapData;
+
     MapData *_map_data { nullptr };
 
     RoadId _id { 0 };
@@ -182,7 +153,8 @@ namespace road {
 
     JuncId _junction_id { -1 };
 
-    LaneSectionMap _lane_sections;
+    /// Range of the lane sections arena of the MapData, sorted by distance.
+    std::pair<LaneSection *, LaneSection *> _lane_sections { nullptr, nullptr };
 
     RoadId _successor { 0 };
 
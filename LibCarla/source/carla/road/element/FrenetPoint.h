@@ -0,0 +1,30 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/road/element/Waypoint.h"
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// Location in lane-relative (Frenet) coordinates: the waypoint at the
+  /// center of the lane, and the lateral offset from it.
+  struct FrenetPoint {
+
+    Waypoint waypoint;
+
+    /// Lateral offset from the center of the lane, in the horizontal plane,
+    /// positive to the right of the lane's direction. Measured perpendicular
+    /// to the road reference line, so it does not depend on the lane width
+    /// changing along the road.
+    double t = 0.0;
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
@@ -53,46 +53,95 @@ namespace element {
     return {};
   }
 
-  static bool IsOffRoad(const Map &map, const geom::Location &location) {
-    return !map.GetWaypoint(location, FLAGS).has_value();
+  /// Find the lane connected to the lane of @a from that lies on the road and
+  /// lane section of @a to, and return it as a waypoint at the distance of @a
+  /// to.
+  static boost::optional<Waypoint> FindConnectedLane(
+      const Map &map,
+      const Waypoint &from,
+      const Waypoint &to) {
+    const auto &lane = map.GetLane(from);
+    auto find = [&](const auto &lanes) {
+      for (const auto *other : lanes) {
+        DEBUG_ASSERT(other != nullptr);
+        const auto *road = other->GetRoad();
+        const auto *section = other->GetLaneSection();
+        if ((road != nullptr) && (section != nullptr) &&
+            (road->GetId() == to.road_id) && (section->GetId() == to.section_id)) {
+          return boost::optional<Waypoint>(Waypoint{to.road_id, to.section_id, other->GetId(), to.s});
+        }
+      }
+      return boost::optional<Waypoint>{};
+    };
+    auto result = find(lane.GetNextLanes());
+    return result.has_value() ? result : find(lane.GetPreviousLanes());
   }
 
   std::vector<LaneMarking> LaneCrossingCalculator::Calculate(
       const Map &map,
       const geom::Location &origin,
       const geom::Location &destination) {
-    auto w0 = map.GetClosestWaypointOnRoad(origin, FLAGS);
-    auto w1 = map.GetClosestWaypointOnRoad(destination, FLAGS);
+    return Calculate(map, Project(map, origin), Project(map, destination));
+  }
 
-    if (!w0.has_value() || !w1.has_value()) {
-      return {};
+  RoadProjection LaneCrossingCalculator::Project(
+      const Map &map,
+      const geom::Location &location,
+      const RoadProjection *hint) {
+    RoadProjection result;
+    result.location = location;
+    if ((hint != nullptr) && hint->waypoint.has_value()) {
+      result.waypoint = map.GetClosestWaypointOnRoad(location, *hint->waypoint, FLAGS);
+    } else {
+      result.waypoint = map.GetClosestWaypointOnRoad(location, FLAGS);
     }
+    result.is_offroad =
+        !result.waypoint.has_value() ||
+        !map.IsWithinLane(*result.waypoint, location);
+    return result;
+  }
 
-    if (w0->road_id != w1->road_id || w0->section_id != w1->section_id) {
-      /// @todo This case should also be handled.
+  std::vector<LaneMarking> LaneCrossingCalculator::Calculate(
+      const Map &map,
+      const RoadProjection &origin,
+      const RoadProjection &destination) {
+    if (!origin.waypoint.has_value() || !destination.waypoint.has_value()) {
       return {};
     }
 
-    if (map.IsJunction(w0->road_id) || map.IsJunction(w1->road_id)) {
+    auto w0 = *origin.waypoint;
+    const auto &w1 = *destination.waypoint;
+
+    if (map.IsJunction(w0.road_id) || map.IsJunction(w1.road_id)) {
       return {};
     }
 
-    const auto w0_is_offroad = IsOffRoad(map, origin);
-    const auto w1_is_offroad = IsOffRoad(map, destination);
+    const auto w0_is_offroad = origin.is_offroad;
+    const auto w1_is_offroad = destination.is_offroad;
 
     if (w0_is_offroad && w1_is_offroad) {
       // outside the road
       return {};
     }
 
-    if ((w0->lane_id == w1->lane_id) && !w0_is_offroad && !w1_is_offroad) {
+    if (w0.road_id != w1.road_id || w0.section_id != w1.section_id) {
+      // We moved into another lane section, continue from the lane connected
+      // to the origin's lane in the destination's lane section.
+      const auto connected = FindConnectedLane(map, w0, w1);
+      if (!connected.has_value()) {
+        return {};
+      }
+      w0 = *connected;
+    }
+
+    if ((w0.lane_id == w1.lane_id) && !w0_is_offroad && !w1_is_offroad) {
       // both at the same lane and inside the road
       return {};
     }
 
-    const auto transform = map.ComputeTransform(*w0);
+    const auto transform = map.ComputeTransform(w0);
     geom::Vector3D orig_vec = transform.GetForwardVector();
-    geom::Vector3D dest_vec = (destination - origin).MakeUnitVector();
+    geom::Vector3D dest_vec = (destination.location - origin.location).MakeUnitVector();
 
     // cross product
     const auto dest_is_at_right =
@@ -100,8 +149,8 @@ namespace element {
 
     return CrossingAtSameSection(
         map,
-        &*w0,
-        &*w1,
+        &w0,
+        &w1,
         w0_is_offroad,
         dest_is_at_right);
   }
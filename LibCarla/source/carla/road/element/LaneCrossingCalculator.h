@@ -6,18 +6,32 @@
 
 #pragma once
 
+#include "carla/geom/Location.h"
 #include "carla/road/element/LaneMarking.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <boost/optional.hpp>
 
 #include <vector>
 
 namespace carla {
-namespace geom { class Location; }
 namespace road {
 
   class Map;
 
 namespace element {
 
+  /// A location together with its closest waypoint on the road. Can be reused
+  /// as a hint for projecting the next location of a moving object.
+  struct RoadProjection {
+
+    geom::Location location;
+
+    boost::optional<Waypoint> waypoint;
+
+    bool is_offroad = true;
+  };
+
   class LaneCrossingCalculator {
   public:
 
@@ -25,6 +39,22 @@ namespace element {
         const Map &map,
         const geom::Location &origin,
         const geom::Location &destination);
+
+    /// Project @a location on the lanes where we can find road marks. If
+    /// @a hint is not null, the search starts at the lane of @a hint and its
+    /// neighbouring roads.
+    static RoadProjection Project(
+        const Map &map,
+        const geom::Location &location,
+        const RoadProjection *hint = nullptr);
+
+    /// Same as above, but taking the locations already projected on the road,
+    /// this way the projection of a location can be reused between
+    /// consecutive calls.
+    static std::vector<LaneMarking> Calculate(
+        const Map &map,
+        const RoadProjection &origin,
+        const RoadProjection &destination);
   };
 
 } // namespace element
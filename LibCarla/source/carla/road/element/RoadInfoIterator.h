@@ -10,7 +10,7 @@
 #include "carla/road/element/RoadInfoVisitor.h"
 
 #include <iterator>
-#include <memory>
+#include <type_traits>
 
 namespace carla {
 namespace road {
@@ -20,10 +20,10 @@ namespace element {
   class RoadInfoIterator : private RoadInfoVisitor {
   public:
 
-    static_assert(std::is_same<std::unique_ptr<RoadInfo>, typename IT::value_type>::value, "Not compatible.");
+    static_assert(std::is_same<RoadInfo *, typename std::iterator_traits<IT>::value_type>::value, "Not compatible.");
 
     using value_type = T;
-    using difference_type = typename IT::difference_type;
+    using difference_type = typename std::iterator_traits<IT>::difference_type;
     using pointer = T *;
     using reference = T &;
 
@@ -60,7 +60,7 @@ namespace element {
 
     pointer operator->() const {
       DEBUG_ASSERT((*_it) != nullptr);
-      return static_cast<T *>(_it->get());
+      return static_cast<T *>(*_it);
     }
 
     bool operator!=(const RoadInfoIterator &rhs) const {
@@ -0,0 +1,126 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/road/element/RoadInfoElevation.h"
+#include "carla/road/element/RoadInfoGeometry.h"
+#include "carla/road/element/RoadInfoLaneAccess.h"
+#include "carla/road/element/RoadInfoLaneBorder.h"
+#include "carla/road/element/RoadInfoLaneHeight.h"
+#include "carla/road/element/RoadInfoLaneMaterial.h"
+#include "carla/road/element/RoadInfoLaneOffset.h"
+#include "carla/road/element/RoadInfoLaneRule.h"
+#include "carla/road/element/RoadInfoLaneVisibility.h"
+#include "carla/road/element/RoadInfoLaneWidth.h"
+#include "carla/road/element/RoadInfoMarkRecord.h"
+#include "carla/road/element/RoadInfoSpeed.h"
+
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// Stores objects of type T in blocks of @a BlockSize contiguous objects.
+  /// Objects are constructed in place and never moved, so pointers to them
+  /// remain valid until the pool is destroyed, even if the pool is moved.
+  template <typename T, size_t BlockSize = 64u>
+  class RoadInfoBlockPool : private MovableNonCopyable {
+  public:
+
+    RoadInfoBlockPool() = default;
+
+    RoadInfoBlockPool(RoadInfoBlockPool &&rhs)
+      : _blocks(std::move(rhs._blocks)),
+        _size_of_last_block(rhs._size_of_last_block) {
+      rhs._blocks.clear();
+      rhs._size_of_last_block = 0u;
+    }
+
+    RoadInfoBlockPool &operator=(RoadInfoBlockPool &&rhs) {
+      if (this != &rhs) {
+        Clear();
+        _blocks = std::move(rhs._blocks);
+        _size_of_last_block = rhs._size_of_last_block;
+        rhs._blocks.clear();
+        rhs._size_of_last_block = 0u;
+      }
+      return *this;
+    }
+
+    ~RoadInfoBlockPool() {
+      Clear();
+    }
+
+    template <typename... Args>
+    T *Emplace(Args &&... args) {
+      if (_blocks.empty() || (_size_of_last_block == BlockSize)) {
+        _blocks.emplace_back(std::make_unique<Storage[]>(BlockSize));
+        _size_of_last_block = 0u;
+      }
+      auto *object = new (&_blocks.back()[_size_of_last_block]) T(std::forward<Args>(args)...);
+      ++_size_of_last_block;
+      return object;
+    }
+
+  private:
+
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+    void Clear() {
+      for (auto i = 0u; i < _blocks.size(); ++i) {
+        const auto count = (i + 1u == _blocks.size()) ? _size_of_last_block : BlockSize;
+        for (auto j = 0u; j < count; ++j) {
+          reinterpret_cast<T *>(&_blocks[i][j])->~T();
+        }
+      }
+      _blocks.clear();
+      _size_of_last_block = 0u;
+    }
+
+    std::vector<std::unique_ptr<Storage[]>> _blocks;
+
+    size_t _size_of_last_block = 0u;
+  };
+
+  /// Owns every road and lane info record of a map, a pool for each type of
+  /// record.
+  class RoadInfoPool : private MovableNonCopyable {
+  public:
+
+    /// Construct a new record of type T, owned by the pool.
+    template <typename T, typename... Args>
+    T *Create(Args &&... args) {
+      return std::get<RoadInfoBlockPool<T>>(_pools).Emplace(std::forward<Args>(args)...);
+    }
+
+  private:
+
+    std::tuple<
+        RoadInfoBlockPool<RoadInfoElevation>,
+        RoadInfoBlockPool<RoadInfoGeometry>,
+        RoadInfoBlockPool<RoadInfoLaneAccess>,
+        RoadInfoBlockPool<RoadInfoLaneBorder>,
+        RoadInfoBlockPool<RoadInfoLaneHeight>,
+        RoadInfoBlockPool<RoadInfoLaneMaterial>,
+        RoadInfoBlockPool<RoadInfoLaneOffset>,
+        RoadInfoBlockPool<RoadInfoLaneRule>,
+        RoadInfoBlockPool<RoadInfoLaneVisibility>,
+        RoadInfoBlockPool<RoadInfoLaneWidth>,
+        RoadInfoBlockPool<RoadInfoMarkRecord>,
+        RoadInfoBlockPool<RoadInfoSpeed>> _pools;
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
@@ -10,6 +10,7 @@
 #include "carla/MsgPackAdaptors.h"
 #include "carla/geom/Transform.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/rpc/PackedVector.h"
 #include "carla/rpc/VehicleControl.h"
 #include "carla/rpc/WalkerControl.h"
 
@@ -18,6 +19,50 @@
 namespace carla {
 namespace rpc {
 
+  // Fields of the values of the batch commands, in the order they are packed.
+
+  template <>
+  struct PackedFields<VehicleControl> {
+    template <typename T>
+    static auto Get(T &control) {
+      return std::tie(
+          control.throttle,
+          control.steer,
+          control.brake,
+          control.hand_brake,
+          control.reverse,
+          control.manual_gear_shift,
+          control.gear);
+    }
+  };
+
+  template <>
+  struct PackedFields<WalkerControl> {
+    template <typename T>
+    static auto Get(T &control) {
+      return std::tie(
+          control.direction.x,
+          control.direction.y,
+          control.direction.z,
+          control.speed,
+          control.jump);
+    }
+  };
+
+  template <>
+  struct PackedFields<geom::Transform> {
+    template <typename T>
+    static auto Get(T &transform) {
+      return std::tie(
+          transform.location.x,
+          transform.location.y,
+          transform.location.z,
+          transform.rotation.pitch,
+          transform.rotation.yaw,
+          transform.rotation.roll);
+    }
+  };
+
   class Command {
   private:
 
@@ -117,6 +162,48 @@ namespace rpc {
       MSGPACK_DEFINE_ARRAY(actor, enabled);
     };
 
+    /// @name Batch commands
+    ///
+    /// Apply the same operation to many actors at once. The arguments are
+    /// stored in parallel arrays, `actors[i]` receives the i-th argument, and
+    /// each array is serialized as a single binary blob.
+    ///
+    /// A batch command produces one response per actor, in the same order as
+    /// `actors`, as if a command had been sent for each of them.
+    /// @{
+
+    struct ApplyVehicleControlBatch : CommandBase<ApplyVehicleControlBatch> {
+      ApplyVehicleControlBatch() = default;
+      ApplyVehicleControlBatch(PackedVector<ActorId> ids, PackedVector<VehicleControl> values)
+        : actors(std::move(ids)),
+          controls(std::move(values)) {}
+      PackedVector<ActorId> actors;
+      PackedVector<VehicleControl> controls;
+      MSGPACK_DEFINE_ARRAY(actors, controls);
+    };
+
+    struct ApplyWalkerControlBatch : CommandBase<ApplyWalkerControlBatch> {
+      ApplyWalkerControlBatch() = default;
+      ApplyWalkerControlBatch(PackedVector<ActorId> ids, PackedVector<WalkerControl> values)
+        : actors(std::move(ids)),
+          controls(std::move(values)) {}
+      PackedVector<ActorId> actors;
+      PackedVector<WalkerControl> controls;
+      MSGPACK_DEFINE_ARRAY(actors, controls);
+    };
+
+    struct ApplyTransformBatch : CommandBase<ApplyTransformBatch> {
+      ApplyTransformBatch() = default;
+      ApplyTransformBatch(PackedVector<ActorId> ids, PackedVector<geom::Transform> values)
+        : actors(std::move(ids)),
+          transforms(std::move(values)) {}
+      PackedVector<ActorId> actors;
+      PackedVector<geom::Transform> transforms;
+      MSGPACK_DEFINE_ARRAY(actors, transforms);
+    };
+
+    /// @}
+
     using CommandType = boost::variant<
         SpawnActor,
         DestroyActor,
@@ -127,7 +214,10 @@ namespace rpc {
         ApplyAngularVelocity,
         ApplyImpulse,
         SetSimulatePhysics,
-        SetAutopilot>;
+        SetAutopilot,
+        ApplyVehicleControlBatch,
+        ApplyWalkerControlBatch,
+        ApplyTransformBatch>;
 
     CommandType command;
 
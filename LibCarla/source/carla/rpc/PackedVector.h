@@ -0,0 +1,229 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/MsgPack.h"
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Lists the fields of a type stored in a PackedVector, specialize it for
+  /// each type as
+  ///
+  /// @code
+  /// template <>
+  /// struct PackedFields<MyType> {
+  ///   template <typename T>
+  ///   static auto Get(T &value) {
+  ///     return std::tie(value.a, value.b);
+  ///   }
+  /// };
+  /// @endcode
+  ///
+  /// Arithmetic types need no specialization.
+  template <typename T>
+  struct PackedFields;
+
+namespace detail {
+
+  /// Binary layout of an element of a PackedVector. Arithmetic values are
+  /// copied as they are, except bools that are stored as a byte that must be
+  /// either 0 or 1. Other types are the concatenation of their PackedFields.
+  template <typename T, typename Enable = void>
+  struct PackedElement;
+
+  template <typename T>
+  struct PackedElement<T, std::enable_if_t<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>> {
+    static constexpr size_t size = sizeof(T);
+
+    static void Write(const T &value, char *out) {
+      std::memcpy(out, &value, sizeof(T));
+    }
+
+    static bool Read(const char *in, T &value) {
+      std::memcpy(&value, in, sizeof(T));
+      return true;
+    }
+  };
+
+  template <>
+  struct PackedElement<bool> {
+    static constexpr size_t size = 1u;
+
+    static void Write(const bool &value, char *out) {
+      *out = static_cast<char>(value ? 1u : 0u);
+    }
+
+    static bool Read(const char *in, bool &value) {
+      const auto byte = static_cast<uint8_t>(*in);
+      value = (byte == 1u);
+      return byte <= 1u;
+    }
+  };
+
+  template <typename... Ts>
+  struct PackedSize;
+
+  template <>
+  struct PackedSize<> {
+    static constexpr size_t value = 0u;
+  };
+
+  template <typename T, typename... Ts>
+  struct PackedSize<T, Ts...> {
+    static constexpr size_t value = PackedElement<std::decay_t<T>>::size + PackedSize<Ts...>::value;
+  };
+
+  template <typename Tuple>
+  struct PackedTupleSize;
+
+  template <typename... Ts>
+  struct PackedTupleSize<std::tuple<Ts...>> : PackedSize<Ts...> {};
+
+  template <typename T>
+  struct PackedElement<T, std::enable_if_t<!std::is_arithmetic<T>::value>> {
+    using Fields = decltype(PackedFields<T>::Get(std::declval<T &>()));
+
+    static constexpr size_t size = PackedTupleSize<Fields>::value;
+
+    static void Write(const T &value, char *out) {
+      WriteFields(PackedFields<T>::Get(value), out, std::make_index_sequence<std::tuple_size<Fields>::value>());
+    }
+
+    static bool Read(const char *in, T &value) {
+      return ReadFields(PackedFields<T>::Get(value), in, std::make_index_sequence<std::tuple_size<Fields>::value>());
+    }
+
+  private:
+
+    template <typename Tuple, size_t... Is>
+    static void WriteFields(const Tuple &fields, char *out, std::index_sequence<Is...>) {
+      auto write = [&out](const auto &field) {
+        PackedElement<std::decay_t<decltype(field)>>::Write(field, out);
+        out += PackedElement<std::decay_t<decltype(field)>>::size;
+      };
+      (void) std::initializer_list<int>{(write(std::get<Is>(fields)), 0)...};
+    }
+
+    template <typename Tuple, size_t... Is>
+    static bool ReadFields(const Tuple &fields, const char *in, std::index_sequence<Is...>) {
+      bool valid = true;
+      auto read = [&in, &valid](auto &field) {
+        valid = PackedElement<std::decay_t<decltype(field)>>::Read(in, field) && valid;
+        in += PackedElement<std::decay_t<decltype(field)>>::size;
+      };
+      (void) std::initializer_list<int>{(read(std::get<Is>(fields)), 0)...};
+      return valid;
+    }
+  };
+
+} // namespace detail
+
+  /// A vector that is serialized as a single MsgPack binary blob, i.e. the
+  /// fields of each element are copied one after another into a contiguous
+  /// block instead of packing each element (and each of its members) as a
+  /// MsgPack object.
+  ///
+  /// The elements are written and read field by field, see PackedFields.
+  /// Unpacking validates the size of the blob and the value of every bool
+  /// field, so a malformed message is rejected instead of producing invalid
+  /// values.
+  ///
+  /// @warning Numbers are copied in the memory layout of the sender, client
+  /// and server must agree on their size and endianness.
+  template <typename T>
+  class PackedVector : public std::vector<T> {
+  public:
+
+    using std::vector<T>::vector;
+
+    PackedVector() = default;
+
+    PackedVector(std::vector<T> vector) : std::vector<T>(std::move(vector)) {}
+  };
+
+} // namespace rpc
+} // namespace carla
+
+namespace clmdep_msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+
+  // ===========================================================================
+  // -- Adaptors for carla::rpc::PackedVector ----------------------------------
+  // ===========================================================================
+
+  template<typename T>
+  struct convert<carla::rpc::PackedVector<T>> {
+    const clmdep_msgpack::object &operator()(
+        const clmdep_msgpack::object &o,
+        carla::rpc::PackedVector<T> &v) const {
+      using Element = carla::rpc::detail::PackedElement<T>;
+      if (o.type != clmdep_msgpack::type::BIN) {
+        ::carla::throw_exception(clmdep_msgpack::type_error());
+      }
+      if ((o.via.bin.size % Element::size) != 0u) {
+        ::carla::throw_exception(clmdep_msgpack::type_error());
+      }
+      v.resize(o.via.bin.size / Element::size);
+      const char *in = o.via.bin.ptr;
+      for (auto &item : v) {
+        if (!Element::Read(in, item)) {
+          ::carla::throw_exception(clmdep_msgpack::type_error());
+        }
+        in += Element::size;
+      }
+      return o;
+    }
+  };
+
+  template<typename T>
+  struct pack<carla::rpc::PackedVector<T>> {
+    template <typename Stream>
+    packer<Stream> &operator()(
+        clmdep_msgpack::packer<Stream> &o,
+        const carla::rpc::PackedVector<T> &v) const {
+      using Element = carla::rpc::detail::PackedElement<T>;
+      const auto size = static_cast<uint32_t>(Element::size * v.size());
+      o.pack_bin(size);
+      char buffer[Element::size];
+      for (const auto &item : v) {
+        Element::Write(item, buffer);
+        o.pack_bin_body(buffer, Element::size);
+      }
+      return o;
+    }
+  };
+
+  template<typename T>
+  struct object_with_zone<carla::rpc::PackedVector<T>> {
+    void operator()(
+        clmdep_msgpack::object::with_zone &o,
+        const carla::rpc::PackedVector<T> &v) const {
+      using Element = carla::rpc::detail::PackedElement<T>;
+      const auto size = static_cast<uint32_t>(Element::size * v.size());
+      o.type = type::BIN;
+      o.via.bin.size = size;
+      auto *ptr = static_cast<char *>(o.zone.allocate_no_align(size));
+      for (auto i = 0u; i < v.size(); ++i) {
+        Element::Write(v[i], ptr + i * Element::size);
+      }
+      o.via.bin.ptr = ptr;
+    }
+  };
+
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
@@ -7,11 +7,13 @@
 #pragma once
 
 #include "carla/Time.h"
+#include "carla/rpc/SyncCallQueue.h"
 
-#include <boost/asio/io_service.hpp>
+#include <boost/optional.hpp>
 
 #include <rpc/server.h>
 
+#include <exception>
 #include <future>
 
 namespace carla {
@@ -33,31 +35,56 @@ namespace detail {
   template <typename R, typename... Args> struct wrapper_function_traits<R (*)(Args...)> {
     using result_type = R;
     using function_type = std::function<R(Args...)>;
-    using packaged_task_type = std::packaged_task<R()>;
+  };
+
+  template <typename R>
+  struct SyncCallCompletion {
+    void operator()(std::exception_ptr error, boost::optional<R> result) const {
+      if (error) {
+        promise->set_exception(error);
+      } else {
+        promise->set_value(std::move(*result));
+      }
+    }
+    std::promise<R> *promise;
+  };
+
+  template <>
+  struct SyncCallCompletion<void> {
+    void operator()(std::exception_ptr error) const {
+      if (error) {
+        promise->set_exception(error);
+      } else {
+        promise->set_value();
+      }
+    }
+    std::promise<void> *promise;
   };
 
   /// Wraps @a functor into a function type with equivalent signature. The wrap
-  /// function returned, when called, posts @a functor into the io_service and
+  /// function returned, when called, pushes @a functor into @a queue and
   /// waits for it to finish.
   ///
   /// This way, no matter from which thread the wrap function is called, the
-  /// @a functor provided is always called from the context of the io_service.
+  /// @a functor provided is always called from the thread draining the queue.
   ///
   /// @warning The wrap function blocks until @a functor is executed by the
-  /// io_service.
+  /// thread draining the queue.
   template <typename F>
-  inline auto WrapSyncCall(boost::asio::io_service &io, F functor) {
+  inline auto WrapSyncCall(SyncCallQueue &queue, F functor) {
     using func_t = typename wrapper_function_traits<F>::function_type;
-    using task_t = typename wrapper_function_traits<F>::packaged_task_type;
-
-    return func_t([&io, functor=std::move(functor)](auto && ... args) {
-      // We can pass arguments by ref to the lambda because the task will be
-      // executed before this function exits.
-      task_t task([functor=std::move(functor), &args...]() {
-        return functor(std::forward<decltype(args)>(args)...);
-      });
-      auto result = task.get_future();
-      io.post([&]() mutable { task(); });
+    using result_t = typename wrapper_function_traits<F>::result_type;
+
+    return func_t([&queue, functor=std::move(functor)](auto && ... args) {
+      // We can pass arguments by ref to the lambda, and the promise by
+      // pointer, because the call is completed before this function exits.
+      std::promise<result_t> promise;
+      auto result = promise.get_future();
+      queue.Push(
+          [&functor, &args...]() -> result_t {
+            return functor(std::forward<decltype(args)>(args)...);
+          },
+          SyncCallCompletion<result_t>{&promise});
       return result.get();
     });
   }
@@ -71,8 +98,8 @@ namespace detail {
   /// run a slice of work in the caller's thread.
   ///
   /// Functions that are bind using `BindAsync` will run asynchronously in the
-  /// worker threads. Functions that are bind using `BindSync` will run within
-  /// `SyncRunFor` function.
+  /// worker threads. Functions that are bind using `BindSync` are pushed into
+  /// a lock-free queue that is drained in batches by `SyncRunFor`.
   class Server {
   public:
 
@@ -91,16 +118,18 @@ namespace detail {
     void BindSync(const std::string &name, Functor functor) {
       _server.bind(
           name,
-          detail::WrapSyncCall(_sync_io_service, std::move(functor)));
+          detail::WrapSyncCall(_sync_queue, std::move(functor)));
     }
 
     void AsyncRun(size_t worker_threads) {
       _server.async_run(worker_threads);
     }
 
-    void SyncRunFor(time_duration duration) {
-      _sync_io_service.reset();
-      _sync_io_service.run_for(duration.to_chrono());
+    /// Run the pending synchronous calls in the caller's thread until there
+    /// are no more calls or @a duration has elapsed. Returns the number of
+    /// calls executed.
+    size_t SyncRunFor(time_duration duration) {
+      return _sync_queue.Drain(duration);
     }
 
     /// @warning does not stop the game thread.
@@ -110,7 +139,7 @@ namespace detail {
 
   private:
 
-    boost::asio::io_service _sync_io_service;
+    SyncCallQueue _sync_queue;
 
     ::rpc::server _server;
   };
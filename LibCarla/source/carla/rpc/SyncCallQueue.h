@@ -0,0 +1,132 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/StopWatch.h"
+#include "carla/Time.h"
+
+#include "moodycamel/ConcurrentQueue.h"
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace carla {
+namespace rpc {
+
+  /// Multiple-producer single-consumer queue of calls to be executed in the
+  /// game thread.
+  ///
+  /// Any thread may push a call together with a completion callback. The
+  /// consumer (the game thread) drains the queue in batches with `Drain`,
+  /// which runs every call and then invokes its completion callback with the
+  /// result, all within the consumer's thread.
+  ///
+  /// Calls pushed by the same thread are executed in the same order they were
+  /// pushed.
+  class SyncCallQueue : private NonCopyable {
+  public:
+
+    using Task = std::function<void()>;
+
+    /// Number of calls dequeued at once by `Drain`. The time budget is checked
+    /// between batches.
+    static constexpr size_t BatchSize = 32u;
+
+    /// Push @a call into the queue. Once executed by the consumer,
+    /// @a on_complete is called in the consumer's thread as
+    ///
+    ///     on_complete(std::exception_ptr error, boost::optional<R> result)
+    ///
+    /// where @a result holds the value returned by @a call, or @a error holds
+    /// the exception it threw. For calls returning void the callback is
+    /// `on_complete(std::exception_ptr error)`. When compiled with
+    /// LIBCARLA_NO_EXCEPTIONS @a error is always null.
+    template <typename F, typename C>
+    void Push(F call, C on_complete) {
+      _queue.enqueue(MakeTask(std::move(call), std::move(on_complete)));
+    }
+
+    /// Run the queued calls in the current thread until the queue is empty or
+    /// @a budget has elapsed, whatever happens first. Returns the number of
+    /// calls executed.
+    ///
+    /// Calls are dequeued in batches of `BatchSize`, every call of a dequeued
+    /// batch is executed even if it exceeds the budget.
+    size_t Drain(time_duration budget) {
+      const auto max_time = budget.to_chrono();
+      StopWatch timer;
+      size_t count = 0u;
+      std::array<Task, BatchSize> batch;
+      do {
+        const auto dequeued = _queue.try_dequeue_bulk(batch.begin(), batch.size());
+        if (dequeued == 0u) {
+          break;
+        }
+        for (auto i = 0u; i < dequeued; ++i) {
+          batch[i]();
+          batch[i] = nullptr;
+        }
+        count += dequeued;
+      } while (timer.GetDuration() < max_time);
+      return count;
+    }
+
+    /// Approximate number of calls waiting in the queue.
+    size_t size_approx() const {
+      return _queue.size_approx();
+    }
+
+  private:
+
+    template <typename F, typename C>
+    static auto MakeTask(F call, C on_complete)
+        -> std::enable_if_t<std::is_void<decltype(call())>::value, Task> {
+      return [call=std::move(call), on_complete=std::move(on_complete)]() mutable {
+        std::exception_ptr error;
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        try {
+#endif // LIBCARLA_NO_EXCEPTIONS
+          call();
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        } catch (...) {
+          error = std::current_exception();
+        }
+#endif // LIBCARLA_NO_EXCEPTIONS
+        on_complete(error);
+      };
+    }
+
+    template <typename F, typename C>
+    static auto MakeTask(F call, C on_complete)
+        -> std::enable_if_t<!std::is_void<decltype(call())>::value, Task> {
+      return [call=std::move(call), on_complete=std::move(on_complete)]() mutable {
+        boost::optional<std::decay_t<decltype(call())>> result;
+        std::exception_ptr error;
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        try {
+#endif // LIBCARLA_NO_EXCEPTIONS
+          result.emplace(call());
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        } catch (...) {
+          error = std::current_exception();
+        }
+#endif // LIBCARLA_NO_EXCEPTIONS
+        on_complete(error, std::move(result));
+      };
+    }
+
+    moodycamel::ConcurrentQueue<Task> _queue;
+  };
+
+} // namespace rpc
+} // namespace carla
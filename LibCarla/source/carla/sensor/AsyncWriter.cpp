@@ -0,0 +1,204 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/AsyncWriter.h"
+
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/StopWatch.h"
+#include "carla/image/ImageWriter.h"
+#include "carla/pointcloud/PointCloudIO.h"
+
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+
+namespace carla {
+namespace sensor {
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  static std::string GetFormat(const std::string &path, const char *default_format) {
+    auto extension = boost::filesystem::path(path).extension().string();
+    if (extension.empty()) {
+      return default_format;
+    }
+    extension.erase(0u, 1u); // Remove the dot.
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+      return static_cast<char>(std::tolower(c));
+    });
+    return extension;
+  }
+
+  // ===========================================================================
+  // -- AsyncWriter ------------------------------------------------------------
+  // ===========================================================================
+
+  AsyncWriter::AsyncWriter(
+      const size_t worker_threads,
+      const size_t max_queue_size,
+      const QueueFullPolicy policy)
+    : _max_queue_size(std::max<size_t>(max_queue_size, 1u)),
+      _policy(policy) {
+    _workers.CreateThreads(std::max<size_t>(worker_threads, 1u), [this]() { Run(); });
+  }
+
+  AsyncWriter::~AsyncWriter() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _queue_not_empty.notify_all();
+    _queue_not_full.notify_all();
+    _workers.JoinAll();
+  }
+
+  bool AsyncWriter::WriteImage(
+      SharedPtr<data::Image> image,
+      std::string path,
+      const ColorConversion color_conversion) {
+    DEBUG_ASSERT(image != nullptr);
+    FileSystem::ValidateFilePath(path, ".png");
+    auto format = GetFormat(path, "png");
+    return Push({std::move(format), [=]() {
+      image::ImageWriter::WriteImage(path, *image, color_conversion);
+      return sizeof(data::Color) * image->size();
+    }});
+  }
+
+  bool AsyncWriter::WritePointCloud(
+      SharedPtr<data::LidarMeasurement> measurement,
+      std::string path) {
+    DEBUG_ASSERT(measurement != nullptr);
+    using PointCloudFormat = pointcloud::PointCloudIO::Format;
+    FileSystem::ValidateFilePath(path, ".ply");
+    auto format = GetFormat(path, "ply");
+    const auto point_cloud_format = (format == "bin" ? PointCloudFormat::Bin : PointCloudFormat::PlyBinary);
+    return Push({std::move(format), [=]() {
+      pointcloud::PointCloudIO::SaveToDisk(path, measurement->begin(), measurement->end(), point_cloud_format);
+      return sizeof(*measurement->begin()) * measurement->size();
+    }});
+  }
+
+  bool AsyncWriter::Write(
+      SharedPtr<SensorData> data,
+      std::string path,
+      const ColorConversion color_conversion) {
+    auto image = boost::dynamic_pointer_cast<data::Image>(data);
+    if (image != nullptr) {
+      return WriteImage(std::move(image), std::move(path), color_conversion);
+    }
+    auto measurement = boost::dynamic_pointer_cast<data::LidarMeasurement>(data);
+    if (measurement != nullptr) {
+      return WritePointCloud(std::move(measurement), std::move(path));
+    }
+    throw_exception(std::invalid_argument("sensor data cannot be written to disk"));
+    return false;
+  }
+
+  void AsyncWriter::Flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]() { return _queue.empty() && (_jobs_in_progress == 0u); });
+  }
+
+  bool AsyncWriter::Flush(const time_duration timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _idle.wait_for(lock, timeout.to_chrono(), [this]() {
+      return _queue.empty() && (_jobs_in_progress == 0u);
+    });
+  }
+
+  size_t AsyncWriter::GetPendingWrites() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queue.size() + _jobs_in_progress;
+  }
+
+  std::unordered_map<std::string, AsyncWriter::Statistics> AsyncWriter::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+  }
+
+  bool AsyncWriter::Push(Job job) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_queue.size() >= _max_queue_size) {
+        switch (_policy) {
+          case QueueFullPolicy::Block:
+            _queue_not_full.wait(lock, [this]() {
+              return _stop || (_queue.size() < _max_queue_size);
+            });
+            break;
+          case QueueFullPolicy::DropNewest:
+            ++_statistics[job.format].files_dropped;
+            return false;
+          case QueueFullPolicy::DropOldest:
+            ++_statistics[_queue.front().format].files_dropped;
+            _queue.pop_front();
+            break;
+        }
+      }
+      if (_stop) {
+        ++_statistics[job.format].files_dropped;
+        return false;
+      }
+      _queue.emplace_back(std::move(job));
+    }
+    _queue_not_empty.notify_one();
+    return true;
+  }
+
+  void AsyncWriter::Run() {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue_not_empty.wait(lock, [this]() { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+          return; // Stopped and nothing left to write.
+        }
+        job = std::move(_queue.front());
+        _queue.pop_front();
+        ++_jobs_in_progress;
+      }
+      _queue_not_full.notify_one();
+
+      StopWatch timer;
+      size_t bytes = 0u;
+      bool success = false;
+      try {
+        bytes = job.write();
+        success = true;
+      } catch (const std::exception &e) {
+        log_error("AsyncWriter: failed to write", job.format, "file:", e.what());
+      }
+      timer.Stop();
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto &statistics = _statistics[job.format];
+        if (success) {
+          ++statistics.files_written;
+          statistics.bytes_written += bytes;
+        } else {
+          ++statistics.errors;
+        }
+        statistics.busy_seconds += 1e-6 * static_cast<double>(
+            timer.GetElapsedTime<std::chrono::microseconds>());
+        --_jobs_in_progress;
+        if (_queue.empty() && (_jobs_in_progress == 0u)) {
+          _idle.notify_all();
+        }
+      }
+    }
+  }
+
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,148 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadGroup.h"
+#include "carla/Time.h"
+#include "carla/image/ImageWriter.h"
+#include "carla/sensor/SensorData.h"
+#include "carla/sensor/data/Image.h"
+#include "carla/sensor/data/LidarMeasurement.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace carla {
+namespace sensor {
+
+  /// Writes sensor data to disk in a pool of worker threads.
+  ///
+  /// The writer keeps a reference to the sensor data queued, so the sensor
+  /// callback only pays the cost of queuing it. Color conversion and encoding
+  /// (PNG, JPEG, TIFF, PLY, or raw floats depending on the file extension)
+  /// happen in the worker threads. The sensor data itself is never modified.
+  ///
+  /// The number of writes waiting is bounded by the queue size, when the
+  /// queue is full the QueueFullPolicy decides whether the caller blocks or a
+  /// write is dropped.
+  class AsyncWriter : private NonCopyable {
+  public:
+
+    using ColorConversion = image::ImageWriter::ColorConversion;
+
+    enum class QueueFullPolicy {
+      /// Block the calling thread until there is space in the queue.
+      Block,
+      /// Drop the write being queued.
+      DropNewest,
+      /// Drop the oldest write waiting in the queue.
+      DropOldest
+    };
+
+    /// Counters of the writes done for a given file format.
+    struct Statistics {
+      size_t files_written = 0u;
+      size_t files_dropped = 0u;
+      size_t errors = 0u;
+      /// Size of the sensor data written.
+      size_t bytes_written = 0u;
+      /// Accumulated time spent by the workers converting and encoding.
+      double busy_seconds = 0.0;
+
+      double GetFilesPerSecond() const {
+        return busy_seconds > 0.0 ? static_cast<double>(files_written) / busy_seconds : 0.0;
+      }
+
+      double GetMegabytesPerSecond() const {
+        return busy_seconds > 0.0 ? 1e-6 * static_cast<double>(bytes_written) / busy_seconds : 0.0;
+      }
+    };
+
+    explicit AsyncWriter(
+        size_t worker_threads = 2u,
+        size_t max_queue_size = 32u,
+        QueueFullPolicy policy = QueueFullPolicy::Block);
+
+    /// Waits for every write queued to finish.
+    ~AsyncWriter();
+
+    /// Queue @a image to be written to @a path (PNG by default if the path
+    /// has no extension). Returns false if dropped.
+    bool WriteImage(
+        SharedPtr<data::Image> image,
+        std::string path,
+        ColorConversion color_conversion = ColorConversion::Raw);
+
+    /// Queue the points of @a measurement to be written to @a path, as raw
+    /// floats if the extension is ".bin" or as binary PLY otherwise. Returns
+    /// false if dropped.
+    bool WritePointCloud(SharedPtr<data::LidarMeasurement> measurement, std::string path);
+
+    /// Queue @a data to be written to @a path, dispatching to WriteImage or
+    /// WritePointCloud depending on the type of @a data.
+    ///
+    /// @throw std::invalid_argument if @a data cannot be written to disk.
+    bool Write(
+        SharedPtr<SensorData> data,
+        std::string path,
+        ColorConversion color_conversion = ColorConversion::Raw);
+
+    /// Block until there are no writes waiting or in progress.
+    void Flush();
+
+    /// Same as Flush but gives up after @a timeout. Returns false if the
+    /// timeout is met.
+    bool Flush(time_duration timeout);
+
+    /// Number of writes waiting or in progress.
+    size_t GetPendingWrites() const;
+
+    /// Statistics per file format, keyed by the file extension (e.g. "png").
+    std::unordered_map<std::string, Statistics> GetStatistics() const;
+
+  private:
+
+    struct Job {
+      std::string format;
+      std::function<size_t()> write;
+    };
+
+    bool Push(Job job);
+
+    void Run();
+
+    const size_t _max_queue_size;
+
+    const QueueFullPolicy _policy;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _queue_not_empty;
+
+    std::condition_variable _queue_not_full;
+
+    std::condition_variable _idle;
+
+    std::deque<Job> _queue;
+
+    size_t _jobs_in_progress = 0u;
+
+    bool _stop = false;
+
+    std::unordered_map<std::string, Statistics> _statistics;
+
+    ThreadGroup _workers;
+  };
+
+} // namespace sensor
+} // namespace carla
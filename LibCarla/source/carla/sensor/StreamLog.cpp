@@ -0,0 +1,262 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/StreamLog.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/sensor/Deserializer.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace carla {
+namespace sensor {
+
+  // ===========================================================================
+  // -- Static local functions -------------------------------------------------
+  // ===========================================================================
+
+  /// First bytes of the index file, the last one is the format version.
+  static constexpr char IndexMagic[8u] = {'C', 'A', 'R', 'L', 'A', 'S', 'L', '1'};
+
+  /// Buffers are written at offsets multiple of this.
+  static constexpr uint64_t Alignment = 8u;
+
+  static std::string GetIndexPath(const std::string &path) {
+    return path + ".idx";
+  }
+
+  static std::string GetSegmentPath(const std::string &path, uint32_t segment) {
+    char suffix[32u];
+    std::snprintf(suffix, sizeof(suffix), ".%06u.seg", segment);
+    return path + suffix;
+  }
+
+  /// Whether the buffer of @a entry lies within a segment of @a segment_size
+  /// bytes. The index may be corrupt, so offset + size must not overflow.
+  static bool IsWithinSegment(const StreamLogEntry &entry, const uint64_t segment_size) {
+    return (entry.size <= segment_size) && (entry.offset <= segment_size - entry.size);
+  }
+
+  // ===========================================================================
+  // -- StreamLogWriter --------------------------------------------------------
+  // ===========================================================================
+
+  constexpr uint64_t StreamLogWriter::DefaultMaxSegmentSize;
+
+  StreamLogWriter::StreamLogWriter(std::string path, const uint64_t max_segment_size)
+    : _path(std::move(path)),
+      _max_segment_size(max_segment_size) {
+    auto index_path = GetIndexPath(_path);
+    FileSystem::ValidateFilePath(index_path);
+    if (!_index.Open(index_path)) {
+      throw_exception(std::runtime_error("cannot create stream log index " + index_path));
+    }
+    _index_buffer.Write(IndexMagic, sizeof(IndexMagic));
+    _index.Write(_index_buffer);
+    OpenSegment();
+  }
+
+  StreamLogWriter::~StreamLogWriter() {
+    // Waits for every buffer appended to be written.
+    _segment.Close();
+    _index.Close();
+    if (_segment.HasFailed() || _index.HasFailed()) {
+      log_error("error writing stream log", _path);
+    }
+  }
+
+  void StreamLogWriter::OpenSegment() {
+    if (_segment.IsOpen()) {
+      // Waits for the previous segment to be written.
+      _segment.Close();
+      if (_segment.HasFailed()) {
+        throw_exception(std::runtime_error("error writing stream log " + _path));
+      }
+      ++_segment_number;
+    }
+    const auto segment_path = GetSegmentPath(_path, _segment_number);
+    if (!_segment.Open(segment_path)) {
+      throw_exception(std::runtime_error("cannot create stream log segment " + segment_path));
+    }
+    _segment_size = 0u;
+  }
+
+  void StreamLogWriter::Write(const uint64_t sensor_id, const Buffer &buffer) {
+    using HeaderSerializer = s11n::SensorHeaderSerializer;
+    if (buffer.size() < HeaderSerializer::header_offset) {
+      throw_exception(std::invalid_argument("buffer too small to contain a sensor header"));
+    }
+    const uint64_t size = buffer.size();
+    const uint64_t padding = (Alignment - size % Alignment) % Alignment;
+    StreamLogEntry entry;
+    entry.sensor_id = sensor_id;
+    entry.frame = HeaderSerializer::Deserialize(buffer).frame_number;
+    entry.reserved = 0u;
+    entry.size = size;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_segment.HasFailed() || _index.HasFailed()) {
+      throw_exception(std::runtime_error("error writing stream log " + _path));
+    }
+    if ((_segment_size > 0u) && (_segment_size + size > _max_segment_size)) {
+      OpenSegment();
+    }
+    entry.segment = _segment_number;
+    entry.offset = _segment_size;
+    static constexpr char zeros[Alignment] = {};
+    _segment_buffer.Write(buffer.data(), size);
+    _segment_buffer.Write(zeros, padding);
+    _segment.Write(_segment_buffer);
+    _index_buffer.Write(entry);
+    _index.Write(_index_buffer);
+    _segment_size += size + padding;
+    ++_buffers_written;
+    _bytes_written += size;
+  }
+
+  void StreamLogWriter::Flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _segment.Flush();
+    _index.Flush();
+  }
+
+  std::pair<uint64_t, uint64_t> StreamLogWriter::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return {_buffers_written, _bytes_written};
+  }
+
+  // ===========================================================================
+  // -- StreamLogReader --------------------------------------------------------
+  // ===========================================================================
+
+  class StreamLogReader::MappedSegment {
+  public:
+
+    explicit MappedSegment(const std::string &path) {
+      namespace bip = boost::interprocess;
+      boost::system::error_code ec;
+      const auto size = boost::filesystem::file_size(path, ec);
+      if (ec || (size == 0u)) {
+        return; // Missing or empty, nothing to map.
+      }
+      _file = bip::file_mapping(path.c_str(), bip::read_only);
+      _region = bip::mapped_region(_file, bip::read_only);
+    }
+
+    const unsigned char *data() const {
+      return static_cast<const unsigned char *>(_region.get_address());
+    }
+
+    uint64_t size() const {
+      return _region.get_size();
+    }
+
+  private:
+
+    boost::interprocess::file_mapping _file;
+
+    boost::interprocess::mapped_region _region;
+  };
+
+  StreamLogReader::StreamLogReader(std::string path)
+    : _path(std::move(path)) {
+    const auto index_path = GetIndexPath(_path);
+    std::ifstream index(index_path, std::ios::binary | std::ios::ate);
+    if (!index) {
+      throw_exception(std::runtime_error("cannot open stream log index " + index_path));
+    }
+    const auto index_size = index.tellg();
+    char magic[sizeof(IndexMagic)] = {};
+    index.seekg(0);
+    index.read(magic, sizeof(magic));
+    if (!index ||
+        (index_size < static_cast<std::streamoff>(sizeof(IndexMagic))) ||
+        (std::memcmp(magic, IndexMagic, sizeof(magic)) != 0)) {
+      throw_exception(std::runtime_error("invalid stream log index " + index_path));
+    }
+    // A trailing partial entry is left by an interrupted write, ignore it.
+    const auto entries_size = static_cast<uint64_t>(index_size) - sizeof(IndexMagic);
+    std::vector<StreamLogEntry> entries(entries_size / sizeof(StreamLogEntry));
+    index.read(reinterpret_cast<char *>(entries.data()), static_cast<std::streamsize>(sizeof(StreamLogEntry) * entries.size()));
+    if (!index) {
+      throw_exception(std::runtime_error("error reading stream log index " + index_path));
+    }
+
+    for (const auto &entry : entries) {
+      // Segments are written one after another, so an entry refers either to
+      // a segment already seen or to the next one. Anything else is corrupt.
+      if (entry.segment == _segments.size()) {
+        const auto segment = static_cast<uint32_t>(_segments.size());
+        _segments.emplace_back(std::make_unique<MappedSegment>(GetSegmentPath(_path, segment)));
+      }
+      if ((entry.segment < _segments.size()) &&
+          IsWithinSegment(entry, _segments[entry.segment]->size())) {
+        _entries.emplace_back(entry);
+      }
+    }
+
+    _by_frame.resize(_entries.size());
+    for (auto i = 0u; i < _by_frame.size(); ++i) {
+      _by_frame[i] = i;
+    }
+    std::stable_sort(_by_frame.begin(), _by_frame.end(), [this](size_t lhs, size_t rhs) {
+      const auto &a = _entries[lhs];
+      const auto &b = _entries[rhs];
+      return (a.frame < b.frame) || ((a.frame == b.frame) && (a.sensor_id < b.sensor_id));
+    });
+  }
+
+  StreamLogReader::~StreamLogReader() = default;
+
+  std::vector<StreamLogEntry> StreamLogReader::GetEntries(
+      const uint64_t frame_begin,
+      const uint64_t frame_end) const {
+    auto first = std::lower_bound(_by_frame.begin(), _by_frame.end(), frame_begin, [this](size_t i, uint64_t frame) {
+      return _entries[i].frame < frame;
+    });
+    std::vector<StreamLogEntry> result;
+    for (auto it = first; (it != _by_frame.end()) && (_entries[*it].frame < frame_end); ++it) {
+      result.emplace_back(_entries[*it]);
+    }
+    return result;
+  }
+
+  const unsigned char *StreamLogReader::GetData(const StreamLogEntry &entry) const {
+    if ((entry.segment >= _segments.size()) ||
+        !IsWithinSegment(entry, _segments[entry.segment]->size())) {
+      throw_exception(std::out_of_range("stream log entry out of range"));
+    }
+    return _segments[entry.segment]->data() + entry.offset;
+  }
+
+  SharedPtr<SensorData> StreamLogReader::Deserialize(const StreamLogEntry &entry) const {
+    return Deserializer::Deserialize(ReadBuffer(entry));
+  }
+
+  void StreamLogReader::Replay(
+      std::function<void(uint64_t, SharedPtr<SensorData>)> callback,
+      const uint64_t frame_begin,
+      const uint64_t frame_end) const {
+    DEBUG_ASSERT(callback != nullptr);
+    for (const auto &entry : GetEntries(frame_begin, frame_end)) {
+      callback(entry.sensor_id, Deserialize(entry));
+    }
+  }
+
+} // namespace sensor
+} // namespace carla
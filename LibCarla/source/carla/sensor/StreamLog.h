@@ -0,0 +1,173 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/recorder/AsyncFileWriter.h"
+#include "carla/recorder/BinaryStream.h"
+#include "carla/sensor/SensorData.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+
+  /// Entry of the index of a stream log, locates the buffer received from a
+  /// sensor at a given frame.
+#pragma pack(push, 1)
+  struct StreamLogEntry {
+    /// Id of the sensor actor.
+    uint64_t sensor_id;
+    uint64_t frame;
+    uint32_t segment;
+    uint32_t reserved;
+    /// Offset of the buffer from the beginning of the segment file.
+    uint64_t offset;
+    uint64_t size;
+  };
+#pragma pack(pop)
+
+  static_assert(sizeof(StreamLogEntry) == 40u, "Invalid stream log entry size.");
+
+  /// Appends the raw buffers received from the sensor streams, exactly as
+  /// received and before deserializing them, to a log on disk.
+  ///
+  /// The log with base path `path` consists of segment files
+  /// `path.000000.seg`, `path.000001.seg`, ... holding the buffers one after
+  /// another, and an index file `path.idx` with a StreamLogEntry per buffer
+  /// in the order they were written. A new segment is started when the
+  /// current one would exceed the maximum segment size.
+  ///
+  /// A log whose writing was interrupted can still be read, the reader
+  /// ignores index entries pointing past the end of their segment or to a
+  /// segment out of sequence.
+  ///
+  /// The files are written by background threads (see
+  /// recorder::AsyncFileWriter), Write only copies the buffer and blocks only
+  /// if the disk cannot keep up with the sensors.
+  ///
+  /// Thread-safe, the sensor streams can write concurrently.
+  class StreamLogWriter : private NonCopyable {
+  public:
+
+    static constexpr uint64_t DefaultMaxSegmentSize = 1024u * 1024u * 1024u;
+
+    /// @throw std::runtime_error if the files cannot be created.
+    explicit StreamLogWriter(std::string path, uint64_t max_segment_size = DefaultMaxSegmentSize);
+
+    ~StreamLogWriter();
+
+    const std::string &GetPath() const {
+      return _path;
+    }
+
+    /// Append @a buffer, received from the sensor with id @a sensor_id. The
+    /// frame is read from the sensor header of the buffer.
+    ///
+    /// @throw std::runtime_error if writing a previous buffer failed.
+    void Write(uint64_t sensor_id, const Buffer &buffer);
+
+    /// Block until the buffers appended are written and flushed to the
+    /// operating system.
+    void Flush();
+
+    /// Number of buffers and bytes appended so far.
+    std::pair<uint64_t, uint64_t> GetStatistics() const;
+
+  private:
+
+    void OpenSegment();
+
+    const std::string _path;
+
+    const uint64_t _max_segment_size;
+
+    mutable std::mutex _mutex;
+
+    recorder::AsyncFileWriter _index;
+
+    recorder::AsyncFileWriter _segment;
+
+    /// Reused to hand the data over to the file writers.
+    recorder::OutputBuffer _index_buffer;
+
+    recorder::OutputBuffer _segment_buffer;
+
+    uint32_t _segment_number = 0u;
+
+    uint64_t _segment_size = 0u;
+
+    uint64_t _buffers_written = 0u;
+
+    uint64_t _bytes_written = 0u;
+  };
+
+  /// Reads a log written by StreamLogWriter. The segment files are mapped to
+  /// memory, buffers can be accessed in place or copied to a Buffer and
+  /// deserialized as if they had been received from the network.
+  class StreamLogReader : private NonCopyable {
+  public:
+
+    /// @throw std::runtime_error if the log cannot be opened.
+    explicit StreamLogReader(std::string path);
+
+    ~StreamLogReader();
+
+    /// Entries of the log in the order they were written.
+    const std::vector<StreamLogEntry> &GetEntries() const {
+      return _entries;
+    }
+
+    /// Entries of the log with frame in [@a frame_begin, @a frame_end),
+    /// sorted by frame and sensor id.
+    std::vector<StreamLogEntry> GetEntries(uint64_t frame_begin, uint64_t frame_end) const;
+
+    /// Pointer to the buffer of @a entry in the mapped segment, valid while
+    /// this reader is alive.
+    const unsigned char *GetData(const StreamLogEntry &entry) const;
+
+    /// Copy of the buffer of @a entry.
+    Buffer ReadBuffer(const StreamLogEntry &entry) const {
+      return Buffer(GetData(entry), entry.size);
+    }
+
+    /// Deserialize the buffer of @a entry. The resulting sensor data is not
+    /// attached to any episode.
+    SharedPtr<SensorData> Deserialize(const StreamLogEntry &entry) const;
+
+    /// Deserialize in order the buffers with frame in
+    /// [@a frame_begin, @a frame_end) and pass them to @a callback with the
+    /// id of their sensor.
+    void Replay(
+        std::function<void(uint64_t, SharedPtr<SensorData>)> callback,
+        uint64_t frame_begin = 0u,
+        uint64_t frame_end = ~uint64_t(0u)) const;
+
+  private:
+
+    class MappedSegment;
+
+    const std::string _path;
+
+    std::vector<StreamLogEntry> _entries;
+
+    /// Indices of _entries sorted by frame and sensor id.
+    std::vector<size_t> _by_frame;
+
+    std::vector<std::unique_ptr<MappedSegment>> _segments;
+  };
+
+} // namespace sensor
+} // namespace carla
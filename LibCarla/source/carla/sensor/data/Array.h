@@ -132,8 +132,8 @@ namespace data {
       : Array(0u, std::move(data)) {}
 
     void SetOffset(size_t offset) {
-      DEBUG_ASSERT(_data.size() >= _offset);
-      DEBUG_ASSERT((_data.size() - _offset) % sizeof(T) == 0u);
+      DEBUG_ASSERT(_data.size() >= offset);
+      DEBUG_ASSERT((_data.size() - offset) % sizeof(T) == 0u);
       _offset = offset;
       DEBUG_ASSERT(begin() <= end());
     }
@@ -0,0 +1,43 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Allocations.h"
+
+#include <cstdlib>
+#include <new>
+
+// Per thread, so allocations made by other threads (e.g. a thread pool of
+// another test still running) are not counted.
+static thread_local size_t NUMBER_OF_ALLOCATIONS = 0u;
+
+void *operator new(size_t size) {
+  ++NUMBER_OF_ALLOCATIONS;
+  void *ptr = std::malloc(size == 0u ? 1u : size);
+  if (ptr == nullptr) {
+#ifdef LIBCARLA_NO_EXCEPTIONS
+    std::abort();
+#else
+    throw std::bad_alloc();
+#endif // LIBCARLA_NO_EXCEPTIONS
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace util {
+
+  size_t GetNumberOfAllocations() {
+    return NUMBER_OF_ALLOCATIONS;
+  }
+
+} // namespace util
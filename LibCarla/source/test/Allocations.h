@@ -0,0 +1,20 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+
+namespace util {
+
+  /// Number of calls to the global operator new made by the current thread
+  /// since it started.
+  ///
+  /// The operator is replaced in Allocations.cpp to count them, so tests can
+  /// check whether some code allocates memory.
+  size_t GetNumberOfAllocations();
+
+} // namespace util
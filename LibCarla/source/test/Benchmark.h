@@ -0,0 +1,51 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <carla/StopWatch.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+namespace util {
+namespace benchmark {
+
+  constexpr size_t default_iterations = 20u;
+
+  /// Average time in microseconds of @a iterations calls to @a kernel().
+  template <typename KernelT>
+  static inline double measure(KernelT &&kernel, size_t iterations = default_iterations) {
+    carla::StopWatch timer;
+    for (auto i = 0u; i < iterations; ++i) {
+      kernel();
+    }
+    timer.Stop();
+    return static_cast<double>(timer.GetElapsedTime<std::chrono::microseconds>()) / iterations;
+  }
+
+  /// Measure @a kernel(threads) with 1 and 4 threads and print the time per
+  /// call, plus the throughput if each call processes @a number_of_points.
+  template <typename KernelT>
+  static inline void measure_threads(
+      const char *name,
+      const char *unit,
+      size_t number_of_points,
+      KernelT &&kernel,
+      size_t iterations = default_iterations) {
+    for (auto threads : {1u, 4u}) {
+      const auto us = measure([&]() { kernel(threads); }, iterations);
+      std::cout << name << " (" << threads << " threads): " << us << "us per " << unit;
+      if (number_of_points > 0u) {
+        std::cout << ", " << number_of_points / us << " Mpoints/s";
+      }
+      std::cout << '\n';
+    }
+  }
+
+} // namespace benchmark
+} // namespace util
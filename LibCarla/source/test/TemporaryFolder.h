@@ -0,0 +1,43 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <carla/NonCopyable.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <string>
+
+namespace util {
+
+  /// A uniquely named folder in the system temporary directory, removed with
+  /// all its contents on destruction.
+  class TemporaryFolder : private carla::NonCopyable {
+  public:
+
+    TemporaryFolder()
+      : _path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()) {
+      boost::filesystem::create_directories(_path);
+    }
+
+    ~TemporaryFolder() {
+      boost::system::error_code ec;
+      boost::filesystem::remove_all(_path, ec);
+    }
+
+    /// Path of @a filename inside this folder.
+    std::string GetFilePath(const std::string &filename) const {
+      return (_path / filename).string();
+    }
+
+  private:
+
+    const boost::filesystem::path _path;
+  };
+
+} // namespace util
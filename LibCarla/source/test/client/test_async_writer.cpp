@@ -0,0 +1,121 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "TemporaryFolder.h"
+
+#include <carla/image/ImageIO.h>
+#include <carla/sensor/AsyncWriter.h>
+#include <carla/sensor/Deserializer.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/s11n/ImageSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <cstring>
+
+using namespace carla::sensor;
+
+static carla::SharedPtr<data::Image> MakeImage(uint32_t width, uint32_t height) {
+  using namespace s11n;
+  const auto index = SensorRegistry::get<ASceneCaptureCamera *>::index;
+  auto header = SensorHeaderSerializer::Serialize(index, 1u, 1.0, carla::rpc::Transform{});
+  const ImageSerializer::ImageHeader image_header{width, height, 90.0f};
+  carla::Buffer buffer(header.size() + sizeof(image_header) + sizeof(data::Color) * width * height);
+  std::memcpy(buffer.data(), header.data(), header.size());
+  std::memcpy(buffer.data() + header.size(), &image_header, sizeof(image_header));
+  auto *pixels = buffer.data() + header.size() + sizeof(image_header);
+  for (auto i = 0u; i < sizeof(data::Color) * width * height; ++i) {
+    pixels[i] = static_cast<unsigned char>(i % 251u);
+  }
+  auto result = boost::dynamic_pointer_cast<data::Image>(Deserializer::Deserialize(std::move(buffer)));
+  EXPECT_NE(result, nullptr);
+  return result;
+}
+
+TEST(async_writer, write_images) {
+  if (!carla::image::io::has_png_support()) {
+    carla::log_info("This test requires PNG support.");
+    return;
+  }
+  constexpr auto number_of_images = 20u;
+  util::TemporaryFolder folder;
+  std::vector<std::string> paths;
+  {
+    AsyncWriter writer(4u, 4u, AsyncWriter::QueueFullPolicy::Block);
+    for (auto i = 0u; i < number_of_images; ++i) {
+      paths.emplace_back(folder.GetFilePath(std::to_string(i) + ".png"));
+      const auto cc = static_cast<AsyncWriter::ColorConversion>(i % 4u);
+      ASSERT_TRUE(writer.Write(MakeImage(64u, 48u), paths.back(), cc));
+    }
+    writer.Flush();
+    ASSERT_EQ(writer.GetPendingWrites(), 0u);
+    const auto statistics = writer.GetStatistics();
+    ASSERT_EQ(statistics.size(), 1u);
+    const auto &png = statistics.at("png");
+    ASSERT_EQ(png.files_written, number_of_images);
+    ASSERT_EQ(png.files_dropped, 0u);
+    ASSERT_EQ(png.errors, 0u);
+    ASSERT_EQ(png.bytes_written, number_of_images * 64u * 48u * sizeof(data::Color));
+  }
+  for (auto &path : paths) {
+    ASSERT_TRUE(boost::filesystem::exists(path)) << path;
+  }
+}
+
+TEST(async_writer, drop_when_full) {
+  if (!carla::image::io::has_png_support()) {
+    carla::log_info("This test requires PNG support.");
+    return;
+  }
+  constexpr auto number_of_images = 50u;
+  util::TemporaryFolder folder;
+  auto image = MakeImage(640u, 480u);
+  for (auto policy : {AsyncWriter::QueueFullPolicy::DropNewest, AsyncWriter::QueueFullPolicy::DropOldest}) {
+    AsyncWriter writer(1u, 2u, policy);
+    size_t accepted = 0u;
+    for (auto i = 0u; i < number_of_images; ++i) {
+      if (writer.WriteImage(image, folder.GetFilePath(std::to_string(i)))) {
+        ++accepted;
+      }
+    }
+    ASSERT_TRUE(writer.Flush(10s));
+    const auto png = writer.GetStatistics().at("png");
+    ASSERT_GT(png.files_dropped, 0u);
+    ASSERT_EQ(png.files_written + png.files_dropped, number_of_images);
+    if (policy == AsyncWriter::QueueFullPolicy::DropNewest) {
+      ASSERT_EQ(accepted, png.files_written);
+    } else {
+      ASSERT_EQ(accepted, number_of_images);
+    }
+  }
+}
+
+TEST(async_writer, destroy_with_pending_writes) {
+  if (!carla::image::io::has_png_support()) {
+    carla::log_info("This test requires PNG support.");
+    return;
+  }
+  constexpr auto number_of_images = 20u;
+  util::TemporaryFolder folder;
+  std::vector<std::string> paths;
+  carla::WeakPtr<data::Image> weak_image;
+  {
+    auto image = MakeImage(640u, 480u);
+    weak_image = image;
+    AsyncWriter writer(1u, number_of_images, AsyncWriter::QueueFullPolicy::Block);
+    for (auto i = 0u; i < number_of_images; ++i) {
+      paths.emplace_back(folder.GetFilePath(std::to_string(i) + ".png"));
+      ASSERT_TRUE(writer.WriteImage(image, paths.back()));
+    }
+    ASSERT_GT(writer.GetPendingWrites(), 0u);
+  }
+  ASSERT_TRUE(weak_image.expired());
+  for (auto &path : paths) {
+    ASSERT_TRUE(boost::filesystem::exists(path)) << path;
+  }
+}
@@ -0,0 +1,297 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Allocations.h"
+
+#include <carla/StopWatch.h>
+#include <carla/geom/Math.h>
+#include <carla/opendrive/OpenDriveParser.h>
+
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#  include <malloc.h>
+#endif // __GLIBC__
+
+using namespace carla::road;
+using namespace carla::road::element;
+using namespace carla::opendrive;
+
+/// Bytes in use by the heap, zero if unknown.
+static size_t GetHeapUsage() {
+#ifdef __GLIBC__
+#  if __GLIBC_PREREQ(2, 33)
+  const auto info = mallinfo2();
+#  else
+  const auto info = mallinfo();
+#  endif
+  return static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd);
+#else
+  return 0u;
+#endif // __GLIBC__
+}
+
+static constexpr double RoadLength = 100.0;
+
+/// A lane of a synthetic road, the sign of the id tells the side.
+static void WriteLane(std::ostream &out, int id, const char *type, double width) {
+  out << "<lane id=\"" << id << "\" type=\"" << type << "\" level=\"false\">"
+      << "<link><predecessor id=\"" << id << "\"/><successor id=\"" << id << "\"/></link>";
+  if (id != 0) {
+    out << "<width sOffset=\"0\" a=\"" << width << "\" b=\"0\" c=\"0\" d=\"0\"/>";
+  }
+  out << "<roadMark sOffset=\"0\" type=\"" << (std::abs(id) == 1 ? "broken" : "solid")
+      << "\" weight=\"standard\" color=\"white\" material=\"standard\" width=\"0.15\" laneChange=\"both\"/>";
+  if (id != 0) {
+    out << "<speed sOffset=\"0\" max=\"" << (std::string(type) == "driving" ? 50 : 5) << "\" unit=\"km/h\"/>";
+  }
+  out << "</lane>";
+}
+
+/// A straight road of RoadLength meters with two lane sections, each with two
+/// driving lanes and a sidewalk on each side.
+static void WriteRoad(
+    std::ostream &out,
+    int id,
+    int predecessor,
+    int successor,
+    double x,
+    double y,
+    double hdg) {
+  out << "<road name=\"Road " << id << "\" length=\"" << RoadLength << "\" id=\"" << id << "\" junction=\"-1\">";
+  out << "<link>";
+  if (predecessor != 0) {
+    out << "<predecessor elementType=\"road\" elementId=\"" << predecessor << "\" contactPoint=\"end\"/>";
+  }
+  if (successor != 0) {
+    out << "<successor elementType=\"road\" elementId=\"" << successor << "\" contactPoint=\"start\"/>";
+  }
+  out << "</link>";
+  out << "<type s=\"0\" type=\"town\"><speed max=\"50\" unit=\"km/h\"/></type>";
+  out << "<planView><geometry s=\"0\" x=\"" << x << "\" y=\"" << y << "\" hdg=\"" << hdg
+      << "\" length=\"" << RoadLength << "\"><line/></geometry></planView>";
+  out << "<elevationProfile><elevation s=\"0\" a=\"0\" b=\"0\" c=\"0\" d=\"0\"/></elevationProfile>";
+  out << "<lanes><laneOffset s=\"0\" a=\"0\" b=\"0\" c=\"0\" d=\"0\"/>";
+  for (auto s : {0.0, 0.5 * RoadLength}) {
+    out << "<laneSection s=\"" << s << "\"><left>";
+    WriteLane(out, 3, "sidewalk", 2.0);
+    WriteLane(out, 2, "driving", 3.5);
+    WriteLane(out, 1, "driving", 3.5);
+    out << "</left><center>";
+    WriteLane(out, 0, "none", 0.0);
+    out << "</center><right>";
+    WriteLane(out, -1, "driving", 3.5);
+    WriteLane(out, -2, "driving", 3.5);
+    WriteLane(out, -3, "sidewalk", 2.0);
+    out << "</right></laneSection>";
+  }
+  out << "</lanes></road>";
+}
+
+/// A grid of @a size x @a size nodes joined by chains of roads, a chain for
+/// each row and each column.
+static std::string MakeGridOpenDrive(int size) {
+  std::ostringstream out;
+  out << "<?xml version=\"1.0\" standalone=\"yes\"?><OpenDRIVE>"
+      << "<header revMajor=\"1\" revMinor=\"4\" name=\"grid\" version=\"1\">"
+      << "<geoReference><![CDATA[+proj=tmerc +lat_0=42 +lon_0=2]]></geoReference></header>";
+  const int roads_per_chain = size - 1;
+  auto row_road = [=](int row, int i) { return 1 + row * roads_per_chain + i; };
+  auto column_road = [=](int column, int i) { return 1 + size * roads_per_chain + column * roads_per_chain + i; };
+  for (auto chain = 0; chain < size; ++chain) {
+    for (auto i = 0; i < roads_per_chain; ++i) {
+      const int previous = i > 0 ? i - 1 : -1;
+      const int next = i + 1 < roads_per_chain ? i + 1 : -1;
+      WriteRoad(out, row_road(chain, i),
+          previous >= 0 ? row_road(chain, previous) : 0,
+          next >= 0 ? row_road(chain, next) : 0,
+          i * RoadLength, chain * RoadLength, 0.0);
+      WriteRoad(out, column_road(chain, i),
+          previous >= 0 ? column_road(chain, previous) : 0,
+          next >= 0 ? column_road(chain, next) : 0,
+          chain * RoadLength, i * RoadLength, carla::geom::Math::pi_half());
+    }
+  }
+  out << "</OpenDRIVE>";
+  return out.str();
+}
+
+static void benchmark_road_map(const int size) {
+  const auto xodr = MakeGridOpenDrive(size);
+  const size_t number_of_roads = 2u * static_cast<size_t>(size * (size - 1));
+
+  const auto heap_before = GetHeapUsage();
+  carla::StopWatch load_timer;
+  auto map = OpenDriveParser::Load(xodr);
+  const auto load_time = load_timer.GetElapsedTime<std::chrono::microseconds>();
+  const auto heap_after = GetHeapUsage();
+  ASSERT_TRUE(map.has_value());
+  ASSERT_EQ(map->GetMap().GetRoadCount(), number_of_roads);
+
+  // Waypoints every 2 meters on the 4 driving lanes of each road.
+  carla::StopWatch generate_timer;
+  const auto waypoints = map->GenerateWaypoints(2.0);
+  const auto generate_time = generate_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_EQ(waypoints.size(), number_of_roads * 4u * 50u);
+
+  carla::StopWatch topology_timer;
+  const auto topology = map->GenerateTopology();
+  const auto topology_time = topology_timer.GetElapsedTime<std::chrono::microseconds>();
+  // Each driving lane of each lane section connects to the lane ahead, except
+  // at the end of each chain.
+  ASSERT_EQ(topology.size(), (2u * number_of_roads - 2u * static_cast<size_t>(size)) * 4u);
+
+  carla::StopWatch transform_timer;
+  double sum = 0.0;
+  for (auto &waypoint : waypoints) {
+    sum += map->ComputeTransform(waypoint).location.z;
+  }
+  const auto transform_time = transform_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_EQ(sum, 0.0);
+
+  carla::StopWatch next_timer;
+  size_t number_of_next = 0u;
+  for (auto &waypoint : waypoints) {
+    number_of_next += map->GetNext(waypoint, 30.0).size();
+  }
+  const auto next_time = next_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_GT(number_of_next, waypoints.size() / 2u);
+
+  // Locations on the driving lanes of the rows, Unreal's Y axis is inverted.
+  constexpr size_t number_of_queries = 500u;
+  std::mt19937 engine(42u);
+  std::uniform_int_distribution<int> row(0, size - 1);
+  std::uniform_real_distribution<double> along(0.0, (size - 1) * RoadLength);
+  std::uniform_real_distribution<double> across(-6.5, 6.5);
+  std::vector<carla::geom::Location> locations;
+  locations.reserve(number_of_queries);
+  for (auto i = 0u; i < number_of_queries; ++i) {
+    locations.emplace_back(
+        static_cast<float>(along(engine)),
+        static_cast<float>(-row(engine) * RoadLength + across(engine)),
+        0.0f);
+  }
+  const auto allocations_before = util::GetNumberOfAllocations();
+  carla::StopWatch query_timer;
+  size_t found = 0u;
+  for (auto &location : locations) {
+    found += map->GetWaypoint(location).has_value() ? 1u : 0u;
+  }
+  const auto query_time = query_timer.GetElapsedTime<std::chrono::microseconds>();
+  const auto query_allocations = util::GetNumberOfAllocations() - allocations_before;
+  ASSERT_GT(found, number_of_queries / 2u);
+
+  // A trajectory along the right lane of the middle row, displaced 0.3 m to
+  // the right of the lane center, avoiding the ends of the roads.
+  const int middle_row = size / 2;
+  const double lane_center = 1.75;
+  const double offset = 0.3;
+  std::vector<carla::geom::Location> trajectory;
+  for (double x = 0.25; x < (size - 1) * RoadLength; x += 0.5) {
+    trajectory.emplace_back(
+        static_cast<float>(x),
+        static_cast<float>(-middle_row * RoadLength + lane_center + offset),
+        0.0f);
+  }
+
+  // Per-point projection, as done without the Frenet API.
+  carla::StopWatch per_point_timer;
+  double per_point_sum = 0.0;
+  for (auto &location : trajectory) {
+    auto waypoint = map->GetWaypoint(location);
+    ASSERT_TRUE(waypoint.has_value());
+    per_point_sum += map->ComputeTransform(*waypoint).location.x;
+  }
+  const auto per_point_time = per_point_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_GT(per_point_sum, 0.0);
+
+  carla::StopWatch frenet_timer;
+  const auto frenet = map->ToFrenet(trajectory);
+  const auto frenet_time = frenet_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_EQ(frenet.size(), trajectory.size());
+  std::vector<FrenetPoint> frenet_points;
+  frenet_points.reserve(frenet.size());
+  for (auto i = 0u; i < trajectory.size(); ++i) {
+    ASSERT_TRUE(frenet[i].has_value());
+    const auto &point = *frenet[i];
+    const double x = trajectory[i].x;
+    const auto road_index = static_cast<int>(x / RoadLength);
+    ASSERT_EQ(point.waypoint.road_id, static_cast<RoadId>(1 + middle_row * (size - 1) + road_index));
+    ASSERT_EQ(point.waypoint.lane_id, -1);
+    ASSERT_NEAR(point.waypoint.s, x - road_index * RoadLength, 1e-3);
+    ASSERT_NEAR(point.t, offset, 1e-3);
+    frenet_points.emplace_back(point);
+  }
+
+  carla::StopWatch lift_timer;
+  const auto lifted = map->FromFrenet(frenet_points);
+  const auto lift_time = lift_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_EQ(lifted.size(), trajectory.size());
+  for (auto i = 0u; i < trajectory.size(); ++i) {
+    ASSERT_LT(carla::geom::Math::Distance2D(lifted[i].location, trajectory[i]), 1e-2);
+  }
+
+  // Lane polylines every half meter, as built by the visualizers from
+  // GenerateWaypoints, one transform and one lane width per point.
+  carla::StopWatch per_waypoint_timer;
+  const auto half_meter_waypoints = map->GenerateWaypoints(0.5);
+  double per_waypoint_sum = 0.0;
+  for (auto &waypoint : half_meter_waypoints) {
+    per_waypoint_sum += map->ComputeTransform(waypoint).location.x + map->GetLaneWidth(waypoint);
+  }
+  const auto per_waypoint_time = per_waypoint_timer.GetElapsedTime<std::chrono::microseconds>();
+  ASSERT_GT(per_waypoint_sum, 0.0);
+
+  carla::StopWatch geometry_timer;
+  const auto geometry = map->ComputeLaneGeometry(0.5);
+  const auto geometry_time = geometry_timer.GetElapsedTime<std::chrono::microseconds>();
+  // Six lanes on each of the two lane sections of each road, 101 points each.
+  ASSERT_EQ(geometry.GetNumberOfLanes(), number_of_roads * 2u * 6u);
+  ASSERT_EQ(geometry.GetNumberOfPoints(), geometry.GetNumberOfLanes() * 101u);
+  for (auto i = 0u; i < geometry.GetNumberOfLanes(); ++i) {
+    const auto point = geometry.offsets[i];
+    const auto lane_id = geometry.lane_ids[i];
+    const auto type = std::abs(lane_id) == 1 ? LaneMarking::Type::Broken : LaneMarking::Type::Solid;
+    ASSERT_EQ(geometry.right_marking_types[point], static_cast<uint8_t>(type));
+    // The inner boundary of the first lanes is the solid center lane marking.
+    const auto inner_type = std::abs(lane_id) == 2 ? LaneMarking::Type::Broken : LaneMarking::Type::Solid;
+    ASSERT_EQ(geometry.left_marking_types[point], static_cast<uint8_t>(inner_type));
+    ASSERT_EQ(geometry.right_marking_colors[point], static_cast<uint8_t>(LaneMarking::Color::White));
+  }
+
+  auto per_item = [](double microseconds, size_t count) {
+    return microseconds / static_cast<double>(std::max<size_t>(count, 1u));
+  };
+  carla::logging::log("Benchmark:", number_of_roads, "roads");
+  carla::logging::log("  load:             ", load_time / 1000u, "ms,",
+      heap_after > heap_before ? (heap_after - heap_before) / 1024u : 0u, "KiB");
+  carla::logging::log("  GenerateWaypoints:", generate_time / 1000u, "ms");
+  carla::logging::log("  GenerateTopology: ", topology_time / 1000u, "ms");
+  carla::logging::log("  ComputeTransform: ", per_item(transform_time, waypoints.size()), "us/waypoint");
+  carla::logging::log("  GetNext:          ", per_item(next_time, waypoints.size()), "us/waypoint");
+  carla::logging::log("  GetWaypoint:      ", per_item(query_time, number_of_queries), "us/query,",
+      static_cast<double>(query_allocations) / number_of_queries, "allocations/query");
+  ASSERT_EQ(query_allocations, 0u);
+  carla::logging::log("  GetWaypoint+ComputeTransform:", per_item(per_point_time, trajectory.size()), "us/point");
+  carla::logging::log("  ToFrenet (batched):", per_item(frenet_time, trajectory.size()), "us/point");
+  carla::logging::log("  FromFrenet (batched):", per_item(lift_time, trajectory.size()), "us/point");
+  carla::logging::log("  GenerateWaypoints+ComputeTransform+GetLaneWidth (0.5 m):", per_waypoint_time / 1000u, "ms");
+  carla::logging::log("  ComputeLaneGeometry (0.5 m):", geometry_time / 1000u, "ms,",
+      geometry.GetNumberOfPoints(), "points");
+}
+
+TEST(benchmark_road_map, grid_10x10) {
+  benchmark_road_map(10);
+}
+
+TEST(benchmark_road_map, grid_30x30) {
+  benchmark_road_map(30);
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/detail/CallbackList.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using carla::client::detail::CallbackList;
+
+template <typename F>
+static void WaitUntil(F condition) {
+  carla::StopWatch timer;
+  while (!condition()) {
+    ASSERT_LT(timer.GetElapsedTime(), 10000u) << "timeout";
+    std::this_thread::sleep_for(1ms);
+  }
+}
+
+TEST(callback_list, register_and_remove) {
+  CallbackList<int> list;
+  int a = 0;
+  int b = 0;
+  auto id_a = list.RegisterCallback([&](int x) { a += x; });
+  auto id_b = list.RegisterCallback([&](int x) { b += x; });
+  ASSERT_NE(id_a, 0u);
+  ASSERT_NE(id_a, id_b);
+  list.Call(1);
+  ASSERT_EQ(a, 1);
+  ASSERT_EQ(b, 1);
+  ASSERT_TRUE(list.RemoveCallback(id_a));
+  ASSERT_FALSE(list.RemoveCallback(id_a));
+  list.Call(1);
+  ASSERT_EQ(a, 1);
+  ASSERT_EQ(b, 2);
+  list.Clear();
+  list.Call(1);
+  ASSERT_EQ(b, 2);
+  ASSERT_FALSE(list.RemoveCallback(id_b));
+}
+
+TEST(callback_list, worker_threads) {
+  constexpr int number_of_calls = 1000;
+  CallbackList<int> list;
+  list.SetWorkerThreads(4u);
+
+  // A slow callback must not delay the fast one.
+  std::atomic_bool release_slow{false};
+  std::atomic_int slow_count{0};
+  list.RegisterCallback([&](int) {
+    while (!release_slow) {
+      std::this_thread::sleep_for(1ms);
+    }
+    ++slow_count;
+  });
+
+  std::mutex mutex;
+  std::vector<int> received;
+  list.RegisterCallback([&](int x) {
+    std::lock_guard<std::mutex> lock(mutex);
+    received.push_back(x);
+  });
+
+  for (auto i = 0; i < number_of_calls; ++i) {
+    list.Call(i);
+  }
+
+  WaitUntil([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return received.size() == number_of_calls;
+  });
+  ASSERT_EQ(slow_count, 0);
+  for (auto i = 0; i < number_of_calls; ++i) {
+    ASSERT_EQ(received[i], i);
+  }
+
+  release_slow = true;
+  WaitUntil([&]() { return slow_count == number_of_calls; });
+}
+
+TEST(callback_list, modify_from_callback) {
+  using ListType = CallbackList<int>;
+  ListType list;
+  list.SetWorkerThreads(2u);
+
+  // Replaces the worker threads it is running in, and removes itself.
+  std::atomic<ListType::CallbackId> self_id{0u};
+  std::atomic_int count{0};
+  self_id = list.RegisterCallback([&](int) {
+    list.SetWorkerThreads(3u);
+    EXPECT_TRUE(list.RemoveCallback(self_id));
+    ++count;
+  });
+  list.Call(1);
+  WaitUntil([&]() { return count == 1; });
+
+  // The new worker threads run the callbacks registered afterwards.
+  std::atomic_int sum{0};
+  list.RegisterCallback([&](int x) { sum += x; });
+  list.Call(2);
+  WaitUntil([&]() { return sum == 2; });
+
+  // Go back to calling in the caller's thread from a worker thread.
+  std::atomic_bool done{false};
+  self_id = list.RegisterCallback([&](int) {
+    if (!done) {
+      list.SetWorkerThreads(0u);
+      EXPECT_TRUE(list.RemoveCallback(self_id));
+      done = true;
+    }
+  });
+  list.Call(3);
+  WaitUntil([&]() { return done.load(); });
+  list.Call(4);
+  ASSERT_EQ(sum, 9);
+  ASSERT_EQ(count, 1);
+}
@@ -5,12 +5,19 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "test.h"
+#include "Benchmark.h"
 
+#include <carla/StopWatch.h>
+#include <carla/image/ColorConverterKernels.h>
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
+#include <carla/image/ImagePipeline.h>
+#include <carla/image/SegmentationAnalysis.h>
 #include <carla/image/ImageView.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 template <typename ViewT, typename PixelT>
 struct TestImage {
@@ -186,3 +193,458 @@ TEST(image, semantic_segmentation) {
     }
   }
 }
+
+using carla::image::ColorConverterKernels;
+using carla::sensor::data::Color;
+
+static auto MakeBgra8View(std::vector<Color> &pixels) {
+  return boost::gil::interleaved_view(
+      pixels.size(),
+      1u,
+      reinterpret_cast<boost::gil::bgra8_pixel_t *>(pixels.data()),
+      sizeof(Color) * pixels.size());
+}
+
+static std::vector<ColorConverterKernels::InstructionSet> GetSupportedInstructionSets() {
+  using IS = ColorConverterKernels::InstructionSet;
+  std::vector<IS> result;
+  for (auto is : {IS::Scalar, IS::SSE41, IS::AVX2}) {
+    if (static_cast<int>(is) <= static_cast<int>(ColorConverterKernels::GetSupportedInstructionSet())) {
+      result.emplace_back(is);
+    }
+  }
+  return result;
+}
+
+template <typename CC>
+static void CheckDepthKernel(CC cc, int tolerance) {
+  using namespace boost::gil;
+  using namespace carla::image;
+
+  // Every possible depth in release, a subset in debug (too slow).
+#ifdef NDEBUG
+  constexpr uint32_t step = 1u;
+#else
+  constexpr uint32_t step = 251u;
+#endif
+  std::vector<Color> source;
+  for (uint32_t depth = 0u; depth < (1u << 24u); depth += step) {
+    source.emplace_back(depth & 0xffu, (depth >> 8u) & 0xffu, (depth >> 16u) & 0xffu);
+  }
+  auto expected_bgra = source;
+  auto expected_bgra_view = MakeBgra8View(expected_bgra);
+  ImageConverter::ConvertInPlace(expected_bgra_view, cc);
+  std::vector<uint8_t> expected_gray(source.size());
+  auto expected_gray_view = interleaved_view(
+      source.size(), 1u,
+      reinterpret_cast<gray8_pixel_t *>(expected_gray.data()),
+      expected_gray.size());
+  ImageConverter::CopyPixels(
+      ImageView::MakeColorConvertedView(MakeBgra8View(source), cc),
+      expected_gray_view);
+
+  for (auto is : GetSupportedInstructionSets()) {
+    std::vector<Color> bgra = source;
+    ColorConverterKernels::Convert(is, cc, bgra.data(), bgra.data(), bgra.size());
+    std::vector<uint8_t> gray(source.size());
+    ColorConverterKernels::Convert(is, cc, source.data(), gray.data(), gray.size());
+    for (auto i = 0u; i < source.size(); ++i) {
+      ASSERT_NEAR(int(bgra[i].r), int(expected_bgra[i].r), tolerance)
+          << ColorConverterKernels::GetName(is) << " at " << i;
+      ASSERT_EQ(bgra[i].r, bgra[i].g);
+      ASSERT_EQ(bgra[i].r, bgra[i].b);
+      ASSERT_EQ(bgra[i].a, expected_bgra[i].a);
+      ASSERT_NEAR(int(gray[i]), int(expected_gray[i]), tolerance)
+          << ColorConverterKernels::GetName(is) << " at " << i;
+    }
+  }
+}
+
+TEST(image, color_converter_kernels_depth) {
+  CheckDepthKernel(carla::image::ColorConverter::Depth(), 0);
+}
+
+TEST(image, color_converter_kernels_logarithmic_depth) {
+  CheckDepthKernel(carla::image::ColorConverter::LogarithmicDepth(), 1);
+}
+
+TEST(image, color_converter_kernels_float_depth) {
+  using namespace carla::image;
+  std::vector<Color> source;
+  for (uint32_t depth = 0u; depth < (1u << 24u); depth += 4093u) {
+    source.emplace_back(depth & 0xffu, (depth >> 8u) & 0xffu, (depth >> 16u) & 0xffu);
+  }
+  source.emplace_back(255u, 255u, 255u);
+  for (auto is : GetSupportedInstructionSets()) {
+    std::vector<float> result(source.size());
+    ColorConverterKernels::Convert(is, ColorConverter::Depth(), source.data(), result.data(), result.size());
+    for (auto i = 0u; i < source.size(); ++i) {
+      const float expected =
+          (source[i].r + source[i].g * 256.0f + source[i].b * 256.0f * 256.0f) / (256.0f * 256.0f * 256.0f - 1.0f);
+      ASSERT_EQ(result[i], expected) << ColorConverterKernels::GetName(is) << " at " << i;
+    }
+    ASSERT_EQ(result.back(), 1.0f);
+  }
+}
+
+TEST(image, color_converter_kernels_semantic_segmentation) {
+  using namespace carla::image;
+  std::vector<Color> source;
+  for (auto i = 0u; i < 4u * 256u + 3u; ++i) {
+    source.emplace_back(static_cast<uint8_t>(i), static_cast<uint8_t>(i / 7u), 0u, 0u);
+  }
+  auto expected = source;
+  auto expected_view = MakeBgra8View(expected);
+  ImageConverter::ConvertInPlace(expected_view, ColorConverter::CityScapesPalette());
+  for (auto is : GetSupportedInstructionSets()) {
+    auto result = source;
+    ColorConverterKernels::Convert(is, ColorConverter::CityScapesPalette(), result.data(), result.data(), result.size());
+    for (auto i = 0u; i < result.size(); ++i) {
+      ASSERT_EQ(result[i], expected[i]) << ColorConverterKernels::GetName(is) << " at " << i;
+    }
+  }
+}
+
+template <typename CC>
+static void BenchmarkColorConverter(const char *name, CC cc, size_t width, size_t height) {
+  using namespace carla::image;
+  std::vector<Color> source(width * height);
+  uint32_t seed = 1u;
+  for (auto &pixel : source) {
+    seed = seed * 1664525u + 1013904223u;
+    pixel = Color(seed >> 8u, seed >> 16u, seed >> 24u);
+  }
+  const double megapixels = 1e-6 * static_cast<double>(source.size());
+  auto report = [&](const char *method, carla::StopWatch &timer) {
+    const auto seconds = 1e-6 * static_cast<double>(
+        timer.GetElapsedTime<std::chrono::microseconds>());
+    std::cout << name << ' ' << width << 'x' << height << ' ' << method
+              << ": " << megapixels / seconds << " MP/s\n";
+  };
+  {
+    auto image = source;
+    auto view = MakeBgra8View(image);
+    carla::StopWatch timer;
+    ImageConverter::ConvertInPlace(view, cc);
+    timer.Stop();
+    report("boost::gil", timer);
+  }
+  for (auto is : GetSupportedInstructionSets()) {
+    auto image = source;
+    carla::StopWatch timer;
+    ColorConverterKernels::Convert(is, cc, image.data(), image.data(), image.size());
+    timer.Stop();
+    report(ColorConverterKernels::GetName(is), timer);
+  }
+}
+
+TEST(image, benchmark_color_converter_kernels) {
+  using namespace carla::image;
+  for (auto size : {std::make_pair(1920u, 1080u), std::make_pair(3840u, 2160u)}) {
+    BenchmarkColorConverter("Depth", ColorConverter::Depth(), size.first, size.second);
+    BenchmarkColorConverter("LogarithmicDepth", ColorConverter::LogarithmicDepth(), size.first, size.second);
+    BenchmarkColorConverter("CityScapesPalette", ColorConverter::CityScapesPalette(), size.first, size.second);
+  }
+}
+
+static auto MakeBgra8View(std::vector<Color> &pixels, size_t width, size_t height) {
+  return boost::gil::interleaved_view(
+      width,
+      height,
+      reinterpret_cast<const boost::gil::bgra8c_pixel_t *>(pixels.data()),
+      sizeof(Color) * width);
+}
+
+TEST(image, pipeline_crop_and_channel_order) {
+  using carla::image::ImagePipeline;
+  constexpr size_t width = 5u;
+  constexpr size_t height = 4u;
+  std::vector<Color> pixels;
+  for (auto i = 0u; i < width * height; ++i) {
+    pixels.emplace_back(i, 100u + i, 200u - i, 7u);
+  }
+  const auto view = MakeBgra8View(pixels, width, height);
+
+  ImagePipeline pipeline;
+  pipeline.Crop(1u, 2u, 3u, 2u).SetChannelOrder(ImagePipeline::ChannelOrder::RGB);
+  const auto shape = pipeline.GetOutputShape(width, height);
+  ASSERT_EQ(shape.height, 2u);
+  ASSERT_EQ(shape.width, 3u);
+  ASSERT_EQ(shape.channels, 3u);
+  std::vector<uint8_t> hwc(shape.size());
+  pipeline.Run(view, hwc.data());
+  for (auto y = 0u; y < 2u; ++y) {
+    for (auto x = 0u; x < 3u; ++x) {
+      const auto &pixel = pixels[(y + 2u) * width + x + 1u];
+      const auto *out = &hwc[(y * 3u + x) * 3u];
+      ASSERT_EQ(out[0u], pixel.r);
+      ASSERT_EQ(out[1u], pixel.g);
+      ASSERT_EQ(out[2u], pixel.b);
+    }
+  }
+
+  pipeline.SetChannelOrder(ImagePipeline::ChannelOrder::BGRA).SetLayout(ImagePipeline::Layout::CHW);
+  std::vector<uint8_t> chw(pipeline.GetOutputShape(width, height).size());
+  pipeline.Run(view, chw.data(), 2u);
+  ASSERT_EQ(chw[0u], pixels[11u].b);
+  ASSERT_EQ(chw[6u + 1u], pixels[12u].g);
+  ASSERT_EQ(chw[12u + 5u], pixels[18u].r);
+  ASSERT_EQ(chw[18u + 2u], 7u);
+
+  pipeline.Crop(3u, 0u, 3u, 1u);
+  ASSERT_THROW(pipeline.Run(view, chw.data()), std::invalid_argument);
+}
+
+TEST(image, pipeline_resize) {
+  using carla::image::ImagePipeline;
+  constexpr size_t width = 4u;
+  constexpr size_t height = 4u;
+  std::vector<Color> pixels(width * height);
+  for (auto i = 0u; i < pixels.size(); ++i) {
+    pixels[i] = Color(static_cast<uint8_t>(i * 10u), 0u, 0u);
+  }
+  const auto view = MakeBgra8View(pixels, width, height);
+
+  // Area averages each 2x2 block.
+  ImagePipeline pipeline;
+  pipeline.Resize(2u, 2u).SetChannelOrder(ImagePipeline::ChannelOrder::RGB).SetLayout(ImagePipeline::Layout::CHW);
+  std::vector<float> area(pipeline.GetOutputShape(width, height).size());
+  pipeline.Run(view, area.data());
+  const std::vector<float> expected = {25.0f, 45.0f, 105.0f, 125.0f};
+  for (auto i = 0u; i < expected.size(); ++i) {
+    ASSERT_NEAR(area[i], expected[i] / 255.0f, 1e-6f);
+  }
+
+  // Downscaling by two, bilinear samples halfway between the same pixels.
+  pipeline.Resize(2u, 2u, ImagePipeline::Interpolation::Bilinear);
+  std::vector<float> bilinear(area.size());
+  pipeline.Run(view, bilinear.data());
+  ASSERT_EQ(bilinear, area);
+
+  // Same size is an exact copy with both methods.
+  for (auto interpolation : {ImagePipeline::Interpolation::Area, ImagePipeline::Interpolation::Bilinear}) {
+    pipeline.Resize(width, height, interpolation);
+    std::vector<uint8_t> copy(pipeline.GetOutputShape(width, height).size());
+    pipeline.Run(view, copy.data());
+    for (auto i = 0u; i < pixels.size(); ++i) {
+      ASSERT_EQ(copy[i], pixels[i].r);
+    }
+  }
+
+  // Non-integer factors keep the mean of a constant image.
+  std::vector<Color> constant(37u * 23u, Color(90u, 60u, 30u));
+  pipeline.Resize(5u, 3u).SetChannelOrder(ImagePipeline::ChannelOrder::BGR).SetLayout(ImagePipeline::Layout::HWC);
+  std::vector<uint8_t> resized(pipeline.GetOutputShape(37u, 23u).size());
+  pipeline.Run(MakeBgra8View(constant, 37u, 23u), resized.data());
+  for (auto i = 0u; i < resized.size(); i += 3u) {
+    ASSERT_EQ(resized[i], 30u);
+    ASSERT_EQ(resized[i + 1u], 60u);
+    ASSERT_EQ(resized[i + 2u], 90u);
+  }
+}
+
+TEST(image, pipeline_normalize) {
+  using carla::image::ImagePipeline;
+  std::vector<Color> pixels(6u, Color(255u, 0u, 51u));
+  ImagePipeline pipeline;
+  pipeline
+      .SetChannelOrder(ImagePipeline::ChannelOrder::RGB)
+      .Normalize({0.5f, 0.0f, 0.1f}, {0.5f});
+  std::vector<float> out(pipeline.GetOutputShape(3u, 2u).size());
+  pipeline.Run(MakeBgra8View(pixels, 3u, 2u), out.data());
+  for (auto i = 0u; i < out.size(); i += 3u) {
+    ASSERT_NEAR(out[i], 1.0f, 1e-6f);
+    ASSERT_NEAR(out[i + 1u], 0.0f, 1e-6f);
+    ASSERT_NEAR(out[i + 2u], 0.2f, 1e-6f);
+  }
+  pipeline.Normalize({0.5f, 0.5f}, {1.0f});
+  ASSERT_THROW(pipeline.Run(MakeBgra8View(pixels, 3u, 2u), out.data()), std::invalid_argument);
+  ASSERT_THROW(pipeline.Normalize({0.0f}, {0.0f}), std::invalid_argument);
+}
+
+TEST(image, benchmark_pipeline) {
+  using carla::image::ImagePipeline;
+  constexpr size_t width = 1280u;
+  constexpr size_t height = 720u;
+  std::vector<Color> source(width * height);
+  uint32_t seed = 1u;
+  for (auto &pixel : source) {
+    seed = seed * 1664525u + 1013904223u;
+    pixel = Color(seed >> 8u, seed >> 16u, seed >> 24u);
+  }
+  const auto view = MakeBgra8View(source, width, height);
+  std::vector<float> out(3u * 224u * 224u);
+  for (auto interpolation : {ImagePipeline::Interpolation::Area, ImagePipeline::Interpolation::Bilinear}) {
+    for (auto size : {84u, 224u}) {
+      ImagePipeline pipeline;
+      pipeline
+          .Resize(size, size, interpolation)
+          .SetChannelOrder(ImagePipeline::ChannelOrder::RGB)
+          .SetLayout(ImagePipeline::Layout::CHW)
+          .Normalize({0.485f, 0.456f, 0.406f}, {0.229f, 0.224f, 0.225f});
+      const auto us = util::benchmark::measure([&]() { pipeline.Run(view, out.data()); });
+      std::cout << "pipeline " << width << 'x' << height << " -> " << size << 'x' << size
+                << (interpolation == ImagePipeline::Interpolation::Area ? " area" : " bilinear") << ": "
+                << us << "us per frame\n";
+    }
+  }
+}
+
+/// Segmentation image from a string per row, a digit per pixel with its tag.
+static std::vector<Color> MakeSegmentation(const std::vector<std::string> &rows) {
+  std::vector<Color> result;
+  for (auto &row : rows) {
+    for (auto c : row) {
+      result.emplace_back(static_cast<uint8_t>(c - '0'), 0u, 0u);
+    }
+  }
+  return result;
+}
+
+TEST(image, segmentation_tag_statistics) {
+  using carla::image::SegmentationAnalysis;
+  const auto pixels = MakeSegmentation({
+    "0000000",
+    "0770000",
+    "0770044",
+    "0000044",
+    "4000000"
+  });
+  std::vector<uint32_t> histogram(SegmentationAnalysis::NumberOfTags);
+  std::vector<SegmentationAnalysis::Box> boxes(SegmentationAnalysis::NumberOfTags);
+  SegmentationAnalysis::ComputeTagStatistics(pixels.data(), 7u, 5u, histogram.data(), boxes.data(), 2u);
+  ASSERT_EQ(histogram[0u], 26u);
+  ASSERT_EQ(histogram[4u], 5u);
+  ASSERT_EQ(histogram[7u], 4u);
+  ASSERT_EQ(histogram[1u], 0u);
+  ASSERT_EQ(boxes[7u].x_min, 1u);
+  ASSERT_EQ(boxes[7u].y_min, 1u);
+  ASSERT_EQ(boxes[7u].x_max, 2u);
+  ASSERT_EQ(boxes[7u].y_max, 2u);
+  ASSERT_EQ(boxes[4u].x_min, 0u);
+  ASSERT_EQ(boxes[4u].y_min, 2u);
+  ASSERT_EQ(boxes[4u].x_max, 6u);
+  ASSERT_EQ(boxes[4u].y_max, 4u);
+  ASSERT_EQ(boxes[1u].x_max, 0u);
+}
+
+TEST(image, segmentation_connected_components) {
+  using carla::image::SegmentationAnalysis;
+  const auto pixels = MakeSegmentation({
+    "0440000",
+    "0440770",
+    "0000070",
+    "4400777",
+    "0400007"
+  });
+  SegmentationAnalysis::ComponentOptions options;
+  options.tags = {4u, 7u};
+  std::vector<uint32_t> labels(pixels.size());
+  auto components = SegmentationAnalysis::FindConnectedComponents(pixels.data(), 7u, 5u, options, labels.data());
+  ASSERT_EQ(components.size(), 3u);
+  ASSERT_EQ(components[0u].tag, 4u);
+  ASSERT_EQ(components[0u].pixel_count, 4u);
+  ASSERT_FLOAT_EQ(components[0u].centroid_x, 1.5f);
+  ASSERT_FLOAT_EQ(components[0u].centroid_y, 0.5f);
+  ASSERT_EQ(components[1u].tag, 7u);
+  ASSERT_EQ(components[1u].pixel_count, 7u);
+  ASSERT_EQ(components[1u].box.x_min, 4u);
+  ASSERT_EQ(components[1u].box.y_min, 1u);
+  ASSERT_EQ(components[1u].box.x_max, 6u);
+  ASSERT_EQ(components[1u].box.y_max, 4u);
+  ASSERT_EQ(components[2u].tag, 4u);
+  ASSERT_EQ(components[2u].pixel_count, 3u);
+  ASSERT_EQ(labels[0u], 0u);
+  ASSERT_EQ(labels[1u], 1u);
+  ASSERT_EQ(labels[7u + 5u], 2u);
+  ASSERT_EQ(labels[4u * 7u + 1u], 3u);
+
+  options.min_pixel_count = 4u;
+  components = SegmentationAnalysis::FindConnectedComponents(pixels.data(), 7u, 5u, options, labels.data());
+  ASSERT_EQ(components.size(), 2u);
+  ASSERT_EQ(labels[7u + 5u], 2u);
+  ASSERT_EQ(labels[4u * 7u + 1u], 0u);
+}
+
+/// Compare the labeling split in blocks with a single-threaded flood fill.
+TEST(image, segmentation_connected_components_blocks) {
+  using carla::image::SegmentationAnalysis;
+  constexpr size_t width = 97u;
+  constexpr size_t height = 300u;
+  std::vector<Color> pixels(width * height);
+  uint32_t seed = 7u;
+  for (auto &pixel : pixels) {
+    seed = seed * 1664525u + 1013904223u;
+    pixel = Color((seed >> 28u) < 6u ? 1u : 2u, 0u, 0u);
+  }
+  SegmentationAnalysis::ComponentOptions options;
+  options.number_of_threads = 4u;
+  std::vector<uint32_t> labels(pixels.size());
+  const auto components = SegmentationAnalysis::FindConnectedComponents(pixels.data(), width, height, options, labels.data());
+
+  std::vector<uint32_t> expected(pixels.size(), 0u);
+  uint32_t count = 0u;
+  std::vector<size_t> stack;
+  for (auto start = 0u; start < pixels.size(); ++start) {
+    if (expected[start] != 0u) {
+      continue;
+    }
+    expected[start] = ++count;
+    stack.push_back(start);
+    while (!stack.empty()) {
+      const auto i = stack.back();
+      stack.pop_back();
+      const size_t x = i % width;
+      const size_t y = i / width;
+      auto visit = [&](size_t j) {
+        if ((expected[j] == 0u) && (pixels[j].r == pixels[i].r)) {
+          expected[j] = count;
+          stack.push_back(j);
+        }
+      };
+      if (x > 0u) visit(i - 1u);
+      if (x + 1u < width) visit(i + 1u);
+      if (y > 0u) visit(i - width);
+      if (y + 1u < height) visit(i + width);
+    }
+  }
+  ASSERT_EQ(components.size(), count);
+  ASSERT_EQ(labels, expected);
+}
+
+TEST(image, benchmark_segmentation_analysis) {
+  using carla::image::SegmentationAnalysis;
+  constexpr size_t width = 1920u;
+  constexpr size_t height = 1080u;
+  // Rectangles of random tags over a background of road.
+  std::vector<Color> pixels(width * height, Color(7u, 0u, 0u));
+  uint32_t seed = 1u;
+  auto random = [&](uint32_t max) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8u) % max;
+  };
+  for (auto i = 0u; i < 2000u; ++i) {
+    const auto x0 = random(width - 50u), y0 = random(height - 50u);
+    const auto w = 1u + random(50u), h = 1u + random(50u);
+    const auto tag = static_cast<uint8_t>(random(13u));
+    for (auto y = y0; y < y0 + h; ++y) {
+      for (auto x = x0; x < x0 + w; ++x) {
+        pixels[y * width + x] = Color(tag, 0u, 0u);
+      }
+    }
+  }
+  std::vector<uint32_t> histogram(SegmentationAnalysis::NumberOfTags);
+  std::vector<SegmentationAnalysis::Box> boxes(SegmentationAnalysis::NumberOfTags);
+  std::vector<uint32_t> labels(pixels.size());
+  constexpr size_t iterations = 10u;
+  util::benchmark::measure_threads("tag statistics", "frame", 0u, [&](size_t threads) {
+    SegmentationAnalysis::ComputeTagStatistics(pixels.data(), width, height, histogram.data(), boxes.data(), threads);
+  }, iterations);
+  size_t count = 0u;
+  util::benchmark::measure_threads("connected components", "frame", 0u, [&](size_t threads) {
+    SegmentationAnalysis::ComponentOptions options;
+    options.number_of_threads = threads;
+    count = SegmentationAnalysis::FindConnectedComponents(pixels.data(), width, height, options, labels.data()).size();
+  }, iterations);
+  std::cout << "connected components: " << count << " components\n";
+}
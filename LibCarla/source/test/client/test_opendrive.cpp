@@ -15,13 +15,16 @@
 #include <carla/opendrive/OpenDriveParser.h>
 #include <carla/opendrive/parser/pugixml/pugixml.hpp>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/element/LaneCrossingCalculator.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
 #include <carla/road/element/RoadInfoVisitor.h>
 
 #include <fstream>
+#include <map>
 #include <string>
+#include <tuple>
 
 using namespace carla::road;
 using namespace carla::road::element;
@@ -209,14 +212,14 @@ void test_road_links(boost::optional<Map>& map) {
 
   // process all roads, sections and lanes
   for (auto &road : map->GetMap().GetRoads()) {
-    for (auto &section : road.second.GetLaneSections()) {
+    for (auto &section : road.GetLaneSections()) {
       for (auto &lane : section.GetLanes()) {
         // check all nexts
-        for (auto link : lane.second.GetNextLanes()) {
+        for (auto link : lane.GetNextLanes()) {
           ASSERT_TRUE(link != nullptr);
         }
         // check all prevs
-        for (auto link : lane.second.GetPreviousLanes()) {
+        for (auto link : lane.GetPreviousLanes()) {
           ASSERT_TRUE(link != nullptr);
         }
       }
@@ -232,9 +235,9 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
   name = filename + ".txt";
   file.open(name, std::ios::out | std::ios::trunc);
   for (auto &road : map->GetMap().GetRoads()) {
-    file << "Road: " << road.second.GetId() << std::endl;
+    file << "Road: " << road.GetId() << std::endl;
     file << "     Nexts: ";
-    for (auto next : road.second.GetNexts()) {
+    for (auto next : road.GetNexts()) {
       if (next != nullptr) {
         file << next->GetId() << " ";
       } else {
@@ -243,7 +246,7 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
     }
     file << std::endl;
     file << "     Prevs: ";
-    for (auto prev : road.second.GetPrevs()) {
+    for (auto prev : road.GetPrevs()) {
       if (prev != nullptr) {
         file << prev->GetId() << " ";
       } else {
@@ -251,12 +254,12 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
       }
     }
     file << std::endl;
-    for (auto &section : road.second.GetLaneSections()) {
+    for (auto &section : road.GetLaneSections()) {
       file << " Section: " << section.GetId() << " " << section.GetDistance() << std::endl;
       for (auto &lane : section.GetLanes()) {
-        file << "   Lane: " << lane.second.GetId() << " (" << static_cast<uint32_t>(lane.second.GetType()) << ")" << std::endl;
+        file << "   Lane: " << lane.GetId() << " (" << static_cast<uint32_t>(lane.GetType()) << ")" << std::endl;
         file << "     Nexts: ";
-        for (auto link : lane.second.GetNextLanes()) {
+        for (auto link : lane.GetNextLanes()) {
           if (link != nullptr) {
             file << " (" << link->GetRoad()->GetId() << "," << link->GetId() << ")";
           } else {
@@ -265,7 +268,7 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
         }
         file << std::endl;
         file << "     Prevs: ";
-        for (auto link : lane.second.GetPreviousLanes()) {
+        for (auto link : lane.GetPreviousLanes()) {
           if (link != nullptr) {
             file << " (" << link->GetRoad()->GetId() << "," << link->GetId() << ")";
           } else {
@@ -287,19 +290,19 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
   file.open(name, std::ios::out | std::ios::trunc);
   for (auto &road : map->GetMap().GetRoads()) {
     std::stringstream road_name;
-    if (road.second.IsJunction()) {
-      road_name << "." << road.second.GetId() << ".";
+    if (road.IsJunction()) {
+      road_name << "." << road.GetId() << ".";
     } else {
-      road_name << road.second.GetId();
+      road_name << road.GetId();
     }
-    file << road.second.GetId() << " " << road_name.str() << std::endl;
+    file << road.GetId() << " " << road_name.str() << std::endl;
   }
   file << "#" << std::endl;
   // by roads
   for (auto &road : map->GetMap().GetRoads()) {
-    for (auto next : road.second.GetNexts()) {
+    for (auto next : road.GetNexts()) {
       if (next != nullptr) {
-        file << road.second.GetId() << " " << next->GetId() << std::endl;
+        file << road.GetId() << " " << next->GetId() << std::endl;
       } else {
         file << " (error, null road)";
       }
@@ -307,16 +310,16 @@ void print_roads(boost::optional<Map>& map, std::string filename) {
   }
   /* by lanes
   for (auto &road : map->GetMap().GetRoads()) {
-    for (auto &section : road.second.GetLaneSections()) {
+    for (auto &section : road.GetLaneSections()) {
       for (auto &lane : section.GetLanes()) {
-        for (auto link : lane.second.GetNextLanes()) {
-          if (link->GetRoad()->GetId() != road.second.GetId()) {
-            file << road.second.GetId() << " " << link->GetRoad()->GetId() << " (" << lane.second.GetId() << "," << link->GetId() << ")" << std::endl;
+        for (auto link : lane.GetNextLanes()) {
+          if (link->GetRoad()->GetId() != road.GetId()) {
+            file << road.GetId() << " " << link->GetRoad()->GetId() << " (" << lane.GetId() << "," << link->GetId() << ")" << std::endl;
           }
         }
-        // for (auto link : lane.second.GetPreviousLanes()) {
-        //   if (link->GetRoad()->GetId() != road.second.GetId()) {
-        //     file << road.second.GetId() << " " << link->GetRoad()->GetId() << " (" << lane.second.GetId() << "," << link->GetId() << ")" << std::endl;
+        // for (auto link : lane.GetPreviousLanes()) {
+        //   if (link->GetRoad()->GetId() != road.GetId()) {
+        //     file << road.GetId() << " " << link->GetRoad()->GetId() << " (" << lane.GetId() << "," << link->GetId() << ")" << std::endl;
         //   }
         // }
       }
@@ -526,3 +529,337 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, get_waypoint_with_hint) {
+  ThreadPool pool;
+  std::vector<std::future<void>> results;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    results.push_back(pool.Post<void>([file]() {
+      auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+      ASSERT_TRUE(m.has_value());
+      auto &map = *m;
+      auto waypoints = map.GenerateWaypoints(0.5);
+      ASSERT_FALSE(waypoints.empty());
+      Random::Shuffle(waypoints);
+      const auto number_of_paths = std::min<size_t>(100u, waypoints.size());
+      size_t count = 0u;
+      size_t time_with_hint = 0u;
+      size_t time_without_hint = 0u;
+      for (auto i = 0u; i < number_of_paths; ++i) {
+        auto wp = waypoints[i];
+        auto hint = wp;
+        for (auto j = 0u; j < 50u; ++j) {
+          const auto location = map.ComputeTransform(wp).location;
+          carla::StopWatch timer;
+          auto tracked = map.GetClosestWaypointOnRoad(location, hint);
+          timer.Stop();
+          time_with_hint += timer.GetElapsedTime<std::chrono::microseconds>();
+          timer.Restart();
+          auto expected = map.GetClosestWaypointOnRoad(location);
+          timer.Stop();
+          time_without_hint += timer.GetElapsedTime<std::chrono::microseconds>();
+          ASSERT_TRUE(tracked.has_value());
+          ASSERT_TRUE(expected.has_value());
+          // Overlapping lanes may return a different waypoint, but it has to
+          // contain the location too.
+          if (*tracked != *expected) {
+            ASSERT_TRUE(map.IsWithinLane(*tracked, location));
+          }
+          ++count;
+          hint = *tracked;
+          auto next = map.GetNext(wp, 2.0);
+          if (next.empty()) {
+            break;
+          }
+          wp = next[0u];
+        }
+      }
+      carla::logging::log(
+          file, ':', count, "queries, with hint", time_with_hint,
+          "us, without hint", time_without_hint, "us.");
+    }));
+  }
+  for (auto &result : results) {
+    result.get();
+  }
+}
+
+TEST(road, get_waypoint_with_hint_across_roads) {
+  ThreadPool pool;
+  std::vector<std::future<void>> results;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    results.push_back(pool.Post<void>([file]() {
+      auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+      ASSERT_TRUE(m.has_value());
+      auto &map = *m;
+      size_t count = 0u;
+      auto is_same_section = [](const Waypoint &lhs, const Waypoint &rhs) {
+        return (lhs.road_id == rhs.road_id) && (lhs.section_id == rhs.section_id);
+      };
+      for (const auto &wp : map.GenerateWaypoints(1.0)) {
+        for (const auto &step : map.GetNext(wp, 1.0)) {
+          // Only the steps that leave the lane section of the hint, into the
+          // next section, the next road, or the roads of a junction.
+          if (is_same_section(step, wp)) {
+            continue;
+          }
+          // Move a bit further, locations right at the boundary belong to
+          // both sections.
+          const auto further = map.GetNext(step, 0.5);
+          if (further.empty() || !is_same_section(further[0u], step)) {
+            continue;
+          }
+          const auto &next = further[0u];
+          const auto location = map.ComputeTransform(next).location;
+          auto tracked = map.GetClosestWaypointOnRoad(location, wp);
+          auto expected = map.GetClosestWaypointOnRoad(location);
+          ASSERT_TRUE(tracked.has_value());
+          ASSERT_TRUE(expected.has_value());
+          ASSERT_EQ(*tracked, *expected);
+
+          // Following a lane into the next section or road crosses no lane
+          // marking, with or without hint.
+          const auto origin = LaneCrossingCalculator::Project(map, map.ComputeTransform(wp).location);
+          const auto destination = LaneCrossingCalculator::Project(map, location);
+          const auto tracked_destination = LaneCrossingCalculator::Project(map, location, &origin);
+          ASSERT_TRUE(tracked_destination.waypoint.has_value());
+          ASSERT_TRUE(destination.waypoint.has_value());
+          ASSERT_EQ(*tracked_destination.waypoint, *destination.waypoint);
+          ASSERT_EQ(tracked_destination.is_offroad, destination.is_offroad);
+          auto is_on_lane_of = [](const auto &projection, const Waypoint &waypoint) {
+            return
+                projection.waypoint.has_value() &&
+                !projection.is_offroad &&
+                (projection.waypoint->road_id == waypoint.road_id) &&
+                (projection.waypoint->lane_id == waypoint.lane_id);
+          };
+          if (is_on_lane_of(origin, wp) && is_on_lane_of(destination, next)) {
+            ASSERT_TRUE(LaneCrossingCalculator::Calculate(map, origin, tracked_destination).empty());
+          }
+          ++count;
+        }
+      }
+      carla::logging::log(file, ':', count, "queries across lane sections.");
+    }));
+  }
+  for (auto &result : results) {
+    result.get();
+  }
+}
+
+TEST(road, frenet_coordinates) {
+  ThreadPool pool;
+  std::vector<std::future<void>> results;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    results.push_back(pool.Post<void>([file]() {
+      auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+      ASSERT_TRUE(m.has_value());
+      auto &map = *m;
+      auto waypoints = map.GenerateWaypoints(0.5);
+      ASSERT_FALSE(waypoints.empty());
+      Random::Shuffle(waypoints);
+      const auto number_of_paths = std::min<size_t>(100u, waypoints.size());
+      constexpr double t = 0.25;
+      size_t count = 0u;
+      size_t same_lane = 0u;
+      for (auto i = 0u; i < number_of_paths; ++i) {
+        // Lift a path along the lane, displaced to the right of its center.
+        std::vector<FrenetPoint> path;
+        auto wp = waypoints[i];
+        for (auto j = 0u; j < 50u; ++j) {
+          path.push_back(FrenetPoint{wp, t});
+          auto next = map.GetNext(wp, 2.0);
+          if (next.empty()) {
+            break;
+          }
+          wp = next[0u];
+        }
+        const auto transforms = map.FromFrenet(path);
+        ASSERT_EQ(transforms.size(), path.size());
+        std::vector<Location> polyline;
+        for (auto &transform : transforms) {
+          polyline.push_back(transform.location);
+        }
+        const auto projected = map.ToFrenet(polyline);
+        ASSERT_EQ(projected.size(), path.size());
+        for (auto j = 0u; j < path.size(); ++j) {
+          ASSERT_TRUE(projected[j].has_value());
+          const auto &point = *projected[j];
+          // Overlapping lanes may return a different lane, but it has to
+          // contain the location too.
+          if ((point.waypoint.road_id == path[j].waypoint.road_id) &&
+              (point.waypoint.lane_id == path[j].waypoint.lane_id)) {
+            ASSERT_NEAR(point.t, t, 0.01);
+            ASSERT_NEAR(point.waypoint.s, path[j].waypoint.s, 0.01);
+            ++same_lane;
+          } else {
+            ASSERT_TRUE(map.IsWithinLane(point.waypoint, polyline[j]));
+          }
+          ++count;
+        }
+      }
+      ASSERT_GT(same_lane, count / 2u);
+    }));
+  }
+  for (auto &result : results) {
+    result.get();
+  }
+}
+
+/// A straight road whose right lanes get wider along it, so the center of
+/// the outer lane is not parallel to the reference line.
+static const char *WideningRoadOpenDrive = R"(<?xml version="1.0" standalone="yes"?>
+<OpenDRIVE>
+  <header revMajor="1" revMinor="4" name="widening" version="1"/>
+  <road name="Road 1" length="50" id="1" junction="-1">
+    <link/>
+    <planView>
+      <geometry s="0" x="0" y="0" hdg="0.3" length="50"><line/></geometry>
+    </planView>
+    <elevationProfile><elevation s="0" a="0" b="0" c="0" d="0"/></elevationProfile>
+    <lanes>
+      <laneOffset s="0" a="0" b="0" c="0" d="0"/>
+      <laneSection s="0">
+        <center>
+          <lane id="0" type="none" level="false"/>
+        </center>
+        <right>
+          <lane id="-1" type="driving" level="false">
+            <width sOffset="0" a="3" b="0.1" c="0" d="0"/>
+          </lane>
+          <lane id="-2" type="driving" level="false">
+            <width sOffset="0" a="3" b="0.1" c="0" d="0"/>
+          </lane>
+        </right>
+      </laneSection>
+    </lanes>
+  </road>
+</OpenDRIVE>
+)";
+
+TEST(road, frenet_coordinates_on_widening_lanes) {
+  auto m = OpenDriveParser::Load(WideningRoadOpenDrive);
+  ASSERT_TRUE(m.has_value());
+  auto &map = *m;
+  auto waypoints = map.GenerateWaypoints(1.0);
+  ASSERT_FALSE(waypoints.empty());
+  size_t count = 0u;
+  for (auto &waypoint : waypoints) {
+    for (auto t : {-0.5, 0.0, 0.5}) {
+      // Stay away from the ends of the road, beyond them the offsets along
+      // the reference line are not perpendicular to it.
+      if ((waypoint.s < 1.0) || (waypoint.s > 49.0)) {
+        continue;
+      }
+      const auto location = map.FromFrenet(FrenetPoint{waypoint, t}).location;
+      const auto point = map.ToFrenet(location, waypoint);
+      ASSERT_TRUE(point.has_value());
+      ASSERT_EQ(point->waypoint.road_id, waypoint.road_id);
+      ASSERT_EQ(point->waypoint.lane_id, waypoint.lane_id);
+      ASSERT_NEAR(point->waypoint.s, waypoint.s, 0.01);
+      ASSERT_NEAR(point->t, t, 0.01);
+      // The hinted search has to find the same lane the full search does.
+      const auto tracked = map.GetClosestWaypointOnRoad(location, waypoint);
+      const auto expected = map.GetClosestWaypointOnRoad(location);
+      ASSERT_TRUE(tracked.has_value());
+      ASSERT_TRUE(expected.has_value());
+      ASSERT_EQ(*tracked, *expected);
+      ++count;
+    }
+  }
+  ASSERT_GT(count, 0u);
+}
+
+TEST(road, lane_geometry) {
+  ThreadPool pool;
+  std::vector<std::future<void>> results;
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    results.push_back(pool.Post<void>([file]() {
+      auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+      ASSERT_TRUE(m.has_value());
+      auto &map = *m;
+      constexpr double resolution = 1.0;
+      const auto geometry = map.ComputeLaneGeometry(resolution);
+      const auto number_of_lanes = geometry.GetNumberOfLanes();
+      const auto number_of_points = geometry.GetNumberOfPoints();
+      ASSERT_GT(number_of_lanes, 0u);
+      ASSERT_EQ(geometry.road_ids.size(), number_of_lanes);
+      ASSERT_EQ(geometry.section_ids.size(), number_of_lanes);
+      ASSERT_EQ(geometry.lane_types.size(), number_of_lanes);
+      ASSERT_EQ(geometry.offsets.size(), number_of_lanes + 1u);
+      ASSERT_EQ(geometry.offsets.front(), 0u);
+      ASSERT_EQ(geometry.offsets.back(), number_of_points);
+      ASSERT_EQ(geometry.centers.size(), 3u * number_of_points);
+      ASSERT_EQ(geometry.left_boundaries.size(), 3u * number_of_points);
+      ASSERT_EQ(geometry.right_boundaries.size(), 3u * number_of_points);
+      ASSERT_EQ(geometry.left_marking_types.size(), number_of_points);
+      ASSERT_EQ(geometry.left_marking_colors.size(), number_of_points);
+      ASSERT_EQ(geometry.right_marking_types.size(), number_of_points);
+      ASSERT_EQ(geometry.right_marking_colors.size(), number_of_points);
+
+      auto location = [](const std::vector<float> &points, size_t i) {
+        return Location(points[3u * i], points[3u * i + 1u], points[3u * i + 2u]);
+      };
+      std::map<std::tuple<RoadId, SectionId, LaneId>, size_t> lanes;
+      for (auto i = 0u; i < number_of_lanes; ++i) {
+        lanes.emplace(std::make_tuple(geometry.road_ids[i], geometry.section_ids[i], geometry.lane_ids[i]), i);
+        const auto begin = geometry.offsets[i];
+        const auto end = geometry.offsets[i + 1u];
+        ASSERT_GE(end - begin, 2u);
+        for (auto j = begin; j < end; ++j) {
+          if (j > begin) {
+            ASSERT_GT(geometry.distances[j], geometry.distances[j - 1u]);
+            ASSERT_LE(geometry.distances[j] - geometry.distances[j - 1u], resolution + 1e-3);
+          }
+          const Waypoint waypoint{
+              geometry.road_ids[i],
+              geometry.section_ids[i],
+              geometry.lane_ids[i],
+              geometry.distances[j]};
+          const auto center = location(geometry.centers, j);
+          ASSERT_LT(Math::Distance(center, map.ComputeTransform(waypoint).location), 0.01);
+          // The boundaries are half the lane width away from its center.
+          const auto half_width = 0.5 * map.GetLaneWidth(waypoint);
+          ASSERT_NEAR(Math::Distance2D(center, location(geometry.left_boundaries, j)), half_width, 0.01);
+          ASSERT_NEAR(Math::Distance2D(center, location(geometry.right_boundaries, j)), half_width, 0.01);
+          const auto markings = map.GetMarkRecord(waypoint);
+          if (markings.first != nullptr) {
+            ASSERT_EQ(geometry.right_marking_types[j], static_cast<uint8_t>(LaneMarking(*markings.first).type));
+          }
+        }
+      }
+
+      // The left boundary of a lane is the right boundary of the next lane
+      // towards the center of the road.
+      size_t number_of_neighbours = 0u;
+      for (auto i = 0u; i < number_of_lanes; ++i) {
+        const auto lane_id = geometry.lane_ids[i];
+        const auto inner_lane_id = lane_id < 0 ? lane_id + 1 : lane_id - 1;
+        const auto it = lanes.find(std::make_tuple(geometry.road_ids[i], geometry.section_ids[i], inner_lane_id));
+        if ((inner_lane_id == 0) || (it == lanes.end())) {
+          continue;
+        }
+        const auto inner = it->second;
+        ASSERT_EQ(geometry.offsets[i + 1u] - geometry.offsets[i], geometry.offsets[inner + 1u] - geometry.offsets[inner]);
+        for (auto j = 0u; j < geometry.offsets[i + 1u] - geometry.offsets[i]; ++j) {
+          const auto point = geometry.offsets[i] + j;
+          const auto inner_point = geometry.offsets[inner] + j;
+          ASSERT_LT(Math::Distance2D(
+              location(geometry.left_boundaries, point),
+              location(geometry.right_boundaries, inner_point)), 0.05);
+          ASSERT_EQ(geometry.left_marking_types[point], geometry.right_marking_types[inner_point]);
+          ASSERT_EQ(geometry.left_marking_colors[point], geometry.right_marking_colors[inner_point]);
+        }
+        ++number_of_neighbours;
+      }
+      ASSERT_GT(number_of_neighbours, 0u);
+    }));
+  }
+  for (auto &result : results) {
+    result.get();
+  }
+}
@@ -0,0 +1,280 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Benchmark.h"
+
+#include <carla/StopWatch.h>
+#include <carla/geom/Location.h>
+#include <carla/geom/Transform.h>
+#include <carla/pointcloud/DepthProjection.h>
+#include <carla/pointcloud/LidarProcessing.h>
+#include <carla/pointcloud/PointCloudIO.h>
+
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using carla::geom::Location;
+using carla::pointcloud::DepthProjection;
+using carla::pointcloud::LidarProcessing;
+using carla::pointcloud::PointCloudIO;
+
+static std::vector<Location> MakePoints(size_t count) {
+  std::vector<Location> points;
+  points.reserve(count);
+  for (auto i = 0u; i < count; ++i) {
+    points.emplace_back(0.5f * i, -0.25f * i, 0.125f * i);
+  }
+  return points;
+}
+
+static std::string SkipHeader(const std::string &data) {
+  const std::string end_header = "end_header\n";
+  const auto pos = data.find(end_header);
+  EXPECT_NE(pos, std::string::npos);
+  return data.substr(pos + end_header.size());
+}
+
+TEST(pointcloud, ply_ascii) {
+  const auto points = MakePoints(3u);
+  std::stringstream out;
+  PointCloudIO::Dump(out, points.begin(), points.end());
+  const auto data = out.str();
+  ASSERT_NE(data.find("format ascii 1.0\n"), std::string::npos);
+  ASSERT_NE(data.find("element vertex 3\n"), std::string::npos);
+  ASSERT_EQ(SkipHeader(data), "0.0000 -0.0000 0.0000\n0.5000 -0.2500 0.1250\n1.0000 -0.5000 0.2500\n");
+}
+
+TEST(pointcloud, ply_binary) {
+  const auto points = MakePoints(100u);
+  auto check = [&](auto begin, auto end) {
+    std::stringstream out;
+    PointCloudIO::Dump(out, begin, end, PointCloudIO::Format::PlyBinary);
+    const auto data = out.str();
+    ASSERT_NE(data.find("format binary_little_endian 1.0\n"), std::string::npos);
+    const auto body = SkipHeader(data);
+    ASSERT_EQ(body.size(), 3u * sizeof(float) * points.size());
+    ASSERT_EQ(std::memcmp(body.data(), points.data(), body.size()), 0);
+  };
+  // Contiguous points are written as they are, any other iterator through a
+  // temporary buffer.
+  check(points.data(), points.data() + points.size());
+  const std::list<Location> list(points.begin(), points.end());
+  check(list.begin(), list.end());
+}
+
+TEST(pointcloud, bin) {
+  const auto points = MakePoints(100u);
+  std::stringstream out;
+  PointCloudIO::Dump(out, points.data(), points.data() + points.size(), PointCloudIO::Format::Bin);
+  const auto data = out.str();
+  ASSERT_EQ(data.size(), 4u * sizeof(float) * points.size());
+  const auto *floats = reinterpret_cast<const float *>(data.data());
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_EQ(floats[4u * i + 0u], points[i].x);
+    ASSERT_EQ(floats[4u * i + 1u], points[i].y);
+    ASSERT_EQ(floats[4u * i + 2u], points[i].z);
+    ASSERT_EQ(floats[4u * i + 3u], 0.0f);
+  }
+}
+
+TEST(pointcloud, benchmark_formats) {
+  // About one sweep of a 64 channel lidar.
+  constexpr size_t number_of_points = 120000u;
+  constexpr size_t number_of_sweeps = 5u;
+  const auto points = MakePoints(number_of_points);
+  for (auto format : {PointCloudIO::Format::PlyAscii, PointCloudIO::Format::PlyBinary, PointCloudIO::Format::Bin}) {
+    size_t bytes = 0u;
+    carla::StopWatch timer;
+    for (auto i = 0u; i < number_of_sweeps; ++i) {
+      std::stringstream out;
+      PointCloudIO::Dump(out, points.data(), points.data() + points.size(), format);
+      bytes += static_cast<size_t>(out.tellp());
+    }
+    timer.Stop();
+    const auto seconds = 1e-6 * static_cast<double>(timer.GetElapsedTime<std::chrono::microseconds>());
+    std::cout << (format == PointCloudIO::Format::PlyAscii ? "ply ascii " :
+                  format == PointCloudIO::Format::PlyBinary ? "ply binary" : "bin       ")
+              << ": " << 1e-6 * bytes / seconds << " MB/s, "
+              << 1e-6 * number_of_points * number_of_sweeps / seconds << " Mpoints/s\n";
+  }
+}
+
+/// Points of a rotating lidar sweep, sorted by channel.
+static std::vector<Location> MakeSweep(
+    size_t channels,
+    size_t points_per_channel,
+    std::vector<uint32_t> &channel_counts) {
+  constexpr float pi = 3.14159265358979323846f;
+  std::mt19937 engine(1u);
+  std::uniform_real_distribution<float> range(2.0f, 50.0f);
+  std::vector<Location> points;
+  points.reserve(channels * points_per_channel);
+  channel_counts.assign(channels, static_cast<uint32_t>(points_per_channel));
+  for (auto channel = 0u; channel < channels; ++channel) {
+    const float pitch = 0.01f * (static_cast<float>(channel) - 0.5f * channels);
+    for (auto i = 0u; i < points_per_channel; ++i) {
+      const float yaw = 2.0f * pi * static_cast<float>(i) / points_per_channel;
+      const float r = range(engine);
+      points.emplace_back(
+          r * std::cos(pitch) * std::cos(yaw),
+          r * std::cos(pitch) * std::sin(yaw),
+          r * std::sin(pitch));
+    }
+  }
+  return points;
+}
+
+TEST(pointcloud, crop) {
+  std::vector<uint32_t> channel_counts;
+  const auto points = MakeSweep(32u, 2000u, channel_counts);
+  const carla::geom::BoundingBox box({10.0f, 0.0f, 0.0f}, {5.0f, 5.0f, 2.0f});
+  std::vector<Location> expected;
+  for (auto &point : points) {
+    if ((std::abs(point.x - 10.0f) <= 5.0f) && (std::abs(point.y) <= 5.0f) && (std::abs(point.z) <= 2.0f)) {
+      expected.emplace_back(point);
+    }
+  }
+  ASSERT_GT(expected.size(), 0u);
+  std::vector<Location> result(points.size());
+  const auto count = LidarProcessing::Crop(points.data(), points.size(), box, result.data(), 4u);
+  ASSERT_EQ(count, expected.size());
+  result.resize(count);
+  ASSERT_EQ(result, expected);
+}
+
+TEST(pointcloud, voxel_downsample) {
+  const std::vector<Location> points = {
+    {0.1f, 0.1f, 0.1f}, {0.3f, 0.3f, 0.3f}, {1.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}
+  };
+  std::vector<Location> result(points.size());
+  const auto count = LidarProcessing::VoxelDownsample(points.data(), points.size(), 1.0f, result.data(), 2u);
+  ASSERT_EQ(count, 3u);
+  result.resize(count);
+  // Sorted by voxel.
+  ASSERT_EQ(result[0u], Location(-0.5f, 0.5f, 0.5f));
+  ASSERT_NEAR(result[1u].x, 0.2f, 1e-6f);
+  ASSERT_NEAR(result[1u].y, 0.2f, 1e-6f);
+  ASSERT_NEAR(result[1u].z, 0.2f, 1e-6f);
+  ASSERT_EQ(result[2u], Location(1.5f, 0.5f, 0.5f));
+  ASSERT_THROW(LidarProcessing::VoxelDownsample(points.data(), points.size(), 0.0f, result.data()), std::invalid_argument);
+}
+
+TEST(pointcloud, range_image) {
+  const std::vector<Location> points = {
+    {10.0f, 0.0f, 0.0f}, {5.0f, 0.0f, 0.0f}, // channel 0, forward
+    {-3.0f, 0.0f, 0.0f}, {0.0f, 4.0f, 0.0f}  // channel 1, backward and right
+  };
+  const std::vector<uint32_t> channel_counts = {2u, 2u};
+  constexpr size_t width = 8u;
+  std::vector<float> image(2u * width, -1.0f);
+  LidarProcessing::MakeRangeImage(points.data(), channel_counts.data(), 2u, width, image.data(), 2u);
+  const std::vector<float> expected = {
+    0.0f, 0.0f, 0.0f, 0.0f, 5.0f, 0.0f, 0.0f, 0.0f,
+    3.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 4.0f, 0.0f
+  };
+  ASSERT_EQ(image, expected);
+}
+
+TEST(pointcloud, benchmark_lidar_processing) {
+  std::vector<uint32_t> channel_counts;
+  const auto points = MakeSweep(64u, 2000u, channel_counts);
+  std::vector<Location> out(points.size());
+  std::vector<float> image(64u * 1024u);
+  const carla::geom::BoundingBox box({0.0f, 0.0f, 0.0f}, {20.0f, 20.0f, 2.0f});
+  util::benchmark::measure_threads("crop", "sweep", points.size(), [&](size_t threads) {
+    LidarProcessing::Crop(points.data(), points.size(), box, out.data(), threads);
+  });
+  util::benchmark::measure_threads("voxel downsample", "sweep", points.size(), [&](size_t threads) {
+    LidarProcessing::VoxelDownsample(points.data(), points.size(), 0.2f, out.data(), threads);
+  });
+  util::benchmark::measure_threads("range image", "sweep", points.size(), [&](size_t threads) {
+    LidarProcessing::MakeRangeImage(points.data(), channel_counts.data(), 64u, 1024u, image.data(), threads);
+  });
+}
+
+/// Encode @a meters as the 24-bit depth of the depth camera, returns the
+/// encoded depth together with the depth actually represented.
+static std::pair<DepthProjection::Pixel, float> EncodeDepth(float meters) {
+  constexpr double max = 256.0 * 256.0 * 256.0 - 1.0;
+  const auto value = static_cast<uint32_t>(std::round(meters / DepthProjection::FarPlane * max));
+  const DepthProjection::Pixel pixel(value & 0xFFu, (value >> 8u) & 0xFFu, (value >> 16u) & 0xFFu);
+  return {pixel, static_cast<float>(value / max * DepthProjection::FarPlane)};
+}
+
+TEST(pointcloud, depth_projection) {
+  // With 90 degrees of field of view the focal length is half the width.
+  constexpr size_t width = 4u;
+  constexpr size_t height = 2u;
+  const auto encoded = EncodeDepth(10.0f);
+  const float d = encoded.second;
+  std::vector<DepthProjection::Pixel> pixels(width * height, encoded.first);
+  pixels[3u] = DepthProjection::Pixel(255u, 255u, 255u);     // sky.
+  pixels[4u] = EncodeDepth(60.0f).first;
+
+  std::vector<Location> out(DepthProjection::GetMaxNumberOfPoints(width, height, 1u));
+  DepthProjection::Options options;
+  options.number_of_threads = 2u;
+  ASSERT_EQ(DepthProjection::Project(pixels.data(), width, height, 90.0f, options, out.data()), 7u);
+  ASSERT_NEAR(out[0u].x, d, 1e-4f);
+  ASSERT_NEAR(out[0u].y, -d, 1e-4f);
+  ASSERT_NEAR(out[0u].z, d / 2.0f, 1e-4f);
+  ASSERT_NEAR(out[2u].y, 0.0f, 1e-4f);
+  ASSERT_NEAR(out[3u].x, 60.0f, 1e-3f);
+  ASSERT_NEAR(out[6u].y, d / 2.0f, 1e-4f);
+  ASSERT_NEAR(out[6u].z, 0.0f, 1e-4f);
+
+  options.max_range = 50.0f;
+  ASSERT_EQ(DepthProjection::Project(pixels.data(), width, height, 90.0f, options, out.data()), 6u);
+
+  options.stride = 2u;
+  ASSERT_EQ(DepthProjection::GetMaxNumberOfPoints(width, height, options.stride), 2u);
+  ASSERT_EQ(DepthProjection::Project(pixels.data(), width, height, 90.0f, options, out.data()), 2u);
+  ASSERT_NEAR(out[1u].y, 0.0f, 1e-4f);
+
+  // In world frame the points must match Transform::TransformPoint.
+  const carla::geom::Transform transform{
+      Location(1.0f, -2.0f, 3.0f),
+      carla::geom::Rotation(15.0f, -30.0f, 5.0f)};
+  std::vector<Location> world(out.size());
+  options = DepthProjection::Options();
+  ASSERT_EQ(DepthProjection::Project(pixels.data(), width, height, 90.0f, options, out.data()), 7u);
+  options.transform = &transform;
+  ASSERT_EQ(DepthProjection::Project(pixels.data(), width, height, 90.0f, options, world.data()), 7u);
+  for (auto i = 0u; i < 7u; ++i) {
+    auto expected = out[i];
+    transform.TransformPoint(expected);
+    ASSERT_NEAR(world[i].x, expected.x, 1e-3f);
+    ASSERT_NEAR(world[i].y, expected.y, 1e-3f);
+    ASSERT_NEAR(world[i].z, expected.z, 1e-3f);
+  }
+
+  ASSERT_THROW(DepthProjection::Project(pixels.data(), width, height, 0.0f, options, out.data()), std::invalid_argument);
+}
+
+TEST(pointcloud, benchmark_depth_projection) {
+  constexpr size_t width = 1280u;
+  constexpr size_t height = 720u;
+  std::mt19937 generator(42u);
+  std::uniform_real_distribution<float> distribution(1.0f, 200.0f);
+  std::vector<DepthProjection::Pixel> pixels(width * height);
+  for (auto &pixel : pixels) {
+    pixel = EncodeDepth(distribution(generator)).first;
+  }
+  std::vector<Location> out(width * height);
+  const carla::geom::Transform transform{Location(0.0f, 0.0f, 2.0f), carla::geom::Rotation(0.0f, 90.0f, 0.0f)};
+  util::benchmark::measure_threads("depth projection", "image", width * height, [&](size_t threads) {
+    DepthProjection::Options options;
+    options.number_of_threads = threads;
+    options.transform = &transform;
+    DepthProjection::Project(pixels.data(), width, height, 90.0f, options, out.data());
+  });
+}
@@ -0,0 +1,194 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "TemporaryFolder.h"
+
+#include <carla/recorder/FrameBuilder.h>
+#include <carla/recorder/query/Query.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace carla::recorder;
+using namespace carla::recorder::query;
+
+/// Frames of 0.125 seconds, a keyframe every 80 frames.
+static constexpr uint32_t NumberOfFrames = 480u;
+
+static EventAdd MakeActor(uint32_t id, uint8_t type, const char *type_id, bool is_hero) {
+  EventAdd event;
+  event.database_id = id;
+  event.type = type;
+  event.location = {};
+  event.rotation = {};
+  event.description.uid = 1u;
+  event.description.id = type_id;
+  event.description.attributes.push_back({1u, "role_name", is_hero ? "hero" : "autopilot"});
+  return event;
+}
+
+/// Two vehicles and a walker: the hero vehicle (1) stops between 20 and 40
+/// seconds, the walker (3) never moves and is destroyed at 50 seconds.
+static void WriteRecording(const std::string &path, bool compact, bool with_index) {
+  FrameBuilder builder;
+  if (compact) {
+    PositionEncoding encoding;
+    encoding.compact = true;
+    builder.SetPositionEncoding(encoding);
+  }
+  builder.WriteInfo(Info{compact ? CompactPositionsVersion : uint16_t(1u), "CARLA_RECORDER", 1234567, "Town01"});
+  for (auto frame = 0u; frame < NumberOfFrames; ++frame) {
+    if (frame == 0u) {
+      builder.Add(MakeActor(1u, 1u, "vehicle.hero", true));
+      builder.Add(MakeActor(2u, 1u, "vehicle.other", false));
+      builder.Add(MakeActor(3u, 2u, "walker.pedestrian", false));
+    }
+    if (frame == 400u) {
+      builder.Add(EventDel{3u});
+    }
+    // The first collision continues through the start of the second chunk.
+    if ((frame >= 78u && frame < 83u) || (frame == 300u)) {
+      builder.Add(Collision{frame, 1u, 2u, true, false});
+    }
+    if (frame == 200u) {
+      builder.Add(Collision{frame, 1u, 3u, true, false});
+    }
+    const float x1 = 10.0f * (frame <= 160u ? frame : (frame <= 320u ? 160u : frame - 160u));
+    builder.Add(Position{1u, {x1, 0.0f, 0.0f}, {0.0f, 0.0f, 90.0f}});
+    builder.Add(Position{2u, {-10.0f * frame, 0.0f, 0.0f}, {0.0f, 0.0f, 180.0f}});
+    if (frame < 400u) {
+      builder.Add(Position{3u, {500.0f, 0.0f, 0.0f}, {}});
+    }
+    builder.EndFrame(0.125);
+  }
+  if (with_index) {
+    builder.WriteIndex();
+  }
+  OutputBuffer buffer;
+  builder.TakeAll(buffer);
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+
+/// The sample recording written once per encoding: plain, compact, and plain
+/// without index. Removed when the tests finish.
+static const std::vector<std::string> &GetRecordings() {
+  static const util::TemporaryFolder folder;
+  static const std::vector<std::string> paths = []() {
+    std::vector<std::string> result = {
+        folder.GetFilePath("plain.rec"),
+        folder.GetFilePath("compact.rec"),
+        folder.GetFilePath("no_index.rec")};
+    WriteRecording(result[0u], false, true);
+    WriteRecording(result[1u], true, true);
+    WriteRecording(result[2u], false, false);
+    return result;
+  }();
+  return paths;
+}
+
+TEST(recorder_query, chunks) {
+  const auto &paths = GetRecordings();
+  RecordingReader reader(paths[1u]);
+  ASSERT_TRUE(reader.HasIndex());
+  ASSERT_EQ(reader.GetInfo().map_file, "Town01");
+  ASSERT_EQ(reader.GetIndex().GetFrames().size(), NumberOfFrames);
+  ASSERT_EQ(reader.GetChunks().size(), 6u);
+  ASSERT_EQ(reader.GetChunks()[1u].first_frame, 80u);
+  ASSERT_EQ(reader.FindChunks(10.0, 20.0), std::make_pair(size_t(1u), size_t(3u)));
+  ASSERT_EQ(reader.FindChunks(-1.0, 100.0), std::make_pair(size_t(0u), size_t(6u)));
+
+  // A small file without index is read as a single chunk.
+  RecordingReader no_index(paths[2u]);
+  ASSERT_FALSE(no_index.HasIndex());
+  ASSERT_EQ(no_index.GetIndex().GetFrames().size(), NumberOfFrames);
+  ASSERT_EQ(no_index.GetChunks().size(), 1u);
+}
+
+TEST(recorder_query, summary) {
+  const auto &paths = GetRecordings();
+  const auto summary = QuerySummary(RecordingReader(paths[0u]), 4u);
+  ASSERT_EQ(summary.frames, NumberOfFrames);
+  ASSERT_EQ(summary.duration, (NumberOfFrames - 1u) * 0.125);
+  ASSERT_EQ(summary.actors.size(), 3u);
+  ASSERT_TRUE(summary.actors[0u].is_hero);
+  ASSERT_FALSE(summary.actors[1u].is_hero);
+  ASSERT_EQ(summary.actors[2u].type_id, "walker.pedestrian");
+  ASSERT_EQ(summary.actors[2u].destroyed, 50.0);
+  ASSERT_LT(summary.actors[0u].destroyed, 0.0);
+  ASSERT_EQ(summary.events.size(), 4u);
+  ASSERT_EQ(summary.events[3u].type, EventRecord::Type::Del);
+  ASSERT_EQ(summary.events[3u].frame, 401u);
+}
+
+TEST(recorder_query, collisions) {
+  const auto &paths = GetRecordings();
+  for (auto &path : paths) {
+    RecordingReader reader(path);
+    const auto all = QueryCollisions(reader, 'a', 'a', 4u);
+    ASSERT_EQ(all.size(), 3u);
+    ASSERT_EQ(all[0u].time, 78u * 0.125);
+    ASSERT_EQ(all[1u].actor2, 3u);
+    ASSERT_EQ(all[1u].category2, 'w');
+    ASSERT_EQ(all[2u].time, 300u * 0.125);
+    ASSERT_EQ(QueryCollisions(reader, 'h', 'w', 4u).size(), 1u);
+    ASSERT_EQ(QueryCollisions(reader, 'v', 'v', 1u).size(), 2u);
+    ASSERT_EQ(QueryCollisions(reader, 'w', 'a', 1u).size(), 0u);
+  }
+}
+
+TEST(recorder_query, blocked) {
+  const auto &paths = GetRecordings();
+  for (auto &path : paths) {
+    RecordingReader reader(path);
+    for (auto threads : {1u, 4u}) {
+      const auto blocked = QueryBlocked(reader, 10.0, 1.0, threads);
+      ASSERT_EQ(blocked.size(), 2u);
+      ASSERT_EQ(blocked[0u].id, 3u);
+      ASSERT_EQ(blocked[0u].time, 0.125);
+      ASSERT_EQ(blocked[0u].duration, 399u * 0.125);
+      ASSERT_EQ(blocked[1u].id, 1u);
+      ASSERT_EQ(blocked[1u].time, 161u * 0.125);
+      ASSERT_EQ(blocked[1u].duration, 20.0);
+    }
+  }
+}
+
+TEST(recorder_query, trajectories) {
+  const auto &paths = GetRecordings();
+  for (auto &path : paths) {
+    RecordingReader reader(path);
+    const auto trajectories = QueryTrajectories(reader, 10.0, 20.0, {2u}, 4u);
+    ASSERT_EQ(trajectories.size(), 81u);
+    for (auto i = 0u; i < trajectories.size(); ++i) {
+      ASSERT_EQ(trajectories.ids[i], 2u);
+      ASSERT_EQ(trajectories.frames[i], 81u + i);
+      ASSERT_EQ(trajectories.times[i], 10.0 + i * 0.125);
+      ASSERT_NEAR(trajectories.locations[i].x, -10.0f * (80u + i), 0.05f);
+      ASSERT_NEAR(trajectories.rotations[i].z, 180.0f, 0.005f);
+    }
+    const auto all = QueryTrajectories(reader, 0.0, 1000.0, {}, 1u);
+    ASSERT_EQ(all.size(), 3u * NumberOfFrames - 80u);
+  }
+}
+
+TEST(recorder_query, many_files) {
+  const auto &paths = GetRecordings();
+  const auto results = QueryEach(paths, [](const RecordingReader &reader) {
+    return QueryBlocked(reader, 10.0, 1.0, 1u);
+  }, 2u);
+  ASSERT_EQ(results.size(), paths.size());
+  for (auto &result : results) {
+    ASSERT_EQ(result.size(), 2u);
+    ASSERT_EQ(result[1u].duration, 20.0);
+  }
+  ASSERT_THROW(QueryEach(std::vector<std::string>{"not_a_recording.rec"}, [](const RecordingReader &reader) {
+    return QuerySummary(reader, 1u);
+  }), std::runtime_error);
+}
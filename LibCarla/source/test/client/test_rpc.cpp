@@ -7,12 +7,15 @@
 #include "test.h"
 
 #include <carla/MsgPackAdaptors.h>
+#include <carla/StopWatch.h>
 #include <carla/ThreadGroup.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Client.h>
 #include <carla/rpc/Response.h>
 #include <carla/rpc/Server.h>
+#include <carla/rpc/SyncCallQueue.h>
 
+#include <stdexcept>
 #include <thread>
 
 using namespace carla::rpc;
@@ -61,3 +64,85 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, sync_call_queue) {
+  SyncCallQueue queue;
+
+  constexpr size_t number_of_threads = 8u;
+  constexpr size_t calls_per_thread = 1000u;
+
+  carla::ThreadGroup threads;
+  std::vector<int> results(number_of_threads, -1);
+  std::atomic_size_t errors{0u};
+  for (auto t = 0u; t < number_of_threads; ++t) {
+    threads.CreateThread([&, t]() {
+      for (auto i = 0u; i < calls_per_thread; ++i) {
+        queue.Push(
+            [i]() { return static_cast<int>(i); },
+            [&results, t](std::exception_ptr error, boost::optional<int> result) {
+              ASSERT_FALSE(error);
+              ASSERT_TRUE(result.has_value());
+              // Calls from the same thread are executed in order.
+              ASSERT_EQ(*result, results[t] + 1);
+              results[t] = *result;
+            });
+      }
+    });
+  }
+  queue.Push(
+      []() { throw std::runtime_error("expected"); },
+      [&](std::exception_ptr error) {
+        ASSERT_TRUE(error);
+        ++errors;
+      });
+  threads.JoinAll();
+
+  size_t total = 0u;
+  while (queue.size_approx() > 0u) {
+    total += queue.Drain(2ms);
+  }
+  ASSERT_EQ(total, number_of_threads * calls_per_thread + 1u);
+  ASSERT_EQ(errors, 1u);
+  for (auto result : results) {
+    ASSERT_EQ(result, static_cast<int>(calls_per_thread) - 1);
+  }
+}
+
+TEST(rpc, benchmark_bind_sync_calls_per_second) {
+  const auto port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  constexpr size_t number_of_clients = 32u;
+  constexpr size_t calls_per_client = 500u;
+
+  Server server(port);
+  server.BindSync("add", [](int x, int y) -> int { return x + y; });
+  server.AsyncRun(number_of_clients);
+
+  std::atomic_size_t clients_done{0u};
+
+  carla::StopWatch timer;
+  carla::ThreadGroup threads;
+  threads.CreateThreads(number_of_clients, [&]() {
+    Client client("localhost", port);
+    for (auto i = 0u; i < calls_per_client; ++i) {
+      auto result = client.call("add", i, 1).as<int>();
+      EXPECT_EQ(result, static_cast<int>(i) + 1);
+    }
+    ++clients_done;
+  });
+
+  size_t ticks = 0u;
+  while (clients_done < number_of_clients) {
+    server.SyncRunFor(2ms);
+    ++ticks;
+  }
+  threads.JoinAll();
+  timer.Stop();
+
+  const auto total_calls = number_of_clients * calls_per_client;
+  const auto seconds = 1e-6 * static_cast<double>(
+      timer.GetElapsedTime<std::chrono::microseconds>());
+  std::cout << "sync calls: " << total_calls << " from " << number_of_clients
+            << " clients in " << seconds << "s (" << ticks << " game ticks), "
+            << static_cast<double>(total_calls) / seconds << " calls/s.\n";
+}
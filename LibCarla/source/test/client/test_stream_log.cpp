@@ -0,0 +1,163 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "TemporaryFolder.h"
+
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/StreamLog.h>
+#include <carla/sensor/data/Image.h>
+#include <carla/sensor/s11n/ImageSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <cstring>
+#include <fstream>
+
+using namespace carla::sensor;
+
+/// Buffer as sent by a camera, with @a frame in the header.
+static carla::Buffer MakeImageBuffer(uint64_t frame, uint32_t width, uint32_t height) {
+  using namespace s11n;
+  const auto index = SensorRegistry::get<ASceneCaptureCamera *>::index;
+  auto header = SensorHeaderSerializer::Serialize(index, frame, 0.5 * frame, carla::rpc::Transform{});
+  const ImageSerializer::ImageHeader image_header{width, height, 90.0f};
+  carla::Buffer buffer(header.size() + sizeof(image_header) + sizeof(data::Color) * width * height);
+  std::memcpy(buffer.data(), header.data(), header.size());
+  std::memcpy(buffer.data() + header.size(), &image_header, sizeof(image_header));
+  auto *pixels = buffer.data() + header.size() + sizeof(image_header);
+  for (auto i = 0u; i < sizeof(data::Color) * width * height; ++i) {
+    pixels[i] = static_cast<unsigned char>((i + frame) % 251u);
+  }
+  return buffer;
+}
+
+static bool IsEqual(const unsigned char *data, const carla::Buffer &buffer) {
+  return std::memcmp(data, buffer.data(), buffer.size()) == 0;
+}
+
+TEST(stream_log, write_and_replay) {
+  util::TemporaryFolder folder;
+  const auto path = folder.GetFilePath("capture");
+  std::vector<carla::Buffer> buffers;
+  {
+    // Small segments so the log is split in several of them.
+    StreamLogWriter writer(path, 3000u);
+    for (auto frame = 10u; frame < 20u; ++frame) {
+      for (auto sensor : {7u, 3u}) {
+        buffers.emplace_back(MakeImageBuffer(frame, 9u + sensor, 11u));
+        writer.Write(sensor, buffers.back());
+      }
+    }
+    ASSERT_EQ(writer.GetStatistics().first, buffers.size());
+  }
+  ASSERT_TRUE(boost::filesystem::exists(path + ".000002.seg"));
+
+  StreamLogReader reader(path);
+  const auto &entries = reader.GetEntries();
+  ASSERT_EQ(entries.size(), buffers.size());
+  for (auto i = 0u; i < entries.size(); ++i) {
+    ASSERT_EQ(entries[i].size, buffers[i].size());
+    ASSERT_EQ(entries[i].offset % 8u, 0u);
+    ASSERT_TRUE(IsEqual(reader.GetData(entries[i]), buffers[i]));
+  }
+
+  const auto frame_entries = reader.GetEntries(12u, 14u);
+  ASSERT_EQ(frame_entries.size(), 4u);
+  ASSERT_EQ(frame_entries[0u].frame, 12u);
+  ASSERT_EQ(frame_entries[0u].sensor_id, 3u);
+  ASSERT_EQ(frame_entries[1u].sensor_id, 7u);
+  ASSERT_EQ(frame_entries[3u].frame, 13u);
+
+  size_t count = 0u;
+  reader.Replay([&](uint64_t sensor_id, carla::SharedPtr<SensorData> data) {
+    auto image = boost::dynamic_pointer_cast<data::Image>(data);
+    ASSERT_NE(image, nullptr);
+    ASSERT_EQ(image->GetFrameNumber(), 15u);
+    ASSERT_EQ(image->GetWidth(), 9u + sensor_id);
+    ASSERT_EQ(image->GetHeight(), 11u);
+    ++count;
+  }, 15u, 16u);
+  ASSERT_EQ(count, 2u);
+}
+
+TEST(stream_log, read_after_flush) {
+  util::TemporaryFolder folder;
+  const auto path = folder.GetFilePath("capture");
+  StreamLogWriter writer(path);
+  std::vector<carla::Buffer> buffers;
+  for (auto frame = 1u; frame <= 3u; ++frame) {
+    buffers.emplace_back(MakeImageBuffer(frame, 64u, 64u));
+    writer.Write(1u, buffers.back());
+  }
+  writer.Flush();
+  StreamLogReader reader(path);
+  ASSERT_EQ(reader.GetEntries().size(), buffers.size());
+  for (auto i = 0u; i < buffers.size(); ++i) {
+    ASSERT_TRUE(IsEqual(reader.GetData(reader.GetEntries()[i]), buffers[i]));
+  }
+}
+
+TEST(stream_log, interrupted_write) {
+  util::TemporaryFolder folder;
+  const auto path = folder.GetFilePath("capture");
+  const auto first = MakeImageBuffer(1u, 4u, 4u);
+  const auto second = MakeImageBuffer(2u, 4u, 4u);
+  {
+    StreamLogWriter writer(path);
+    writer.Write(1u, first);
+    writer.Write(1u, second);
+  }
+  // Cut the last buffer and leave half an index entry.
+  boost::filesystem::resize_file(path + ".000000.seg", boost::filesystem::file_size(path + ".000000.seg") - 16u);
+  {
+    std::ofstream index(path + ".idx", std::ios::binary | std::ios::app);
+    index.write("partial", 7u);
+  }
+  StreamLogReader reader(path);
+  ASSERT_EQ(reader.GetEntries().size(), 1u);
+  ASSERT_TRUE(IsEqual(reader.GetData(reader.GetEntries()[0u]), first));
+}
+
+TEST(stream_log, corrupt_index) {
+  util::TemporaryFolder folder;
+  const auto path = folder.GetFilePath("capture");
+  const auto buffer = MakeImageBuffer(1u, 4u, 4u);
+  {
+    StreamLogWriter writer(path);
+    writer.Write(1u, buffer);
+  }
+  {
+    std::ofstream index(path + ".idx", std::ios::binary | std::ios::app);
+    // offset + size overflows and wraps around within the segment.
+    StreamLogEntry entry{1u, 2u, 0u, 0u, ~uint64_t(0u) - 7u, 16u};
+    index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    entry = StreamLogEntry{1u, 3u, 0u, 0u, 0u, ~uint64_t(0u)};
+    index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    // Segment far ahead of the last one written.
+    entry = StreamLogEntry{1u, 4u, ~uint32_t(0u), 0u, 0u, 16u};
+    index.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+  }
+  StreamLogReader reader(path);
+  ASSERT_EQ(reader.GetEntries().size(), 1u);
+  ASSERT_TRUE(IsEqual(reader.GetData(reader.GetEntries()[0u]), buffer));
+  const StreamLogEntry overflow{1u, 2u, 0u, 0u, ~uint64_t(0u) - 7u, 16u};
+  ASSERT_THROW(reader.GetData(overflow), std::out_of_range);
+}
+
+TEST(stream_log, invalid_log) {
+  util::TemporaryFolder folder;
+  const auto path = folder.GetFilePath("capture");
+  ASSERT_THROW(StreamLogReader reader(path), std::runtime_error);
+  {
+    std::ofstream index(path + ".idx", std::ios::binary);
+    index << "not a log";
+  }
+  ASSERT_THROW(StreamLogReader reader(path), std::runtime_error);
+  StreamLogWriter writer(path);
+  ASSERT_THROW(writer.Write(1u, carla::Buffer(8u)), std::invalid_argument);
+}
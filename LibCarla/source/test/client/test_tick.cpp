@@ -0,0 +1,168 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/ThreadGroup.h>
+#include <carla/Version.h>
+#include <carla/client/detail/FrameWaiter.h>
+#include <carla/client/detail/Simulator.h>
+#include <carla/rpc/EpisodeInfo.h>
+#include <carla/rpc/EpisodeSettings.h>
+#include <carla/rpc/Server.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/streaming/Server.h>
+
+#include <atomic>
+#include <thread>
+
+using carla::client::detail::FrameWaiter;
+using carla::client::detail::Simulator;
+
+TEST(tick, frame_waiter) {
+  FrameWaiter waiter;
+  ASSERT_TRUE(waiter.WaitFor(0u, 0ms));
+  ASSERT_FALSE(waiter.WaitFor(1u, 1ms));
+  ASSERT_FALSE(waiter.WaitFor(1u, 1ms, 1ms));
+
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    for (auto i = 1u; i <= 10u; ++i) {
+      std::this_thread::sleep_for(1ms);
+      waiter.SetFrame(i);
+    }
+  });
+  ASSERT_TRUE(waiter.WaitFor(5u, 1s));
+  ASSERT_GE(waiter.GetFrame(), 5u);
+  ASSERT_TRUE(waiter.WaitFor(10u, 1s, 2ms));
+  ASSERT_EQ(waiter.GetFrame(), 10u);
+}
+
+/// Emulates a simulator in synchronous mode: each frame the episode state is
+/// broadcast and the game thread waits for a tick cue before continuing. As in
+/// the simulator, tick cues are answered by the game thread at the end of the
+/// frame.
+class LockstepSimulator {
+public:
+
+  static constexpr uint64_t episode_id = 1u;
+
+  LockstepSimulator(uint16_t rpc_port, uint16_t streaming_port, std::chrono::microseconds frame_time)
+    : _rpc_server(rpc_port),
+      _streaming_server(streaming_port),
+      _stream(_streaming_server.MakeMultiStream()) {
+    _rpc_server.BindAsync("version", []() -> std::string {
+      return carla::version();
+    });
+    _rpc_server.BindAsync("get_episode_info", [this]() -> carla::rpc::EpisodeInfo {
+      return {episode_id, _stream.token()};
+    });
+    _rpc_server.BindAsync("get_episode_settings", []() -> carla::rpc::EpisodeSettings {
+      return {true, false};
+    });
+    _rpc_server.BindSync("tick_cue", [this]() -> uint64_t {
+      ++_tick_cues;
+      return _frame + _tick_cues;
+    });
+    _rpc_server.AsyncRun(2u);
+    _streaming_server.AsyncRun(2u);
+    _game_thread.CreateThread([this, frame_time]() {
+      while (!_done) {
+        ++_frame;
+        BroadcastEpisodeState();
+        std::this_thread::sleep_for(frame_time);
+        do {
+          _rpc_server.SyncRunFor(1ms);
+        } while ((_tick_cues == 0u) && !_done);
+        if (_tick_cues > 0u) {
+          --_tick_cues;
+        }
+      }
+    });
+  }
+
+  ~LockstepSimulator() {
+    _done = true;
+    _game_thread.JoinAll();
+  }
+
+private:
+
+  void BroadcastEpisodeState() {
+    using namespace carla::sensor;
+    auto header = s11n::SensorHeaderSerializer::Serialize(
+        SensorRegistry::get<FWorldObserver *>::index,
+        _frame,
+        1e-3 * static_cast<double>(_frame),
+        carla::rpc::Transform{});
+    s11n::EpisodeStateSerializer::Header state;
+    state.episode_id = episode_id;
+    state.platform_timestamp = 0.0;
+    state.delta_seconds = 1e-3f;
+    carla::Buffer body;
+    body.copy_from(reinterpret_cast<const unsigned char *>(&state), sizeof(state));
+    _stream.Write(std::move(header), std::move(body));
+  }
+
+  carla::rpc::Server _rpc_server;
+
+  carla::streaming::Server _streaming_server;
+
+  carla::streaming::MultiStream _stream;
+
+  uint64_t _frame = 0u;
+
+  uint64_t _tick_cues = 0u;
+
+  std::atomic_bool _done{false};
+
+  carla::ThreadGroup _game_thread;
+};
+
+static void benchmark_tick_round_trip(
+    std::chrono::microseconds frame_time,
+    std::chrono::microseconds client_time,
+    size_t max_outstanding_ticks,
+    carla::time_duration spin_time) {
+  constexpr size_t number_of_ticks = 200u;
+  const auto rpc_port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+  const auto streaming_port = static_cast<uint16_t>(rpc_port + 1u);
+
+  LockstepSimulator server(rpc_port, streaming_port, frame_time);
+
+  auto simulator = std::make_shared<Simulator>("localhost", rpc_port);
+  simulator->SetNetworkingTimeout(1s);
+  simulator->GetCurrentEpisode();
+
+  carla::StopWatch timer;
+  for (auto i = 0u; i < number_of_ticks; ++i) {
+    simulator->TickPipelined(max_outstanding_ticks, 1s, spin_time);
+    std::this_thread::sleep_for(client_time);
+  }
+  timer.Stop();
+
+  const auto us = timer.GetElapsedTime<std::chrono::microseconds>();
+  std::cout << "ticks: " << number_of_ticks
+            << ", outstanding: " << max_outstanding_ticks
+            << ", spin: " << spin_time.milliseconds() << "ms"
+            << ", mean round trip " << us / number_of_ticks << "us"
+            << ", " << 1e6 * number_of_ticks / static_cast<double>(us) << " ticks/s.\n";
+}
+
+TEST(tick, benchmark_tick_round_trip) {
+  benchmark_tick_round_trip(0us, 0us, 0u, 0ms);
+  benchmark_tick_round_trip(0us, 0us, 0u, 5ms);
+}
+
+TEST(tick, benchmark_tick_pipelined) {
+  // Client and server take the same time per frame, with one tick in flight
+  // their work overlaps. The simulator acknowledges a tick cue only at the end
+  // of a frame, so allowing more ticks in flight should not improve further.
+  benchmark_tick_round_trip(2ms, 2ms, 0u, 0ms);
+  benchmark_tick_round_trip(2ms, 2ms, 1u, 0ms);
+  benchmark_tick_round_trip(2ms, 2ms, 2u, 0ms);
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/recorder/FrameBuilder.h>
+#include <carla/recorder/PositionCodec.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace carla::recorder;
+
+/// Vehicles driving along straight lines at different speeds, a quarter of
+/// them parked.
+class Traffic {
+public:
+
+  Traffic(size_t number_of_vehicles) : _engine(42u) {
+    std::uniform_real_distribution<float> location(-20000.0f, 20000.0f);
+    std::uniform_real_distribution<float> yaw(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> speed(500.0f, 2000.0f);
+    for (auto i = 0u; i < number_of_vehicles; ++i) {
+      const auto heading = yaw(_engine);
+      _positions.push_back(Position{i + 100u, {location(_engine), location(_engine), 30.0f}, {0.0f, 0.0f, heading}});
+      _speeds.push_back(i % 4u == 0u ? 0.0f : speed(_engine));
+    }
+  }
+
+  const std::vector<Position> &Tick(float delta_seconds) {
+    constexpr float to_radians = 3.14159265f / 180.0f;
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (auto i = 0u; i < _positions.size(); ++i) {
+      if (_speeds[i] > 0.0f) {
+        auto &position = _positions[i];
+        const auto distance = _speeds[i] * delta_seconds;
+        position.rotation.z += noise(_engine);
+        position.location.x += distance * std::cos(position.rotation.z * to_radians);
+        position.location.y += distance * std::sin(position.rotation.z * to_radians);
+        position.location.z = 30.0f + noise(_engine);
+        position.rotation.y = noise(_engine);
+      }
+    }
+    return _positions;
+  }
+
+private:
+
+  std::mt19937 _engine;
+
+  std::vector<Position> _positions;
+
+  std::vector<float> _speeds;
+};
+
+static void benchmark_positions(const size_t number_of_vehicles, const size_t number_of_frames) {
+  constexpr float delta_seconds = 0.05f;
+  PositionEncoding encoding;
+  encoding.compact = true;
+  FrameBuilder plain;
+  FrameBuilder compact;
+  compact.SetPositionEncoding(encoding);
+  Traffic traffic(number_of_vehicles);
+
+  double plain_encode_time = 0.0;
+  double compact_encode_time = 0.0;
+  for (auto frame = 0u; frame < number_of_frames; ++frame) {
+    const auto &positions = traffic.Tick(delta_seconds);
+    carla::StopWatch plain_timer;
+    for (auto &position : positions) {
+      plain.Add(position);
+    }
+    plain.EndFrame(delta_seconds);
+    plain_encode_time += plain_timer.GetElapsedTime<std::chrono::microseconds>();
+    carla::StopWatch compact_timer;
+    for (auto &position : positions) {
+      compact.Add(position);
+    }
+    compact.EndFrame(delta_seconds);
+    compact_encode_time += compact_timer.GetElapsedTime<std::chrono::microseconds>();
+  }
+  OutputBuffer plain_buffer;
+  OutputBuffer compact_buffer;
+  plain.TakeAll(plain_buffer);
+  compact.TakeAll(compact_buffer);
+
+  // Read the positions of every frame, as the replayer does.
+  auto decode = [](const OutputBuffer &buffer) {
+    std::vector<Position> positions;
+    PositionDecoder decoder;
+    size_t count = 0u;
+    carla::StopWatch timer;
+    InputBuffer in(buffer.data(), buffer.size());
+    while (!in.IsAtEnd()) {
+      const auto id = static_cast<PacketId>(in.Read<char>());
+      const auto size = in.Read<uint32_t>();
+      if (id == PacketId::Position) {
+        positions.resize(in.Read<uint16_t>());
+        in.Read(positions.data(), positions.size() * sizeof(Position));
+        count += positions.size();
+      } else if (id == PacketId::PositionCompact) {
+        EXPECT_TRUE(decoder.Decode(in.GetPosition(), size));
+        count += decoder.GetPositions().size();
+        in.Skip(size);
+      } else {
+        in.Skip(size);
+      }
+    }
+    return std::make_pair(count, timer.GetElapsedTime<std::chrono::microseconds>());
+  };
+  const auto plain_decode = decode(plain_buffer);
+  const auto compact_decode = decode(compact_buffer);
+  ASSERT_EQ(plain_decode.first, number_of_vehicles * number_of_frames);
+  ASSERT_EQ(compact_decode.first, plain_decode.first);
+
+  auto positions_per_second = [&](double microseconds) {
+    return static_cast<double>(plain_decode.first) / (1e-6 * std::max(microseconds, 1.0));
+  };
+  carla::logging::log("Benchmark:", number_of_vehicles, "vehicles,", number_of_frames, "frames");
+  carla::logging::log("  plain:  ", plain_buffer.size(), "bytes,",
+      positions_per_second(plain_encode_time), "positions/s written,",
+      positions_per_second(plain_decode.second), "positions/s read");
+  carla::logging::log("  compact:", compact_buffer.size(), "bytes,",
+      positions_per_second(compact_encode_time), "positions/s written,",
+      positions_per_second(compact_decode.second), "positions/s read");
+  carla::logging::log("  ratio:  ",
+      static_cast<double>(plain_buffer.size()) / static_cast<double>(compact_buffer.size()));
+  ASSERT_LT(compact_buffer.size(), plain_buffer.size() / 2u);
+}
+
+TEST(benchmark_recorder, positions_100_vehicles) {
+  benchmark_positions(100u, 1200u);
+}
+
+TEST(benchmark_recorder, positions_500_vehicles) {
+  benchmark_positions(500u, 1200u);
+}
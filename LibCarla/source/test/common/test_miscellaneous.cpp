@@ -6,8 +6,51 @@
 
 #include "test.h"
 
+#include <carla/ParallelFor.h>
 #include <carla/Version.h>
 
+#include <stdexcept>
+#include <vector>
+
 TEST(miscellaneous, version) {
   std::cout << "LibCarla " << carla::version() << std::endl;
 }
+
+TEST(miscellaneous, parallel_for) {
+  std::vector<int> values(10000u, 0);
+  carla::ParallelFor(values.size(), [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      ++values[i];
+    }
+  }, 4u, 100u);
+  for (auto value : values) {
+    ASSERT_EQ(value, 1);
+  }
+}
+
+TEST(miscellaneous, parallel_for_nested) {
+  std::vector<int> values(64u * 1000u, 0);
+  carla::ParallelFor(64u, [&](size_t begin, size_t end) {
+    for (; begin < end; ++begin) {
+      auto *row = values.data() + 1000u * begin;
+      carla::ParallelFor(1000u, [&](size_t i, size_t row_end) {
+        for (; i < row_end; ++i) {
+          ++row[i];
+        }
+      }, 4u, 100u);
+    }
+  }, 0u, 1u);
+  for (auto value : values) {
+    ASSERT_EQ(value, 1);
+  }
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(miscellaneous, parallel_for_exception) {
+  ASSERT_THROW(carla::ParallelFor(10000u, [](size_t begin, size_t) {
+    if (begin > 0u) {
+      throw std::runtime_error("error");
+    }
+  }, 4u, 100u), std::runtime_error);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
@@ -7,7 +7,10 @@
 #include "test.h"
 
 #include <carla/MsgPackAdaptors.h>
+#include <carla/StopWatch.h>
 #include <carla/rpc/Actor.h>
+#include <carla/rpc/Command.h>
+#include <carla/rpc/PackedVector.h>
 #include <carla/rpc/Response.h>
 
 #include <thread>
@@ -105,3 +108,88 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, packed_vector) {
+  using mp = carla::MsgPack;
+
+  PackedVector<VehicleControl> var;
+
+  auto result = mp::UnPack<decltype(var)>(mp::Pack(var));
+  ASSERT_TRUE(result.empty());
+
+  var.emplace_back(1.0f, 0.5f, 0.0f, false, true, false, 3);
+  var.emplace_back(0.0f, -0.5f, 1.0f, true, false, true, -1);
+  result = mp::UnPack<decltype(var)>(mp::Pack(var));
+  ASSERT_EQ(result.size(), var.size());
+  ASSERT_EQ(result[0u], var[0u]);
+  ASSERT_EQ(result[1u], var[1u]);
+
+  Command command = Command::ApplyVehicleControlBatch{{42u, 43u}, var};
+  auto command_result = mp::UnPack<Command>(mp::Pack(command));
+  ASSERT_EQ(command_result.command.which(), command.command.which());
+  const auto &batch = boost::get<Command::ApplyVehicleControlBatch>(command_result.command);
+  ASSERT_EQ(batch.actors.size(), 2u);
+  ASSERT_EQ(batch.actors[1u], 43u);
+  ASSERT_EQ(batch.controls[1u], var[1u]);
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(msgpack, packed_vector_invalid) {
+  using mp = carla::MsgPack;
+  PackedVector<VehicleControl> var;
+  var.emplace_back(1.0f, 0.5f, 0.0f, false, true, false, 3);
+  auto buffer = mp::Pack(var);
+  // A bin 8 header of two bytes, then throttle, steer, brake and hand_brake.
+  const size_t hand_brake = 2u + 3u * sizeof(float);
+  ASSERT_EQ(buffer[hand_brake], 0u);
+  buffer[hand_brake] = 2u;
+  ASSERT_THROW(mp::UnPack<decltype(var)>(buffer), clmdep_msgpack::type_error);
+  // Truncated record.
+  PackedVector<uint8_t> bytes(10u, 1u);
+  ASSERT_THROW(mp::UnPack<decltype(var)>(mp::Pack(bytes)), clmdep_msgpack::type_error);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
+
+TEST(msgpack, benchmark_batch_commands) {
+  using mp = carla::MsgPack;
+
+  constexpr size_t number_of_actors = 5000u;
+  constexpr size_t iterations = 20u;
+
+  std::vector<Command> commands;
+  Command::ApplyVehicleControlBatch batch;
+  for (auto i = 0u; i < number_of_actors; ++i) {
+    VehicleControl control{0.5f, 0.1f * i, 0.0f, false, false, false, 0};
+    commands.emplace_back(Command::ApplyVehicleControl{i, control});
+    batch.actors.emplace_back(i);
+    batch.controls.emplace_back(control);
+  }
+  const std::vector<Command> batch_commands = {batch};
+
+  auto benchmark = [&](const char *name, const std::vector<Command> &cmds) {
+    size_t size = 0u;
+    carla::StopWatch pack_timer;
+    carla::Buffer buffer;
+    for (auto i = 0u; i < iterations; ++i) {
+      buffer = mp::Pack(cmds);
+    }
+    pack_timer.Stop();
+    size = buffer.size();
+    carla::StopWatch unpack_timer;
+    for (auto i = 0u; i < iterations; ++i) {
+      auto result = mp::UnPack<std::vector<Command>>(buffer);
+      ASSERT_EQ(result.size(), cmds.size());
+    }
+    unpack_timer.Stop();
+    const auto to_ms = [&](const carla::StopWatch &timer) {
+      return 1e-3 * static_cast<double>(
+          timer.GetElapsedTime<std::chrono::microseconds>()) / iterations;
+    };
+    std::cout << name << ": " << number_of_actors << " vehicle controls, "
+              << size << " bytes, pack " << to_ms(pack_timer) << "ms, unpack "
+              << to_ms(unpack_timer) << "ms\n";
+  };
+
+  benchmark("per-command", commands);
+  benchmark("batch command", batch_commands);
+}
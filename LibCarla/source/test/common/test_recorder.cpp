@@ -0,0 +1,621 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/recorder/FrameBuilder.h>
+#include <carla/recorder/FrameIndex.h>
+#include <carla/recorder/PacketReader.h>
+#include <carla/recorder/PositionCodec.h>
+#include <carla/recorder/Recorder.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace carla::recorder;
+
+static Info MakeInfo() {
+  return Info{1u, "CARLA_RECORDER", 1234567, "Town01"};
+}
+
+static EventAdd MakeEventAdd(uint32_t id) {
+  EventAdd event;
+  event.database_id = id;
+  event.type = 2u;
+  event.location = {1.0f, 2.0f, 3.0f};
+  event.rotation = {0.0f, 90.0f, 0.0f};
+  event.description.uid = 7u;
+  event.description.id = "vehicle.test";
+  event.description.attributes.push_back({1u, "role_name", "hero"});
+  event.description.attributes.push_back({3u, "color", "255,0,0"});
+  return event;
+}
+
+/// Add some packets of every kind and end the frame.
+static void AddFrame(FrameBuilder &builder, uint32_t frame) {
+  if (frame % 4u == 0u) {
+    builder.Add(MakeEventAdd(frame));
+  }
+  if (frame % 5u == 0u) {
+    builder.Add(EventDel{frame});
+    builder.Add(EventParent{frame, frame + 1u});
+  }
+  builder.Add(Collision{frame, 1u, 2u, true, false});
+  builder.Add(Collision{frame + 1u, 1u, 2u, true, false});
+  for (auto i = 0u; i < 10u; ++i) {
+    builder.Add(Position{i, {float(frame), float(i), 0.0f}, {}});
+  }
+  builder.Add(StateTrafficLight{100u, false, 0.5f * frame, 2});
+  builder.EndFrame(0.05 * (1u + frame % 3u));
+}
+
+static std::vector<unsigned char> ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static std::vector<unsigned char> ToVector(const OutputBuffer &buffer) {
+  return {buffer.data(), buffer.data() + buffer.size()};
+}
+
+TEST(recorder, packets_round_trip) {
+  OutputBuffer out;
+  Write(out, MakeInfo());
+  Write(out, MakeEventAdd(42u));
+  Write(out, Position{3u, {1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}});
+
+  InputBuffer in(out.data(), out.size());
+  Info info;
+  Read(in, info);
+  ASSERT_EQ(info.magic, "CARLA_RECORDER");
+  ASSERT_EQ(info.map_file, "Town01");
+  ASSERT_EQ(info.date, 1234567);
+  EventAdd event;
+  Read(in, event);
+  ASSERT_EQ(event.database_id, 42u);
+  ASSERT_EQ(event.description.id, "vehicle.test");
+  ASSERT_EQ(event.description.attributes.size(), 2u);
+  ASSERT_EQ(event.description.attributes[1u].value, "255,0,0");
+  Position position;
+  Read(in, position);
+  ASSERT_EQ(position.database_id, 3u);
+  ASSERT_EQ(position.rotation.z, 6.0f);
+  ASSERT_TRUE(in.IsAtEnd());
+#ifndef LIBCARLA_NO_EXCEPTIONS
+  ASSERT_THROW(in.Read<uint8_t>(), std::runtime_error);
+#endif // LIBCARLA_NO_EXCEPTIONS
+}
+
+TEST(recorder, input_buffer_without_exceptions) {
+  OutputBuffer out;
+  Write(out, MakeEventAdd(42u));
+  // Cut the last attribute.
+  InputBuffer in(out.data(), out.size() - 4u, false);
+  EventAdd event;
+  Read(in, event);
+  ASSERT_FALSE(in.IsValid());
+  ASSERT_TRUE(in.IsAtEnd());
+  ASSERT_EQ(event.database_id, 42u);
+  ASSERT_EQ(event.description.attributes.size(), 2u);
+  ASSERT_TRUE(event.description.attributes[1u].value.empty());
+  ASSERT_EQ(in.Read<uint32_t>(), 0u);
+}
+
+TEST(recorder, frame_format) {
+  FrameBuilder builder;
+  builder.WriteInfo(MakeInfo());
+  for (auto frame = 0u; frame < 3u; ++frame) {
+    AddFrame(builder, frame);
+  }
+  OutputBuffer out;
+  builder.TakeAll(out);
+
+  InputBuffer in(out.data(), out.size());
+  Info info;
+  Read(in, info);
+  std::vector<Frame> frames;
+  std::vector<PacketId> ids;
+  while (!in.IsAtEnd()) {
+    const auto id = static_cast<PacketId>(in.Read<char>());
+    const auto size = in.Read<uint32_t>();
+    ids.push_back(id);
+    const auto begin = in.GetOffset();
+    switch (id) {
+      case PacketId::FrameStart:
+        ASSERT_EQ(size, sizeof(Frame));
+        frames.push_back(in.Read<Frame>());
+        break;
+      case PacketId::Collision:
+        // The second collision between the same actors is dropped.
+        ASSERT_EQ(in.Read<uint16_t>(), 1u);
+        in.Skip(size - sizeof(uint16_t));
+        break;
+      case PacketId::Position:
+        ASSERT_EQ(in.Read<uint16_t>(), 10u);
+        ASSERT_EQ(size, sizeof(uint16_t) + 10u * sizeof(Position));
+        in.Skip(size - sizeof(uint16_t));
+        break;
+      default:
+        in.Skip(size);
+        break;
+    }
+    ASSERT_EQ(in.GetOffset() - begin, size);
+  }
+  ASSERT_EQ(ids.size(), 3u * 8u);
+  ASSERT_EQ(ids[0u], PacketId::FrameStart);
+  ASSERT_EQ(ids[1u], PacketId::EventAdd);
+  ASSERT_EQ(ids[7u], PacketId::FrameEnd);
+  ASSERT_EQ(frames.size(), 3u);
+  ASSERT_EQ(frames[0u].id, 1u);
+  ASSERT_EQ(frames[0u].elapsed, 0.0);
+  // Durations are patched when the next frame starts.
+  ASSERT_DOUBLE_EQ(frames[0u].duration, 0.10);
+  ASSERT_DOUBLE_EQ(frames[1u].duration, 0.15);
+  ASSERT_DOUBLE_EQ(frames[1u].elapsed, 0.10);
+  ASSERT_EQ(frames[2u].duration, -1.0);
+}
+
+TEST(recorder, take_completed) {
+  FrameBuilder whole;
+  FrameBuilder split;
+  whole.WriteInfo(MakeInfo());
+  split.WriteInfo(MakeInfo());
+  std::vector<unsigned char> result;
+  OutputBuffer chunk;
+  for (auto frame = 0u; frame < 20u; ++frame) {
+    AddFrame(whole, frame);
+    AddFrame(split, frame);
+    if (frame % 7u == 0u) {
+      split.TakeCompleted(chunk);
+      ASSERT_EQ(split.GetCompletedSize(), 0u);
+      result.insert(result.end(), chunk.data(), chunk.data() + chunk.size());
+    }
+  }
+  split.TakeAll(chunk);
+  result.insert(result.end(), chunk.data(), chunk.data() + chunk.size());
+  OutputBuffer expected;
+  whole.TakeAll(expected);
+  ASSERT_EQ(result, ToVector(expected));
+}
+
+TEST(recorder, write_file) {
+  const std::string path = "carla_test_recorder.log";
+  // Small flush size to go through the background writer several times.
+  Recorder recorder(256u);
+  ASSERT_FALSE(recorder.IsRecording());
+  ASSERT_TRUE(recorder.Start(path, MakeInfo()));
+  ASSERT_TRUE(recorder.IsRecording());
+  FrameBuilder expected_builder;
+  expected_builder.WriteInfo(MakeInfo());
+  for (auto frame = 0u; frame < 200u; ++frame) {
+    recorder.Add(Position{frame, {}, {}});
+    recorder.Add(MakeEventAdd(frame));
+    recorder.EndFrame(0.1);
+    expected_builder.Add(Position{frame, {}, {}});
+    expected_builder.Add(MakeEventAdd(frame));
+    expected_builder.EndFrame(0.1);
+    if (frame == 100u) {
+      recorder.Flush();
+      ASSERT_GT(recorder.GetBytesWritten(), 0u);
+    }
+  }
+  ASSERT_EQ(recorder.GetFrameCount(), 200u);
+  recorder.Stop();
+  ASSERT_FALSE(recorder.IsRecording());
+  ASSERT_FALSE(recorder.HasFailed());
+
+  OutputBuffer expected;
+  expected_builder.WriteIndex();
+  expected_builder.TakeAll(expected);
+  ASSERT_EQ(ReadFile(path), ToVector(expected));
+  ASSERT_EQ(recorder.GetBytesWritten(), expected.size());
+  std::remove(path.c_str());
+}
+
+TEST(recorder, invalid_path) {
+  Recorder recorder;
+  ASSERT_FALSE(recorder.Start("/this/folder/does/not/exist/recorder.log", MakeInfo()));
+  ASSERT_FALSE(recorder.IsRecording());
+  recorder.Add(Position{});
+  recorder.EndFrame(0.1);
+  ASSERT_EQ(recorder.GetFrameCount(), 0u);
+}
+
+static void WriteFile(const std::string &path, const OutputBuffer &buffer) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+
+TEST(recorder, frame_index) {
+  FrameBuilder builder;
+  builder.WriteInfo(MakeInfo());
+  OutputBuffer chunk;
+  std::vector<unsigned char> file;
+  for (auto frame = 0u; frame < 1000u; ++frame) {
+    AddFrame(builder, frame);
+    if (frame % 100u == 0u) {
+      builder.TakeCompleted(chunk);
+      file.insert(file.end(), chunk.data(), chunk.data() + chunk.size());
+    }
+  }
+  const auto &index = builder.GetIndex();
+  builder.WriteIndex();
+  builder.TakeAll(chunk);
+  file.insert(file.end(), chunk.data(), chunk.data() + chunk.size());
+
+  // Every entry points to the FrameStart packet of its frame.
+  ASSERT_EQ(index.GetFrames().size(), 1000u);
+  for (auto &entry : index.GetFrames()) {
+    ASSERT_LT(entry.offset + 5u + sizeof(Frame), file.size());
+    ASSERT_EQ(file[entry.offset], static_cast<unsigned char>(PacketId::FrameStart));
+    Frame frame;
+    std::memcpy(&frame, file.data() + entry.offset + 5u, sizeof(Frame));
+    ASSERT_EQ(frame.id, entry.id);
+    ASSERT_EQ(frame.elapsed, entry.elapsed);
+  }
+  // Every actor offset points to its EventAdd record.
+  ASSERT_EQ(index.GetActorOffsets().size(), 250u);
+  for (auto i = 0u; i < index.GetActorOffsets().size(); ++i) {
+    const auto offset = index.GetActorOffsets()[i];
+    InputBuffer in(file.data() + offset, file.size() - offset);
+    EventAdd event;
+    Read(in, event);
+    ASSERT_EQ(event.database_id, 4u * i);
+    ASSERT_EQ(event.description.id, "vehicle.test");
+  }
+
+  const double duration = index.GetDuration();
+  ASSERT_EQ(duration, index.GetFrames().back().elapsed);
+  ASSERT_EQ(index.FindFrame(-1.0), 0u);
+  ASSERT_EQ(index.FindFrame(duration + 1.0), 999u);
+  for (auto i = 1u; i < 1000u; ++i) {
+    const auto &entry = index.GetFrames()[i];
+    ASSERT_EQ(index.FindFrame(entry.elapsed), i);
+    ASSERT_EQ(index.FindFrame(entry.elapsed - 0.01), i - 1u);
+  }
+
+  // A keyframe every ten seconds with the actors created by the previous
+  // frames and not destroyed yet (see AddFrame).
+  ASSERT_GT(duration, 90.0);
+  ASSERT_EQ(index.GetKeyframes().size(), static_cast<size_t>(duration / 10.0) + 1u);
+  ASSERT_EQ(index.FindKeyframe(-1.0), nullptr);
+  for (auto &keyframe : index.GetKeyframes()) {
+    const auto elapsed = index.GetFrames()[keyframe.frame].elapsed;
+    ASSERT_EQ(index.FindKeyframe(elapsed + 0.01), &keyframe);
+    std::vector<uint32_t> expected;
+    for (auto frame = 0u; frame < keyframe.frame; frame += 4u) {
+      if (frame % 5u != 0u) {
+        expected.push_back(frame / 4u);
+      }
+    }
+    ASSERT_EQ(keyframe.actors, expected);
+  }
+
+  // Read it back from the file.
+  const std::string path = "carla_test_frame_index.log";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+  }
+  std::ifstream in(path, std::ios::binary);
+  in.seekg(10);
+  FrameIndex read;
+  ASSERT_TRUE(read.ReadFooter(in));
+  ASSERT_EQ(in.tellg(), 10);
+  ASSERT_EQ(read.GetActorOffsets(), index.GetActorOffsets());
+  ASSERT_EQ(read.GetKeyframes().size(), index.GetKeyframes().size());
+  ASSERT_EQ(read.GetKeyframes().back().actors, index.GetKeyframes().back().actors);
+  ASSERT_EQ(read.GetFrames().size(), index.GetFrames().size());
+  ASSERT_EQ(std::memcmp(
+      read.GetFrames().data(),
+      index.GetFrames().data(),
+      index.GetFrames().size() * sizeof(FrameIndexEntry)), 0);
+
+  // Scanning skips the index packet and finds the same frames.
+  FrameIndex scanned;
+  ASSERT_TRUE(scanned.Scan(in));
+  ASSERT_TRUE(scanned.GetKeyframes().empty());
+  ASSERT_EQ(scanned.GetFrames().size(), index.GetFrames().size());
+  ASSERT_EQ(scanned.GetFrames().back().offset, index.GetFrames().back().offset);
+  in.close();
+  std::remove(path.c_str());
+}
+
+TEST(recorder, frame_index_fallback) {
+  FrameBuilder builder;
+  builder.WriteInfo(MakeInfo());
+  for (auto frame = 0u; frame < 50u; ++frame) {
+    AddFrame(builder, frame);
+  }
+  OutputBuffer buffer;
+  // A file written by an older recorder, without index.
+  builder.TakeAll(buffer);
+  const std::string path = "carla_test_frame_index_fallback.log";
+  WriteFile(path, buffer);
+  std::ifstream in(path, std::ios::binary);
+  FrameIndex index;
+  ASSERT_FALSE(index.ReadFooter(in));
+  ASSERT_TRUE(index.empty());
+  ASSERT_TRUE(index.Load(in));
+  ASSERT_EQ(index.GetFrames().size(), 50u);
+  ASSERT_EQ(index.GetFrames().front().id, 1u);
+  ASSERT_EQ(index.FindKeyframe(1000.0), nullptr);
+  in.close();
+
+  // A damaged index is ignored.
+  builder.Reset();
+  builder.WriteInfo(MakeInfo());
+  AddFrame(builder, 0u);
+  builder.WriteIndex();
+  builder.TakeAll(buffer);
+  buffer.resize(buffer.size() - 20u);
+  buffer.Write(FrameIndexFooter{0u, {'C', 'A', 'R', 'L', 'A', 'I', 'D', 'X'}});
+  WriteFile(path, buffer);
+  in.open(path, std::ios::binary);
+  ASSERT_FALSE(index.ReadFooter(in));
+  ASSERT_TRUE(index.Load(in));
+  ASSERT_EQ(index.GetFrames().size(), 1u);
+  in.close();
+  std::remove(path.c_str());
+}
+
+TEST(recorder, compression) {
+  std::mt19937 engine(42u);
+  std::vector<std::vector<unsigned char>> inputs;
+  inputs.emplace_back();
+  inputs.emplace_back(7u, 'a');
+  inputs.emplace_back(100000u, 0u);
+  std::vector<unsigned char> random(70000u);
+  for (auto &byte : random) {
+    byte = static_cast<unsigned char>(engine());
+  }
+  inputs.push_back(random);
+  // Repeated blocks further than the window and overlapping references.
+  std::vector<unsigned char> mixed;
+  for (auto i = 0u; i < 5000u; ++i) {
+    const auto length = engine() % 40u;
+    if (engine() % 2u == 0u) {
+      const auto value = static_cast<unsigned char>(engine());
+      mixed.insert(mixed.end(), length, value);
+    } else {
+      mixed.insert(mixed.end(), random.begin() + length, random.begin() + 3u * length);
+    }
+  }
+  inputs.push_back(mixed);
+
+  BlockCompressor compressor;
+  OutputBuffer compressed;
+  for (auto &input : inputs) {
+    compressed.clear();
+    compressor.Compress(input.data(), input.size(), compressed);
+    std::vector<unsigned char> output(input.size());
+    ASSERT_TRUE(DecompressBlock(compressed.data(), compressed.size(), output.data(), output.size()));
+    ASSERT_EQ(output, input);
+    if (input.size() > 1000u) {
+      ASSERT_FALSE(DecompressBlock(compressed.data(), compressed.size(), output.data(), output.size() - 1u));
+      ASSERT_FALSE(DecompressBlock(compressed.data(), compressed.size() / 2u, output.data(), output.size()));
+    }
+  }
+  ASSERT_LT(compressed.size(), mixed.size() / 2u);
+}
+
+TEST(recorder, position_codec) {
+  std::mt19937 engine(7u);
+  std::uniform_real_distribution<float> step(-50.0f, 50.0f);
+  PositionEncoding encoding;
+  encoding.compact = true;
+  PositionEncoder encoder(encoding);
+  PositionDecoder decoder;
+  OutputBuffer payload;
+  std::vector<Position> positions;
+  for (auto i = 0u; i < 300u; ++i) {
+    positions.push_back(Position{i * 3u, {1000.0f * i, -500.0f * i, 20.0f}, {0.0f, 0.0f, float(i % 360u)}});
+  }
+  for (auto frame = 0u; frame < 100u; ++frame) {
+    for (auto &position : positions) {
+      if (position.database_id % 2u == 0u) {
+        position.location.x += step(engine);
+        position.location.y += step(engine);
+        position.rotation.z += step(engine) / 10.0f;
+      }
+    }
+    if (frame == 30u) {
+      // Actors destroyed and spawned, and a different order.
+      positions.erase(positions.begin() + 10, positions.begin() + 20);
+      positions.push_back(Position{5000u, {1.0f, 2.0f, 3.0f}, {}});
+      std::shuffle(positions.begin(), positions.end(), engine);
+    }
+    payload.clear();
+    encoder.Encode(positions, frame % 25u == 0u, payload);
+    ASSERT_TRUE(decoder.Decode(payload.data(), payload.size()));
+    const auto &decoded = decoder.GetPositions();
+    ASSERT_EQ(decoded.size(), positions.size());
+    for (auto i = 0u; i < positions.size(); ++i) {
+      ASSERT_EQ(decoded[i].database_id, positions[i].database_id);
+      // The quantization error does not accumulate.
+      ASSERT_NEAR(decoded[i].location.x, positions[i].location.x, 0.05f + 1e-6f * std::abs(positions[i].location.x));
+      ASSERT_NEAR(decoded[i].location.y, positions[i].location.y, 0.05f + 1e-6f * std::abs(positions[i].location.y));
+      ASSERT_NEAR(decoded[i].location.z, positions[i].location.z, 0.05f);
+      ASSERT_NEAR(decoded[i].rotation.z, positions[i].rotation.z, 0.005f + 1e-6f * std::abs(positions[i].rotation.z));
+    }
+    ASSERT_LT(payload.size(), positions.size() * sizeof(Position) / 2u);
+  }
+
+  // Only a key frame can be decoded on its own.
+  PositionDecoder other;
+  ASSERT_FALSE(other.Decode(payload.data(), payload.size()));
+  payload.clear();
+  encoder.Encode(positions, true, payload);
+  ASSERT_TRUE(other.Decode(payload.data(), payload.size()));
+  ASSERT_EQ(other.GetPositions().size(), positions.size());
+  ASSERT_FALSE(other.Decode(payload.data(), payload.size() - 1u));
+  ASSERT_TRUE(other.GetPositions().empty());
+}
+
+TEST(recorder, compact_positions_file) {
+  PositionEncoding encoding;
+  encoding.compact = true;
+  FrameBuilder plain;
+  FrameBuilder compact;
+  compact.SetPositionEncoding(encoding);
+  plain.WriteInfo(MakeInfo());
+  compact.WriteInfo(MakeInfo());
+  for (auto frame = 0u; frame < 300u; ++frame) {
+    AddFrame(plain, frame);
+    AddFrame(compact, frame);
+  }
+  compact.WriteIndex();
+  OutputBuffer plain_buffer;
+  OutputBuffer compact_buffer;
+  plain.TakeAll(plain_buffer);
+  compact.TakeAll(compact_buffer);
+  ASSERT_LT(compact_buffer.size(), plain_buffer.size());
+
+  // Decode the file from each keyframe, as the replayer does when seeking.
+  const auto &index = compact.GetIndex();
+  ASSERT_GT(index.GetKeyframes().size(), 1u);
+  for (auto &keyframe : index.GetKeyframes()) {
+    const auto offset = index.GetFrames()[keyframe.frame].offset;
+    InputBuffer in(compact_buffer.data() + offset, compact_buffer.size() - offset);
+    PositionDecoder decoder;
+    auto frame = keyframe.frame;
+    for (;;) {
+      const auto id = static_cast<PacketId>(in.Read<char>());
+      const auto size = in.Read<uint32_t>();
+      if (id == PacketId::FrameIndex) {
+        break;
+      }
+      ASSERT_NE(id, PacketId::Position);
+      if (id == PacketId::PositionCompact) {
+        ASSERT_TRUE(decoder.Decode(in.GetPosition(), size));
+        const auto &positions = decoder.GetPositions();
+        ASSERT_EQ(positions.size(), 10u);
+        for (auto i = 0u; i < 10u; ++i) {
+          ASSERT_EQ(positions[i].database_id, i);
+          ASSERT_EQ(positions[i].location.x, float(frame));
+          ASSERT_EQ(positions[i].location.y, float(i));
+        }
+        ++frame;
+      }
+      in.Skip(size);
+    }
+    ASSERT_EQ(frame, 300u);
+  }
+}
+
+static std::string ToString(const OutputBuffer &buffer) {
+  return {reinterpret_cast<const char *>(buffer.data()), buffer.size()};
+}
+
+TEST(recorder, packet_reader) {
+  FrameBuilder builder;
+  builder.WriteInfo(MakeInfo());
+  for (auto frame = 0u; frame < 20u; ++frame) {
+    AddFrame(builder, frame);
+  }
+  builder.WriteIndex();
+  OutputBuffer buffer;
+  builder.TakeAll(buffer);
+  std::istringstream file(ToString(buffer));
+
+  PacketReader reader;
+  Info info;
+  ASSERT_TRUE(reader.ReadInfo(file, info));
+  ASSERT_EQ(info.magic, "CARLA_RECORDER");
+  ASSERT_EQ(info.map_file, "Town01");
+  auto frames = 0u;
+  auto events = 0u;
+  bool index_found = false;
+  while (reader.ReadHeader(file)) {
+    switch (reader.GetPacketId()) {
+      case PacketId::FrameStart: {
+        Frame frame;
+        ASSERT_TRUE(reader.Read(file, frame));
+        ASSERT_EQ(frame.id, ++frames);
+        break;
+      }
+      case PacketId::EventAdd: {
+        std::vector<EventAdd> records;
+        ASSERT_TRUE(reader.ReadList(file, records));
+        for (auto &event : records) {
+          ASSERT_EQ(event.description.id, "vehicle.test");
+          ASSERT_EQ(event.description.attributes.size(), 2u);
+          ++events;
+        }
+        break;
+      }
+      case PacketId::Position: {
+        std::vector<Position> records;
+        ASSERT_TRUE(reader.ReadList(file, records));
+        ASSERT_EQ(records.size(), 10u);
+        ASSERT_EQ(records[9u].location.y, 9.0f);
+        break;
+      }
+      case PacketId::FrameIndex:
+        index_found = true;
+        reader.SkipPacket(file);
+        break;
+      default:
+        reader.SkipPacket(file);
+    }
+  }
+  ASSERT_EQ(frames, 20u);
+  ASSERT_EQ(events, 5u);
+  ASSERT_TRUE(index_found);
+
+  // Events at the offsets of the index, as the replayer does when seeking.
+  const auto &offsets = builder.GetIndex().GetActorOffsets();
+  ASSERT_EQ(offsets.size(), 5u);
+  for (auto i = 0u; i < offsets.size(); ++i) {
+    EventAdd event;
+    ASSERT_TRUE(reader.ReadRecordAt(file, offsets[i], event));
+    ASSERT_EQ(event.database_id, 4u * i);
+  }
+  EventAdd event;
+  ASSERT_FALSE(reader.ReadRecordAt(file, buffer.size(), event));
+}
+
+TEST(recorder, packet_reader_truncated) {
+  FrameBuilder builder;
+  builder.WriteInfo(MakeInfo());
+  AddFrame(builder, 0u);
+  OutputBuffer buffer;
+  builder.TakeAll(buffer);
+  // Cut the file in the middle of each packet, reading must never fail
+  // other than returning false.
+  for (auto size = 0u; size < buffer.size(); ++size) {
+    std::istringstream file(ToString(buffer).substr(0u, size));
+    PacketReader reader;
+    Info info;
+    if (!reader.ReadInfo(file, info)) {
+      continue;
+    }
+    bool valid = true;
+    while (valid && reader.ReadHeader(file)) {
+      switch (reader.GetPacketId()) {
+        case PacketId::EventAdd: {
+          std::vector<EventAdd> records;
+          valid = reader.ReadList(file, records);
+          ASSERT_TRUE(valid || records.empty());
+          break;
+        }
+        case PacketId::Collision: {
+          std::vector<Collision> records;
+          valid = reader.ReadList(file, records);
+          break;
+        }
+        default:
+          reader.SkipPacket(file);
+      }
+    }
+  }
+}
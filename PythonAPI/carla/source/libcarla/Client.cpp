@@ -69,6 +69,8 @@ void export_client() {
     .def("show_recorder_actors_blocked", CALL_WITHOUT_GIL_3(cc::Client, ShowRecorderActorsBlocked, std::string, float, float), (arg("name"), arg("min_time"), arg("min_distance")))
     .def("replay_file", CALL_WITHOUT_GIL_4(cc::Client, ReplayFile, std::string, float, float, int), (arg("name"), arg("time_start"), arg("duration"), arg("follow_id")))
     .def("set_replayer_time_factor", &cc::Client::SetReplayerTimeFactor, (arg("time_factor")))
+    .def("start_stream_capture", CALL_WITHOUT_GIL_2(cc::Client, StartStreamCapture, std::string, uint64_t), (arg("path"), arg("max_segment_size")=carla::sensor::StreamLogWriter::DefaultMaxSegmentSize))
+    .def("stop_stream_capture", CALL_WITHOUT_GIL(cc::Client, StopStreamCapture))
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
   ;
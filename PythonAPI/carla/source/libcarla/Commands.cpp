@@ -8,6 +8,8 @@
 #include <carla/rpc/Command.h>
 #include <carla/rpc/CommandResponse.h>
 
+#include <algorithm>
+
 namespace command_impl {
 
   template <typename T>
@@ -40,6 +42,112 @@ namespace command_impl {
     return self;
   }
 
+  static carla::rpc::PackedVector<carla::rpc::ActorId> MakeActorIds(
+      const boost::python::object &actor_ids) {
+    return MakeVectorFromPython<carla::rpc::ActorId>(actor_ids);
+  }
+
+  /// Reads a two-dimensional array of numbers with up to @a max_columns
+  /// columns, and calls @a make_row for each row. If @a values is not an
+  /// array, it is read as a Python list of T instead.
+  template <typename T, typename RowFunctor>
+  static carla::rpc::PackedVector<T> MakeBatchValues(
+      const boost::python::object &values,
+      const size_t max_columns,
+      RowFunctor make_row) {
+    if (!PyObject_CheckBuffer(values.ptr())) {
+      boost::python::stl_input_iterator<T> begin(values), end;
+      return carla::rpc::PackedVector<T>(begin, end);
+    }
+    size_t columns;
+    const auto numbers = MakeVectorFromPython<float>(values, &columns);
+    if ((columns == 0u) || (columns > max_columns)) {
+      PyErr_SetString(PyExc_ValueError, "unexpected number of columns in array");
+      boost::python::throw_error_already_set();
+    }
+    carla::rpc::PackedVector<T> result;
+    result.reserve(numbers.size() / columns);
+    for (auto i = 0u; i + columns <= numbers.size(); i += columns) {
+      result.emplace_back(make_row(&numbers[i], columns));
+    }
+    return result;
+  }
+
+  template <typename T>
+  static void CheckBatchSize(
+      const carla::rpc::PackedVector<carla::rpc::ActorId> &actors,
+      const carla::rpc::PackedVector<T> &values) {
+    if (actors.size() != values.size()) {
+      PyErr_SetString(PyExc_ValueError, "actor ids and values must have the same length");
+      boost::python::throw_error_already_set();
+    }
+  }
+
+  /// Columns: throttle, steer, brake, hand_brake, reverse, manual_gear_shift,
+  /// gear. Trailing columns may be omitted.
+  static boost::python::object CustomVehicleControlBatchInit(
+      boost::python::object self,
+      const boost::python::object &actor_ids,
+      const boost::python::object &controls) {
+    using namespace carla::rpc;
+    Command::ApplyVehicleControlBatch batch{
+        MakeActorIds(actor_ids),
+        MakeBatchValues<VehicleControl>(controls, 7u, [](const float *row, size_t columns) {
+          VehicleControl control;
+          control.throttle = row[0u];
+          if (columns > 1u) { control.steer = row[1u]; }
+          if (columns > 2u) { control.brake = row[2u]; }
+          if (columns > 3u) { control.hand_brake = (row[3u] != 0.0f); }
+          if (columns > 4u) { control.reverse = (row[4u] != 0.0f); }
+          if (columns > 5u) { control.manual_gear_shift = (row[5u] != 0.0f); }
+          if (columns > 6u) { control.gear = static_cast<int32_t>(row[6u]); }
+          return control;
+        })};
+    CheckBatchSize(batch.actors, batch.controls);
+    return self.attr("__init__")(std::move(batch));
+  }
+
+  /// Columns: direction x, y, z, speed, jump. Trailing columns may be
+  /// omitted.
+  static boost::python::object CustomWalkerControlBatchInit(
+      boost::python::object self,
+      const boost::python::object &actor_ids,
+      const boost::python::object &controls) {
+    using namespace carla::rpc;
+    Command::ApplyWalkerControlBatch batch{
+        MakeActorIds(actor_ids),
+        MakeBatchValues<WalkerControl>(controls, 5u, [](const float *row, size_t columns) {
+          WalkerControl control;
+          control.direction.x = row[0u];
+          if (columns > 1u) { control.direction.y = row[1u]; }
+          if (columns > 2u) { control.direction.z = row[2u]; }
+          if (columns > 3u) { control.speed = row[3u]; }
+          if (columns > 4u) { control.jump = (row[4u] != 0.0f); }
+          return control;
+        })};
+    CheckBatchSize(batch.actors, batch.controls);
+    return self.attr("__init__")(std::move(batch));
+  }
+
+  /// Columns: x, y, z, pitch, yaw, roll. Trailing columns may be omitted.
+  static boost::python::object CustomTransformBatchInit(
+      boost::python::object self,
+      const boost::python::object &actor_ids,
+      const boost::python::object &transforms) {
+    using namespace carla::rpc;
+    Command::ApplyTransformBatch batch{
+        MakeActorIds(actor_ids),
+        MakeBatchValues<carla::geom::Transform>(transforms, 6u, [](const float *row, size_t columns) {
+          float values[6u] = {0.0f};
+          std::copy(row, row + columns, values);
+          return carla::geom::Transform{
+              carla::geom::Location{values[0u], values[1u], values[2u]},
+              carla::geom::Rotation{values[3u], values[4u], values[5u]}};
+        })};
+    CheckBatchSize(batch.actors, batch.transforms);
+    return self.attr("__init__")(std::move(batch));
+  }
+
 } // namespace command_impl
 
 void export_commands() {
@@ -148,6 +256,24 @@ void export_commands() {
     .def_readwrite("enabled", &cr::Command::SetAutopilot::enabled)
   ;
 
+  class_<cr::Command::ApplyVehicleControlBatch>("ApplyVehicleControlBatch")
+    .def("__init__", &command_impl::CustomVehicleControlBatchInit, (arg("actor_ids"), arg("controls")))
+    .def(init<cr::Command::ApplyVehicleControlBatch>())
+    .def("__len__", +[](const cr::Command::ApplyVehicleControlBatch &self) { return self.actors.size(); })
+  ;
+
+  class_<cr::Command::ApplyWalkerControlBatch>("ApplyWalkerControlBatch")
+    .def("__init__", &command_impl::CustomWalkerControlBatchInit, (arg("actor_ids"), arg("controls")))
+    .def(init<cr::Command::ApplyWalkerControlBatch>())
+    .def("__len__", +[](const cr::Command::ApplyWalkerControlBatch &self) { return self.actors.size(); })
+  ;
+
+  class_<cr::Command::ApplyTransformBatch>("ApplyTransformBatch")
+    .def("__init__", &command_impl::CustomTransformBatchInit, (arg("actor_ids"), arg("transforms")))
+    .def(init<cr::Command::ApplyTransformBatch>())
+    .def("__len__", +[](const cr::Command::ApplyTransformBatch &self) { return self.actors.size(); })
+  ;
+
   implicitly_convertible<cr::Command::SpawnActor, cr::Command>();
   implicitly_convertible<cr::Command::DestroyActor, cr::Command>();
   implicitly_convertible<cr::Command::ApplyVehicleControl, cr::Command>();
@@ -158,4 +284,7 @@ void export_commands() {
   implicitly_convertible<cr::Command::ApplyImpulse, cr::Command>();
   implicitly_convertible<cr::Command::SetSimulatePhysics, cr::Command>();
   implicitly_convertible<cr::Command::SetAutopilot, cr::Command>();
+  implicitly_convertible<cr::Command::ApplyVehicleControlBatch, cr::Command>();
+  implicitly_convertible<cr::Command::ApplyWalkerControlBatch, cr::Command>();
+  implicitly_convertible<cr::Command::ApplyTransformBatch, cr::Command>();
 }
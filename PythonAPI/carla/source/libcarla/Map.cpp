@@ -10,6 +10,9 @@
 #include <carla/client/Waypoint.h>
 #include <carla/road/element/LaneMarking.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <ostream>
 #include <fstream>
 
@@ -55,6 +58,147 @@ static carla::geom::GeoLocation ToGeolocation(
   return self.GetGeoReference().Transform(location);
 }
 
+/// Reads @a values, an N x @a columns array of numbers (or a flat sequence),
+/// and checks @a output holds N x @a output_columns float64 values.
+static std::vector<double> MakeFrenetInput(
+    const boost::python::object &values,
+    const size_t columns,
+    const WritablePythonBuffer<double> &output,
+    const size_t output_columns) {
+  size_t input_columns;
+  auto numbers = MakeVectorFromPython<double>(values, &input_columns);
+  if (((input_columns != 1u) && (input_columns != columns)) || (numbers.size() % columns != 0u)) {
+    PyErr_SetString(PyExc_ValueError, "unexpected number of columns in array");
+    boost::python::throw_error_already_set();
+  }
+  if (output.size() != (numbers.size() / columns) * output_columns) {
+    PyErr_SetString(PyExc_ValueError, "output array size does not match the input");
+    boost::python::throw_error_already_set();
+  }
+  return numbers;
+}
+
+/// Columns of @a locations: x, y, z. Writes a row of road_id, lane_id, s, t
+/// into @a output for each location, NaN if it could not be projected.
+/// Returns the number of locations projected.
+static size_t ToFrenet(
+    const carla::client::Map &self,
+    const boost::python::object &locations,
+    const boost::python::object &output,
+    uint32_t lane_type) {
+  WritablePythonBuffer<double> out(output);
+  const auto numbers = MakeFrenetInput(locations, 3u, out, 4u);
+  carla::PythonUtil::ReleaseGIL unlock;
+  std::vector<carla::geom::Location> polyline;
+  polyline.reserve(numbers.size() / 3u);
+  for (auto i = 0u; i < numbers.size(); i += 3u) {
+    polyline.emplace_back(
+        static_cast<float>(numbers[i]),
+        static_cast<float>(numbers[i + 1u]),
+        static_cast<float>(numbers[i + 2u]));
+  }
+  const auto points = self.GetMap().ToFrenet(polyline, lane_type);
+  size_t count = 0u;
+  double *row = out.data();
+  for (const auto &point : points) {
+    if (point.has_value()) {
+      row[0u] = point->waypoint.road_id;
+      row[1u] = point->waypoint.lane_id;
+      row[2u] = point->waypoint.s;
+      row[3u] = point->t;
+      ++count;
+    } else {
+      std::fill(row, row + 4u, std::numeric_limits<double>::quiet_NaN());
+    }
+    row += 4u;
+  }
+  return count;
+}
+
+/// Whether @a value is an integer that fits in @a T.
+template <typename T>
+static bool IsInteger(const double value) {
+  return
+      std::isfinite(value) &&
+      (std::trunc(value) == value) &&
+      (value >= static_cast<double>(std::numeric_limits<T>::lowest())) &&
+      (value <= static_cast<double>(std::numeric_limits<T>::max()));
+}
+
+/// Columns of @a points: road_id, lane_id, s, t. Writes a row of x, y, z,
+/// pitch, yaw, roll into @a output for each point, NaN if the road has no
+/// such lane at s or the row is all NaN (a location to_frenet could not
+/// project). Returns the number of points transformed.
+static size_t FromFrenet(
+    const carla::client::Map &self,
+    const boost::python::object &points,
+    const boost::python::object &output) {
+  WritablePythonBuffer<double> out(output);
+  const auto numbers = MakeFrenetInput(points, 4u, out, 6u);
+  auto is_unprojected = [&](size_t i) {
+    return std::all_of(numbers.begin() + i, numbers.begin() + i + 4u, [](double value) {
+      return std::isnan(value);
+    });
+  };
+  for (auto i = 0u; i < numbers.size(); i += 4u) {
+    if (!is_unprojected(i) && (
+          !IsInteger<carla::road::RoadId>(numbers[i]) ||
+          !IsInteger<carla::road::LaneId>(numbers[i + 1u]) ||
+          !std::isfinite(numbers[i + 2u]) ||
+          !std::isfinite(numbers[i + 3u]))) {
+      PyErr_SetString(PyExc_ValueError, "invalid road_id, lane_id, s or t in frenet array");
+      boost::python::throw_error_already_set();
+    }
+  }
+  carla::PythonUtil::ReleaseGIL unlock;
+  const auto &map = self.GetMap();
+  size_t count = 0u;
+  double *row = out.data();
+  for (auto i = 0u; i < numbers.size(); i += 4u, row += 6u) {
+    const auto waypoint = !is_unprojected(i) ?
+        map.GetWaypoint(
+            static_cast<carla::road::RoadId>(numbers[i]),
+            static_cast<carla::road::LaneId>(numbers[i + 1u]),
+            numbers[i + 2u]) :
+        boost::optional<carla::road::element::Waypoint>{};
+    if (!waypoint.has_value()) {
+      std::fill(row, row + 6u, std::numeric_limits<double>::quiet_NaN());
+      continue;
+    }
+    const auto transform = map.FromFrenet({*waypoint, numbers[i + 3u]});
+    row[0u] = transform.location.x;
+    row[1u] = transform.location.y;
+    row[2u] = transform.location.z;
+    row[3u] = transform.rotation.pitch;
+    row[4u] = transform.rotation.yaw;
+    row[5u] = transform.rotation.roll;
+    ++count;
+  }
+  return count;
+}
+
+static carla::SharedPtr<const carla::road::LaneGeometry> GetLaneGeometry(
+    const carla::client::Map &self,
+    const double resolution) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.GetLaneGeometry(resolution);
+}
+
+/// Read-only view of the array @a member of the LaneGeometry @a self, with
+/// @a columns values per row. The view keeps @a self alive.
+template <typename T>
+static boost::python::object GetLaneGeometryArray(
+    const boost::python::object &self,
+    const std::vector<T> carla::road::LaneGeometry::*member,
+    const size_t columns = 1u) {
+  const auto &geometry = boost::python::extract<const carla::road::LaneGeometry &>(self)();
+  const auto &array = geometry.*member;
+  if (columns == 1u) {
+    return MakeArrayView(self, array.data(), {array.size()}, true);
+  }
+  return MakeArrayView(self, array.data(), {array.size() / columns, columns}, true);
+}
+
 void export_map() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -133,6 +277,9 @@ void export_map() {
     .def("get_topology", &GetTopology)
     .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
     .def("transform_to_geolocation", &ToGeolocation, (arg("location")))
+    .def("to_frenet", &ToFrenet, (arg("locations"), arg("output"), arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("from_frenet", &FromFrenet, (arg("frenet"), arg("output")))
+    .def("get_lane_geometry", &GetLaneGeometry, (arg("resolution")=0.5))
     .def("to_opendrive", CALL_RETURNING_COPY(cc::Map, GetOpenDrive))
     .def("save_to_disk", &SaveOpenDriveToDisk, (arg("path")=""))
     .def(self_ns::str(self_ns::self))
@@ -149,6 +296,27 @@ void export_map() {
     .add_property("width", &cre::LaneMarking::width)
   ;
 
+  class_<cr::LaneGeometry, boost::noncopyable>("LaneGeometry", no_init)
+    .def("__len__", &cr::LaneGeometry::GetNumberOfLanes)
+    .add_property("number_of_points", &cr::LaneGeometry::GetNumberOfPoints)
+    .add_property("road_id", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::road_ids); })
+    .add_property("section_id", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::section_ids); })
+    .add_property("lane_id", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::lane_ids); })
+    .add_property("lane_type", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::lane_types); })
+    .add_property("offsets", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::offsets); })
+    .add_property("s", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::distances); })
+    .add_property("center", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::centers, 3u); })
+    .add_property("left_boundary", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::left_boundaries, 3u); })
+    .add_property("right_boundary", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::right_boundaries, 3u); })
+    .add_property("left_marking_type", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::left_marking_types); })
+    .add_property("left_marking_color", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::left_marking_colors); })
+    .add_property("right_marking_type", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::right_marking_types); })
+    .add_property("right_marking_color", +[](const object &self) { return GetLaneGeometryArray(self, &cr::LaneGeometry::right_marking_colors); })
+  ;
+
+  // Held as const, the arrays are exposed as read-only views.
+  register_ptr_to_python<carla::SharedPtr<const cr::LaneGeometry>>();
+
   class_<cc::Waypoint, boost::noncopyable, boost::shared_ptr<cc::Waypoint>>("Waypoint", no_init)
     .add_property("id", &cc::Waypoint::GetId)
     .add_property("transform", CALL_RETURNING_COPY(cc::Waypoint, GetTransform))
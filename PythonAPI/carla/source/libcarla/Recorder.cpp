@@ -0,0 +1,224 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/PythonUtil.h>
+#include <carla/recorder/query/Query.h>
+
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+namespace query {
+
+  std::ostream &operator<<(std::ostream &out, const RecordingReader &self) {
+    out << "RecorderFile(path=" << self.GetPath()
+        << ", map=" << self.GetInfo().map_file
+        << ", frames=" << self.GetIndex().GetFrames().size()
+        << ", duration=" << self.GetIndex().GetDuration() << ')';
+    return out;
+  }
+
+} // namespace query
+} // namespace recorder
+} // namespace carla
+
+namespace recorder_detail {
+
+  namespace crq = carla::recorder::query;
+
+  /// Copy the member @a member of each item of @a items into an array.
+  template <typename T, typename Item, typename Member>
+  static boost::python::object MakeColumn(const std::vector<Item> &items, Member member) {
+    std::vector<T> column;
+    column.reserve(items.size());
+    for (auto &item : items) {
+      column.emplace_back(static_cast<T>(item.*member));
+    }
+    return MakeArrayCopy(column.data(), {column.size()});
+  }
+
+  /// Copy the pair of members @a first and @a second of each item of
+  /// @a items into a (N, 2) array.
+  template <typename T, typename Item, typename Member>
+  static boost::python::object MakeColumns(const std::vector<Item> &items, Member first, Member second) {
+    std::vector<T> columns;
+    columns.reserve(2u * items.size());
+    for (auto &item : items) {
+      columns.emplace_back(static_cast<T>(item.*first));
+      columns.emplace_back(static_cast<T>(item.*second));
+    }
+    return MakeArrayCopy(columns.data(), {items.size(), 2u});
+  }
+
+  static boost::python::dict ToPython(const crq::RecordingSummary &summary) {
+    namespace py = boost::python;
+    py::dict actors;
+    actors["id"] = MakeColumn<uint32_t>(summary.actors, &crq::ActorRecord::id);
+    actors["type"] = MakeColumn<uint8_t>(summary.actors, &crq::ActorRecord::type);
+    actors["is_hero"] = MakeColumn<uint8_t>(summary.actors, &crq::ActorRecord::is_hero);
+    actors["created"] = MakeColumn<double>(summary.actors, &crq::ActorRecord::created);
+    actors["destroyed"] = MakeColumn<double>(summary.actors, &crq::ActorRecord::destroyed);
+    py::list type_ids;
+    for (auto &actor : summary.actors) {
+      type_ids.append(actor.type_id);
+    }
+    actors["type_id"] = type_ids;
+    py::dict events;
+    events["frame"] = MakeColumn<uint64_t>(summary.events, &crq::EventRecord::frame);
+    events["time"] = MakeColumn<double>(summary.events, &crq::EventRecord::time);
+    events["type"] = MakeColumn<uint8_t>(summary.events, &crq::EventRecord::type);
+    events["id"] = MakeColumn<uint32_t>(summary.events, &crq::EventRecord::id);
+    events["parent"] = MakeColumn<uint32_t>(summary.events, &crq::EventRecord::parent);
+    py::dict result;
+    result["path"] = summary.path;
+    result["version"] = summary.info.version;
+    result["map"] = summary.info.map_file;
+    result["date"] = summary.info.date;
+    result["has_index"] = summary.has_index;
+    result["frames"] = summary.frames;
+    result["duration"] = summary.duration;
+    result["actors"] = actors;
+    result["events"] = events;
+    return result;
+  }
+
+  static boost::python::dict ToPython(const std::vector<crq::CollisionRecord> &collisions) {
+    boost::python::dict result;
+    result["frame"] = MakeColumn<uint64_t>(collisions, &crq::CollisionRecord::frame);
+    result["time"] = MakeColumn<double>(collisions, &crq::CollisionRecord::time);
+    result["id"] = MakeColumns<uint32_t>(collisions, &crq::CollisionRecord::actor1, &crq::CollisionRecord::actor2);
+    result["category"] = MakeColumns<uint8_t>(collisions, &crq::CollisionRecord::category1, &crq::CollisionRecord::category2);
+    result["is_hero"] = MakeColumns<uint8_t>(collisions, &crq::CollisionRecord::is_actor1_hero, &crq::CollisionRecord::is_actor2_hero);
+    return result;
+  }
+
+  static boost::python::dict ToPython(const std::vector<crq::BlockedRecord> &blocked) {
+    boost::python::dict result;
+    result["id"] = MakeColumn<uint32_t>(blocked, &crq::BlockedRecord::id);
+    result["time"] = MakeColumn<double>(blocked, &crq::BlockedRecord::time);
+    result["duration"] = MakeColumn<double>(blocked, &crq::BlockedRecord::duration);
+    return result;
+  }
+
+  static boost::python::dict ToPython(const crq::Trajectories &trajectories) {
+    static_assert(sizeof(carla::geom::Vector3D) == 3u * sizeof(float), "Invalid vector size.");
+    boost::python::dict result;
+    result["frame"] = MakeArrayCopy(trajectories.frames.data(), {trajectories.size()});
+    result["time"] = MakeArrayCopy(trajectories.times.data(), {trajectories.size()});
+    result["id"] = MakeArrayCopy(trajectories.ids.data(), {trajectories.size()});
+    result["location"] = MakeArrayCopy(
+        reinterpret_cast<const float *>(trajectories.locations.data()),
+        {trajectories.size(), 3u});
+    result["rotation"] = MakeArrayCopy(
+        reinterpret_cast<const float *>(trajectories.rotations.data()),
+        {trajectories.size(), 3u});
+    return result;
+  }
+
+  template <typename T>
+  static boost::python::list ToPython(const std::vector<T> &results) {
+    boost::python::list list;
+    for (auto &result : results) {
+      list.append(ToPython(result));
+    }
+    return list;
+  }
+
+  static std::vector<uint32_t> ToActorIds(const boost::python::object &actors) {
+    return actors.is_none() ? std::vector<uint32_t>{} : MakeVectorFromPython<uint32_t>(actors);
+  }
+
+  static std::vector<std::string> ToPaths(const boost::python::object &paths) {
+    boost::python::stl_input_iterator<std::string> begin(paths), end;
+    return {begin, end};
+  }
+
+  /// Run @a query without the GIL and convert its result.
+  template <typename F>
+  static auto CallWithoutGIL(F &&query) -> decltype(ToPython(query())) {
+    decltype(query()) result;
+    {
+      carla::PythonUtil::ReleaseGIL unlock;
+      result = query();
+    }
+    return ToPython(result);
+  }
+
+} // namespace recorder_detail
+
+void export_recorder() {
+  using namespace boost::python;
+  using namespace recorder_detail;
+  namespace crq = carla::recorder::query;
+
+  class_<crq::RecordingReader, boost::noncopyable, boost::shared_ptr<crq::RecordingReader>>("RecorderFile",
+      init<std::string>((arg("path"))))
+    .add_property("path", +[](const crq::RecordingReader &self) { return self.GetPath(); })
+    .add_property("version", +[](const crq::RecordingReader &self) { return self.GetInfo().version; })
+    .add_property("map", +[](const crq::RecordingReader &self) { return self.GetInfo().map_file; })
+    .add_property("date", +[](const crq::RecordingReader &self) { return self.GetInfo().date; })
+    .add_property("has_index", &crq::RecordingReader::HasIndex)
+    .add_property("frames", +[](const crq::RecordingReader &self) { return self.GetIndex().GetFrames().size(); })
+    .add_property("duration", +[](const crq::RecordingReader &self) { return self.GetIndex().GetDuration(); })
+    .add_property("chunks", +[](const crq::RecordingReader &self) { return self.GetChunks().size(); })
+    .def("summary", +[](const crq::RecordingReader &self, size_t number_of_threads) {
+      return CallWithoutGIL([&]() { return crq::QuerySummary(self, number_of_threads); });
+    }, (arg("number_of_threads")=0u))
+    .def("collisions", +[](const crq::RecordingReader &self, char category1, char category2, size_t number_of_threads) {
+      return CallWithoutGIL([&]() { return crq::QueryCollisions(self, category1, category2, number_of_threads); });
+    }, (arg("category1")='a', arg("category2")='a', arg("number_of_threads")=0u))
+    .def("actors_blocked", +[](const crq::RecordingReader &self, double min_time, double min_distance, size_t number_of_threads) {
+      return CallWithoutGIL([&]() { return crq::QueryBlocked(self, min_time, min_distance, number_of_threads); });
+    }, (arg("min_time")=30.0, arg("min_distance")=10.0, arg("number_of_threads")=0u))
+    .def("trajectories", +[](const crq::RecordingReader &self, double begin_time, double end_time, const object &actors, size_t number_of_threads) {
+      auto ids = ToActorIds(actors);
+      return CallWithoutGIL([&]() { return crq::QueryTrajectories(self, begin_time, end_time, std::move(ids), number_of_threads); });
+    }, (arg("begin_time")=0.0, arg("end_time")=std::numeric_limits<double>::max(), arg("actors")=object(), arg("number_of_threads")=0u))
+    .def(self_ns::str(self_ns::self))
+  ;
+
+  // Queries on many files, each file read by a single thread.
+
+  def("query_recorder_summaries", +[](const object &paths, size_t number_of_threads) {
+    const auto files = ToPaths(paths);
+    return CallWithoutGIL([&]() {
+      return crq::QueryEach(files, [](const crq::RecordingReader &reader) {
+        return crq::QuerySummary(reader, 1u);
+      }, number_of_threads);
+    });
+  }, (arg("paths"), arg("number_of_threads")=0u));
+
+  def("query_recorder_collisions", +[](const object &paths, char category1, char category2, size_t number_of_threads) {
+    const auto files = ToPaths(paths);
+    return CallWithoutGIL([&]() {
+      return crq::QueryEach(files, [=](const crq::RecordingReader &reader) {
+        return crq::QueryCollisions(reader, category1, category2, 1u);
+      }, number_of_threads);
+    });
+  }, (arg("paths"), arg("category1")='a', arg("category2")='a', arg("number_of_threads")=0u));
+
+  def("query_recorder_actors_blocked", +[](const object &paths, double min_time, double min_distance, size_t number_of_threads) {
+    const auto files = ToPaths(paths);
+    return CallWithoutGIL([&]() {
+      return crq::QueryEach(files, [=](const crq::RecordingReader &reader) {
+        return crq::QueryBlocked(reader, min_time, min_distance, 1u);
+      }, number_of_threads);
+    });
+  }, (arg("paths"), arg("min_time")=30.0, arg("min_distance")=10.0, arg("number_of_threads")=0u));
+
+  def("query_recorder_trajectories", +[](const object &paths, double begin_time, double end_time, const object &actors, size_t number_of_threads) {
+    const auto files = ToPaths(paths);
+    const auto ids = ToActorIds(actors);
+    return CallWithoutGIL([&]() {
+      return crq::QueryEach(files, [&](const crq::RecordingReader &reader) {
+        return crq::QueryTrajectories(reader, begin_time, end_time, ids, 1u);
+      }, number_of_threads);
+    });
+  }, (arg("paths"), arg("begin_time")=0.0, arg("end_time")=std::numeric_limits<double>::max(), arg("actors")=object(), arg("number_of_threads")=0u));
+}
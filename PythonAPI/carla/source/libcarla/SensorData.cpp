@@ -6,10 +6,16 @@
 
 #include <carla/PythonUtil.h>
 #include <carla/image/ImageConverter.h>
-#include <carla/image/ImageIO.h>
+#include <carla/image/ImageWriter.h>
+#include <carla/image/ImagePipeline.h>
+#include <carla/image/SegmentationAnalysis.h>
 #include <carla/image/ImageView.h>
+#include <carla/pointcloud/DepthProjection.h>
+#include <carla/pointcloud/LidarProcessing.h>
 #include <carla/pointcloud/PointCloudIO.h>
+#include <carla/sensor/AsyncWriter.h>
 #include <carla/sensor/SensorData.h>
+#include <carla/sensor/StreamLog.h>
 #include <carla/sensor/data/CollisionEvent.h>
 #include <carla/sensor/data/ObstacleDetectionEvent.h>
 #include <carla/sensor/data/Image.h>
@@ -19,7 +25,10 @@
 
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
+#include <cstring>
+#include <memory>
 #include <ostream>
+#include <vector>
 #include <iostream>
 
 namespace carla {
@@ -87,31 +96,111 @@ enum class EColorConverter {
 };
 
 template <typename T>
-static auto GetRawDataAsBuffer(T &self) {
+static boost::python::object GetRawDataAsBuffer(boost::python::object self_object) {
+  T &self = boost::python::extract<T &>(self_object);
   auto *data = reinterpret_cast<unsigned char *>(self.data());
   auto size = sizeof(typename T::value_type) * self.size();
 #if PY_MAJOR_VERSION >= 3 // NOTE(Andrei): python 3
-  auto *ptr = PyMemoryView_FromMemory(reinterpret_cast<char *>(data), size, PyBUF_READ);
+  return MakeArrayView(self_object, reinterpret_cast<const uint8_t *>(data), {size}, true);
 #else        // NOTE(Andrei): python 2
   auto *ptr = PyBuffer_FromMemory(data, size);
-#endif
   return boost::python::object(boost::python::handle<>(ptr));
+#endif
+}
+
+static boost::python::object GetImageArrayView(boost::python::object self_object) {
+  carla::sensor::data::Image &self = boost::python::extract<carla::sensor::data::Image &>(self_object);
+  return MakeArrayView(
+      self_object,
+      reinterpret_cast<uint8_t *>(self.data()),
+      {self.GetHeight(), self.GetWidth(), sizeof(carla::sensor::data::Color)});
+}
+
+static boost::python::object GetLidarArrayView(boost::python::object self_object) {
+  carla::sensor::data::LidarMeasurement &self = boost::python::extract<carla::sensor::data::LidarMeasurement &>(self_object);
+  return MakeArrayView(self_object, reinterpret_cast<float *>(self.data()), {self.size(), 3u});
+}
+
+static void CheckOutputSize(size_t size, size_t expected) {
+  if (size != expected) {
+    PyErr_SetString(PyExc_ValueError, "output array size does not match the image");
+    boost::python::throw_error_already_set();
+  }
+}
+
+/// Write the result of converting @a self with @a cc into @a output, which
+/// can be an array of uint8 BGRA pixels, of uint8 gray levels (depth only),
+/// or of float32 normalized depths (depth only).
+template <typename T>
+static void ConvertImageInto(const T &self, const boost::python::object &output, EColorConverter cc) {
+  using namespace carla::image;
+  using Pixel = ColorConverterKernels::Pixel;
+  auto unsupported = []() {
+    PyErr_SetString(PyExc_ValueError, "color converter not supported for this output type");
+    boost::python::throw_error_already_set();
+  };
+  const size_t count = self.size();
+  const auto format = GetBufferFormat(output);
+  if (format == 'f') {
+    WritablePythonBuffer<float> out(output);
+    CheckOutputSize(out.size(), count);
+    if (cc != EColorConverter::Depth) {
+      unsupported();
+    }
+    carla::PythonUtil::ReleaseGIL unlock;
+    ColorConverterKernels::Convert(ColorConverter::Depth(), self.data(), out.data(), count);
+  } else if (format == 'B') {
+    WritablePythonBuffer<uint8_t> out(output);
+    if (out.size() == sizeof(Pixel) * count) {
+      auto *dst = reinterpret_cast<Pixel *>(out.data());
+      carla::PythonUtil::ReleaseGIL unlock;
+      switch (cc) {
+        case EColorConverter::Raw:
+          std::memcpy(dst, self.data(), sizeof(Pixel) * count);
+          break;
+        case EColorConverter::Depth:
+          ColorConverterKernels::Convert(ColorConverter::Depth(), self.data(), dst, count);
+          break;
+        case EColorConverter::LogarithmicDepth:
+          ColorConverterKernels::Convert(ColorConverter::LogarithmicDepth(), self.data(), dst, count);
+          break;
+        case EColorConverter::CityScapesPalette:
+          ColorConverterKernels::Convert(ColorConverter::CityScapesPalette(), self.data(), dst, count);
+          break;
+        default:
+          throw std::invalid_argument("invalid color converter!");
+      }
+    } else {
+      CheckOutputSize(out.size(), count);
+      if (cc == EColorConverter::Depth) {
+        carla::PythonUtil::ReleaseGIL unlock;
+        ColorConverterKernels::Convert(ColorConverter::Depth(), self.data(), out.data(), count);
+      } else if (cc == EColorConverter::LogarithmicDepth) {
+        carla::PythonUtil::ReleaseGIL unlock;
+        ColorConverterKernels::Convert(ColorConverter::LogarithmicDepth(), self.data(), out.data(), count);
+      } else {
+        unsupported();
+      }
+    }
+  } else {
+    PyErr_SetString(PyExc_TypeError, "output must be an array of uint8 or float32");
+    boost::python::throw_error_already_set();
+  }
 }
 
 template <typename T>
 static void ConvertImage(T &self, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
   using namespace carla::image;
-  auto view = ImageView::MakeView(self);
   switch (cc) {
     case EColorConverter::Depth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::Depth());
+      ImageConverter::ConvertInPlace(self, ColorConverter::Depth());
       break;
     case EColorConverter::LogarithmicDepth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::LogarithmicDepth());
+      ImageConverter::ConvertInPlace(self, ColorConverter::LogarithmicDepth());
       break;
     case EColorConverter::CityScapesPalette:
-      ImageConverter::ConvertInPlace(view, ColorConverter::CityScapesPalette());
+      ImageConverter::ConvertInPlace(self, ColorConverter::CityScapesPalette());
       break;
     case EColorConverter::Raw:
       break; // ignore.
@@ -120,37 +209,306 @@ static void ConvertImage(T &self, EColorConverter cc) {
   }
 }
 
-template <typename T>
-static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
-  carla::PythonUtil::ReleaseGIL unlock;
-  using namespace carla::image;
-  auto view = ImageView::MakeView(self);
+static carla::image::ImageWriter::ColorConversion ToColorConversion(EColorConverter cc) {
+  using CC = carla::image::ImageWriter::ColorConversion;
   switch (cc) {
-    case EColorConverter::Raw:
-      return ImageIO::WriteView(
-          std::move(path),
-          view);
-    case EColorConverter::Depth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::Depth()));
-    case EColorConverter::LogarithmicDepth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::LogarithmicDepth()));
-    case EColorConverter::CityScapesPalette:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::CityScapesPalette()));
+    case EColorConverter::Raw:               return CC::Raw;
+    case EColorConverter::Depth:             return CC::Depth;
+    case EColorConverter::LogarithmicDepth:  return CC::LogarithmicDepth;
+    case EColorConverter::CityScapesPalette: return CC::CityScapesPalette;
     default:
       throw std::invalid_argument("invalid color converter!");
   }
 }
 
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
+  const auto color_conversion = ToColorConversion(cc);
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::image::ImageWriter::WriteImage(std::move(path), self, color_conversion);
+}
+
+template <typename T>
+static std::string SavePointCloudToDisk(
+    T &self,
+    std::string path,
+    carla::pointcloud::PointCloudIO::Format format) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end(), format);
+}
+
+/// Output buffer for @a max_points points, as a float array of at least
+/// `3 * max_points` elements.
+class PointsOutput {
+public:
+
+  PointsOutput(const boost::python::object &output, size_t max_points)
+    : _buffer(output) {
+    if (_buffer.size() < 3u * max_points) {
+      PyErr_SetString(PyExc_ValueError, "output array is too small, it needs room for every point");
+      boost::python::throw_error_already_set();
+    }
+  }
+
+  carla::geom::Location *data() {
+    return reinterpret_cast<carla::geom::Location *>(_buffer.data());
+  }
+
+private:
+
+  WritablePythonBuffer<float> _buffer;
+};
+
+static size_t CropLidar(
+    const carla::sensor::data::LidarMeasurement &self,
+    const carla::geom::BoundingBox &box,
+    const boost::python::object &output,
+    size_t number_of_threads) {
+  PointsOutput out(output, self.size());
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::pointcloud::LidarProcessing::Crop(self, box, out.data(), number_of_threads);
+}
+
+static size_t VoxelDownsampleLidar(
+    const carla::sensor::data::LidarMeasurement &self,
+    float voxel_size,
+    const boost::python::object &output,
+    size_t number_of_threads) {
+  PointsOutput out(output, self.size());
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::pointcloud::LidarProcessing::VoxelDownsample(self, voxel_size, out.data(), number_of_threads);
+}
+
+static void MakeLidarRangeImage(
+    const carla::sensor::data::LidarMeasurement &self,
+    const boost::python::object &output,
+    size_t number_of_threads) {
+  WritablePythonBuffer<float> out(output);
+  const size_t channels = self.GetChannelCount();
+  if ((channels == 0u) || (out.size() % channels != 0u)) {
+    PyErr_SetString(PyExc_ValueError, "output array size must be a multiple of the number of channels");
+    boost::python::throw_error_already_set();
+  }
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::pointcloud::LidarProcessing::MakeRangeImage(self, out.size() / channels, out.data(), number_of_threads);
+}
+
+static size_t ProjectDepthImage(
+    const carla::sensor::data::Image &self,
+    const boost::python::object &output,
+    size_t stride,
+    float max_range,
+    bool world_frame,
+    size_t number_of_threads) {
+  using carla::pointcloud::DepthProjection;
+  PointsOutput out(output, DepthProjection::GetMaxNumberOfPoints(self.GetWidth(), self.GetHeight(), stride));
+  DepthProjection::Options options;
+  options.stride = stride;
+  options.max_range = max_range;
+  options.number_of_threads = number_of_threads;
+  carla::PythonUtil::ReleaseGIL unlock;
+  return DepthProjection::Project(self, options, world_frame, out.data());
+}
+
+static std::vector<float> MakeNormalizationValues(const boost::python::object &obj) {
+  boost::python::extract<float> value(obj);
+  if (value.check()) {
+    return {value()};
+  }
+  return MakeVectorFromPython<float>(obj);
+}
+
+static boost::python::tuple GetImagePipelineOutputShape(
+    const carla::image::ImagePipeline &self,
+    size_t width,
+    size_t height) {
+  const auto shape = self.GetOutputShape(width, height);
+  if (self.GetLayout() == carla::image::ImagePipeline::Layout::CHW) {
+    return boost::python::make_tuple(shape.channels, shape.height, shape.width);
+  }
+  return boost::python::make_tuple(shape.height, shape.width, shape.channels);
+}
+
+/// Run @a self on @a count images into @a output, a uint8 or float32 array
+/// with room for exactly @a count output tensors.
+static void RunImagePipeline(
+    const carla::image::ImagePipeline &self,
+    const carla::sensor::data::Image *const *images,
+    const size_t count,
+    const boost::python::object &output,
+    const size_t number_of_threads) {
+  const size_t expected = count == 0u ? 0u :
+      count * self.GetOutputShape(images[0u]->GetWidth(), images[0u]->GetHeight()).size();
+  auto run = [&](auto &out) {
+    if (out.size() != expected) {
+      PyErr_SetString(PyExc_ValueError, "output array size does not match the output shape");
+      boost::python::throw_error_already_set();
+    }
+    carla::PythonUtil::ReleaseGIL unlock;
+    self.RunBatch(images, count, out.data(), number_of_threads);
+  };
+  const auto format = GetBufferFormat(output);
+  if (format == 'f') {
+    WritablePythonBuffer<float> out(output);
+    run(out);
+  } else if (format == 'B') {
+    WritablePythonBuffer<uint8_t> out(output);
+    run(out);
+  } else {
+    PyErr_SetString(PyExc_TypeError, "output array must be of type uint8 or float32");
+    boost::python::throw_error_already_set();
+  }
+}
+
+static void ProcessImageBatch(
+    const carla::image::ImagePipeline &self,
+    const boost::python::object &images,
+    const boost::python::object &output,
+    const size_t number_of_threads) {
+  using ImagePtr = boost::shared_ptr<carla::sensor::data::Image>;
+  boost::python::stl_input_iterator<ImagePtr> begin(images), end;
+  // Keep the images alive while the GIL is released.
+  const std::vector<ImagePtr> owners(begin, end);
+  std::vector<const carla::sensor::data::Image *> pointers;
+  pointers.reserve(owners.size());
+  for (auto &image : owners) {
+    pointers.emplace_back(image.get());
+  }
+  RunImagePipeline(self, pointers.data(), pointers.size(), output, number_of_threads);
+}
+
+static boost::python::tuple GetTagStatistics(const carla::sensor::data::Image &self, size_t number_of_threads) {
+  using carla::image::SegmentationAnalysis;
+  std::vector<uint32_t> histogram(SegmentationAnalysis::NumberOfTags);
+  std::vector<SegmentationAnalysis::Box> boxes(SegmentationAnalysis::NumberOfTags);
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    SegmentationAnalysis::ComputeTagStatistics(self, histogram.data(), boxes.data(), number_of_threads);
+  }
+  return boost::python::make_tuple(
+      MakeArrayCopy(histogram.data(), {histogram.size()}),
+      MakeArrayCopy(reinterpret_cast<const uint32_t *>(boxes.data()), {boxes.size(), 4u}));
+}
+
+/// Return the components as a (N, 6) uint32 array of tag, pixel count and
+/// box, and a (N, 2) float32 array of centroids.
+static boost::python::tuple FindConnectedComponents(
+    const carla::sensor::data::Image &self,
+    const boost::python::object &tags,
+    uint32_t min_pixel_count,
+    const boost::python::object &labels,
+    size_t number_of_threads) {
+  using carla::image::SegmentationAnalysis;
+  SegmentationAnalysis::ComponentOptions options;
+  options.tags = MakeVectorFromPython<uint8_t>(tags);
+  options.min_pixel_count = min_pixel_count;
+  options.number_of_threads = number_of_threads;
+  std::unique_ptr<WritablePythonBuffer<uint32_t>> labels_buffer;
+  if (!labels.is_none()) {
+    labels_buffer = std::make_unique<WritablePythonBuffer<uint32_t>>(labels);
+    CheckOutputSize(labels_buffer->size(), self.size());
+  }
+  std::vector<SegmentationAnalysis::Component> components;
+  std::vector<uint32_t> statistics;
+  std::vector<float> centroids;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    components = SegmentationAnalysis::FindConnectedComponents(
+        self,
+        options,
+        labels_buffer != nullptr ? labels_buffer->data() : nullptr);
+    statistics.reserve(6u * components.size());
+    centroids.reserve(2u * components.size());
+    for (const auto &component : components) {
+      statistics.insert(statistics.end(), {
+          component.tag,
+          component.pixel_count,
+          component.box.x_min,
+          component.box.y_min,
+          component.box.x_max,
+          component.box.y_max});
+      centroids.insert(centroids.end(), {component.centroid_x, component.centroid_y});
+    }
+  }
+  return boost::python::make_tuple(
+      MakeArrayCopy(statistics.data(), {components.size(), 6u}),
+      MakeArrayCopy(centroids.data(), {components.size(), 2u}));
+}
+
+static bool AsyncWrite(
+    carla::sensor::AsyncWriter &self,
+    carla::SharedPtr<carla::sensor::SensorData> data,
+    std::string path,
+    EColorConverter cc) {
+  const auto color_conversion = ToColorConversion(cc);
+  // The pointer received from Python may hold a reference to a Python object,
+  // the writer releases it in a worker thread so we need to make sure it is
+  // deleted while holding the GIL.
+  using Deleter = carla::PythonUtil::AcquireGILDeleter;
+  auto *holder = new carla::SharedPtr<carla::sensor::SensorData>(std::move(data));
+  const carla::SharedPtr<carla::SharedPtr<carla::sensor::SensorData>> owner{holder, Deleter()};
+  carla::SharedPtr<carla::sensor::SensorData> guarded_data{owner, holder->get()};
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  return self.Write(std::move(guarded_data), std::move(path), color_conversion);
+}
+
+// The writer waits for its pending writes on destruction, and the workers need
+// the GIL to release the data they hold, so it must be destroyed without it.
+static boost::shared_ptr<carla::sensor::AsyncWriter> MakeAsyncWriter(
+    size_t worker_threads,
+    size_t max_queue_size,
+    carla::sensor::AsyncWriter::QueueFullPolicy policy) {
+  return {
+      new carla::sensor::AsyncWriter(worker_threads, max_queue_size, policy),
+      carla::PythonUtil::ReleaseGILDeleter()};
+}
+
+static boost::python::list GetStreamLogEntries(
+    const carla::sensor::StreamLogReader &self,
+    uint64_t frame_begin,
+    uint64_t frame_end) {
+  boost::python::list result;
+  for (const auto &entry : self.GetEntries(frame_begin, frame_end)) {
+    result.append(entry);
+  }
+  return result;
+}
+
+static void ReplayStreamLog(
+    const carla::sensor::StreamLogReader &self,
+    boost::python::object callback,
+    uint64_t frame_begin,
+    uint64_t frame_end) {
+  namespace py = boost::python;
+  if (!PyCallable_Check(callback.ptr())) {
+    PyErr_SetString(PyExc_TypeError, "callback argument must be callable!");
+    py::throw_error_already_set();
+  }
+  for (const auto &entry : self.GetEntries(frame_begin, frame_end)) {
+    carla::SharedPtr<carla::sensor::SensorData> data;
+    {
+      carla::PythonUtil::ReleaseGIL unlock;
+      data = self.Deserialize(entry);
+    }
+    callback(entry.sensor_id, py::object(data));
+  }
+}
+
+static boost::python::dict GetAsyncWriterStatistics(const carla::sensor::AsyncWriter &self) {
+  boost::python::dict result;
+  for (auto &&item : self.GetStatistics()) {
+    const auto &statistics = item.second;
+    boost::python::dict entry;
+    entry["files_written"] = statistics.files_written;
+    entry["files_dropped"] = statistics.files_dropped;
+    entry["errors"] = statistics.errors;
+    entry["bytes_written"] = statistics.bytes_written;
+    entry["busy_seconds"] = statistics.busy_seconds;
+    entry["files_per_second"] = statistics.GetFilesPerSecond();
+    entry["megabytes_per_second"] = statistics.GetMegabytesPerSecond();
+    result[item.first] = entry;
+  }
+  return result;
 }
 
 void export_sensor_data() {
@@ -178,7 +536,12 @@ void export_sensor_data() {
     .add_property("height", &csd::Image::GetHeight)
     .add_property("fov", &csd::Image::GetFOVAngle)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::Image>)
+    .add_property("array_view", &GetImageArrayView)
     .def("convert", &ConvertImage<csd::Image>, (arg("color_converter")))
+    .def("convert_into", &ConvertImageInto<csd::Image>, (arg("output"), arg("color_converter")))
+    .def("get_tag_statistics", &GetTagStatistics, (arg("num_threads")=0u))
+    .def("find_connected_components", &FindConnectedComponents, (arg("tags")=list(), arg("min_pixel_count")=1u, arg("labels")=object(), arg("num_threads")=0u))
+    .def("to_point_cloud", &ProjectDepthImage, (arg("output"), arg("stride")=1u, arg("max_range")=carla::pointcloud::DepthProjection::FarPlane, arg("world_frame")=false, arg("num_threads")=0u))
     .def("save_to_disk", &SaveImageToDisk<csd::Image>, (arg("path"), arg("color_converter")=EColorConverter::Raw))
     .def("__len__", &csd::Image::size)
     .def("__iter__", iterator<csd::Image>())
@@ -191,12 +554,22 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  enum_<carla::pointcloud::PointCloudIO::Format>("PointCloudFormat")
+    .value("PlyAscii", carla::pointcloud::PointCloudIO::Format::PlyAscii)
+    .value("PlyBinary", carla::pointcloud::PointCloudIO::Format::PlyBinary)
+    .value("Bin", carla::pointcloud::PointCloudIO::Format::Bin)
+  ;
+
   class_<csd::LidarMeasurement, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::LidarMeasurement>>("LidarMeasurement", no_init)
     .add_property("horizontal_angle", &csd::LidarMeasurement::GetHorizontalAngle)
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
+    .add_property("array_view", &GetLidarArrayView)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("crop", &CropLidar, (arg("bounding_box"), arg("output"), arg("num_threads")=0u))
+    .def("voxel_downsample", &VoxelDownsampleLidar, (arg("voxel_size"), arg("output"), arg("num_threads")=0u))
+    .def("make_range_image", &MakeLidarRangeImage, (arg("output"), arg("num_threads")=0u))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudIO::Format::PlyAscii))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> cr::Location {
@@ -234,4 +607,87 @@ void export_sensor_data() {
     .add_property("altitude", &csd::GnssEvent::GetAltitude)
     .def(self_ns::str(self_ns::self))
   ;
+
+  namespace ci = carla::image;
+
+  enum_<ci::ImagePipeline::Interpolation>("ImagePipelineInterpolation")
+    .value("Area", ci::ImagePipeline::Interpolation::Area)
+    .value("Bilinear", ci::ImagePipeline::Interpolation::Bilinear)
+  ;
+
+  enum_<ci::ImagePipeline::ChannelOrder>("ImagePipelineChannelOrder")
+    .value("BGRA", ci::ImagePipeline::ChannelOrder::BGRA)
+    .value("RGBA", ci::ImagePipeline::ChannelOrder::RGBA)
+    .value("BGR", ci::ImagePipeline::ChannelOrder::BGR)
+    .value("RGB", ci::ImagePipeline::ChannelOrder::RGB)
+  ;
+
+  enum_<ci::ImagePipeline::Layout>("ImagePipelineLayout")
+    .value("HWC", ci::ImagePipeline::Layout::HWC)
+    .value("CHW", ci::ImagePipeline::Layout::CHW)
+  ;
+
+  class_<ci::ImagePipeline>("ImagePipeline")
+    .def("crop", &ci::ImagePipeline::Crop, (arg("x"), arg("y"), arg("width"), arg("height")), return_self<>())
+    .def("resize", &ci::ImagePipeline::Resize, (arg("width"), arg("height"), arg("interpolation")=ci::ImagePipeline::Interpolation::Area), return_self<>())
+    .def("set_channel_order", &ci::ImagePipeline::SetChannelOrder, (arg("channel_order")), return_self<>())
+    .def("set_layout", &ci::ImagePipeline::SetLayout, (arg("layout")), return_self<>())
+    .def("normalize", +[](ci::ImagePipeline &self, const object &mean, const object &std) -> ci::ImagePipeline & {
+      return self.Normalize(MakeNormalizationValues(mean), MakeNormalizationValues(std));
+    }, (arg("mean"), arg("std")), return_self<>())
+    .def("get_output_shape", &GetImagePipelineOutputShape, (arg("width"), arg("height")))
+    .def("process", +[](const ci::ImagePipeline &self, const csd::Image &image, const object &output, size_t number_of_threads) {
+      const csd::Image *images[] = {&image};
+      RunImagePipeline(self, images, 1u, output, number_of_threads);
+    }, (arg("image"), arg("output"), arg("num_threads")=1u))
+    .def("process_batch", &ProcessImageBatch, (arg("images"), arg("output"), arg("num_threads")=0u))
+  ;
+
+  enum_<cs::AsyncWriter::QueueFullPolicy>("AsyncWriterQueueFullPolicy")
+    .value("Block", cs::AsyncWriter::QueueFullPolicy::Block)
+    .value("DropNewest", cs::AsyncWriter::QueueFullPolicy::DropNewest)
+    .value("DropOldest", cs::AsyncWriter::QueueFullPolicy::DropOldest)
+  ;
+
+  class_<cs::AsyncWriter, boost::noncopyable, boost::shared_ptr<cs::AsyncWriter>>("AsyncWriter", no_init)
+    .def("__init__", make_constructor(&MakeAsyncWriter, default_call_policies(), (
+        arg("worker_threads")=2u,
+        arg("max_queue_size")=32u,
+        arg("policy")=cs::AsyncWriter::QueueFullPolicy::Block)))
+    .add_property("pending_writes", &cs::AsyncWriter::GetPendingWrites)
+    .def("write", &AsyncWrite, (arg("data"), arg("path"), arg("color_converter")=EColorConverter::Raw))
+    .def("flush", +[](cs::AsyncWriter &self) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      self.Flush();
+    })
+    .def("flush", +[](cs::AsyncWriter &self, double seconds) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      return self.Flush(TimeDurationFromSeconds(seconds));
+    }, (arg("seconds")))
+    .def("get_statistics", &GetAsyncWriterStatistics)
+  ;
+
+  // Members of the packed entry are returned by value.
+  class_<cs::StreamLogEntry>("StreamLogEntry", no_init)
+    .add_property("sensor_id", +[](const cs::StreamLogEntry &self) -> uint64_t { return self.sensor_id; })
+    .add_property("frame", +[](const cs::StreamLogEntry &self) -> uint64_t { return self.frame; })
+    .add_property("segment", +[](const cs::StreamLogEntry &self) -> uint32_t { return self.segment; })
+    .add_property("offset", +[](const cs::StreamLogEntry &self) -> uint64_t { return self.offset; })
+    .add_property("size", +[](const cs::StreamLogEntry &self) -> uint64_t { return self.size; })
+  ;
+
+  class_<cs::StreamLogReader, boost::noncopyable, boost::shared_ptr<cs::StreamLogReader>>("StreamLogReader",
+      init<std::string>((arg("path"))))
+    .def("__len__", +[](const cs::StreamLogReader &self) { return self.GetEntries().size(); })
+    .def("get_entries", &GetStreamLogEntries, (arg("frame_begin")=0u, arg("frame_end")=~uint64_t(0u)))
+    .def("read", +[](const cs::StreamLogReader &self, const cs::StreamLogEntry &entry) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      return self.Deserialize(entry);
+    }, (arg("entry")))
+    .def("read_raw", +[](const object &self, const cs::StreamLogEntry &entry) {
+      const auto &reader = extract<const cs::StreamLogReader &>(self)();
+      return MakeArrayView(self, reader.GetData(entry), {static_cast<size_t>(entry.size)}, true);
+    }, (arg("entry")))
+    .def("replay", &ReplayStreamLog, (arg("callback"), arg("frame_begin")=0u, arg("frame_end")=~uint64_t(0u)))
+  ;
 }
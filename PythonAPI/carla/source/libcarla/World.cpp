@@ -52,8 +52,29 @@ static auto WaitForTick(const carla::client::World &world, double seconds) {
   return world.WaitForTick(TimeDurationFromSeconds(seconds));
 }
 
-static void OnTick(carla::client::World &self, boost::python::object callback) {
-  self.OnTick(MakeCallback(std::move(callback)));
+static auto TickAndWait(carla::client::World &world, double seconds, double spin_seconds) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return world.TickAndWait(TimeDurationFromSeconds(seconds), TimeDurationFromSeconds(spin_seconds));
+}
+
+static boost::python::object TickPipelined(
+    carla::client::World &world,
+    size_t max_outstanding_ticks,
+    double seconds,
+    double spin_seconds) {
+  boost::optional<uint64_t> frame;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    frame = world.TickPipelined(
+        max_outstanding_ticks,
+        TimeDurationFromSeconds(seconds),
+        TimeDurationFromSeconds(spin_seconds));
+  }
+  return frame.has_value() ? boost::python::object(*frame) : boost::python::object();
+}
+
+static size_t OnTick(carla::client::World &self, boost::python::object callback) {
+  return self.OnTick(MakeCallback(std::move(callback)));
 }
 
 static auto GetActorsById(carla::client::World &self, const boost::python::list &actor_ids) {
@@ -131,7 +152,11 @@ void export_world() {
     .def("try_spawn_actor", SPAWN_ACTOR_WITHOUT_GIL(TrySpawnActor))
     .def("wait_for_tick", &WaitForTick, (arg("seconds")=10.0))
     .def("on_tick", &OnTick, (arg("callback")))
+    .def("remove_on_tick", CALL_WITHOUT_GIL_1(cc::World, RemoveOnTick, size_t), (arg("callback_id")))
+    .def("set_on_tick_worker_threads", CALL_WITHOUT_GIL_1(cc::World, SetOnTickWorkerThreads, size_t), (arg("count")))
     .def("tick", &cc::World::Tick)
+    .def("tick_and_wait", &TickAndWait, (arg("seconds")=10.0, arg("spin_seconds")=0.0))
+    .def("tick_pipelined", &TickPipelined, (arg("max_outstanding_ticks"), arg("seconds")=10.0, arg("spin_seconds")=0.0))
     .def(self_ns::str(self_ns::self))
   ;
 
@@ -4,10 +4,16 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include <carla/Debug.h>
 #include <carla/Memory.h>
 #include <carla/PythonUtil.h>
 #include <carla/Time.h>
 
+#include <boost/python/stl_iterator.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <ostream>
 #include <type_traits>
 #include <vector>
@@ -154,6 +160,309 @@ static auto MakeCallback(boost::python::object callback) {
   };
 }
 
+namespace python_array_detail {
+
+  template <typename T, typename U>
+  static void CopyAs(const void *data, size_t count, std::vector<T> &result) {
+    const auto *begin = reinterpret_cast<const U *>(data);
+    result.reserve(result.size() + count);
+    for (auto i = 0u; i < count; ++i) {
+      result.emplace_back(static_cast<T>(begin[i]));
+    }
+  }
+
+  /// Releases a Py_buffer on destruction.
+  class BufferGuard : private carla::NonCopyable {
+  public:
+
+    explicit BufferGuard(Py_buffer &view) : _view(view) {}
+
+    ~BufferGuard() {
+      PyBuffer_Release(&_view);
+    }
+
+  private:
+
+    Py_buffer &_view;
+  };
+
+} // namespace python_array_detail
+
+/// Copies the numbers in @a obj into a contiguous vector of T, casting each
+/// element to T. @a obj may be any object exposing the buffer protocol (e.g.
+/// a numpy array) or any Python iterable of numbers.
+///
+/// If @a columns is not null, it is set to the size of the last dimension of
+/// @a obj when this is a two-dimensional buffer, or to 1 otherwise. Buffers
+/// of more than two dimensions are rejected.
+template <typename T>
+static std::vector<T> MakeVectorFromPython(
+    const boost::python::object &obj,
+    size_t *columns = nullptr) {
+  namespace py = boost::python;
+  namespace pad = python_array_detail;
+  std::vector<T> result;
+  if (columns != nullptr) {
+    *columns = 1u;
+  }
+  if (!PyObject_CheckBuffer(obj.ptr())) {
+    py::stl_input_iterator<T> begin(obj), end;
+    result.assign(begin, end);
+    return result;
+  }
+  Py_buffer view;
+  if (PyObject_GetBuffer(obj.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+    py::throw_error_already_set();
+  }
+  pad::BufferGuard guard(view);
+  if (view.ndim > 2) {
+    PyErr_SetString(PyExc_ValueError, "expected an array of one or two dimensions");
+    py::throw_error_already_set();
+  }
+  if ((columns != nullptr) && (view.ndim == 2)) {
+    *columns = static_cast<size_t>(view.shape[1]);
+  }
+  const size_t count = static_cast<size_t>(view.len / view.itemsize);
+  const char *format = view.format != nullptr ? view.format : "B";
+  if ((*format == '@') || (*format == '=') || (*format == '<')) {
+    ++format;
+  }
+  switch (*format) {
+    case 'b': pad::CopyAs<T, int8_t>(view.buf, count, result); break;
+    case 'B': pad::CopyAs<T, uint8_t>(view.buf, count, result); break;
+    case '?': pad::CopyAs<T, bool>(view.buf, count, result); break;
+    case 'h': pad::CopyAs<T, int16_t>(view.buf, count, result); break;
+    case 'H': pad::CopyAs<T, uint16_t>(view.buf, count, result); break;
+    case 'i': pad::CopyAs<T, int32_t>(view.buf, count, result); break;
+    case 'I': pad::CopyAs<T, uint32_t>(view.buf, count, result); break;
+    case 'l': pad::CopyAs<T, long>(view.buf, count, result); break;
+    case 'L': pad::CopyAs<T, unsigned long>(view.buf, count, result); break;
+    case 'q': pad::CopyAs<T, int64_t>(view.buf, count, result); break;
+    case 'Q': pad::CopyAs<T, uint64_t>(view.buf, count, result); break;
+    case 'f': pad::CopyAs<T, float>(view.buf, count, result); break;
+    case 'd': pad::CopyAs<T, double>(view.buf, count, result); break;
+    default:
+      PyErr_SetString(PyExc_TypeError, "unsupported array data type");
+      py::throw_error_already_set();
+  }
+  return result;
+}
+
+namespace python_array_detail {
+
+  template <typename T>
+  struct BufferFormat;
+
+  template <>
+  struct BufferFormat<float> {
+    static constexpr char value = 'f';
+  };
+
+  template <>
+  struct BufferFormat<uint8_t> {
+    static constexpr char value = 'B';
+  };
+
+  template <>
+  struct BufferFormat<int32_t> {
+    static constexpr char value = 'i';
+  };
+
+  template <>
+  struct BufferFormat<uint32_t> {
+    static constexpr char value = 'I';
+  };
+
+  template <>
+  struct BufferFormat<uint64_t> {
+    static constexpr char value = 'Q';
+  };
+
+  template <>
+  struct BufferFormat<double> {
+    static constexpr char value = 'd';
+  };
+
+} // namespace python_array_detail
+
+/// Writable view of a C-contiguous Python buffer of T (e.g. a numpy array of
+/// the matching dtype), used to write results directly into memory owned by
+/// the caller. The buffer is released on destruction.
+template <typename T>
+class WritablePythonBuffer : private carla::NonCopyable {
+public:
+
+  explicit WritablePythonBuffer(const boost::python::object &obj) {
+    namespace py = boost::python;
+    if (PyObject_GetBuffer(obj.ptr(), &_view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      py::throw_error_already_set();
+    }
+    const char *format = _view.format != nullptr ? _view.format : "B";
+    if ((*format == '@') || (*format == '=') || (*format == '<')) {
+      ++format;
+    }
+    if ((_view.itemsize != sizeof(T)) || (*format != python_array_detail::BufferFormat<T>::value)) {
+      PyBuffer_Release(&_view);
+      PyErr_SetString(PyExc_TypeError, "unexpected array data type");
+      py::throw_error_already_set();
+    }
+  }
+
+  ~WritablePythonBuffer() {
+    PyBuffer_Release(&_view);
+  }
+
+  T *data() {
+    return reinterpret_cast<T *>(_view.buf);
+  }
+
+  /// Number of elements of type T.
+  size_t size() const {
+    return static_cast<size_t>(_view.len) / sizeof(T);
+  }
+
+private:
+
+  Py_buffer _view;
+};
+
+namespace python_array_detail {
+
+  /// Python object exporting a typed N-dimensional buffer over memory owned
+  /// by another Python object, which is kept alive while the buffer exists.
+  struct ArrayExporter {
+    PyObject_HEAD
+    PyObject *owner;
+    void *data;
+    int readonly;
+    int ndim;
+    Py_ssize_t itemsize;
+    Py_ssize_t shape[3];
+    Py_ssize_t strides[3];
+    char format[2];
+  };
+
+  static int ArrayExporterGetBuffer(PyObject *obj, Py_buffer *view, int flags) {
+    auto *self = reinterpret_cast<ArrayExporter *>(obj);
+    Py_ssize_t length = self->itemsize;
+    for (auto i = 0; i < self->ndim; ++i) {
+      length *= self->shape[i];
+    }
+    if (PyBuffer_FillInfo(view, obj, self->data, length, self->readonly, flags) != 0) {
+      return -1;
+    }
+    view->itemsize = self->itemsize;
+    if ((flags & PyBUF_FORMAT) == PyBUF_FORMAT) {
+      view->format = self->format;
+    }
+    if ((flags & PyBUF_ND) == PyBUF_ND) {
+      view->ndim = self->ndim;
+      view->shape = self->shape;
+    }
+    if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) {
+      view->strides = self->strides;
+    }
+    return 0;
+  }
+
+  static void ArrayExporterDealloc(PyObject *obj) {
+    Py_XDECREF(reinterpret_cast<ArrayExporter *>(obj)->owner);
+    Py_TYPE(obj)->tp_free(obj);
+  }
+
+  /// Called with the GIL held. The type is filled in place, once ready Python
+  /// keeps pointers to it (e.g. in its MRO) so it must never be copied.
+  static PyTypeObject *GetArrayExporterType() {
+    static PyBufferProcs buffer_procs;
+    static PyTypeObject type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+    if (type.tp_name == nullptr) {
+      buffer_procs.bf_getbuffer = &ArrayExporterGetBuffer;
+      type.tp_name = "carla.libcarla.ArrayExporter";
+      type.tp_basicsize = sizeof(ArrayExporter);
+      type.tp_dealloc = &ArrayExporterDealloc;
+      type.tp_as_buffer = &buffer_procs;
+#if PY_MAJOR_VERSION >= 3 // NOTE(Andrei): python 3
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+#else        // NOTE(Andrei): python 2
+      type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+    }
+    // Does nothing once the type is ready.
+    if (PyType_Ready(&type) != 0) {
+      boost::python::throw_error_already_set();
+    }
+    return &type;
+  }
+
+} // namespace python_array_detail
+
+/// Make a memoryview of @a shape elements of type T, C-contiguous, sharing
+/// the memory pointed by @a data. The memory must be owned by @a owner, which
+/// is kept alive as long as the memoryview, or any array created from it,
+/// exists. Convert it to a numpy array without copying with
+/// `numpy.asarray(view)`.
+template <typename T>
+static boost::python::object MakeArrayView(
+    const boost::python::object &owner,
+    T *data,
+    std::initializer_list<size_t> shape,
+    bool readonly = false) {
+  namespace pad = python_array_detail;
+  DEBUG_ASSERT(shape.size() > 0u && shape.size() <= 3u);
+  auto *exporter = PyObject_New(pad::ArrayExporter, pad::GetArrayExporterType());
+  if (exporter == nullptr) {
+    boost::python::throw_error_already_set();
+  }
+  Py_INCREF(owner.ptr());
+  exporter->owner = owner.ptr();
+  exporter->data = const_cast<typename std::remove_const<T>::type *>(data);
+  exporter->readonly = readonly ? 1 : 0;
+  exporter->ndim = static_cast<int>(shape.size());
+  exporter->itemsize = sizeof(T);
+  exporter->format[0u] = pad::BufferFormat<typename std::remove_const<T>::type>::value;
+  exporter->format[1u] = '\0';
+  auto i = 0u;
+  for (auto extent : shape) {
+    exporter->shape[i++] = static_cast<Py_ssize_t>(extent);
+  }
+  Py_ssize_t stride = sizeof(T);
+  for (auto j = exporter->ndim - 1; j >= 0; --j) {
+    exporter->strides[j] = stride;
+    stride *= exporter->shape[j];
+  }
+  boost::python::handle<> handle(reinterpret_cast<PyObject *>(exporter));
+  return boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(handle.get())));
+}
+
+/// Copy @a data into a new Python bytearray and return an array view of it
+/// with the given @a shape, for results computed in C++ that Python owns.
+template <typename T>
+static boost::python::object MakeArrayCopy(const T *data, std::initializer_list<size_t> shape) {
+  size_t count = 1u;
+  for (auto extent : shape) {
+    count *= extent;
+  }
+  boost::python::object bytes(boost::python::handle<>(PyByteArray_FromStringAndSize(
+      reinterpret_cast<const char *>(data),
+      static_cast<Py_ssize_t>(sizeof(T) * count))));
+  return MakeArrayView(bytes, reinterpret_cast<T *>(PyByteArray_AsString(bytes.ptr())), shape);
+}
+
+/// Data type of the elements of the buffer exposed by @a obj, as a struct
+/// module format character (e.g. 'f' for float32).
+static char GetBufferFormat(const boost::python::object &obj) {
+  Py_buffer view;
+  if (PyObject_GetBuffer(obj.ptr(), &view, PyBUF_FORMAT) != 0) {
+    boost::python::throw_error_already_set();
+  }
+  python_array_detail::BufferGuard guard(view);
+  const char *format = view.format != nullptr ? view.format : "B";
+  if ((*format == '@') || (*format == '=') || (*format == '<')) {
+    ++format;
+  }
+  return *format;
+}
+
 #include "Geom.cpp"
 #include "Actor.cpp"
 #include "Blueprint.cpp"
@@ -161,6 +470,7 @@ static auto MakeCallback(boost::python::object callback) {
 #include "Control.cpp"
 #include "Exception.cpp"
 #include "Map.cpp"
+#include "Recorder.cpp"
 #include "Sensor.cpp"
 #include "SensorData.cpp"
 #include "Weather.cpp"
@@ -180,6 +490,7 @@ BOOST_PYTHON_MODULE(libcarla) {
   export_weather();
   export_world();
   export_map();
+  export_recorder();
   export_client();
   export_exception();
   export_commands();
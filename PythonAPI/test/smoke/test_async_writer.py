@@ -0,0 +1,52 @@
+# Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+from . import SmokeTest
+
+import carla
+
+import os
+import shutil
+import tempfile
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
+
+
+class TestAsyncWriter(SmokeTest):
+    def setUp(self):
+        super(TestAsyncWriter, self).setUp()
+        self.world = self.client.get_world()
+        self.folder = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.folder)
+        self.world = None
+        super(TestAsyncWriter, self).tearDown()
+
+    def test_drop_writer_with_pending_writes(self):
+        cam_bp = self.world.get_blueprint_library().find('sensor.camera.rgb')
+        t = carla.Transform(carla.Location(z=10))
+        camera = self.world.spawn_actor(cam_bp, t)
+        try:
+            image_queue = queue.Queue()
+            camera.listen(image_queue.put)
+            image = image_queue.get(timeout=10.0)
+        finally:
+            camera.destroy()
+
+        paths = [os.path.join(self.folder, '%d.png' % i) for i in range(0, 20)]
+        writer = carla.AsyncWriter(worker_threads=1, max_queue_size=len(paths))
+        for path in paths:
+            self.assertTrue(writer.write(image, path))
+        self.assertGreater(writer.pending_writes, 0)
+        # The writer finishes its pending writes on destruction.
+        del writer
+        image = None
+        for path in paths:
+            self.assertTrue(os.path.exists(path))
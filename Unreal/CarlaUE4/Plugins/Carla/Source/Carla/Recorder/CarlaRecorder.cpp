@@ -9,6 +9,10 @@
 #include "CarlaReplayerHelper.h"
 #include "Carla/Actor/ActorDescription.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/rpc/String.h>
+#include <compiler/enable-ue4-macros.h>
+
 #include <ctime>
 #include <sstream>
 
@@ -141,26 +145,25 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName)
   // get the final path + filename
   std::string Filename = GetRecorderFilename(Name);
 
-  // binary file
-  // file.open(filename.str(), std::ios::binary | std::ios::trunc |
-  // std::ios::out);
-  File.open(Filename, std::ios::binary);
-  if (!File.is_open())
+  // general info
+  carla::recorder::Info Info;
+  Info.version = carla::recorder::CompactPositionsVersion;
+  Info.magic = "CARLA_RECORDER";
+  Info.date = std::time(0);
+  Info.map_file = carla::rpc::FromFString(MapName);
+
+  // positions as quantized deltas against the previous frame, compressed
+  carla::recorder::PositionEncoding Encoding;
+  Encoding.compact = true;
+  Encoding.location_precision = PositionPrecision;
+  Encoding.rotation_precision = RotationPrecision;
+
+  // binary file, written in a background thread
+  if (!Writer.Start(Filename, Info, Encoding))
   {
     return "";
   }
 
-  // save info
-  Info.Version = 1;
-  Info.Magic = TEXT("CARLA_RECORDER");
-  Info.Date = std::time(0);
-  Info.Mapfile = MapName;
-
-  // write general info
-  Info.Write(File);
-
-  Frames.Reset();
-
   Enable();
 
   // add all existing actors
@@ -173,51 +176,29 @@ void ACarlaRecorder::Stop(void)
 {
   Disable();
 
-  if (File)
-  {
-    File.close();
-  }
-
-  Clear();
+  // write the pending frames and close the file
+  Writer.Stop();
 }
 
 void ACarlaRecorder::Clear(void)
 {
-  EventsAdd.Clear();
-  EventsDel.Clear();
-  EventsParent.Clear();
-  Collisions.Clear();
-  Positions.Clear();
-  States.Clear();
+  Writer.Clear();
 }
 
 void ACarlaRecorder::Write(double DeltaSeconds)
 {
-  // update this frame data
-  Frames.SetFrame(DeltaSeconds);
-
-  // start
-  Frames.WriteStart(File);
-
-  // write data
-  EventsAdd.Write(File);
-  EventsDel.Write(File);
-  EventsParent.Write(File);
-  Collisions.Write(File);
-  Positions.Write(File);
-  States.Write(File);
-
-  // end
-  Frames.WriteEnd(File);
-
-  Clear();
+  // serialize this frame, the file is written when enough data is pending
+  Writer.EndFrame(DeltaSeconds);
 }
 
 void ACarlaRecorder::AddPosition(const CarlaRecorderPosition &Position)
 {
   if (Enabled)
   {
-    Positions.Add(Position);
+    Writer.Add(carla::recorder::Position{
+        Position.DatabaseId,
+        Position.Location,
+        Position.Rotation});
   }
 }
 
@@ -225,7 +206,12 @@ void ACarlaRecorder::AddEvent(const CarlaRecorderEventAdd &Event)
 {
   if (Enabled)
   {
-    EventsAdd.Add(std::move(Event));
+    Writer.Add(carla::recorder::EventAdd{
+        Event.DatabaseId,
+        Event.Type,
+        Event.Location,
+        Event.Rotation,
+        ToRecorder(Event.Description)});
   }
 }
 
@@ -233,7 +219,7 @@ void ACarlaRecorder::AddEvent(const CarlaRecorderEventDel &Event)
 {
   if (Enabled)
   {
-    EventsDel.Add(std::move(Event));
+    Writer.Add(carla::recorder::EventDel{Event.DatabaseId});
   }
 }
 
@@ -241,7 +227,7 @@ void ACarlaRecorder::AddEvent(const CarlaRecorderEventParent &Event)
 {
   if (Enabled)
   {
-    EventsParent.Add(std::move(Event));
+    Writer.Add(carla::recorder::EventParent{Event.DatabaseId, Event.DatabaseIdParent});
   }
 }
 
@@ -274,7 +260,12 @@ void ACarlaRecorder::AddCollision(AActor *Actor1, AActor *Actor2)
     }
     Collision.DatabaseId2 = Episode->GetActorRegistry().Find(Actor2).GetActorId();
 
-    Collisions.Add(std::move(Collision));
+    Writer.Add(carla::recorder::Collision{
+        Collision.Id,
+        Collision.DatabaseId1,
+        Collision.DatabaseId2,
+        Collision.IsActor1Hero,
+        Collision.IsActor2Hero});
   }
 }
 
@@ -282,7 +273,11 @@ void ACarlaRecorder::AddState(const CarlaRecorderStateTrafficLight &State)
 {
   if (Enabled)
   {
-    States.Add(State);
+    Writer.Add(carla::recorder::StateTrafficLight{
+        State.DatabaseId,
+        State.IsFrozen,
+        State.ElapsedTime,
+        State.State});
   }
 }
 
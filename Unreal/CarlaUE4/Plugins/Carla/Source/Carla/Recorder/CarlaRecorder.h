@@ -8,8 +8,6 @@
 
 // #include "GameFramework/Actor.h"
 #include <fstream>
-#include "CarlaRecorderInfo.h"
-#include "CarlaRecorderFrames.h"
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
@@ -20,22 +18,16 @@
 #include "CarlaReplayer.h"
 #include "Carla/Actor/ActorDescription.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/Recorder.h>
+#include <compiler/enable-ue4-macros.h>
+
 #include "CarlaRecorder.generated.h"
 
 class AActor;
 class UCarlaEpisode;
 
-enum class CarlaRecorderPacketId : uint8_t
-{
-  FrameStart = 0,
-  FrameEnd,
-  EventAdd,
-  EventDel,
-  EventParent,
-  Collision,
-  Position,
-  State
-};
+using CarlaRecorderPacketId = carla::recorder::PacketId;
 
 /// Recorder for the simulation
 UCLASS()
@@ -113,20 +105,19 @@ private:
 
   uint32_t NextCollisionId = 0;
 
-  // files
-  std::ofstream File;
-
   UCarlaEpisode *Episode = nullptr;
 
-  // structures
-  CarlaRecorderInfo Info;
-  CarlaRecorderFrames Frames;
-  CarlaRecorderEventsAdd EventsAdd;
-  CarlaRecorderEventsDel EventsDel;
-  CarlaRecorderEventsParent EventsParent;
-  CarlaRecorderCollisions Collisions;
-  CarlaRecorderPositions Positions;
-  CarlaRecorderStates States;
+  // quantization step of the recorded locations (cm)
+  UPROPERTY(Category = "CARLA Recorder", EditAnywhere, meta = (ClampMin = "0.001"))
+  float PositionPrecision = 0.1f;
+
+  // quantization step of the recorded rotations (degrees)
+  UPROPERTY(Category = "CARLA Recorder", EditAnywhere, meta = (ClampMin = "0.0001"))
+  float RotationPrecision = 0.01f;
+
+  // serializes the packets of each frame, the file is written in a
+  // background thread
+  carla::recorder::Recorder Writer;
 
   // replayer
   CarlaReplayer Replayer;
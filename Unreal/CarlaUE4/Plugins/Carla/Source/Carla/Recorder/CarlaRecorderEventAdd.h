@@ -6,9 +6,12 @@
 
 #pragma once
 
-#include <fstream>
 #include <vector>
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/Packets.h>
+#include <compiler/enable-ue4-macros.h>
+
 struct CarlaRecorderActorAttribute
 {
     uint8_t Type;       // EActorAttributeType
@@ -30,19 +33,9 @@ struct CarlaRecorderEventAdd
     FVector Location;
     FVector Rotation;
     CarlaRecorderActorDescription Description;
-
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
 };
 
-class CarlaRecorderEventsAdd
-{
+// conversion from and to the description stored in the recorder files
+carla::recorder::ActorDescription ToRecorder(const CarlaRecorderActorDescription &Description);
 
-    public:
-    void Add(const CarlaRecorderEventAdd &Event);
-    void Clear(void);
-    void Write(std::ofstream &OutFile);
-
-    private:
-    std::vector<CarlaRecorderEventAdd> Events;
-};
+CarlaRecorderActorDescription FromRecorder(const carla::recorder::ActorDescription &Description);
@@ -6,25 +6,9 @@
 
 #pragma once
 
-#include <fstream>
-#include <vector>
+#include <cstdint>
 
 struct CarlaRecorderEventDel
 {
     uint32_t DatabaseId;
-
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
-};
-
-class CarlaRecorderEventsDel
-{
-
-    public:
-    void Add(const CarlaRecorderEventDel &Event);
-    void Clear(void);
-    void Write(std::ofstream &OutFile);
-
-    private:
-    std::vector<CarlaRecorderEventDel> Events;
 };
@@ -6,26 +6,10 @@
 
 #pragma once
 
-#include <fstream>
-#include <vector>
+#include <cstdint>
 
 struct CarlaRecorderEventParent
 {
     uint32_t DatabaseId;
     uint32_t DatabaseIdParent;
-
-    void Read(std::ifstream &InFile);
-    void Write(std::ofstream &OutFile) const;
-};
-
-class CarlaRecorderEventsParent
-{
-
-    public:
-    void Add(const CarlaRecorderEventParent &Event);
-    void Clear(void);
-    void Write(std::ofstream &OutFile);
-
-    private:
-    std::vector<CarlaRecorderEventParent> Events;
 };
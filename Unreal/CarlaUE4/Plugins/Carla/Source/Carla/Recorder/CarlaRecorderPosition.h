@@ -6,8 +6,9 @@
 
 #pragma once
 
-#include <fstream>
-#include <vector>
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/Packets.h>
+#include <compiler/enable-ue4-macros.h>
 
 #pragma pack(push, 1)
 struct CarlaRecorderPosition
@@ -15,25 +16,8 @@ struct CarlaRecorderPosition
   uint32_t DatabaseId;
   FVector Location;
   FVector Rotation;
-
-  void Read(std::ifstream &InFile);
-
-  void Write(std::ofstream &OutFile);
-
 };
 #pragma pack(pop)
 
-class CarlaRecorderPositions
-{
-public:
-
-  void Add(const CarlaRecorderPosition &InObj);
-
-  void Clear(void);
-
-  void Write(std::ofstream &OutFile);
-
-private:
-
-  std::vector<CarlaRecorderPosition> Positions;
-};
+// conversion from the position stored in the recorder files
+CarlaRecorderPosition FromRecorder(const carla::recorder::Position &Position);
@@ -4,45 +4,37 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include "CarlaRecorder.h"
 #include "CarlaRecorderHelpers.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/rpc/String.h>
+#include <compiler/enable-ue4-macros.h>
+
 #include <ctime>
+#include <iomanip>
+#include <map>
 #include <sstream>
-
-inline bool CarlaRecorderQuery::ReadHeader(void)
-{
-  if (File.eof())
-  {
-    return false;
-  }
-
-  ReadValue<char>(File, Header.Id);
-  ReadValue<uint32_t>(File, Header.Size);
-
-  return true;
-}
-
-inline void CarlaRecorderQuery::SkipPacket(void)
-{
-  File.seekg(Header.Size, std::ios::cur);
-}
+#include <unordered_map>
+#include <unordered_set>
 
 inline bool CarlaRecorderQuery::CheckFileInfo(std::stringstream &Info)
 {
   // read Info
-  RecInfo.Read(File);
-
-  // check magic string
-  if (RecInfo.Magic != "CARLA_RECORDER")
+  PositionDecoder.Reset();
+  if (!Reader.ReadInfo(File, RecInfo) || RecInfo.magic != "CARLA_RECORDER")
   {
+    // check magic string
     Info << "File is not a CARLA recorder" << std::endl;
+    File.close();
     return false;
   }
 
   // show general Info
-  Info << "Version: " << RecInfo.Version << std::endl;
-  Info << "Map: " << TCHAR_TO_UTF8(*RecInfo.Mapfile) << std::endl;
-  tm *TimeInfo = localtime(&RecInfo.Date);
+  Info << "Version: " << RecInfo.version << std::endl;
+  Info << "Map: " << RecInfo.map_file << std::endl;
+  std::time_t Date = static_cast<std::time_t>(RecInfo.date);
+  tm *TimeInfo = localtime(&Date);
   char DateStr[100];
   strftime(DateStr, sizeof(DateStr), "%x %X", TimeInfo);
   Info << "Date: " << DateStr << std::endl << std::endl;
@@ -65,35 +57,42 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
     return Info.str();
   }
 
-  uint16_t i, Total;
   bool bFramePrinted = false;
 
   // lambda for repeating task
   auto PrintFrame = [this](std::stringstream &Info)
   {
-    Info << "Frame " << Frame.Id << " at " << Frame.Elapsed << " seconds\n";
-    // Info << "Frame " << Frame.Id << " at " << Frame.Elapsed << " seconds (offset 0x" << std::hex << File.tellg() << std::dec << ")\n";
+    Info << "Frame " << Frame.id << " at " << Frame.elapsed << " seconds\n";
+    // Info << "Frame " << Frame.id << " at " << Frame.elapsed << " seconds (offset 0x" << std::hex << File.tellg() << std::dec << ")\n";
+  };
+
+  // lambda to show the positions of a packet, plain or compact
+  auto PrintPositions = [&](const std::vector<carla::recorder::Position> &Records)
+  {
+    if (Records.size() > 0 && !bFramePrinted)
+    {
+      PrintFrame(Info);
+      bFramePrinted = true;
+    }
+    Info << " Positions: " << Records.size() << std::endl;
+    for (const auto &Position : Records)
+    {
+      Info << "  Id: " << Position.database_id << " Location (" << Position.location.x << ", " << Position.location.y << ", " << Position.location.z << ") Rotation (" <<  Position.rotation.x << ", " << Position.rotation.y << ", " << Position.rotation.z << ")" << std::endl;
+    }
   };
 
   if (!CheckFileInfo(Info))
     return Info.str();
 
   // parse only frames
-  while (File)
+  while (Reader.ReadHeader(File))
   {
-
-    // get header
-    if (!ReadHeader())
-    {
-      break;
-    }
-
     // check for a frame packet
-    switch (Header.Id)
+    switch (Reader.GetPacketId())
     {
       // frame
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
+      case CarlaRecorderPacketId::FrameStart:
+        Reader.Read(File, Frame);
         if (bShowAll)
         {
           PrintFrame(Info);
@@ -104,136 +103,136 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
         break;
 
       // events add
-      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
-        ReadValue<uint16_t>(File, Total);
-        if (Total > 0 && !bFramePrinted)
+      case CarlaRecorderPacketId::EventAdd:
+        Reader.ReadList(File, EventsAdd);
+        if (EventsAdd.size() > 0 && !bFramePrinted)
         {
           PrintFrame(Info);
           bFramePrinted = true;
         }
-        for (i = 0; i < Total; ++i)
+        for (const auto &EventAdd : EventsAdd)
         {
           // add
-          EventAdd.Read(File);
-          Info << " Create " << EventAdd.DatabaseId << ": " << TCHAR_TO_UTF8(*EventAdd.Description.Id) <<
+          Info << " Create " << EventAdd.database_id << ": " << EventAdd.description.id <<
             " (" <<
-            static_cast<int>(EventAdd.Type) << ") at (" << EventAdd.Location.X << ", " <<
-            EventAdd.Location.Y << ", " << EventAdd.Location.Z << ")" << std::endl;
-          for (auto &Att : EventAdd.Description.Attributes)
+            static_cast<int>(EventAdd.type) << ") at (" << EventAdd.location.x << ", " <<
+            EventAdd.location.y << ", " << EventAdd.location.z << ")" << std::endl;
+          for (const auto &Att : EventAdd.description.attributes)
           {
-            Info << "  " << TCHAR_TO_UTF8(*Att.Id) << " = " << TCHAR_TO_UTF8(*Att.Value) << std::endl;
+            Info << "  " << Att.id << " = " << Att.value << std::endl;
           }
         }
         break;
 
       // events del
-      case static_cast<char>(CarlaRecorderPacketId::EventDel):
-        ReadValue<uint16_t>(File, Total);
-        if (Total > 0 && !bFramePrinted)
+      case CarlaRecorderPacketId::EventDel:
+        Reader.ReadList(File, EventsDel);
+        if (EventsDel.size() > 0 && !bFramePrinted)
         {
           PrintFrame(Info);
           bFramePrinted = true;
         }
-        for (i = 0; i < Total; ++i)
+        for (const auto &EventDel : EventsDel)
         {
-          EventDel.Read(File);
-          Info << " Destroy " << EventDel.DatabaseId << "\n";
+          Info << " Destroy " << EventDel.database_id << "\n";
         }
         break;
 
       // events parenting
-      case static_cast<char>(CarlaRecorderPacketId::EventParent):
-        ReadValue<uint16_t>(File, Total);
-        if (Total > 0 && !bFramePrinted)
+      case CarlaRecorderPacketId::EventParent:
+        Reader.ReadList(File, EventsParent);
+        if (EventsParent.size() > 0 && !bFramePrinted)
         {
           PrintFrame(Info);
           bFramePrinted = true;
         }
-        for (i = 0; i < Total; ++i)
+        for (const auto &EventParent : EventsParent)
         {
-          EventParent.Read(File);
-          Info << " Parenting " << EventParent.DatabaseId << " with " << EventParent.DatabaseId <<
+          Info << " Parenting " << EventParent.database_id << " with " << EventParent.database_id_parent <<
             " (parent)\n";
         }
         break;
 
       // collisions
-      case static_cast<char>(CarlaRecorderPacketId::Collision):
-        ReadValue<uint16_t>(File, Total);
-        if (Total > 0 && !bFramePrinted)
+      case CarlaRecorderPacketId::Collision:
+        Reader.ReadList(File, Collisions);
+        if (Collisions.size() > 0 && !bFramePrinted)
         {
           PrintFrame(Info);
           bFramePrinted = true;
         }
-        for (i = 0; i < Total; ++i)
+        for (const auto &Collision : Collisions)
         {
-          Collision.Read(File);
-          Info << " Collision id " << Collision.Id << " between " << Collision.DatabaseId1;
-          if (Collision.IsActor1Hero)
+          Info << " Collision id " << Collision.id << " between " << Collision.database_id1;
+          if (Collision.is_actor1_hero)
             Info << " (hero) ";
-          Info << " with " << Collision.DatabaseId2;
-          if (Collision.IsActor2Hero)
+          Info << " with " << Collision.database_id2;
+          if (Collision.is_actor2_hero)
             Info << " (hero) ";
           Info << std::endl;
         }
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::Position):
+      case CarlaRecorderPacketId::Position:
         if (bShowAll)
         {
-          ReadValue<uint16_t>(File, Total);
-          if (Total > 0 && !bFramePrinted)
-          {
-            PrintFrame(Info);
-            bFramePrinted = true;
-          }
-          Info << " Positions: " << Total << std::endl;
-          for (i = 0; i < Total; ++i)
-          {
-            Position.Read(File);
-            Info << "  Id: " << Position.DatabaseId << " Location (" << Position.Location.X << ", " << Position.Location.Y << ", " << Position.Location.Z << ") Rotation (" <<  Position.Rotation.X << ", " << Position.Rotation.Y << ", " << Position.Rotation.Z << ")" << std::endl;
-          }
+          Reader.ReadList(File, Positions);
+          PrintPositions(Positions);
         }
         else
-          SkipPacket();
+          Reader.SkipPacket(File);
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::State):
+      case CarlaRecorderPacketId::PositionCompact:
         if (bShowAll)
         {
-          ReadValue<uint16_t>(File, Total);
-          if (Total > 0 && !bFramePrinted)
+          PositionDecoder.Decode(File, Reader.GetPacketSize());
+          PrintPositions(PositionDecoder.GetPositions());
+        }
+        else
+          Reader.SkipPacket(File);
+        break;
+
+      case CarlaRecorderPacketId::State:
+        if (bShowAll)
+        {
+          Reader.ReadList(File, StatesTraffic);
+          if (StatesTraffic.size() > 0 && !bFramePrinted)
           {
             PrintFrame(Info);
             bFramePrinted = true;
           }
-          Info << " State traffic lights: " << Total << std::endl;
-          for (i = 0; i < Total; ++i)
+          Info << " State traffic lights: " << StatesTraffic.size() << std::endl;
+          for (const auto &StateTraffic : StatesTraffic)
           {
-            StateTraffic.Read(File);
-            Info << "  Id: " << StateTraffic.DatabaseId << " state: " << static_cast<char>(0x30 + StateTraffic.State) << " frozen: " <<
-              StateTraffic.IsFrozen << " elapsedTime: " << StateTraffic.ElapsedTime << std::endl;
+            Info << "  Id: " << StateTraffic.database_id << " state: " << static_cast<char>(0x30 + StateTraffic.state) << " frozen: " <<
+              StateTraffic.is_frozen << " elapsedTime: " << StateTraffic.elapsed_time << std::endl;
           }
         }
         else
-          SkipPacket();
+          Reader.SkipPacket(File);
         break;
 
       // frame end
-      case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+      case CarlaRecorderPacketId::FrameEnd:
         // do nothing, it is empty
         break;
 
+      // frame index at the end of the file
+      case CarlaRecorderPacketId::FrameIndex:
+        Reader.SkipPacket(File);
+        break;
+
       default:
         // skip packet
-        Info << "Unknown packet id: " << Header.Id << " at offset " << File.tellg() << std::endl;
-        SkipPacket();
+        Info << "Unknown packet id: " << static_cast<int>(Reader.GetPacketId()) << " at offset " << File.tellg() << std::endl;
+        Reader.SkipPacket(File);
         break;
     }
   }
 
-  Info << "\nFrames: " << Frame.Id << "\n";
-  Info << "Duration: " << Frame.Elapsed << " seconds\n";
+  Info << "\nFrames: " << Frame.id << "\n";
+  Info << "Duration: " << Frame.elapsed << " seconds\n";
 
   File.close();
 
@@ -260,11 +259,10 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
 
   // other, vehicle, walkers, trafficLight, hero, any
   char Categories[] = { 'o', 'v', 'w', 't', 'h', 'a' };
-  uint16_t i, Total;
   struct ReplayerActorInfo
   {
     uint8_t Type;
-    FString Id;
+    std::string Id;
   };
   std::unordered_map<uint32_t, ReplayerActorInfo> Actors;
   struct PairHash
@@ -289,70 +287,60 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
   Info << std::endl;
 
   // parse only frames
-  while (File)
+  while (Reader.ReadHeader(File))
   {
-
-    // get header
-    if (!ReadHeader())
-    {
-      break;
-    }
-
     // check for a frame packet
-    switch (Header.Id)
+    switch (Reader.GetPacketId())
     {
       // frame
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
+      case CarlaRecorderPacketId::FrameStart:
+        Reader.Read(File, Frame);
         // exchange sets of collisions (to know when a collision is new or continue from previous frame)
         oldCollisions = std::move(newCollisions);
         newCollisions.clear();
         break;
 
       // events add
-      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
-        ReadValue<uint16_t>(File, Total);
-        for (i = 0; i < Total; ++i)
+      case CarlaRecorderPacketId::EventAdd:
+        Reader.ReadList(File, EventsAdd);
+        for (const auto &EventAdd : EventsAdd)
         {
           // add
-          EventAdd.Read(File);
-          Actors[EventAdd.DatabaseId] = ReplayerActorInfo { EventAdd.Type, EventAdd.Description.Id };
+          Actors[EventAdd.database_id] = ReplayerActorInfo { EventAdd.type, EventAdd.description.id };
         }
         break;
 
       // events del
-      case static_cast<char>(CarlaRecorderPacketId::EventDel):
-        ReadValue<uint16_t>(File, Total);
-        for (i = 0; i < Total; ++i)
+      case CarlaRecorderPacketId::EventDel:
+        Reader.ReadList(File, EventsDel);
+        for (const auto &EventDel : EventsDel)
         {
-          EventDel.Read(File);
-          Actors.erase(EventAdd.DatabaseId);
+          Actors.erase(EventDel.database_id);
         }
         break;
 
       // events parenting
-      case static_cast<char>(CarlaRecorderPacketId::EventParent):
-        SkipPacket();
+      case CarlaRecorderPacketId::EventParent:
+        Reader.SkipPacket(File);
         break;
 
       // collisions
-      case static_cast<char>(CarlaRecorderPacketId::Collision):
-        ReadValue<uint16_t>(File, Total);
-        for (i = 0; i < Total; ++i)
+      case CarlaRecorderPacketId::Collision:
+        Reader.ReadList(File, Collisions);
+        for (const auto &Collision : Collisions)
         {
-          Collision.Read(File);
 
           int Valid = 0;
           // get categories for both actors
-          uint8_t Type1 = Categories[Actors[Collision.DatabaseId1].Type];
-          uint8_t Type2 = Categories[Actors[Collision.DatabaseId2].Type];
+          uint8_t Type1 = Categories[Actors[Collision.database_id1].Type];
+          uint8_t Type2 = Categories[Actors[Collision.database_id2].Type];
 
           // filter actor 1
           if (Category1 == 'a')
             ++Valid;
           else if (Category1 == Type1)
             ++Valid;
-          else if (Category1 == 'h' && Collision.IsActor1Hero)
+          else if (Category1 == 'h' && Collision.is_actor1_hero)
             ++Valid;
 
           // filter actor 2
@@ -360,24 +348,24 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
             ++Valid;
           else if (Category2 == Type2)
             ++Valid;
-          else if (Category2 == 'h' && Collision.IsActor2Hero)
+          else if (Category2 == 'h' && Collision.is_actor2_hero)
             ++Valid;
 
           // only show if both actors has passed the filter
           if (Valid == 2)
           {
             // check if we need to show as a starting collision or it is a continuation one
-            auto collisionPair = std::make_pair(Collision.DatabaseId1, Collision.DatabaseId2);
+            auto collisionPair = std::make_pair(Collision.database_id1, Collision.database_id2);
             if (oldCollisions.count(collisionPair) == 0)
             {
               // Info << std::setw(5) << Collision.Id << " ";
-              Info << std::setw(8) << std::setprecision(0) << std::right << std::fixed << Frame.Elapsed;
+              Info << std::setw(8) << std::setprecision(0) << std::right << std::fixed << Frame.elapsed;
               Info << " " << "  " << Type1 << " " << Type2 << " ";
-              Info << " " << std::setw(6) << std::right << Collision.DatabaseId1;
-              Info << " " << std::setw(35) << std::left << TCHAR_TO_UTF8(*Actors[Collision.DatabaseId1].Id);
-              Info << " " << std::setw(6) << std::right << Collision.DatabaseId2;
-              Info << " " << std::setw(35) << std::left << TCHAR_TO_UTF8(*Actors[Collision.DatabaseId2].Id);
-              //Info << std::setw(8) << Frame.Id;
+              Info << " " << std::setw(6) << std::right << Collision.database_id1;
+              Info << " " << std::setw(35) << std::left << Actors[Collision.database_id1].Id;
+              Info << " " << std::setw(6) << std::right << Collision.database_id2;
+              Info << " " << std::setw(35) << std::left << Actors[Collision.database_id2].Id;
+              //Info << std::setw(8) << Frame.id;
               Info << std::endl;
             }
             // save current collision
@@ -386,30 +374,39 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
         }
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::Position):
+      case CarlaRecorderPacketId::Position:
         // Info << "Positions\n";
-        SkipPacket();
+        Reader.SkipPacket(File);
+        break;
+
+      case CarlaRecorderPacketId::PositionCompact:
+        Reader.SkipPacket(File);
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::State):
-        SkipPacket();
+      case CarlaRecorderPacketId::State:
+        Reader.SkipPacket(File);
         break;
 
       // frame end
-      case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+      case CarlaRecorderPacketId::FrameEnd:
         // do nothing, it is empty
         break;
 
+      // frame index at the end of the file
+      case CarlaRecorderPacketId::FrameIndex:
+        Reader.SkipPacket(File);
+        break;
+
       default:
         // skip packet
-        Info << "Unknown packet id: " << Header.Id << " at offset " << File.tellg() << std::endl;
-        SkipPacket();
+        Info << "Unknown packet id: " << static_cast<int>(Reader.GetPacketId()) << " at offset " << File.tellg() << std::endl;
+        Reader.SkipPacket(File);
         break;
     }
   }
 
-  Info << "\nFrames: " << Frame.Id << "\n";
-  Info << "Duration: " << Frame.Elapsed << " seconds\n";
+  Info << "\nFrames: " << Frame.id << "\n";
+  Info << "Duration: " << Frame.elapsed << " seconds\n";
 
   File.close();
 
@@ -435,11 +432,10 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
     return Info.str();
 
   // other, vehicle, walkers, trafficLight, hero, any
-  uint16_t i, Total;
   struct ReplayerActorInfo
   {
     uint8_t Type;
-    FString Id;
+    std::string Id;
     FVector LastPosition;
     double Time;
     double Duration;
@@ -448,6 +444,37 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
   // to be able to sort the results by the duration of each actor (decreasing order)
   std::multimap<double, std::string, std::greater<double>> Results;
 
+  // lambda to check if an actor moved since the last position
+  auto CheckPosition = [&](const carla::recorder::Position &Position)
+  {
+    const FVector Location = Position.location;
+    // check if actor moved less than a distance
+    if (FVector::Distance(Actors[Position.database_id].LastPosition, Location) < MinDistance)
+    {
+      // actor stopped
+      if (Actors[Position.database_id].Duration == 0)
+        Actors[Position.database_id].Time = Frame.elapsed;
+      Actors[Position.database_id].Duration += Frame.duration;
+    }
+    else
+    {
+      // check to show info
+      if (Actors[Position.database_id].Duration >= MinTime)
+      {
+        std::stringstream Result;
+        Result << std::setw(8) << std::setprecision(0) << std::fixed << Actors[Position.database_id].Time;
+        Result << " " << std::setw(6) << Position.database_id;
+        Result << " " << std::setw(35) << std::left << Actors[Position.database_id].Id;
+        Result << " " << std::setw(10) << std::setprecision(0) << std::fixed << std::right << Actors[Position.database_id].Duration;
+        Result << std::endl;
+        Results.insert(std::make_pair(Actors[Position.database_id].Duration, Result.str()));
+      }
+      // actor moving
+      Actors[Position.database_id].Duration = 0;
+      Actors[Position.database_id].LastPosition = Location;
+    }
+  };
+
   // header
   Info << std::setw(8) << "Time";
   Info << " " << std::setw(6) << "Id";
@@ -456,101 +483,81 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
   Info << std::endl;
 
   // parse only frames
-  while (File)
+  while (Reader.ReadHeader(File))
   {
-
-    // get header
-    if (!ReadHeader())
-    {
-      break;
-    }
-
     // check for a frame packet
-    switch (Header.Id)
+    switch (Reader.GetPacketId())
     {
       // frame
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
+      case CarlaRecorderPacketId::FrameStart:
+        Reader.Read(File, Frame);
         break;
 
       // events add
-      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
-        ReadValue<uint16_t>(File, Total);
-        for (i = 0; i < Total; ++i)
+      case CarlaRecorderPacketId::EventAdd:
+        Reader.ReadList(File, EventsAdd);
+        for (const auto &EventAdd : EventsAdd)
         {
           // add
-          EventAdd.Read(File);
-          Actors[EventAdd.DatabaseId] = ReplayerActorInfo { EventAdd.Type, EventAdd.Description.Id };
+          Actors[EventAdd.database_id] = ReplayerActorInfo { EventAdd.type, EventAdd.description.id };
         }
         break;
 
       // events del
-      case static_cast<char>(CarlaRecorderPacketId::EventDel):
-        ReadValue<uint16_t>(File, Total);
-        for (i = 0; i < Total; ++i)
+      case CarlaRecorderPacketId::EventDel:
+        Reader.ReadList(File, EventsDel);
+        for (const auto &EventDel : EventsDel)
         {
-          EventDel.Read(File);
-          Actors.erase(EventAdd.DatabaseId);
+          Actors.erase(EventDel.database_id);
         }
         break;
 
       // events parenting
-      case static_cast<char>(CarlaRecorderPacketId::EventParent):
-        SkipPacket();
+      case CarlaRecorderPacketId::EventParent:
+        Reader.SkipPacket(File);
         break;
 
       // collisions
-      case static_cast<char>(CarlaRecorderPacketId::Collision):
-        SkipPacket();
+      case CarlaRecorderPacketId::Collision:
+        Reader.SkipPacket(File);
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::Position):
+      case CarlaRecorderPacketId::Position:
         // read all positions
-        ReadValue<uint16_t>(File, Total);
-        for (i=0; i<Total; ++i)
+        Reader.ReadList(File, Positions);
+        for (const auto &Position : Positions)
         {
-          Position.Read(File);
-          // check if actor moved less than a distance
-          if (FVector::Distance(Actors[Position.DatabaseId].LastPosition, Position.Location) < MinDistance)
-          {
-            // actor stopped
-            if (Actors[Position.DatabaseId].Duration == 0)
-              Actors[Position.DatabaseId].Time = Frame.Elapsed;
-            Actors[Position.DatabaseId].Duration += Frame.DurationThis;
-          }
-          else
-          {
-            // check to show info
-            if (Actors[Position.DatabaseId].Duration >= MinTime)
-            {
-              std::stringstream Result;
-              Result << std::setw(8) << std::setprecision(0) << std::fixed << Actors[Position.DatabaseId].Time;
-              Result << " " << std::setw(6) << Position.DatabaseId;
-              Result << " " << std::setw(35) << std::left << TCHAR_TO_UTF8(*Actors[Position.DatabaseId].Id);
-              Result << " " << std::setw(10) << std::setprecision(0) << std::fixed << std::right << Actors[Position.DatabaseId].Duration;
-              Result << std::endl;
-              Results.insert(std::make_pair(Actors[Position.DatabaseId].Duration, Result.str()));
-            }
-            // actor moving
-            Actors[Position.DatabaseId].Duration = 0;
-            Actors[Position.DatabaseId].LastPosition = Position.Location;
-          }
+          CheckPosition(Position);
+        }
+        break;
+
+      case CarlaRecorderPacketId::PositionCompact:
+        // read all positions
+        PositionDecoder.Decode(File, Reader.GetPacketSize());
+        for (const auto &Position : PositionDecoder.GetPositions())
+        {
+          CheckPosition(Position);
         }
         break;
 
-      case static_cast<char>(CarlaRecorderPacketId::State):
-        SkipPacket();
+      case CarlaRecorderPacketId::State:
+        Reader.SkipPacket(File);
         break;
 
       // frame end
-      case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+      case CarlaRecorderPacketId::FrameEnd:
         // do nothing, it is empty
         break;
 
+      // frame index at the end of the file
+      case CarlaRecorderPacketId::FrameIndex:
+        Reader.SkipPacket(File);
+        break;
+
       default:
         // skip packet
-        Info << "Unknown packet id: " << Header.Id << " at offset " << File.tellg() << std::endl;
-        SkipPacket();
+        Info << "Unknown packet id: " << static_cast<int>(Reader.GetPacketId()) << " at offset " << File.tellg() << std::endl;
+        Reader.SkipPacket(File);
         break;
     }
   }
@@ -564,7 +571,7 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
       std::stringstream Result;
       Result << std::setw(8) << std::setprecision(0) << std::fixed << Actor.second.Time;
       Result << " " << std::setw(6) << Actor.first;
-      Result << " " << std::setw(35) << std::left << TCHAR_TO_UTF8(*Actor.second.Id);
+      Result << " " << std::setw(35) << std::left << Actor.second.Id;
       Result << " " << std::setw(10) << std::setprecision(0) << std::fixed << std::right << Actor.second.Duration;
       Result << std::endl;
       Results.insert(std::make_pair(Actor.second.Duration, Result.str()));
@@ -577,8 +584,8 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
     Info << Result.second;
   }
 
-  Info << "\nFrames: " << Frame.Id << "\n";
-  Info << "Duration: " << Frame.Elapsed << " seconds\n";
+  Info << "\nFrames: " << Frame.id << "\n";
+  Info << "Duration: " << Frame.elapsed << " seconds\n";
 
   File.close();
 
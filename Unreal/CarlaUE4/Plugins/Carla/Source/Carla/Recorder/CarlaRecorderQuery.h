@@ -7,26 +7,16 @@
 #pragma once
 
 #include <fstream>
-#include "CarlaRecorderInfo.h"
-#include "CarlaRecorderFrames.h"
-#include "CarlaRecorderEventAdd.h"
-#include "CarlaRecorderEventDel.h"
-#include "CarlaRecorderEventParent.h"
-#include "CarlaRecorderCollision.h"
-#include "CarlaRecorderPosition.h"
-#include "CarlaRecorderState.h"
+#include <vector>
+
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/PacketReader.h>
+#include <carla/recorder/PositionCodec.h>
+#include <compiler/enable-ue4-macros.h>
 
 class CarlaRecorderQuery
 {
 
-  #pragma pack(push, 1)
-  struct Header
-  {
-    char Id;
-    uint32_t Size;
-  };
-  #pragma pack(pop)
-
 public:
 
   // get general info
@@ -39,21 +29,18 @@ public:
 private:
 
   std::ifstream File;
-  Header Header;
-  CarlaRecorderInfo RecInfo;
-  CarlaRecorderFrame Frame;
-  CarlaRecorderEventAdd EventAdd;
-  CarlaRecorderEventDel EventDel;
-  CarlaRecorderEventParent EventParent;
-  CarlaRecorderPosition Position;
-  CarlaRecorderCollision Collision;
-  CarlaRecorderStateTrafficLight StateTraffic;
-
-  // read next header packet
-  bool ReadHeader(void);
-
-  // skip current packet
-  void SkipPacket(void);
+  // parses the packets of the file
+  carla::recorder::PacketReader Reader;
+  carla::recorder::Info RecInfo;
+  carla::recorder::Frame Frame;
+  std::vector<carla::recorder::EventAdd> EventsAdd;
+  std::vector<carla::recorder::EventDel> EventsDel;
+  std::vector<carla::recorder::EventParent> EventsParent;
+  std::vector<carla::recorder::Collision> Collisions;
+  std::vector<carla::recorder::Position> Positions;
+  std::vector<carla::recorder::StateTrafficLight> StatesTraffic;
+  // compact positions (deltas against the previous frame)
+  carla::recorder::PositionDecoder PositionDecoder;
 
   // read the start info structure and check the magic string
   bool CheckFileInfo(std::stringstream &Info);
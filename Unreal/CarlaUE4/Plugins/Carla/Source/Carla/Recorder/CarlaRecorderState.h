@@ -6,7 +6,9 @@
 
 #pragma once
 
-#include <fstream>
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/Packets.h>
+#include <compiler/enable-ue4-macros.h>
 
 #pragma pack(push, 1)
 
@@ -16,27 +18,9 @@ struct CarlaRecorderStateTrafficLight
   bool IsFrozen;
   float ElapsedTime;
   char State;
-
-  void Read(std::ifstream &InFile);
-
-  void Write(std::ofstream &OutFile);
-
 };
 
 #pragma pack(pop)
 
-class CarlaRecorderStates
-{
-
-public:
-
-  void Add(const CarlaRecorderStateTrafficLight &State);
-
-  void Clear(void);
-
-  void Write(std::ofstream &OutFile);
-
-private:
-
-  std::vector<CarlaRecorderStateTrafficLight> StatesTrafficLights;
-};
+// conversion from the traffic light state stored in the recorder files
+CarlaRecorderStateTrafficLight FromRecorder(const carla::recorder::StateTrafficLight &State);
@@ -7,6 +7,10 @@
 #include "CarlaReplayer.h"
 #include "CarlaRecorder.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/rpc/String.h>
+#include <compiler/enable-ue4-macros.h>
+
 #include <ctime>
 #include <sstream>
 
@@ -30,27 +34,10 @@ void CarlaReplayer::Stop(bool bKeepActors)
   }
 
   File.close();
+  Index.clear();
 }
 
-bool CarlaReplayer::ReadHeader()
-{
-  if (File.eof())
-  {
-    return false;
-  }
-
-  ReadValue<char>(File, Header.Id);
-  ReadValue<uint32_t>(File, Header.Size);
-
-  return true;
-}
-
-void CarlaReplayer::SkipPacket(void)
-{
-  File.seekg(Header.Size, std::ios::cur);
-}
-
-void CarlaReplayer::Rewind(void)
+bool CarlaReplayer::Rewind(void)
 {
   CurrentTime = 0.0f;
   TotalTime = 0.0f;
@@ -60,44 +47,53 @@ void CarlaReplayer::Rewind(void)
   File.seekg(0, std::ios::beg);
 
   // mark as header as invalid to force reload a new one next time
-  Frame.Elapsed = -1.0f;
-  Frame.DurationThis = 0.0f;
+  Frame.elapsed = -1.0f;
+  Frame.duration = 0.0f;
 
   MappedId.clear();
+  PositionDecoder.Reset();
 
   // read geneal Info
-  RecInfo.Read(File);
+  return Reader.ReadInfo(File, RecInfo);
 }
 
-// read last frame in File and return the Total time recorded
+// load the frame index (from the end of the File, or scanning all frames if
+// it was recorded without index) and return the Total time recorded
 double CarlaReplayer::GetTotalTime(void)
 {
-  std::streampos Current = File.tellg();
+  Index.Load(File);
+  return Index.GetDuration();
+}
 
-  // parse only frames
-  while (File)
+// jump to the last keyframe before the time, creating the actors alive at
+// that point instead of processing the events of all previous frames
+void CarlaReplayer::SeekToKeyframe(double Time)
+{
+  const carla::recorder::Keyframe *Keyframe = Index.FindKeyframe(Time);
+  if (Keyframe == nullptr)
   {
-    // get header
-    if (!ReadHeader())
-    {
-      break;
-    }
+    return;
+  }
 
-    // check for a frame packet
-    switch (Header.Id)
-    {
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
-        Frame.Read(File);
-        break;
-      default:
-        SkipPacket();
-        break;
-    }
+  carla::recorder::EventAdd EventAdd;
+  for (uint32_t Actor : Keyframe->actors)
+  {
+    if (Reader.ReadRecordAt(File, Index.GetActorOffsets()[Actor], EventAdd))
+      ProcessEventAdd(EventAdd);
+    else
+      UE_LOG(LogCarla, Log, TEXT("Actor could not be read from replayer (index %d)"), Actor);
+  }
+
+  for (const auto &Parent : Keyframe->parents)
+  {
+    Helper.ProcessReplayerEventParent(MappedId[Parent.database_id], MappedId[Parent.database_id_parent]);
   }
 
+  // continue reading from the frame of the keyframe, its positions are
+  // encoded without reference to the previous frame
+  PositionDecoder.Reset();
   File.clear();
-  File.seekg(Current, std::ios::beg);
-  return Frame.Elapsed;
+  File.seekg(Index.GetFrames()[Keyframe->frame].offset, std::ios::beg);
 }
 
 std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, double Duration, uint32_t ThisFollowId)
@@ -126,24 +122,30 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   }
 
   // from start
-  Rewind();
+  if (!Rewind())
+  {
+    Info << "File " << Filename2 << " is not a CARLA recorder\n";
+    Stop();
+    return Info.str();
+  }
 
   // check to load map if different
-  if (Episode->GetMapName() != RecInfo.Mapfile)
+  const FString Mapfile = carla::rpc::ToFString(RecInfo.map_file);
+  if (Episode->GetMapName() != Mapfile)
   {
-    if (!Episode->LoadNewEpisode(RecInfo.Mapfile))
+    if (!Episode->LoadNewEpisode(Mapfile))
     {
-      Info << "Could not load mapfile " << TCHAR_TO_UTF8(*RecInfo.Mapfile) << std::endl;
+      Info << "Could not load mapfile " << RecInfo.map_file << std::endl;
       Stop();
       return Info.str();
     }
-    Info << "Loading map " << TCHAR_TO_UTF8(*RecInfo.Mapfile) << std::endl;
+    Info << "Loading map " << RecInfo.map_file << std::endl;
     Info << "Replayer will start after map is loaded..." << std::endl;
 
     // prepare autoplay after map is loaded
     Autoplay.Enabled = true;
     Autoplay.Filename = Filename2;
-    Autoplay.Mapfile = RecInfo.Mapfile;
+    Autoplay.Mapfile = Mapfile;
     Autoplay.TimeStart = TimeStart;
     Autoplay.Duration = Duration;
     Autoplay.FollowId = FollowId;
@@ -177,7 +179,8 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   // if we don't need to load a new map, then start
   if (!Autoplay.Enabled)
   {
-    // process all events until the time
+    // process all events until the time, from the closest keyframe
+    SeekToKeyframe(TimeStart);
     ProcessToTime(TimeStart);
     // mark as enabled
     Enabled = true;
@@ -210,7 +213,11 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
   }
 
   // from start
-  Rewind();
+  if (!Rewind())
+  {
+    File.close();
+    return;
+  }
 
   // get Total time of recorder
   TotalTime = GetTotalTime();
@@ -236,7 +243,8 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
   // apply time factor
   TimeFactor = Autoplay.TimeFactor;
 
-  // process all events until the time
+  // process all events until the time, from the closest keyframe
+  SeekToKeyframe(TimeStart);
   ProcessToTime(TimeStart);
 
   // mark as enabled
@@ -252,74 +260,80 @@ void CarlaReplayer::ProcessToTime(double Time)
   bool bExitLoop = false;
 
   // check if we are in the right frame
-  if (NewTime >= Frame.Elapsed && NewTime < Frame.Elapsed + Frame.DurationThis)
+  if (NewTime >= Frame.elapsed && NewTime < Frame.elapsed + Frame.duration)
   {
-    Per = (NewTime - Frame.Elapsed) / Frame.DurationThis;
+    Per = (NewTime - Frame.elapsed) / Frame.duration;
     bFrameFound = true;
     bExitLoop = true;
-    // UE_LOG(LogCarla, Log, TEXT("Frame %f (%f) now %f per %f"), Frame.Elapsed, Frame.Elapsed + Frame.DurationThis, NewTime, Per);
+    // UE_LOG(LogCarla, Log, TEXT("Frame %f (%f) now %f per %f"), Frame.elapsed, Frame.elapsed + Frame.duration, NewTime, Per);
   }
 
   // process all frames until time we want or end
-  while (!File.eof() && !bExitLoop)
+  while (!bExitLoop && Reader.ReadHeader(File))
   {
-    // get header
-    ReadHeader();
-
     // check for a frame packet
-    switch (Header.Id)
+    switch (Reader.GetPacketId())
     {
       // frame
-      case static_cast<char>(CarlaRecorderPacketId::FrameStart):
+      case CarlaRecorderPacketId::FrameStart:
         // only read if we are not in the right frame
-        Frame.Read(File);
+        if (!Reader.Read(File, Frame))
+        {
+          bExitLoop = true;
+          break;
+        }
         // check if target time is in this frame
-        if (NewTime < Frame.Elapsed + Frame.DurationThis)
+        if (NewTime < Frame.elapsed + Frame.duration)
         {
-          Per = (NewTime - Frame.Elapsed) / Frame.DurationThis;
+          Per = (NewTime - Frame.elapsed) / Frame.duration;
           bFrameFound = true;
-          // UE_LOG(LogCarla, Log, TEXT("Frame %f (%f) now %f per %f"), Frame.Elapsed, Frame.Elapsed + Frame.DurationThis, NewTime, Per);
+          // UE_LOG(LogCarla, Log, TEXT("Frame %f (%f) now %f per %f"), Frame.elapsed, Frame.elapsed + Frame.duration, NewTime, Per);
         }
         break;
 
       // events add
-      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+      case CarlaRecorderPacketId::EventAdd:
         ProcessEventsAdd();
         break;
 
       // events del
-      case static_cast<char>(CarlaRecorderPacketId::EventDel):
+      case CarlaRecorderPacketId::EventDel:
         ProcessEventsDel();
         break;
 
       // events parent
-      case static_cast<char>(CarlaRecorderPacketId::EventParent):
+      case CarlaRecorderPacketId::EventParent:
         ProcessEventsParent();
         break;
 
       // collisions
-      case static_cast<char>(CarlaRecorderPacketId::Collision):
-        SkipPacket();
+      case CarlaRecorderPacketId::Collision:
+        Reader.SkipPacket(File);
         break;
 
       // positions
-      case static_cast<char>(CarlaRecorderPacketId::Position):
+      case CarlaRecorderPacketId::Position:
         if (bFrameFound)
           ProcessPositions();
         else
-          SkipPacket();
+          Reader.SkipPacket(File);
+        break;
+
+      // positions as deltas against the previous frame, always decoded
+      case CarlaRecorderPacketId::PositionCompact:
+        ProcessPositionsCompact(bFrameFound);
         break;
 
       // states
-      case static_cast<char>(CarlaRecorderPacketId::State):
+      case CarlaRecorderPacketId::State:
         if (bFrameFound)
           ProcessStates();
         else
-          SkipPacket();
+          Reader.SkipPacket(File);
         break;
 
       // frame end
-      case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+      case CarlaRecorderPacketId::FrameEnd:
         if (bFrameFound)
           bExitLoop = true;
         break;
@@ -327,7 +341,7 @@ void CarlaReplayer::ProcessToTime(double Time)
       // unknown packet, just skip
       default:
         // skip packet
-        SkipPacket();
+        Reader.SkipPacket(File);
         break;
 
     }
@@ -360,121 +374,76 @@ void CarlaReplayer::ProcessToTime(double Time)
 
 void CarlaReplayer::ProcessEventsAdd(void)
 {
-  uint16_t i, Total;
-  CarlaRecorderEventAdd EventAdd;
-  // std::stringstream Info;
-
   // process creation events
-  ReadValue<uint16_t>(File, Total);
-  for (i = 0; i < Total; ++i)
+  Reader.ReadList(File, EventsAdd);
+  for (const auto &EventAdd : EventsAdd)
   {
-    EventAdd.Read(File);
+    ProcessEventAdd(EventAdd);
+  }
+}
+
+void CarlaReplayer::ProcessEventAdd(const carla::recorder::EventAdd &EventAdd)
+{
+  // avoid sensor events
+  if (EventAdd.description.id.compare(0, 7, "sensor.") != 0)
+  {
+    auto Result = Helper.ProcessReplayerEventAdd(
+        EventAdd.location,
+        EventAdd.rotation,
+        FromRecorder(EventAdd.description),
+        EventAdd.database_id);
 
-    // avoid sensor events
-    if (!EventAdd.Description.Id.StartsWith("sensor."))
+    switch (Result.first)
     {
-      // show log
-      // Info.str("");
-      // Info << " Create " << EventAdd.DatabaseId << ": " << TCHAR_TO_UTF8(*EventAdd.Description.Id) << " (" <<
-        // EventAdd.Description.UId << ") at (" << EventAdd.Location.X << ", " <<
-        // EventAdd.Location.Y << ", " << EventAdd.Location.Z << ")" << std::endl;
-      // for (auto &Att : EventAdd.Description.Attributes)
-      // {
-      //   Info << "  " << TCHAR_TO_UTF8(*Att.Id) << " = " << TCHAR_TO_UTF8(*Att.Value) << std::endl;
-      // }
-      // UE_LOG(LogCarla, Log, TEXT("%s"), Info.str().c_str());
-
-      // auto Result = CallbackEventAdd(
-      auto Result = Helper.ProcessReplayerEventAdd(
-          EventAdd.Location,
-          EventAdd.Rotation,
-          std::move(EventAdd.Description),
-          EventAdd.DatabaseId);
-
-      switch (Result.first)
-      {
-        // actor not created
-        case 0:
-          UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
-          break;
+      // actor not created
+      case 0:
+        UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
+        break;
 
-        // actor created but with different id
-        case 1:
-          // if (Result.second != EventAdd.DatabaseId)
-          // {
-          //   UE_LOG(LogCarla, Log, TEXT("actor created but with different id"));
-          // }
-          // else
-          // {
-          //   UE_LOG(LogCarla, Log, TEXT("actor created with same id"));
-          // }
-          // mapping id (recorded Id is a new Id in replayer)
-          MappedId[EventAdd.DatabaseId] = Result.second;
-          break;
+      // actor created but with different id
+      case 1:
+        // mapping id (recorded Id is a new Id in replayer)
+        MappedId[EventAdd.database_id] = Result.second;
+        break;
 
-        // actor reused from existing
-        case 2:
-          // UE_LOG(LogCarla, Log, TEXT("actor already exist, not created"));
-          // mapping id (say desired Id is mapped to what)
-          MappedId[EventAdd.DatabaseId] = Result.second;
-          break;
-      }
+      // actor reused from existing
+      case 2:
+        // mapping id (say desired Id is mapped to what)
+        MappedId[EventAdd.database_id] = Result.second;
+        break;
     }
   }
 }
 
 void CarlaReplayer::ProcessEventsDel(void)
 {
-  uint16_t i, Total;
-  CarlaRecorderEventDel EventDel;
-  // std::stringstream Info;
-
   // process destroy events
-  ReadValue<uint16_t>(File, Total);
-  for (i = 0; i < Total; ++i)
+  Reader.ReadList(File, EventsDel);
+  for (const auto &EventDel : EventsDel)
   {
-    EventDel.Read(File);
-    // Info.str("");
-    // Info << "Destroy " << MappedId[EventDel.DatabaseId] << "\n";
-    // UE_LOG(LogCarla, Log, "%s", Info.str().c_str());
-    Helper.ProcessReplayerEventDel(MappedId[EventDel.DatabaseId]);
-    MappedId.erase(EventDel.DatabaseId);
+    Helper.ProcessReplayerEventDel(MappedId[EventDel.database_id]);
+    MappedId.erase(EventDel.database_id);
   }
 }
 
 void CarlaReplayer::ProcessEventsParent(void)
 {
-  uint16_t i, Total;
-  CarlaRecorderEventParent EventParent;
-  std::stringstream Info;
-
   // process parenting events
-  ReadValue<uint16_t>(File, Total);
-  for (i = 0; i < Total; ++i)
+  Reader.ReadList(File, EventsParent);
+  for (const auto &EventParent : EventsParent)
   {
-    EventParent.Read(File);
-    // Info.str("");
-    // Info << "Parenting " << MappedId[EventParent.DatabaseId] << " with " << MappedId[EventParent.DatabaseId] <<
-      // " (parent)\n";
-    // UE_LOG(LogCarla, Log, "%s", Info.str().c_str());
-    Helper.ProcessReplayerEventParent(MappedId[EventParent.DatabaseId], MappedId[EventParent.DatabaseIdParent]);
+    Helper.ProcessReplayerEventParent(MappedId[EventParent.database_id], MappedId[EventParent.database_id_parent]);
   }
 }
 
 void CarlaReplayer::ProcessStates(void)
 {
-  uint16_t i, Total;
-  CarlaRecorderStateTrafficLight StateTrafficLight;
-  std::stringstream Info;
-
   // read Total traffic light states
-  ReadValue<uint16_t>(File, Total);
-  for (i = 0; i < Total; ++i)
+  Reader.ReadList(File, States);
+  for (const auto &State : States)
   {
-    StateTrafficLight.Read(File);
-
-    // UE_LOG(LogCarla, Log, TEXT("calling callback add"));
-    StateTrafficLight.DatabaseId = MappedId[StateTrafficLight.DatabaseId];
+    CarlaRecorderStateTrafficLight StateTrafficLight = FromRecorder(State);
+    StateTrafficLight.DatabaseId = MappedId[State.database_id];
     if (!Helper.ProcessReplayerStateTrafficLight(StateTrafficLight))
     {
       UE_LOG(LogCarla,
@@ -487,29 +456,58 @@ void CarlaReplayer::ProcessStates(void)
 
 void CarlaReplayer::ProcessPositions(void)
 {
-  uint16_t i, Total;
+  // save current as previous
+  PrevPos = std::move(CurrPos);
+
+  // read all positions
+  CurrPos.clear();
+  Reader.ReadList(File, Positions);
+  CurrPos.reserve(Positions.size());
+  for (const auto &Position : Positions)
+  {
+    AddCurrentPosition(Position);
+  }
+}
+
+void CarlaReplayer::ProcessPositionsCompact(bool bApply)
+{
+  // each packet is decoded against the previous one, so all of them need to
+  // be decoded even if the positions are not applied
+  const bool bDecoded = PositionDecoder.Decode(File, Reader.GetPacketSize());
+  if (!bApply)
+  {
+    return;
+  }
 
   // save current as previous
   PrevPos = std::move(CurrPos);
 
   // read all positions
-  ReadValue<uint16_t>(File, Total);
   CurrPos.clear();
-  CurrPos.reserve(Total);
-  for (i = 0; i < Total; ++i)
+  if (!bDecoded)
   {
-    CarlaRecorderPosition Pos;
-    Pos.Read(File);
-    // assign mapped Id
-    auto NewId = MappedId.find(Pos.DatabaseId);
-    if (NewId != MappedId.end())
-    {
-      Pos.DatabaseId = NewId->second;
-    }
-    else
-      UE_LOG(LogCarla, Log, TEXT("Actor not found when trying to move from replayer (id. %d)"), Pos.DatabaseId);
-    CurrPos.push_back(std::move(Pos));
+    UE_LOG(LogCarla, Log, TEXT("Positions could not be decoded from replayer"));
+    return;
+  }
+  CurrPos.reserve(PositionDecoder.GetPositions().size());
+  for (const auto &Position : PositionDecoder.GetPositions())
+  {
+    AddCurrentPosition(Position);
+  }
+}
+
+void CarlaReplayer::AddCurrentPosition(const carla::recorder::Position &Position)
+{
+  CarlaRecorderPosition Pos = FromRecorder(Position);
+  // assign mapped Id
+  auto NewId = MappedId.find(Pos.DatabaseId);
+  if (NewId != MappedId.end())
+  {
+    Pos.DatabaseId = NewId->second;
   }
+  else
+    UE_LOG(LogCarla, Log, TEXT("Actor not found when trying to move from replayer (id. %d)"), Pos.DatabaseId);
+  CurrPos.push_back(std::move(Pos));
 }
 
 void CarlaReplayer::UpdatePositions(double Per)
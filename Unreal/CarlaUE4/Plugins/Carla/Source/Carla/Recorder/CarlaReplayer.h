@@ -11,29 +11,22 @@
 #include <unordered_map>
 
 #include <functional>
-#include "CarlaRecorderInfo.h"
-#include "CarlaRecorderFrames.h"
 #include "CarlaRecorderEventAdd.h"
-#include "CarlaRecorderEventDel.h"
-#include "CarlaRecorderEventParent.h"
-#include "CarlaRecorderCollision.h"
 #include "CarlaRecorderPosition.h"
 #include "CarlaRecorderState.h"
 #include "CarlaRecorderHelpers.h"
 #include "CarlaReplayerHelper.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/FrameIndex.h>
+#include <carla/recorder/PacketReader.h>
+#include <carla/recorder/PositionCodec.h>
+#include <compiler/enable-ue4-macros.h>
+
 class UCarlaEpisode;
 
 class CarlaReplayer
 {
-  #pragma pack(push, 1)
-  struct Header
-  {
-    char Id;
-    uint32_t Size;
-  };
-  #pragma pack(pop)
-
 public:
   struct PlayAfterLoadMap
   {
@@ -90,9 +83,20 @@ private:
   UCarlaEpisode *Episode = nullptr;
   // binary file reader
   std::ifstream File;
-  Header Header;
-  CarlaRecorderInfo RecInfo;
-  CarlaRecorderFrame Frame;
+  // parses the packets of the file
+  carla::recorder::PacketReader Reader;
+  // frame index to seek in the file
+  carla::recorder::FrameIndex Index;
+  // decoder of the compact positions (deltas against the previous frame)
+  carla::recorder::PositionDecoder PositionDecoder;
+  carla::recorder::Info RecInfo;
+  carla::recorder::Frame Frame;
+  // records of the last packet read
+  std::vector<carla::recorder::EventAdd> EventsAdd;
+  std::vector<carla::recorder::EventDel> EventsDel;
+  std::vector<carla::recorder::EventParent> EventsParent;
+  std::vector<carla::recorder::Position> Positions;
+  std::vector<carla::recorder::StateTrafficLight> States;
   // positions (to be able to interpolate)
   std::vector<CarlaRecorderPosition> CurrPos;
   std::vector<CarlaRecorderPosition> PrevPos;
@@ -110,22 +114,25 @@ private:
   double TimeFactor { 1.0 };
 
   // utils
-  bool ReadHeader();
-
-  void SkipPacket();
-
   double GetTotalTime(void);
 
-  void Rewind(void);
+  // back to the beginning of the file, false if it is not a recorder file
+  bool Rewind(void);
+
+  // jump to the last keyframe before a time
+  void SeekToKeyframe(double Time);
 
   // processing packets
   void ProcessToTime(double Time);
 
   void ProcessEventsAdd(void);
+  void ProcessEventAdd(const carla::recorder::EventAdd &EventAdd);
   void ProcessEventsDel(void);
   void ProcessEventsParent(void);
 
   void ProcessPositions(void);
+  void ProcessPositionsCompact(bool bApply);
+  void AddCurrentPosition(const carla::recorder::Position &Position);
 
   void ProcessStates(void);
 
@@ -152,10 +152,16 @@ void FTheNewCarlaServer::FPimpl::BindActions()
 
   // ~~ Tick ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-  BIND_SYNC(tick_cue) << [this]() -> R<void>
+  BIND_SYNC(tick_cue) << [this]() -> R<uint64_t>
   {
     ++TickCuesReceived;
-    return R<void>::Success();
+    if ((Episode != nullptr) && !Episode->GetSettings().bSynchronousMode)
+    {
+      return GFrameCounter + 1u;
+    }
+    // In synchronous mode the game thread is blocked at the end of the current
+    // frame, each pending cue lets one more frame through.
+    return GFrameCounter + TickCuesReceived;
   };
 
   // ~~ Load new episode ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -787,35 +793,63 @@ void FTheNewCarlaServer::FPimpl::BindActions()
     return response.HasError() ? CR{response.GetError()} : CR{id};
   };
 
-#define MAKE_RESULT(operation) return parse_result(c.actor, operation);
+#define MAKE_RESULT(operation) result.emplace_back(parse_result(c.actor, operation));
+
+  // Applies the operation to every actor of a batch command, appending one
+  // response per actor to the result.
+  auto apply_to_each = [=](const auto &actors, const auto &values, auto operation, std::vector<CR> &result) {
+    if (actors.size() != values.size())
+    {
+      const CR error = carla::rpc::ResponseError("invalid batch command: size mismatch");
+      result.insert(result.end(), actors.size(), error);
+      return;
+    }
+    result.reserve(result.size() + actors.size());
+    for (auto i = 0u; i < actors.size(); ++i)
+    {
+      result.emplace_back(parse_result(actors[i], operation(actors[i], values[i])));
+    }
+  };
 
+  // Appends the responses of a command to the result, one per actor for batch
+  // commands and one otherwise.
   auto command_visitor = carla::MakeRecursiveOverload(
-      [=](auto self, const C::SpawnActor &c) -> CR {
-        auto result = c.parent.has_value() ?
+      [=](auto self, const C::SpawnActor &c, std::vector<CR> &result) -> void {
+        auto spawn_result = c.parent.has_value() ?
             spawn_actor_with_parent(c.description, c.transform, *c.parent) :
             spawn_actor(c.description, c.transform);
-        if (!result.HasError()) {
-          ActorId id = result.Get().id;
+        if (!spawn_result.HasError()) {
+          ActorId id = spawn_result.Get().id;
           auto set_id = carla::MakeOverload(
               [](C::SpawnActor &) {},
+              [](C::ApplyVehicleControlBatch &) {},
+              [](C::ApplyWalkerControlBatch &) {},
+              [](C::ApplyTransformBatch &) {},
               [id](auto &s) { s.actor = id; });
+          // The responses of the commands applied after spawning are ignored.
+          std::vector<CR> ignored;
+          auto apply = [&](const auto &command) { self(command, ignored); };
           for (auto command : c.do_after) {
             boost::apply_visitor(set_id, command.command);
-            boost::apply_visitor(self, command.command);
+            boost::apply_visitor(apply, command.command);
           }
-          return id;
+          result.emplace_back(id);
+        } else {
+          result.emplace_back(spawn_result.GetError());
         }
-        return result.GetError();
       },
-      [=](auto, const C::DestroyActor &c) {         MAKE_RESULT(destroy_actor(c.actor)); },
-      [=](auto, const C::ApplyVehicleControl &c) {  MAKE_RESULT(apply_control_to_vehicle(c.actor, c.control)); },
-      [=](auto, const C::ApplyWalkerControl &c) {   MAKE_RESULT(apply_control_to_walker(c.actor, c.control)); },
-      [=](auto, const C::ApplyTransform &c) {       MAKE_RESULT(set_actor_transform(c.actor, c.transform)); },
-      [=](auto, const C::ApplyVelocity &c) {        MAKE_RESULT(set_actor_velocity(c.actor, c.velocity)); },
-      [=](auto, const C::ApplyAngularVelocity &c) { MAKE_RESULT(set_actor_angular_velocity(c.actor, c.angular_velocity)); },
-      [=](auto, const C::ApplyImpulse &c) {         MAKE_RESULT(add_actor_impulse(c.actor, c.impulse)); },
-      [=](auto, const C::SetSimulatePhysics &c) {   MAKE_RESULT(set_actor_simulate_physics(c.actor, c.enabled)); },
-      [=](auto, const C::SetAutopilot &c) {         MAKE_RESULT(set_actor_autopilot(c.actor, c.enabled)); });
+      [=](auto, const C::DestroyActor &c, std::vector<CR> &result) {         MAKE_RESULT(destroy_actor(c.actor)); },
+      [=](auto, const C::ApplyVehicleControl &c, std::vector<CR> &result) {  MAKE_RESULT(apply_control_to_vehicle(c.actor, c.control)); },
+      [=](auto, const C::ApplyWalkerControl &c, std::vector<CR> &result) {   MAKE_RESULT(apply_control_to_walker(c.actor, c.control)); },
+      [=](auto, const C::ApplyTransform &c, std::vector<CR> &result) {       MAKE_RESULT(set_actor_transform(c.actor, c.transform)); },
+      [=](auto, const C::ApplyVelocity &c, std::vector<CR> &result) {        MAKE_RESULT(set_actor_velocity(c.actor, c.velocity)); },
+      [=](auto, const C::ApplyAngularVelocity &c, std::vector<CR> &result) { MAKE_RESULT(set_actor_angular_velocity(c.actor, c.angular_velocity)); },
+      [=](auto, const C::ApplyImpulse &c, std::vector<CR> &result) {         MAKE_RESULT(add_actor_impulse(c.actor, c.impulse)); },
+      [=](auto, const C::SetSimulatePhysics &c, std::vector<CR> &result) {   MAKE_RESULT(set_actor_simulate_physics(c.actor, c.enabled)); },
+      [=](auto, const C::SetAutopilot &c, std::vector<CR> &result) {         MAKE_RESULT(set_actor_autopilot(c.actor, c.enabled)); },
+      [=](auto, const C::ApplyVehicleControlBatch &c, std::vector<CR> &result) { apply_to_each(c.actors, c.controls, apply_control_to_vehicle, result); },
+      [=](auto, const C::ApplyWalkerControlBatch &c, std::vector<CR> &result) {  apply_to_each(c.actors, c.controls, apply_control_to_walker, result); },
+      [=](auto, const C::ApplyTransformBatch &c, std::vector<CR> &result) {      apply_to_each(c.actors, c.transforms, set_actor_transform, result); });
 
 #undef MAKE_RESULT
 
@@ -823,9 +857,10 @@ void FTheNewCarlaServer::FPimpl::BindActions()
   {
     std::vector<CR> result;
     result.reserve(commands.size());
+    auto apply = [&](const auto &command) { command_visitor(command, result); };
     for (const auto &command : commands)
     {
-      result.emplace_back(boost::apply_visitor(command_visitor, command.command));
+      boost::apply_visitor(apply, command.command);
     }
     if (do_tick_cue)
     {
@@ -125,10 +125,19 @@ namespace server {
       case CARLA_SERVER_AGENT_TRAFFICLIGHT_RED:
         return SetTrafficLight(lhs->mutable_traffic_light(), rhs, cs::TrafficLight::RED);
       default:
+        // The message is reused, do not leave the agent of a previous frame.
+        lhs->clear_agent();
+        lhs->set_id(0u);
         log_error("invalid agent type");
     }
   }
 
+  CarlaEncoder::CarlaEncoder()
+    : _measurements(std::make_unique<cs::Measurements>()),
+      _control(std::make_unique<cs::Control>()) {}
+
+  CarlaEncoder::~CarlaEncoder() = default;
+
   std::string CarlaEncoder::Encode(const carla_scene_description &values) {
     auto *message = _protobuf.CreateMessage<cs::SceneDescription>();
     DEBUG_ASSERT(message != nullptr);
@@ -153,8 +162,8 @@ namespace server {
     return Protobuf::Encode(*message);
   }
 
-  std::string CarlaEncoder::Encode(const carla_measurements &values) {
-    static thread_local auto *message = _protobuf.CreateMessage<cs::Measurements>();
+  const std::string &CarlaEncoder::Encode(const carla_measurements &values) {
+    auto *message = _measurements.get();
     DEBUG_ASSERT(message != nullptr);
     message->set_frame_number(values.frame_number);
     message->set_platform_timestamp(values.platform_timestamp);
@@ -172,12 +181,25 @@ namespace server {
     player->set_intersection_otherlane(values.player_measurements.intersection_otherlane);
     player->set_intersection_offroad(values.player_measurements.intersection_offroad);
     Set(player->mutable_autopilot_control(), values.player_measurements.autopilot_control);
-    // Non-player agents.
-    message->clear_non_player_agents(); // we need to clear as we cache the message.
+    // Non-player agents. We overwrite the agents of the previous frame instead
+    // of clearing them, clearing an agent would free its oneof sub-message and
+    // we would need to allocate it again. Agents keep their order between
+    // frames, so usually the type at each position matches.
+    auto *non_player_agents = message->mutable_non_player_agents();
+    DEBUG_ASSERT(non_player_agents != nullptr);
+    int index = 0;
     for (auto &agent : agents(values)) {
-      Set(message->add_non_player_agents(), agent);
+      Set(index < non_player_agents->size() ?
+              non_player_agents->Mutable(index) :
+              non_player_agents->Add(),
+          agent);
+      ++index;
     }
-    return Protobuf::Encode(*message);
+    while (non_player_agents->size() > index) {
+      non_player_agents->RemoveLast();
+    }
+    Protobuf::Encode(*message, _measurements_buffer);
+    return _measurements_buffer;
   }
 
   bool CarlaEncoder::Decode(const std::string &str, RequestNewEpisode &values) {
@@ -212,7 +234,7 @@ namespace server {
   }
 
   bool CarlaEncoder::Decode(const std::string &str, carla_control &values) {
-    static thread_local auto *message = _protobuf.CreateMessage<cs::Control>();
+    auto *message = _control.get();
     DEBUG_ASSERT(message != nullptr);
     message->ParseFromString(str);
     if (message->IsInitialized()) {
@@ -6,9 +6,18 @@
 
 #pragma once
 
+#include "carla/NonCopyable.h"
 #include "carla/server/CarlaServerAPI.h"
 #include "carla/server/Protobuf.h"
 
+#include <memory>
+#include <string>
+
+namespace carla_server {
+  class Control;
+  class Measurements;
+} // namespace carla_server
+
 namespace carla {
 namespace server {
 
@@ -17,9 +26,18 @@ namespace server {
 
   /// Converts the data between the C interface types and the Protobuf message
   /// that is going to be sent and received through the socket.
-  class CarlaEncoder {
+  ///
+  /// The messages sent or received every frame (measurements and control) are
+  /// cached and reused, so once their size settles they are encoded and
+  /// decoded without allocating memory. Each of these is only used by one
+  /// thread, the agent server writing measurements or the one reading control.
+  class CarlaEncoder : private NonCopyable {
   public:
 
+    CarlaEncoder();
+
+    ~CarlaEncoder();
+
     // =========================================================================
     /// @name string encoders (for testing only)
     // =========================================================================
@@ -46,7 +64,9 @@ namespace server {
 
     std::string Encode(const carla_episode_ready &values);
 
-    std::string Encode(const carla_measurements &values);
+    /// The string returned is reused by the next call, and it is only valid
+    /// until then.
+    const std::string &Encode(const carla_measurements &values);
 
     bool Decode(const std::string &message, RequestNewEpisode &values);
 
@@ -59,6 +79,12 @@ namespace server {
   private:
 
     Protobuf _protobuf;
+
+    const std::unique_ptr<carla_server::Measurements> _measurements;
+
+    std::string _measurements_buffer;
+
+    const std::unique_ptr<carla_server::Control> _control;
   };
 
 } // namespace server
@@ -55,7 +55,7 @@ namespace server {
 
     template <typename T>
     error_code Write(const T &values, time_duration timeout) {
-      const auto string = _encoder.Encode(values);
+      const auto &string = _encoder.Encode(values);
       return _server.Write(boost::asio::buffer(string), timeout);
     }
 
@@ -63,7 +63,7 @@ namespace server {
     /// to each individual Write. Effectively, it may wait the timeout for each
     /// sensor.
     error_code Write(const MeasurementsMessage &values, time_duration timeout) {
-      const auto string = _encoder.Encode(values.measurements());
+      const auto &string = _encoder.Encode(values.measurements());
       auto ec = _server.Write(boost::asio::buffer(string), timeout);
       if (!ec) {
         ec = Write(values.sensor_inbox(), timeout);
@@ -8,6 +8,8 @@
 
 #include "carla/Debug.h"
 
+#include <cstring>
+
 namespace carla {
 namespace server {
 
@@ -26,11 +28,20 @@ namespace server {
 
   std::string Protobuf::Encode(const google::protobuf::MessageLite &message) {
     std::string result;
-    DEBUG_ASSERT(message.IsInitialized());
-    PrependByteSize(result, message.ByteSize());
-    message.AppendToString(&result);
+    Encode(message, result);
     return result;
   }
 
+  void Protobuf::Encode(const google::protobuf::MessageLite &message, std::string &result) {
+    DEBUG_ASSERT(message.IsInitialized());
+    constexpr uint32_t extraSize = sizeof(uint32_t);
+    const uint32_t size = static_cast<uint32_t>(message.ByteSizeLong());
+    // Only allocates if the message grew beyond the capacity of the string.
+    result.resize(extraSize + size);
+    std::memcpy(&result[0u], &size, extraSize);
+    // Sizes were just cached by ByteSizeLong.
+    message.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(&result[extraSize]));
+  }
+
 } // namespace server
 } // namespace carla
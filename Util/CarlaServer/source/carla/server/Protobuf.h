@@ -9,6 +9,8 @@
 #include <google/protobuf/arena.h>
 #include <google/protobuf/message_lite.h>
 
+#include <string>
+
 namespace carla {
 namespace server {
 
@@ -31,6 +33,9 @@ namespace server {
     /// message.
     static std::string Encode(const google::protobuf::MessageLite &message);
 
+    /// Same as above but encoding into @a result, reusing its memory.
+    static void Encode(const google::protobuf::MessageLite &message, std::string &result);
+
     /// Creates a protobuf message using arena allocation.
     template <typename T>
     T *CreateMessage() {
@@ -8,8 +8,8 @@
 
 #include "carla/Debug.h"
 #include "carla/NonCopyable.h"
-#include "carla/server/DoubleBuffer.h"
 #include "carla/server/SensorDataMessage.h"
+#include "carla/server/TripleBuffer.h"
 
 #include <type_traits>
 #include <unordered_map>
@@ -52,13 +52,14 @@ namespace detail {
   /// Stores the data received from the sensors (asynchronously) to be sent next
   /// on next tick.
   ///
-  /// Each sensor has a double-buffer for one producer and one consumer per
+  /// Each sensor has a triple-buffer for one producer and one consumer per
   /// sensor. Several threads can simultaneously write as long as they write to
   /// different buffers, i.e. each sensor can have its own producer and consumer
-  /// threads.
+  /// threads. Writing never waits for the consumer; only the latest data of
+  /// each sensor is sent.
   class SensorDataInbox : private NonCopyable {
 
-    using DataBuffer = DoubleBuffer<SensorDataMessage>;
+    using DataBuffer = TripleBuffer<SensorDataMessage>;
 
     using Map = std::unordered_map<uint32_t, DataBuffer>;
 
@@ -81,7 +82,7 @@ namespace detail {
     }
 
     /// Tries to acquire a reader on the buffer of the given sensor. See
-    /// DoubleBuffer.
+    /// TripleBuffer.
     auto TryMakeReader(uint32_t sensor_id) {
       return _buffers.at(sensor_id).TryMakeReader();
     }
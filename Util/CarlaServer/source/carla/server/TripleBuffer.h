@@ -0,0 +1,110 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace carla {
+namespace server {
+
+namespace detail {
+
+  /// Keeps the state of an atomic triple-buffer.
+  ///
+  /// Each side owns one of the three buffers, the third one (the "middle"
+  /// buffer) is exchanged atomically: the writer swaps its buffer with the
+  /// middle one to publish it, the reader swaps its buffer with the middle one
+  /// if it holds a value not read yet. Both operations are a single atomic
+  /// exchange, neither side ever waits for the other.
+  class TripleBufferState : private NonCopyable {
+  public:
+
+    static constexpr uint32_t NUMBER_OF_BUFFERS = 3u;
+
+    TripleBufferState() : _middle(1u), _write(0u), _read(2u) {}
+
+    /// Buffer owned by the writer.
+    uint32_t StartWriting() const {
+      return _write;
+    }
+
+    /// Publish the writer's buffer, the writer takes the middle one.
+    void EndWriting() {
+      // Release the data written, acquire the buffer released by the reader.
+      _write = _middle.exchange(_write | NEW_DATA, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /// Take the last buffer published, or return NUMBER_OF_BUFFERS if nothing
+    /// was published since the previous read.
+    uint32_t StartReading() {
+      if ((_middle.load(std::memory_order_relaxed) & NEW_DATA) == 0u) {
+        return NUMBER_OF_BUFFERS;
+      }
+      _read = _middle.exchange(_read, std::memory_order_acq_rel) & INDEX_MASK;
+      return _read;
+    }
+
+  private:
+
+    static constexpr uint32_t INDEX_MASK = 0x3u;
+
+    /// Flag of the middle buffer, set if it holds a value not read yet.
+    static constexpr uint32_t NEW_DATA = 0x4u;
+
+    std::atomic<uint32_t> _middle;
+
+    /// Only accessed by the writer.
+    uint32_t _write;
+
+    /// Only accessed by the reader.
+    uint32_t _read;
+  };
+
+} // namespace detail
+
+  /// A wait-free triple buffer for one producer and one consumer, keeping the
+  /// latest value written.
+  ///
+  /// Contrary to the DoubleBuffer, the writer never waits nor copies while the
+  /// consumer reads: the three buffers are preallocated and only their indices
+  /// are exchanged. If the producer writes several times between two reads,
+  /// the consumer only sees the last value. Reading has no time-out, readers
+  /// poll with TryMakeReader.
+  template <typename T>
+  class TripleBuffer : private detail::TripleBufferState {
+  public:
+
+    /// Returns a pointer to the latest value written, or nullptr if nothing
+    /// was written since the previous call.
+    ///
+    /// The value pointed remains owned by the reader, and valid, until the
+    /// next call to TryMakeReader.
+    const T *TryMakeReader() {
+      const auto index = StartReading();
+      return index != NUMBER_OF_BUFFERS ? &_buffer[index] : nullptr;
+    }
+
+    /// Returns an unique_ptr to the buffer to be written. The value is
+    /// published when the unique_ptr is destroyed.
+    ///
+    /// Never returns nullptr.
+    auto MakeWriter() {
+      const auto deleter = [this](T *) { EndWriting(); };
+      return std::unique_ptr<T, decltype(deleter)>(&_buffer[StartWriting()], deleter);
+    }
+
+  private:
+
+    T _buffer[NUMBER_OF_BUFFERS];
+  };
+
+} // namespace server
+} // namespace carla
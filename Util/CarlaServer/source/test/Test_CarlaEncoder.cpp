@@ -0,0 +1,144 @@
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "carla/server/CarlaEncoder.h"
+#include "carla/server/carla_server.pb.h"
+
+#include "Allocations.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+static const uint32_t AGENT_TYPES[] = {
+  CARLA_SERVER_AGENT_VEHICLE,
+  CARLA_SERVER_AGENT_PEDESTRIAN,
+  CARLA_SERVER_AGENT_SPEEDLIMITSIGN,
+  CARLA_SERVER_AGENT_TRAFFICLIGHT_GREEN,
+  CARLA_SERVER_AGENT_TRAFFICLIGHT_YELLOW,
+  CARLA_SERVER_AGENT_TRAFFICLIGHT_RED
+};
+
+/// Agents of every type, @a offset shifts which type each position gets.
+static std::vector<carla_agent> MakeAgents(size_t count, size_t offset = 0u) {
+  std::vector<carla_agent> agents(count);
+  for (auto i = 0u; i < count; ++i) {
+    auto &agent = agents[i];
+    agent.id = i;
+    agent.type = AGENT_TYPES[(i + offset) % (sizeof(AGENT_TYPES) / sizeof(AGENT_TYPES[0u]))];
+    agent.transform.location = {1.0f * i, 2.0f * i, 3.0f};
+    agent.transform.orientation = {1.0f, 0.0f, 0.0f};
+    agent.transform.rotation = {0.0f, 90.0f, 0.0f};
+    agent.bounding_box.transform = agent.transform;
+    agent.bounding_box.extent = {2.0f, 1.0f, 1.5f};
+    agent.forward_speed = 0.5f * i;
+  }
+  return agents;
+}
+
+static carla_measurements MakeMeasurements(uint32_t frame, const std::vector<carla_agent> &agents) {
+  carla_measurements values;
+  std::memset(&values, 0, sizeof(values));
+  values.frame_number = frame;
+  values.game_timestamp = 10u * frame;
+  values.player_measurements.forward_speed = 1.0f;
+  values.non_player_agents = agents.data();
+  values.number_of_non_player_agents = static_cast<uint32_t>(agents.size());
+  return values;
+}
+
+/// Decode @a encoded and check it matches @a agents.
+static void CheckMeasurements(const std::string &encoded, uint32_t frame, const std::vector<carla_agent> &agents) {
+  uint32_t size;
+  ASSERT_GE(encoded.size(), sizeof(size));
+  std::memcpy(&size, encoded.data(), sizeof(size));
+  ASSERT_EQ(size, encoded.size() - sizeof(size));
+  carla_server::Measurements message;
+  ASSERT_TRUE(message.ParseFromArray(encoded.data() + sizeof(size), static_cast<int>(size)));
+  ASSERT_EQ(message.frame_number(), frame);
+  ASSERT_EQ(message.player_measurements().forward_speed(), 1.0f);
+  ASSERT_EQ(static_cast<size_t>(message.non_player_agents_size()), agents.size());
+  for (auto i = 0u; i < agents.size(); ++i) {
+    const auto &agent = message.non_player_agents(static_cast<int>(i));
+    ASSERT_EQ(agent.id(), agents[i].id);
+    switch (agents[i].type) {
+      case CARLA_SERVER_AGENT_VEHICLE:
+        ASSERT_TRUE(agent.has_vehicle());
+        ASSERT_EQ(agent.vehicle().forward_speed(), agents[i].forward_speed);
+        ASSERT_EQ(agent.vehicle().transform().location().x(), agents[i].transform.location.x);
+        break;
+      case CARLA_SERVER_AGENT_PEDESTRIAN:
+        ASSERT_TRUE(agent.has_pedestrian());
+        ASSERT_EQ(agent.pedestrian().bounding_box().extent().z(), agents[i].bounding_box.extent.z);
+        break;
+      case CARLA_SERVER_AGENT_SPEEDLIMITSIGN:
+        ASSERT_TRUE(agent.has_speed_limit_sign());
+        ASSERT_EQ(agent.speed_limit_sign().speed_limit(), agents[i].forward_speed);
+        break;
+      default:
+        ASSERT_TRUE(agent.has_traffic_light());
+        ASSERT_EQ(agent.traffic_light().transform().location().y(), agents[i].transform.location.y);
+    }
+  }
+}
+
+TEST(CarlaEncoder, ReuseMeasurements) {
+  using namespace carla::server;
+  CarlaEncoder encoder;
+  // The cached message must not keep agents, or types, of previous frames.
+  const std::vector<std::vector<carla_agent>> frames = {
+    MakeAgents(100u),
+    MakeAgents(100u, 1u),
+    MakeAgents(20u, 3u),
+    MakeAgents(0u),
+    MakeAgents(150u, 2u),
+    MakeAgents(150u, 2u)
+  };
+  for (auto i = 0u; i < frames.size(); ++i) {
+    const auto &encoded = encoder.Encode(MakeMeasurements(i, frames[i]));
+    CheckMeasurements(encoded, i, frames[i]);
+  }
+}
+
+TEST(CarlaEncoder, InvalidAgentType) {
+  using namespace carla::server;
+  CarlaEncoder encoder;
+  auto agents = MakeAgents(10u);
+  encoder.Encode(MakeMeasurements(0u, agents));
+  // The agent reused at this position must not keep the previous type.
+  agents[3u].type = 0xFFFFu;
+  const auto &encoded = encoder.Encode(MakeMeasurements(1u, agents));
+  carla_server::Measurements message;
+  ASSERT_TRUE(message.ParseFromArray(encoded.data() + sizeof(uint32_t), static_cast<int>(encoded.size() - sizeof(uint32_t))));
+  ASSERT_EQ(message.non_player_agents_size(), 10);
+  const auto &agent = message.non_player_agents(3);
+  ASSERT_EQ(agent.agent_case(), carla_server::Agent::AGENT_NOT_SET);
+  ASSERT_EQ(agent.id(), 0u);
+  ASSERT_NE(message.non_player_agents(4).agent_case(), carla_server::Agent::AGENT_NOT_SET);
+}
+
+TEST(CarlaEncoder, MeasurementsBenchmark) {
+  using namespace carla::server;
+  using clock = std::chrono::steady_clock;
+  constexpr size_t numberOfFrames = 100u;
+  for (auto count : {0u, 10u, 100u, 1000u, 10000u}) {
+    CarlaEncoder encoder;
+    const auto agents = MakeAgents(count);
+    // The first frame allocates the cached message, and the string big enough
+    // for the largest frame number.
+    encoder.Encode(MakeMeasurements(numberOfFrames, agents));
+    const size_t allocations_before = util::GetNumberOfAllocations();
+    const auto start = clock::now();
+    size_t bytes = 0u;
+    for (auto frame = 1u; frame <= numberOfFrames; ++frame) {
+      bytes += encoder.Encode(MakeMeasurements(frame, agents)).size();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = clock::now() - start;
+    const size_t allocations = util::GetNumberOfAllocations() - allocations_before;
+    std::cout << count << " agents: " << elapsed.count() / numberOfFrames << "us/frame, "
+              << bytes / numberOfFrames << " bytes/frame, "
+              << static_cast<double>(allocations) / numberOfFrames << " allocations/frame" << std::endl;
+    ASSERT_EQ(allocations, 0u);
+  }
+}
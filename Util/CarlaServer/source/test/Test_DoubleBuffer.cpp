@@ -4,11 +4,15 @@
 
 #include <carla/Logging.h>
 #include <carla/server/DoubleBuffer.h>
+#include <carla/server/TripleBuffer.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <future>
 #include <string>
+#include <thread>
+#include <vector>
 
 // #define CARLA_DOUBLEBUFFER_TEST_LOG
 #ifdef CARLA_DOUBLEBUFFER_TEST_LOG
@@ -144,3 +148,148 @@ TEST(DoubleBuffer, LongMessage) {
   result_reader.get();
   result_writer.get();
 }
+
+TEST(TripleBuffer, WriteAndRead) {
+  using namespace carla::server;
+
+  TripleBuffer<size_t> buffer;
+  ASSERT_TRUE(buffer.TryMakeReader() == nullptr);
+
+  for (size_t i = 0u; i < 10u; ++i) {
+    {
+      auto writer = buffer.MakeWriter();
+      ASSERT_TRUE(writer != nullptr);
+      *writer = i;
+    }
+    auto reader = buffer.TryMakeReader();
+    ASSERT_TRUE(reader != nullptr);
+    ASSERT_EQ(*reader, i);
+    ASSERT_TRUE(buffer.TryMakeReader() == nullptr);
+  }
+
+  // Only the latest value is kept.
+  for (size_t i = 0u; i < 3u; ++i) {
+    *buffer.MakeWriter() = 100u + i;
+  }
+  auto reader = buffer.TryMakeReader();
+  ASSERT_TRUE(reader != nullptr);
+  ASSERT_EQ(*reader, 102u);
+  ASSERT_TRUE(buffer.TryMakeReader() == nullptr);
+}
+
+namespace {
+
+  /// Message with a payload large enough to detect torn reads.
+  struct StressMessage {
+    size_t sequence = 0u;
+    std::chrono::steady_clock::time_point time;
+    size_t payload[256u];
+  };
+
+} // namespace
+
+TEST(TripleBuffer, Stress) {
+  using namespace carla::server;
+
+  TripleBuffer<StressMessage> buffer;
+
+  constexpr size_t numberOfWrites = 200000u;
+
+  auto result_writer = std::async(std::launch::async, [&](){
+    for (size_t i = 1u; i <= numberOfWrites; ++i) {
+      auto writer = buffer.MakeWriter();
+      writer->sequence = i;
+      std::fill(std::begin(writer->payload), std::end(writer->payload), i);
+    }
+  });
+
+  auto result_reader = std::async(std::launch::async, [&](){
+    size_t last = 0u;
+    size_t readings = 0u;
+    while (last < numberOfWrites) {
+      auto reader = buffer.TryMakeReader();
+      if (reader == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+      ASSERT_GT(reader->sequence, last);
+      for (auto value : reader->payload) {
+        ASSERT_EQ(value, reader->sequence);
+      }
+      last = reader->sequence;
+      ++readings;
+    }
+    test_log("read", readings, "of", numberOfWrites, "messages");
+  });
+
+  result_reader.get();
+  result_writer.get();
+}
+
+/// Measures how long the writer takes to publish each message and how long
+/// the message takes to reach a reader polling the buffer.
+template <typename Buffer>
+static void BenchmarkLatency(const char *name) {
+  using clock = std::chrono::steady_clock;
+  using microseconds = std::chrono::duration<double, std::micro>;
+
+  Buffer buffer;
+
+  constexpr size_t numberOfWrites = 5000u;
+
+  std::atomic_bool done{false};
+  std::vector<double> write_times;
+  write_times.reserve(numberOfWrites);
+
+  auto result_writer = std::async(std::launch::async, [&](){
+    for (size_t i = 1u; i <= numberOfWrites; ++i) {
+      const auto start = clock::now();
+      {
+        auto writer = buffer.MakeWriter();
+        writer->sequence = i;
+        std::fill(std::begin(writer->payload), std::end(writer->payload), i);
+        writer->time = clock::now();
+      }
+      write_times.emplace_back(microseconds(clock::now() - start).count());
+      std::this_thread::sleep_for(std::chrono::microseconds(50u));
+    }
+    done = true;
+  });
+
+  std::vector<double> latencies;
+  latencies.reserve(numberOfWrites);
+  auto result_reader = std::async(std::launch::async, [&](){
+    size_t last = 0u;
+    while (!done) {
+      auto reader = buffer.TryMakeReader();
+      if (reader == nullptr) {
+        std::this_thread::yield();
+        continue;
+      }
+      latencies.emplace_back(microseconds(clock::now() - reader->time).count());
+      ASSERT_GT(reader->sequence, last);
+      last = reader->sequence;
+    }
+  });
+
+  result_reader.get();
+  result_writer.get();
+  ASSERT_FALSE(latencies.empty());
+
+  auto percentile = [](std::vector<double> &values, double p) {
+    const auto n = static_cast<size_t>(p * static_cast<double>(values.size() - 1u));
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    return values[n];
+  };
+  std::cout << name << ": " << latencies.size() << '/' << numberOfWrites << " messages read"
+            << ", write median " << percentile(write_times, 0.5) << "us"
+            << ", max " << percentile(write_times, 1.0) << "us"
+            << ", latency median " << percentile(latencies, 0.5) << "us"
+            << ", p99 " << percentile(latencies, 0.99) << "us" << std::endl;
+}
+
+TEST(TripleBuffer, LatencyBenchmark) {
+  using namespace carla::server;
+  BenchmarkLatency<DoubleBuffer<StressMessage>>("DoubleBuffer");
+  BenchmarkLatency<TripleBuffer<StressMessage>>("TripleBuffer");
+}
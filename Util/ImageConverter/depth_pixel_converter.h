@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 
 #include "image_converter_types.h"
 
@@ -41,6 +42,29 @@ namespace detail {
     grayscale.copy_to_pixel(pixel);
   }
 
+  // Apply DEPTH_TO_GRAYSCALE to every pixel of a row. Works on the raw
+  // interleaved channels without branches so the compiler can vectorize it.
+  template <typename DEPTH_TO_GRAYSCALE>
+  static void convert_depth_row(
+      boost::gil::rgb8_pixel_t *begin,
+      boost::gil::rgb8_pixel_t *end,
+      DEPTH_TO_GRAYSCALE depth_to_grayscale) {
+    static_assert(sizeof(boost::gil::rgb8_pixel_t) == 3u, "Unexpected pixel layout");
+    uint8 *data = &(*begin)[0];
+    const auto size = static_cast<size_t>(end - begin);
+    for (auto i = 0u; i < size; ++i) {
+      uint8 *pixel = data + 3u * i;
+      const auto depth =
+          (cast(pixel[Color::Red]) +
+          (cast(pixel[Color::Green]) * 256.0f) +
+          (cast(pixel[Color::Blue])  * 256.0f * 256.0f)) / cast(256 * 256 * 256 - 1);
+      const auto grayscale = depth_to_grayscale(depth);
+      pixel[Color::Red] = grayscale;
+      pixel[Color::Green] = grayscale;
+      pixel[Color::Blue] = grayscale;
+    }
+  }
+
 } // namespace detail
 
 struct depth_pixel_converter {
@@ -48,6 +72,12 @@ struct depth_pixel_converter {
     using namespace detail;
     copy_to_pixel(normalized_depth(pixel), pixel);
   }
+
+  void operator()(boost::gil::rgb8_pixel_t *begin, boost::gil::rgb8_pixel_t *end) const {
+    detail::convert_depth_row(begin, end, [](float depth) {
+      return static_cast<uint8>(255.0f * depth);
+    });
+  }
 };
 
 struct logarithmic_depth_pixel_converter {
@@ -56,6 +86,12 @@ struct logarithmic_depth_pixel_converter {
     const auto depth = clamp(logdepth(normalized_depth(pixel)));
     copy_to_pixel(depth, pixel);
   }
+
+  void operator()(boost::gil::rgb8_pixel_t *begin, boost::gil::rgb8_pixel_t *end) const {
+    detail::convert_depth_row(begin, end, [](float depth) {
+      return static_cast<uint8>(255.0f * detail::clamp(detail::logdepth(depth)));
+    });
+  }
 };
 
 } // namespace image_converter
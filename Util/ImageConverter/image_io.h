@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <regex>
+#include <string>
+
 #include <boost/gil/image.hpp>
 
 #if __has_include("jpeglib.h")
@@ -160,6 +163,98 @@ namespace detail {
   // -- any_image_io -----------------------------------------------------------
   // ===========================================================================
 
+namespace detail {
+
+  using write_function = void (*)(const char *, const boost::gil::rgb8c_view_t &);
+
+  template <typename IO, bool IS_SUPPORTED = IO::is_supported>
+  struct any_io {
+    static write_function read(const char *, boost::gil::rgb8_image_t &) {
+      return nullptr;
+    }
+  };
+
+  template <typename IO>
+  struct any_io<IO, true> {
+    static write_function read(const char *in_filename, boost::gil::rgb8_image_t &image) {
+      IO::reader_type::read_image(in_filename, image);
+      return &write;
+    }
+
+    static void write(const char *out_filename, const boost::gil::rgb8c_view_t &view) {
+      IO::writer_type::write_view(out_filename, view);
+    }
+  };
+
+  // Match filepath with a regular expression (case insensitive).
+  inline bool match(const std::string &filepath, const char *regex) {
+    return std::regex_match(
+        filepath,
+        std::regex(regex, std::regex_constants::icase));
+  }
+
+} // namespace detail
+
+  // Image file whose format is determined at runtime from its extension, and
+  // written back in the same format.
+  class any_image_file {
+  public:
+
+    // Return false if the format of in_filename is not supported.
+    bool read(const std::string &in_filename) {
+      using namespace detail;
+      const char *filename = in_filename.c_str();
+      if (match(in_filename, ".*\\.png$")) {
+        _write = any_io<png_io>::read(filename, _image);
+      } else if (match(in_filename, ".*\\.(jpg|jpeg)$")) {
+        _write = any_io<jpeg_io>::read(filename, _image);
+      } else if (match(in_filename, ".*\\.tiff$")) {
+        _write = any_io<tiff_io>::read(filename, _image);
+      } else {
+        _write = nullptr;
+      }
+      return _write != nullptr;
+    }
+
+    auto view() {
+      return boost::gil::view(_image);
+    }
+
+    auto view() const {
+      return boost::gil::const_view(_image);
+    }
+
+    void write(const std::string &out_filename) const {
+      _write(out_filename.c_str(), view());
+    }
+
+  private:
+
+    boost::gil::rgb8_image_t _image;
+
+    detail::write_function _write = nullptr;
+  };
+
+  // ===========================================================================
+  // -- apply_rows_to_view -----------------------------------------------------
+  // ===========================================================================
+
+  // Call row_converter(begin, end) on each row of an interleaved view, rows
+  // are split among number_of_threads OpenMP threads.
+  template <typename VIEW, typename ROW_CONVERTER>
+  static void apply_rows_to_view(
+      const VIEW &view,
+      ROW_CONVERTER row_converter,
+      int number_of_threads = 1) {
+    const auto height = static_cast<int>(view.height());
+    const auto width = view.width();
+#pragma omp parallel for num_threads(number_of_threads) schedule(static) if(number_of_threads > 1)
+    for (int y = 0; y < height; ++y) {
+      auto *row = &*view.row_begin(y);
+      row_converter(row, row + width);
+    }
+  }
+
   // ===========================================================================
   // -- image_file -------------------------------------------------------------
   // ===========================================================================
@@ -199,6 +294,11 @@ namespace detail {
       }
     }
 
+    template <typename ROW_CONVERTER>
+    void apply_rows(ROW_CONVERTER row_converter, int number_of_threads = 1) {
+      apply_rows_to_view(view(), row_converter, number_of_threads);
+    }
+
     template <typename OTHER_FORMAT=IO_WRITER>
     void write(const char *out_filename) const {
       static_assert(OTHER_FORMAT::is_supported, "I/O format not supported!");
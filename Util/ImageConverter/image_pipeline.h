@@ -0,0 +1,221 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_io.h"
+
+namespace image_converter {
+
+  // ===========================================================================
+  // -- Pipeline types ---------------------------------------------------------
+  // ===========================================================================
+
+  struct conversion_task {
+    std::string in_filename;
+    std::string out_filename;
+  };
+
+  struct pipeline_options {
+    // Threads decoding input files.
+    unsigned read_threads = 1u;
+    // Threads converting the rows of each image.
+    unsigned convert_threads = 1u;
+    // Threads encoding output files.
+    unsigned write_threads = 1u;
+    // Maximum number of images waiting between two stages.
+    size_t queue_size = 8u;
+  };
+
+  struct pipeline_statistics {
+    size_t images_converted = 0u;
+    size_t files_skipped = 0u;
+    size_t errors = 0u;
+    double seconds = 0.0;
+
+    double images_per_second() const {
+      return seconds > 0.0 ? static_cast<double>(images_converted) / seconds : 0.0;
+    }
+  };
+
+namespace detail {
+
+  // ===========================================================================
+  // -- blocking_queue ---------------------------------------------------------
+  // ===========================================================================
+
+  // Bounded queue connecting two stages, push blocks while full and pop
+  // blocks while empty until the queue is closed.
+  template <typename T>
+  class blocking_queue {
+  public:
+
+    explicit blocking_queue(size_t capacity)
+      : _capacity(std::max<size_t>(1u, capacity)) {}
+
+    void push(T item) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _not_full.wait(lock, [this]() { return _queue.size() < _capacity; });
+      _queue.emplace_back(std::move(item));
+      lock.unlock();
+      _not_empty.notify_one();
+    }
+
+    // Return false if the queue is closed and there are no items left.
+    bool pop(T &item) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _not_empty.wait(lock, [this]() { return !_queue.empty() || _closed; });
+      if (_queue.empty()) {
+        return false;
+      }
+      item = std::move(_queue.front());
+      _queue.pop_front();
+      lock.unlock();
+      _not_full.notify_one();
+      return true;
+    }
+
+    void close() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+      }
+      _not_empty.notify_all();
+    }
+
+  private:
+
+    const size_t _capacity;
+
+    std::mutex _mutex;
+
+    std::condition_variable _not_full;
+
+    std::condition_variable _not_empty;
+
+    std::deque<T> _queue;
+
+    bool _closed = false;
+  };
+
+  struct image_job {
+    std::unique_ptr<any_image_file> file;
+    std::string out_filename;
+  };
+
+  template <typename FUNCTOR>
+  static void run_threads(unsigned count, std::vector<std::thread> &threads, FUNCTOR functor) {
+    for (auto i = 0u; i < std::max(count, 1u); ++i) {
+      threads.emplace_back(functor);
+    }
+  }
+
+  static void join_threads(std::vector<std::thread> &threads) {
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    threads.clear();
+  }
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- run_pipeline -----------------------------------------------------------
+  // ===========================================================================
+
+  // Convert every task in three stages running concurrently: decode the input
+  // files, apply row_converter to the rows of each image, and encode the
+  // output files. Files with unsupported extensions are skipped, errors are
+  // reported to std::cerr and do not stop the pipeline.
+  template <typename ROW_CONVERTER>
+  static pipeline_statistics run_pipeline(
+      const std::vector<conversion_task> &tasks,
+      ROW_CONVERTER row_converter,
+      const pipeline_options &options) {
+    using namespace detail;
+    const auto start = std::chrono::steady_clock::now();
+
+    blocking_queue<image_job> decoded(options.queue_size);
+    blocking_queue<image_job> converted(options.queue_size);
+    std::atomic_size_t next_task{0u};
+    std::atomic_size_t images_converted{0u};
+    std::atomic_size_t files_skipped{0u};
+    std::atomic_size_t errors{0u};
+    std::mutex output_mutex;
+
+    auto report_error = [&](const std::string &filename, const std::exception &e) {
+      std::lock_guard<std::mutex> lock(output_mutex);
+      std::cerr << "exception thrown parsing file \"" << filename << "\"\n" << e.what() << std::endl;
+      ++errors;
+    };
+
+    std::vector<std::thread> readers;
+    run_threads(options.read_threads, readers, [&]() {
+      for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+        try {
+          image_job job{std::make_unique<any_image_file>(), tasks[i].out_filename};
+          if (job.file->read(tasks[i].in_filename)) {
+            decoded.push(std::move(job));
+          } else {
+            ++files_skipped;
+          }
+        } catch (const std::exception &e) {
+          report_error(tasks[i].in_filename, e);
+        }
+      }
+    });
+
+    std::thread converter([&]() {
+      const int number_of_threads = static_cast<int>(std::max(options.convert_threads, 1u));
+      image_job job;
+      while (decoded.pop(job)) {
+        apply_rows_to_view(job.file->view(), row_converter, number_of_threads);
+        converted.push(std::move(job));
+      }
+      converted.close();
+    });
+
+    std::vector<std::thread> writers;
+    run_threads(options.write_threads, writers, [&]() {
+      image_job job;
+      while (converted.pop(job)) {
+        try {
+          job.file->write(job.out_filename);
+          ++images_converted;
+        } catch (const std::exception &e) {
+          report_error(job.out_filename, e);
+        }
+        job.file.reset();
+      }
+    });
+
+    join_threads(readers);
+    decoded.close();
+    converter.join();
+    join_threads(writers);
+
+    pipeline_statistics statistics;
+    statistics.images_converted = images_converted;
+    statistics.files_skipped = files_skipped;
+    statistics.errors = errors;
+    statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return statistics;
+  }
+
+} // namespace image_converter
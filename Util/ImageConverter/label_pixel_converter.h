@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "image_converter_types.h"
 
 namespace image_converter {
@@ -28,15 +30,50 @@ namespace detail {
       {220u, 220u,   0u}  // TrafficSigns =  12u,
   };
 
+  constexpr static auto LABEL_COLOR_MAP_SIZE = sizeof(LABEL_COLOR_MAP)/sizeof(*LABEL_COLOR_MAP);
+
+  // Color of every possible value of the red channel, avoids the modulo per
+  // pixel.
+  struct label_color_table {
+    label_color_table() {
+      for (auto i = 0u; i < 256u; ++i) {
+        const auto &color = LABEL_COLOR_MAP[i % LABEL_COLOR_MAP_SIZE];
+        for (auto c = 0u; c < Color::NUMBER_OF_CHANNELS; ++c) {
+          data[i][c] = color[c];
+        }
+      }
+    }
+
+    uint8 data[256u][Color::NUMBER_OF_CHANNELS];
+  };
+
+  static const label_color_table &get_label_color_table() {
+    static const label_color_table table;
+    return table;
+  }
+
 } // namespace detail
 
 struct label_pixel_converter {
   void operator()(boost::gil::rgb8_pixel_t &pixel) const {
     using namespace detail;
-    constexpr auto size = sizeof(LABEL_COLOR_MAP)/sizeof(*LABEL_COLOR_MAP);
-    const auto index = pixel[Color::Red] % size;
+    const auto index = pixel[Color::Red] % LABEL_COLOR_MAP_SIZE;
     LABEL_COLOR_MAP[index].copy_to_pixel(pixel);
   }
+
+  void operator()(boost::gil::rgb8_pixel_t *begin, boost::gil::rgb8_pixel_t *end) const {
+    using namespace detail;
+    const auto &table = get_label_color_table();
+    uint8 *data = &(*begin)[0];
+    const auto size = static_cast<size_t>(end - begin);
+    for (auto i = 0u; i < size; ++i) {
+      uint8 *pixel = data + 3u * i;
+      const uint8 *color = table.data[pixel[Color::Red]];
+      pixel[Color::Red] = color[Color::Red];
+      pixel[Color::Green] = color[Color::Green];
+      pixel[Color::Blue] = color[Color::Blue];
+    }
+  }
 };
 
 } // namespace image_converter
@@ -4,16 +4,18 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
-#include <functional>
 #include <iostream>
-#include <regex>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
 #include "image_converter.h"
+#include "image_pipeline.h"
 
 enum MainFunctionReturnValues {
   Success,
@@ -24,76 +26,60 @@ enum MainFunctionReturnValues {
 namespace fs = boost::filesystem;
 namespace po = boost::program_options;
 
-using pixel_converter_function = std::function<void(boost::gil::rgb8_pixel_t &)>;
-
-static pixel_converter_function get_pixel_converter(const std::string &name) {
+// Call functor with the pixel converter named name. Each converter type gets
+// its own instantiation of the pipeline, so no indirect call is made per
+// pixel.
+template <typename FUNCTOR>
+static void with_pixel_converter(const std::string &name, FUNCTOR &&functor) {
   if (name == "semseg") {
-    return image_converter::label_pixel_converter();
+    functor(image_converter::label_pixel_converter());
   } else if (name == "depth") {
-    return image_converter::depth_pixel_converter();
+    functor(image_converter::depth_pixel_converter());
   } else if (name == "logdepth") {
-    return image_converter::logarithmic_depth_pixel_converter();
+    functor(image_converter::logarithmic_depth_pixel_converter());
   } else {
     throw po::error("invalid converter, please choose \"semseg\", \"depth\", or \"logdepth\"");
   }
 }
 
-// Match filepath with a regular expression (case insensitive).
-static bool match(const std::string &filepath, const std::string &regex) {
-  return std::regex_match(
-      filepath,
-      std::regex(regex, std::regex_constants::icase));
-}
-
-// Load image, apply pixel converter, and save it.
-template <typename IO>
-static void parse_image(
-    const std::string &in_filename,
-    const std::string &out_filename,
-    pixel_converter_function converter) {
-  image_converter::image_file<IO> file_io(in_filename);
-  file_io.apply(converter);
-  file_io.write(out_filename);
-}
-
-// Determine the file format and parse it accordingly.
-static void parse_any_image(
-    const std::string &in_filename,
-    const std::string &out_filename,
-    pixel_converter_function converter) {
-  namespace ic = image_converter;
-  try {
-    if (ic::has_png_support() && match(in_filename, ".*\\.png$")) {
-      parse_image<ic::png_io>(in_filename, out_filename, converter);
-    } else if (ic::has_jpeg_support() && match(in_filename, ".*\\.(jpg|jpeg)$")) {
-      parse_image<ic::jpeg_io>(in_filename, out_filename, converter);
-    } else if (ic::has_tiff_support() && match(in_filename, ".*\\.tiff$")) {
-      parse_image<ic::tiff_io>(in_filename, out_filename, converter);
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "exception thrown parsing file \"" << in_filename << "\"\n" << e.what() << std::endl;
-  }
-}
-
-// Parse in parallel every regular file in input_folder.
+// Parse every regular file in input_folder in a read, convert and write
+// pipeline.
+template <typename ROW_CONVERTER>
 static void do_the_thing(
     const fs::path &input_folder,
     const fs::path &output_folder,
-    const pixel_converter_function converter) {
-  const std::vector<fs::directory_entry> entries{
-      fs::directory_iterator(input_folder),
-      fs::directory_iterator()};
-  std::cout << "parsing " << entries.size() << " files in folder\n";
-
-#pragma omp parallel for
-  for (auto i = 0u; i < entries.size(); ++i) {
-    const auto &entry = entries[i];
-    if (fs::is_regular_file(entry.status())) {
-      const auto &in_path = entry.path();
-      const auto &out_path = output_folder / in_path.filename();
-      parse_any_image(in_path.string(), out_path.string(), converter);
+    ROW_CONVERTER converter,
+    const unsigned jobs) {
+  namespace ic = image_converter;
+  std::vector<ic::conversion_task> tasks;
+  for (auto it = fs::directory_iterator(input_folder); it != fs::directory_iterator(); ++it) {
+    if (fs::is_regular_file(it->status())) {
+      const auto &in_path = it->path();
+      tasks.push_back({in_path.string(), (output_folder / in_path.filename()).string()});
     }
   }
+  std::cout << "parsing " << tasks.size() << " files in folder\n";
+
+  // Decoding and encoding are the expensive stages, conversion splits the
+  // rows of each image so a few huge files still use every core.
+  ic::pipeline_options options;
+  options.read_threads = jobs;
+  options.convert_threads = jobs;
+  options.write_threads = jobs;
+  options.queue_size = 2u * jobs;
+
+  const auto statistics = ic::run_pipeline(tasks, converter, options);
+
+  std::cout << "converted " << statistics.images_converted << " images in "
+            << statistics.seconds << " seconds ("
+            << statistics.images_per_second() << " images/s)";
+  if (statistics.files_skipped > 0u) {
+    std::cout << ", skipped " << statistics.files_skipped << " files";
+  }
+  if (statistics.errors > 0u) {
+    std::cout << ", " << statistics.errors << " errors";
+  }
+  std::cout << std::endl;
 }
 
 int main(int argc, char *argv[]) {
@@ -101,6 +87,7 @@ int main(int argc, char *argv[]) {
     std::string converter_name;
     fs::path input_folder;
     fs::path output_folder;
+    unsigned jobs;
 
     // Fill program options.
     po::options_description desc("Allowed options");
@@ -109,6 +96,7 @@ int main(int argc, char *argv[]) {
       ("converter,c", po::value<std::string>(&converter_name)->required(), "converter (semseg or depth or logdepth)")
       ("input-folder,i", po::value<fs::path>(&input_folder)->default_value("."), "input folder containing images")
       ("output-folder,o", po::value<fs::path>(&output_folder)->default_value("./converted_images"), "output folder to save converted images")
+      ("jobs,j", po::value<unsigned>(&jobs)->default_value(0u), "number of threads per stage (0 for one per hardware thread)")
       ;
 
     try {
@@ -136,10 +124,13 @@ int main(int argc, char *argv[]) {
         throw std::invalid_argument("cannot create folder: " + output_folder.string());
       }
 
-      // Retrieve the pixel converter.
-      const pixel_converter_function converter = get_pixel_converter(converter_name);
+      if (jobs == 0u) {
+        jobs = std::max(std::thread::hardware_concurrency(), 1u);
+      }
 
-      do_the_thing(input_folder, output_folder, converter);
+      with_pixel_converter(converter_name, [&](auto converter) {
+        do_the_thing(input_folder, output_folder, converter, jobs);
+      });
 
     } catch (const po::error &e) {
       std::cerr << desc << "\n" << e.what() << std::endl;